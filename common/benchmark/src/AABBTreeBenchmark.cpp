@@ -35,6 +35,11 @@
 #include "Model/World.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
@@ -81,4 +86,74 @@ namespace TrenchBroom {
             }
         }, "Add objects to AABB tree");
     }
+
+    TEST(AABBTreeBenchmark, benchQueryTree) {
+        static constexpr size_t NumBoxes = 50'000;
+        static constexpr size_t NumQueries = 10'000;
+
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> position(-4096.0, 4096.0);
+        std::uniform_real_distribution<double> size(8.0, 128.0);
+        std::uniform_real_distribution<double> direction(-1.0, 1.0);
+
+        std::vector<BOX> boxes;
+        for (size_t i = 0; i < NumBoxes; ++i) {
+            const auto min = vm::vec3(position(rng), position(rng), position(rng));
+            boxes.emplace_back(min, min + vm::vec3(size(rng), size(rng), size(rng)));
+        }
+
+        std::vector<vm::ray3> rays;
+        std::vector<vm::vec3> points;
+        for (size_t i = 0; i < NumQueries; ++i) {
+            rays.emplace_back(vm::vec3(position(rng), position(rng), position(rng)), vm::normalize(vm::vec3(direction(rng), direction(rng), direction(rng))));
+            points.emplace_back(position(rng), position(rng), position(rng));
+        }
+
+        // the trees store the indices of the boxes as their data
+        using IndexTree = AABBTree<double, 3, size_t>;
+
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            indices.push_back(i);
+        }
+        const auto getBounds = [&](const size_t i) { return boxes[i]; };
+
+        IndexTree incrementalTree;
+        timeLambda([&]() {
+            for (const auto i : indices) {
+                incrementalTree.insert(getBounds(i), i);
+            }
+        }, "Insert " + std::to_string(NumBoxes) + " boxes into AABB tree one by one");
+
+        IndexTree bulkTree;
+        timeLambda([&]() {
+            bulkTree.clearAndBuild(indices, getBounds);
+        }, "Build AABB tree with " + std::to_string(NumBoxes) + " boxes in bulk");
+
+        for (const auto* tree : { &incrementalTree, &bulkTree }) {
+            const auto name = std::string(tree == &incrementalTree ? "incrementally built" : "bulk built") + " tree of height " + std::to_string(tree->height());
+
+            size_t intersectorCount = 0;
+            timeLambda([&]() {
+                std::vector<size_t> result;
+                for (const auto& ray : rays) {
+                    result.clear();
+                    tree->findIntersectors(ray, std::back_inserter(result));
+                    intersectorCount += result.size();
+                }
+            }, "Find intersectors of " + std::to_string(NumQueries) + " rays in " + name);
+
+            size_t containerCount = 0;
+            timeLambda([&]() {
+                std::vector<size_t> result;
+                for (const auto& point : points) {
+                    result.clear();
+                    tree->findContainers(point, std::back_inserter(result));
+                    containerCount += result.size();
+                }
+            }, "Find containers of " + std::to_string(NumQueries) + " points in " + name);
+
+            printf("Found %zu intersectors and %zu containers\n", intersectorCount, containerCount);
+        }
+    }
 }
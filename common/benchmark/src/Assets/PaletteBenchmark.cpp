@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/Reader.h"
+
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        TEST(PaletteBenchmark, benchIndexedToRgba) {
+            // roughly the contents of a large Quake texture wad: 512 textures with 4 mip levels each
+            static constexpr size_t NumTextures = 512;
+            static constexpr size_t MipLevels = 4;
+            static constexpr size_t Repetitions = 10;
+            static const size_t Sizes[][2] = { { 64, 64 }, { 128, 128 }, { 256, 128 }, { 64, 256 } };
+
+            std::mt19937 rng(0);
+            std::uniform_int_distribution<int> byte(0, 255);
+
+            auto paletteData = std::vector<unsigned char>(768);
+            for (auto& c : paletteData) {
+                c = static_cast<unsigned char>(byte(rng));
+            }
+            const auto palette = Palette(paletteData);
+
+            std::vector<std::vector<char>> indexedImages;
+            std::vector<TextureBuffer> rgbaImages;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                const auto* size = Sizes[i % 4];
+                for (size_t j = 0; j < MipLevels; ++j) {
+                    const auto pixelCount = (size[0] >> j) * (size[1] >> j);
+
+                    auto indexedImage = std::vector<char>(pixelCount);
+                    // textures consist of runs of similar colors, so don't use uniformly distributed indices
+                    auto index = byte(rng);
+                    for (auto& c : indexedImage) {
+                        if (byte(rng) < 32) {
+                            index = byte(rng);
+                        }
+                        c = static_cast<char>(index);
+                    }
+
+                    indexedImages.push_back(std::move(indexedImage));
+                    rgbaImages.emplace_back(4 * pixelCount);
+                }
+            }
+
+            size_t transparentCount = 0;
+            timeLambda([&]() {
+                for (size_t r = 0; r < Repetitions; ++r) {
+                    for (size_t i = 0; i < indexedImages.size(); ++i) {
+                        const auto& indexedImage = indexedImages[i];
+                        auto reader = IO::Reader::from(indexedImage.data(), indexedImage.data() + indexedImage.size());
+
+                        Color averageColor;
+                        if (palette.indexedToRgba(reader, indexedImage.size(), rgbaImages[i], PaletteTransparency::Index255Transparent, averageColor)) {
+                            ++transparentCount;
+                        }
+                    }
+                }
+            }, "Convert indexed images to RGBA");
+
+            ASSERT_GT(transparentCount, 0u);
+        }
+    }
+}
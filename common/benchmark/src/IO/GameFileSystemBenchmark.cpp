@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "Model/GameConfig.h"
+#include "Model/GameFileSystem.h"
+
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        // roughly the size of the Quake 2 or Half-Life search paths
+        static constexpr size_t NumPaks = 4;
+        static constexpr size_t NumEntriesPerPak = 4'000;
+        static constexpr size_t NumLookups = 100'000;
+
+        static std::string entryName(const size_t pak, const size_t entry) {
+            static const char* Directories[] = { "textures/e1u1", "textures/e2u3", "models/items", "sound/world", "pics" };
+            return std::string(Directories[entry % 5]) + "/pak" + std::to_string(pak) + "_entry" + std::to_string(entry) + ".dat";
+        }
+
+        static Path pakName(const size_t pak) {
+            return Path("pak" + std::to_string(pak) + ".pak");
+        }
+
+        static void appendInt32(std::string& str, const size_t value) {
+            const auto i = static_cast<int32_t>(value);
+            str.append(reinterpret_cast<const char*>(&i), sizeof(i));
+        }
+
+        static void writePak(const Path& path, const size_t pak) {
+            static const std::string EntryContents = "some data";
+            static constexpr size_t HeaderLength = 12;
+            static constexpr size_t EntryNameLength = 56;
+
+            std::string contents = "PACK";
+            appendInt32(contents, HeaderLength + NumEntriesPerPak * EntryContents.size());
+            appendInt32(contents, NumEntriesPerPak * (EntryNameLength + 8));
+            for (size_t i = 0; i < NumEntriesPerPak; ++i) {
+                contents += EntryContents;
+            }
+
+            for (size_t i = 0; i < NumEntriesPerPak; ++i) {
+                auto name = entryName(pak, i);
+                name.resize(EntryNameLength, '\0');
+                contents += name;
+                appendInt32(contents, HeaderLength + i * EntryContents.size());
+                appendInt32(contents, EntryContents.size());
+            }
+
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary);
+            stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+
+        TEST(GameFileSystemBenchmark, benchLookupsInStackedPaks) {
+            const auto gamePath = Disk::getCurrentWorkingDir() + Path("GameFileSystemBenchmark");
+            const auto searchPath = Path("id1");
+
+            WritableDiskFileSystem diskFS(gamePath + searchPath, true);
+            for (size_t i = 0; i < NumPaks; ++i) {
+                writePak(gamePath + searchPath + pakName(i), i);
+            }
+
+            const auto config = Model::GameConfig(
+                "Benchmark", Path(), Path(), false, {},
+                Model::FileSystemConfig(searchPath, Model::PackageFormatConfig("pak", "idpak")),
+                Model::TextureConfig(), Model::EntityConfig(), Model::FaceAttribsConfig(), {});
+
+            NullLogger logger;
+            Model::GameFileSystem fs;
+            fs.initialize(config, gamePath, {}, logger);
+
+            // look up existing files in all paks with varying case; the last pak index doesn't exist and yields
+            // files which are not found in any pak
+            std::mt19937 rng(0);
+            std::uniform_int_distribution<size_t> pakDist(0, NumPaks);
+            std::uniform_int_distribution<size_t> entryDist(0, NumEntriesPerPak - 1);
+
+            std::vector<Path> paths;
+            paths.reserve(NumLookups);
+            for (size_t i = 0; i < NumLookups; ++i) {
+                auto name = entryName(pakDist(rng), entryDist(rng));
+                if (i % 2 == 0) {
+                    name[0] = static_cast<char>(std::toupper(name[0]));
+                }
+                paths.emplace_back(name);
+            }
+
+            size_t found = 0;
+            size_t opened = 0;
+            timeLambda([&]() {
+                for (const auto& path : paths) {
+                    if (fs.fileExists(path)) {
+                        ++found;
+                        if (fs.openFile(path) != nullptr) {
+                            ++opened;
+                        }
+                    }
+                }
+            }, "Look up files in stacked paks");
+
+            ASSERT_GT(found, 0u);
+            ASSERT_LT(found, NumLookups);
+            ASSERT_EQ(found, opened);
+
+            for (size_t i = 0; i < NumPaks; ++i) {
+                diskFS.deleteFile(pakName(i));
+            }
+        }
+    }
+}
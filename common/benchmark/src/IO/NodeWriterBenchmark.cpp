@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2018 Eric Wasylishen
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/NodeWriter.h"
+#include "IO/PrintfMapFileSerializer.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushes = 64'000;
+
+        static void addBrushes(Model::World& world) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            // use fractional coordinates so that the face points are written with many digits
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                const auto x = static_cast<FloatType>(i % 64) * 96.0 - 3072.0 + 1.0 / 3.0;
+                const auto y = static_cast<FloatType>((i / 64) % 64) * 96.0 - 3072.0 + 1.0 / 7.0;
+                const auto z = static_cast<FloatType>(i / 4096) * 96.0 - 3072.0 + 1.0 / 9.0;
+                const auto min = vm::vec3(x, y, z);
+                auto* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(64.0, 64.0, 64.0)), "texture");
+                world.defaultLayer()->addChild(brush);
+            }
+        }
+
+        TEST(NodeWriterBenchmark, benchWriteMap) {
+            Model::World world(Model::MapFormat::Valve);
+            addBrushes(world);
+
+            FILE* printfFile = std::tmpfile();
+            ASSERT_NE(nullptr, printfFile);
+
+            timeLambda([&]() {
+                NodeWriter writer(world, PrintfMapFileSerializer::create(world.format(), printfFile).release());
+                writer.writeMap();
+            }, "write " + std::to_string(NumBrushes) + " brushes with fprintf");
+
+            FILE* bufferedFile = std::tmpfile();
+            ASSERT_NE(nullptr, bufferedFile);
+
+            timeLambda([&]() {
+                NodeWriter writer(world, bufferedFile);
+                writer.writeMap();
+            }, "write " + std::to_string(NumBrushes) + " brushes with buffers");
+
+            ASSERT_EQ(std::ftell(printfFile), std::ftell(bufferedFile));
+
+            std::fclose(bufferedFile);
+            std::fclose(printfFile);
+        }
+    }
+}
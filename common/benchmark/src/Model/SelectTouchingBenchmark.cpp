@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/EditorContext.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(SelectTouchingBenchmark, benchSelectTouchingAndInside) {
+            static constexpr size_t NumBrushes = 50'000;
+            static constexpr size_t NumQueries = 1'000;
+
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard);
+            BrushBuilder builder(&world, worldBounds);
+
+            std::mt19937 rng(0);
+            std::uniform_real_distribution<double> position(-4096.0, 4096.0);
+
+            const auto createBrush = [&](const double maxSize) {
+                std::uniform_real_distribution<double> size(8.0, maxSize);
+                const auto min = vm::vec3(position(rng), position(rng), position(rng));
+                return builder.createCuboid(vm::bbox3(min, min + vm::vec3(size(rng), size(rng), size(rng))), "texture");
+            };
+
+            std::vector<Brush*> queryBrushes;
+            world.disableNodeTreeUpdates();
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                world.defaultLayer()->addChild(createBrush(128.0));
+            }
+            for (size_t i = 0; i < NumQueries; ++i) {
+                auto* brush = createBrush(512.0);
+                world.defaultLayer()->addChild(brush);
+                queryBrushes.push_back(brush);
+            }
+            world.enableNodeTreeUpdates();
+            world.rebuildNodeTree();
+
+            const EditorContext editorContext;
+            using Iter = std::vector<Brush*>::const_iterator;
+            const auto suffix = " of " + std::to_string(NumQueries) + " brushes among " + std::to_string(NumBrushes) + " brushes";
+
+            size_t bruteForceCount = 0;
+            timeLambda([&]() {
+                CollectTouchingNodesVisitor<Iter> visitor(std::begin(queryBrushes), std::end(queryBrushes), editorContext);
+                world.acceptAndRecurse(visitor);
+                bruteForceCount = visitor.nodes().size();
+            }, "Find touching nodes" + suffix + " by testing every pair");
+
+            size_t broadPhaseCount = 0;
+            timeLambda([&]() {
+                CollectTouchingNodesVisitor<Iter> visitor(std::begin(queryBrushes), std::end(queryBrushes), world, editorContext);
+                world.acceptAndRecurse(visitor);
+                broadPhaseCount = visitor.nodes().size();
+            }, "Find touching nodes" + suffix + " using the node tree");
+
+            ASSERT_EQ(bruteForceCount, broadPhaseCount);
+
+            timeLambda([&]() {
+                CollectContainedNodesVisitor<Iter> visitor(std::begin(queryBrushes), std::end(queryBrushes), editorContext);
+                world.acceptAndRecurse(visitor);
+                bruteForceCount = visitor.nodes().size();
+            }, "Find contained nodes" + suffix + " by testing every pair");
+
+            timeLambda([&]() {
+                CollectContainedNodesVisitor<Iter> visitor(std::begin(queryBrushes), std::end(queryBrushes), world, editorContext);
+                world.acceptAndRecurse(visitor);
+                broadPhaseCount = visitor.nodes().size();
+            }, "Find contained nodes" + suffix + " using the node tree");
+
+            ASSERT_EQ(bruteForceCount, broadPhaseCount);
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #ifndef TRENCHBROOM_AABBTREE_H
 #define TRENCHBROOM_AABBTREE_H
 
+#include "BVHUtils.h"
 #include "Exceptions.h"
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
@@ -27,15 +28,24 @@
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
  *
+ * The nodes of the tree are stored in a flat array and refer to each other by their indices. The tree can be built
+ * incrementally by inserting and removing nodes one by one, or in bulk using `clearAndBuild`, which uses the surface
+ * area heuristic to produce a tree that can be queried more efficiently and lays out the nodes in depth first order.
+ *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
  * @tparam U the node data to store in the leafs
@@ -49,418 +59,45 @@ public:
     using FloatType = T;
     static constexpr size_t Components = S;
 private:
-    class InnerNode;
-    class LeafNode;
-
-    class Visitor {
-    public:
-        virtual ~Visitor() = default;
-
-        virtual bool visit(const InnerNode* innerNode) = 0;
-        virtual void visit(const LeafNode* leaf) = 0;
-    };
-
-    class LambdaVisitor : public Visitor {
-    public:
-        using InnerNodeVisitor = std::function<bool(const InnerNode*)>;
-        using LeafVisitor = std::function<void(const LeafNode*)>;
-    private:
-        const InnerNodeVisitor m_innerNodeVisitor;
-        const LeafVisitor m_leafVisitor;
-    public:
-        LambdaVisitor(const InnerNodeVisitor& innerNodeVisitor, const LeafVisitor& leafVisitor) :
-        m_innerNodeVisitor(innerNodeVisitor),
-        m_leafVisitor(leafVisitor) {}
-
-        bool visit(const InnerNode* innerNode) override { return m_innerNodeVisitor(innerNode); }
-        void visit(const LeafNode* leaf)           override { m_leafVisitor(leaf); }
-    };
-
-    class Node {
-    public:
-        Box m_bounds;
-        InnerNode* m_parent;
-    protected:
-        explicit Node(const Box& bounds) :
-        m_bounds(bounds),
-        m_parent(nullptr) {}
-    public:
-        virtual ~Node() = default;
-
-        /**
-         * Return the bounds of this node.
-         *
-         * @return the bounds
-         */
-        const Box& bounds() const {
-            return m_bounds;
-        }
-
-        /**
-         * Return the height of this node. A leaf always has a height of 1, and an inner node has a height equal to the
-         * maximum of the heights of its children plus one.
-         *
-         * @return the height
-         */
-        virtual size_t height() const = 0;
-
-        /**
-         * Inserts a new node into the subtree rooted at `this`.
-         *
-         * @param bounds the bounds of the data to be inserted
-         * @param data the data to be inserted
-         * @return a pair containing the new subtree root (may be `this`, or a new node), and the newly inserted LeafNode
-         */
-        virtual std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) = 0;
-
-        /**
-         * Accepts the given visitor.
-         *
-         * @param visitor the visitor to accept
-         */
-        virtual void accept(Visitor& visitor) const = 0;
-    public:
-        /**
-         * Appends a textual representation of this node to the given output stream.
-         *
-         * @param str the stream to append to
-         */
-        void appendTo(std::ostream& str) const {
-            appendTo(str, "  ", 0);
-        }
-
-        /**
-         * Appends a textual representation of this node to the given output stream using the given indent string and
-         * the given level of indentation.
-         *
-         * @param str the stream to append to
-         * @param indent the indent string
-         * @param level the level of indentation
-         */
-        virtual void appendTo(std::ostream& str, const std::string& indent, size_t level) const = 0;
-
-        virtual void checkParentPointers(const Node* expectedParent) const = 0;
-    protected:
-        /**
-         * Updates the bounds of this node.
-         *
-         * @param bounds the new bounds
-         */
-        void setBounds(const Box& bounds) {
-            m_bounds = bounds;
-        }
-
-        /**
-         * Appends a textual representation of this node's bounds to the given output stream.
-         *
-         * @param str the stream to append to
-         */
-        void appendBounds(std::ostream& str) const {
-            str << "[ ( " << m_bounds.min << " ) ( " << m_bounds.max  << " ) ]";
-        }
-    };
+    static constexpr size_t NoNode = std::numeric_limits<size_t>::max();
 
     /**
-     * An inner node of an AABB tree does not carry data. It's only purpose is to structure the tree. Its bounds is
-     * the smallest bounding box that contains the bounds of its children.
+     * A node of the tree. An inner node has two children and does not carry data. Its bounds is the smallest bounding
+     * box that contains the bounds of its children. A leaf node has no children and carries data; its bounds equals
+     * the bounds supplied when the data was inserted into the tree.
+     *
+     * A leaf always has a height of 1, and an inner node has a height equal to the maximum of the heights of its
+     * children plus one.
      */
-    class InnerNode : public Node {
-    private:
-        Node* m_left;
-        Node* m_right;
-        size_t m_height;
-    public:
-        InnerNode(Node* left, Node* right) :
-        Node(merge(left->bounds(), right->bounds())),
-        m_left(left),
-        m_right(right),
-        m_height(0) {
-            assert(m_left != nullptr);
-            assert(m_right != nullptr);
-
-            m_left->m_parent = this;
-            m_right->m_parent = this;
-
-            updateHeight();
-        }
-
-    private: // node removal private
-        /**
-         * Children (or grandchildren etc.) changed. Update the height and bounds.
-         * Recurses up the tree along the m_parent chain until it reaches the root.
-         *
-         * @return the new root of the tree
-         */
-        Node* updateAndReturnRoot() {
-            updateHeight();
-            updateBounds();
-
-            if (this->m_parent == nullptr) {
-                return this;
-            }
-
-            return this->m_parent->updateAndReturnRoot();
-        }
-
-        /**
-         * One of our direct children is being swapped for a new node.
-         *
-         * @return the new root of the tree
-         */
-        Node* replaceChild(Node* child, Node* replacement) {
-            replacement->m_parent = this;
+    struct Node {
+        Box bounds;
+        size_t parent;
+        size_t left;
+        size_t right;
+        size_t height;
+        U data;
 
-            if (child == m_left) {
-                m_left = replacement;
-            } else {
-                assert(child == m_right);
-                m_right = replacement;
-            }
-
-            return updateAndReturnRoot();
-        }
-    public: // Node removal public
-        /**
-         * One of our direct children is being deleted. `this` will turn into a LeafNode.
-         *
-         * @param child either m_left or m_right, which is being deleted
-         * @return the new root of the tree
-         */
-        Node* handleChildDeletion(LeafNode* child) {
-            Node* replacementForThis;
-            if (child == m_left) {
-                replacementForThis = m_right;
-            } else {
-                assert(child == m_right);
-                replacementForThis = m_left;
-            }
-
-            // Clear m_left/m_right so our destructor doesn't delete our children.
-            // The caller is going to delete one of them (`child`),
-            // and we will reuse the other one as the replacement for `this`.
-            m_left = nullptr;
-            m_right = nullptr;
-
-            // Special case when `this` is already the tree root
-            if (this->m_parent == nullptr) {
-                Node* newTreeRoot = replacementForThis;
-                newTreeRoot->m_parent = nullptr;
-                delete this;
-                return newTreeRoot;
-            }
-
-            Node* newTreeRoot = this->m_parent->replaceChild(this, replacementForThis);
-            delete this;
-            return newTreeRoot;
-        }
-
-    public: // Node overrides
-        ~InnerNode() override {
-            delete m_left;
-            delete m_right;
-        }
-
-        size_t height() const override {
-            return m_height;
-        }
-
-        std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-            // Select the subtree which is increased the least by inserting a node with the given bounds.
-            // Then insert the node into that subtree and update our reference to it.
-            auto*& subtree = selectLeastIncreaser(m_left, m_right, bounds);
-
-            Node* newSubtree;
-            LeafNode* insertedLeafNode;
-            std::tie(newSubtree, insertedLeafNode) = subtree->insert(bounds, data);
-
-            // Update the parent pointer
-            newSubtree->m_parent = this;
-
-            // Subtree is either a reference to m_left or m_right
-            if (subtree == m_left) {
-                m_left = newSubtree;
-            } else {
-                assert(subtree == m_right);
-                m_right = newSubtree;
-            }
-
-            // Update our data.
-            updateBounds();
-            updateHeight();
-
-            return std::make_pair(this, insertedLeafNode);
-        }
-
-    private:
-        /**
-         * Selects one of the two given nodes such that it increases the given bounds the least.
-         *
-         * @tparam TT the type of the nodes
-         * @param node1 the first node to test
-         * @param node2 the second node to test
-         * @param bounds the bounds to test against
-         * @return node1 if it increases the given bounds volume by a smaller or equal amount than node2 would, and
-         *     node2 otherwise
-         */
-        template <typename TT>
-        static TT*& selectLeastIncreaser(TT*& node1, TT*& node2, const Box& bounds) {
-            const auto node1Contains = node1->bounds().contains(bounds);
-            const auto node2Contains = node2->bounds().contains(bounds);
-
-            if (node1Contains && !node2Contains) {
-                return node1;
-            } else if (!node1Contains && node2Contains) {
-                return node2;
-            } else if (!node1Contains && !node2Contains) {
-                const auto new1 = vm::merge(node1->bounds(), bounds);
-                const auto new2 = vm::merge(node2->bounds(), bounds);
-                const auto vol1 = node1->bounds().volume();
-                const auto vol2 = node2->bounds().volume();
-                const auto diff1 = new1.volume() - vol1;
-                const auto diff2 = new2.volume() - vol2;
-
-                if (diff1 < diff2) {
-                    return node1;
-                } else if (diff2 < diff1) {
-                    return node2;
-                }
-            }
-
-            static auto choice = 0u;
-
-            if (node1->height() < node2->height()) {
-                return node1;
-            } else if (node2->height() < node1->height()) {
-                return node2;
-            } else {
-                if (choice++ % 2 == 0) {
-                    return node1;
-                } else {
-                    return node2;
-                }
-            }
-        }
-
-        void updateBounds() {
-            this->setBounds(merge(m_left->bounds(), m_right->bounds()));
-        }
-
-        void updateHeight() {
-            m_height = std::max(m_left->height(), m_right->height()) + 1;
-            assert(m_height > 0);
-        }
-
-        void accept(Visitor& visitor) const override {
-            if (visitor.visit(this)) {
-                m_left->accept(visitor);
-                m_right->accept(visitor);
-            }
-        }
-    public:
-        void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-            for (size_t i = 0; i < level; ++i)
-                str << indent;
-
-            str << "O ";
-            this->appendBounds(str);
-            str << std::endl;
-
-            m_left->appendTo(str, indent, level + 1);
-            m_right->appendTo(str, indent, level + 1);
-        }
-
-        virtual void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-            assert(this->m_parent == expectedParent);
-            m_left->checkParentPointers(this);
-            m_left->checkParentPointers(this);
+        bool leaf() const {
+            return left == NoNode;
         }
     };
 
     /**
-     * A leaf node represents actual data. It does not have any children. Its bounds equals the bounds supplied when
-     * the node was inserted into the tree. A leaf has a height of 1 and a balance of 0.
+     * An element to be inserted when building a tree in bulk.
      */
-    class LeafNode : public Node {
-    private:
-        U m_data;
-    public:
-        LeafNode(const Box& bounds, const U& data) : Node(bounds), m_data(data) {}
-
-        /**
-         * Deletes this. Returns the new root of the tree.
-         */
-        Node* deleteThis() {
-            Node* newRoot = (this->m_parent != nullptr)
-                    ? this->m_parent->handleChildDeletion(this)
-                    : nullptr;
-            delete this;
-            return newRoot;
-        }
-
-        /**
-         * Returns the data associated with this node.
-         *
-         * @return the data associated with this node
-         */
-        U& data() {
-            return m_data;
-        }
-
-        /**
-         * Returns the data associated with this node.
-         *
-         * @return the data associated with this node
-         */
-        const U& data() const {
-            return m_data;
-        }
-
-    public: // Node overrides
-        size_t height() const override {
-            return 1;
-        }
-
-        /**
-         * Returns a new inner node that has this leaf as its left child and a new leaf representing the given bounds
-         * and data as its right child.
-         *
-         * @param bounds the bounds to insert
-         * @param data the data to insert
-         * @return a pair containing the new inner node that is the root of this subtree, and the newly inserted LeafNode
-         */
-        std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-            auto* newLeaf = new LeafNode(bounds, data);
-            auto* newParent = new InnerNode(this, newLeaf);
-
-            return std::make_pair(newParent, newLeaf);
-        }
-
-        void accept(Visitor& visitor) const override {
-            visitor.visit(this);
-        }
-
-        void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-            for (size_t i = 0; i < level; ++i)
-                str << indent;
-
-            str << "L ";
-            this->appendBounds(str);
-            str << ": " << m_data << std::endl;
-        }
-
-        virtual void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-            assert(this->m_parent == expectedParent);
-        }
+    struct BuildItem {
+        Box bounds;
+        vm::vec<T,S> center;
+        U data;
+        size_t bin;
     };
-private:
-    Node* m_root;
-    std::unordered_map<U, LeafNode*> m_leafForData;
-public:
-    AABBTree() : m_root(nullptr) {}
 
-    ~AABBTree() {
-        clear();
-    }
+    std::vector<Node> m_nodes;
+    std::vector<size_t> m_freeNodes;
+    size_t m_root;
+    std::unordered_map<U, size_t> m_leafForData;
+public:
+    AABBTree() : m_root(NoNode) {}
 
     /**
      * Indicates whether a node with the given data exists in this tree.
@@ -474,16 +111,37 @@ public:
     }
 
     /**
-     * Clears this tree and rebuilds it by inserting given objects.
+     * Clears this tree and rebuilds it from the given objects. The tree is built top down, and every inner node
+     * splits its objects such that the expected cost of intersecting the tree is minimized according to the surface
+     * area heuristic.
      *
      * @param objects the objects to insert, a list of DataType
      * @param getBounds a function from DataType -> Box to compute the bounds of each object
+     *
+     * @throws NodeTreeException if the given objects contain duplicates or the bounds of an object contains NaN
      */
     template <typename DataList, typename GetBounds>
     void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
         clear();
+
+        std::vector<BuildItem> items;
         for (const U& object : objects) {
-            insert(getBounds(object), object);
+            const Box bounds = getBounds(object);
+            check(bounds);
+            items.push_back(BuildItem{ bounds, bounds.center(), object, 0 });
+        }
+
+        if (items.empty()) {
+            return;
+        }
+
+        m_nodes.reserve(2 * items.size() - 1);
+        m_leafForData.reserve(items.size());
+        try {
+            m_root = build(std::begin(items), std::end(items), NoNode);
+        } catch (...) {
+            clear();
+            throw;
         }
     }
 
@@ -503,16 +161,34 @@ public:
             throw NodeTreeException("Data already in tree");
         }
 
+        const auto newLeaf = createNode(bounds, NoNode, NoNode, 1, data);
+        m_leafForData[data] = newLeaf;
+
         if (empty()) {
-            auto* insertedLeafNode = new LeafNode(bounds, data);
+            m_root = newLeaf;
+            return;
+        }
 
-            m_root = insertedLeafNode;
-            m_leafForData[data] = insertedLeafNode;
-        } else {
-            LeafNode* insertedLeafNode;
-            std::tie(m_root, insertedLeafNode) = m_root->insert(bounds, data);
+        // Descend into the subtree which is increased the least by inserting a node with the given bounds.
+        auto sibling = m_root;
+        while (!m_nodes[sibling].leaf()) {
+            const auto& node = m_nodes[sibling];
+            sibling = selectLeastIncreaser(node.left, node.right, bounds) ? node.left : node.right;
+        }
+
+        // Replace the leaf we found by a new inner node which has that leaf as its left child and the new leaf as its
+        // right child.
+        const auto oldParent = m_nodes[sibling].parent;
+        const auto newParent = createNode(merge(m_nodes[sibling].bounds, bounds), oldParent, sibling, 2, U());
+        m_nodes[newParent].right = newLeaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[newLeaf].parent = newParent;
 
-            m_leafForData[data] = insertedLeafNode;
+        if (oldParent == NoNode) {
+            m_root = newParent;
+        } else {
+            replaceChild(oldParent, sibling, newParent);
+            updateAncestors(oldParent);
         }
     }
 
@@ -528,11 +204,30 @@ public:
             return false;
         }
 
-        LeafNode* leaf = it->second;
-        assert(leaf->data() == data);
+        const auto leaf = it->second;
+        assert(m_nodes[leaf].data == data);
         m_leafForData.erase(it);
 
-        m_root = leaf->deleteThis();
+        const auto parent = m_nodes[leaf].parent;
+        freeNode(leaf);
+
+        if (parent == NoNode) {
+            m_root = NoNode;
+            return true;
+        }
+
+        // The sibling of the removed leaf takes the place of its parent.
+        const auto sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+        const auto grandParent = m_nodes[parent].parent;
+        freeNode(parent);
+
+        m_nodes[sibling].parent = grandParent;
+        if (grandParent == NoNode) {
+            m_root = sibling;
+        } else {
+            replaceChild(grandParent, parent, sibling);
+            updateAncestors(grandParent);
+        }
 
         return true;
     }
@@ -564,10 +259,10 @@ public:
      * Clears this node tree.
      */
     void clear() {
-        if (!empty()) {
-            delete m_root;
-            m_root = nullptr;
-        }
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_leafForData.clear();
+        m_root = NoNode;
     }
 
     /**
@@ -576,7 +271,7 @@ public:
      * @return true if this tree is empty and false otherwise
      */
     bool empty() const {
-        return m_root == nullptr;
+        return m_root == NoNode;
     }
 
     /**
@@ -591,7 +286,7 @@ public:
         if (empty()) {
             return EmptyBox;
         } else {
-            return m_root->bounds();
+            return m_nodes[m_root].bounds;
         }
     }
 
@@ -601,7 +296,7 @@ public:
      * @return the height of this tree
      */
     size_t height() const {
-        return empty() ? 0 : m_root->height();
+        return empty() ? 0 : m_nodes[m_root].height;
     }
 
     /**
@@ -626,21 +321,87 @@ public:
      */
     template <typename O>
     void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-        if (!empty()) {
-            LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
-                            ++out;
-                        }
-                    }
-            );
-            m_root->accept(visitor);
-        }
+        visitNodes(
+            [&](const Node& node) {
+                return node.bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, node.bounds));
+            },
+            [&](const Node& leaf) {
+                out = leaf.data;
+                ++out;
+            });
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given bounding box and returns a list
+     * of those items.
+     *
+     * @param bounds the bounding box to test
+     * @return a list containing all found data items
+     */
+    List findIntersectors(const Box& bounds) const {
+        List result;
+        findIntersectors(bounds, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given bounding box and appends it to
+     * the given output iterator.
+     *
+     * @tparam O the output iterator type
+     * @param bounds the bounding box to test
+     * @param out the output iterator to append to
+     */
+    template <typename O>
+    void findIntersectors(const Box& bounds, O out) const {
+        visitNodes(
+            [&](const Node& node) {
+                return node.bounds.intersects(bounds);
+            },
+            [&](const Node& leaf) {
+                out = leaf.data;
+                ++out;
+            });
+    }
+
+    /**
+     * Calls the given visitor for every data item in this tree whose bounding box intersects with the given ray. The
+     * subtrees of each node are visited in the order in which the ray enters their bounding boxes, so the data items
+     * are visited roughly from front to back.
+     *
+     * @tparam F the type of the visitor, must be callable with a const U&
+     * @param ray the ray to test
+     * @param visitor the visitor to call
+     */
+    template <typename F>
+    void visitIntersectors(const vm::ray<T,S>& ray, F&& visitor) const {
+        traverseFrontToBack(ray, [&](const U& data) {
+            visitor(data);
+            return vm::nan<T>();
+        });
+    }
+
+    /**
+     * Finds the closest intersection of the given ray with the data items in this tree. The given function is called
+     * for data items whose bounding boxes intersect with the ray and returns the distance from the ray origin to the
+     * point where the ray intersects with the data item, or NaN if it does not intersect with it.
+     *
+     * The subtrees of each node are visited front to back, and subtrees whose bounding boxes are entered by the ray
+     * beyond the closest intersection found so far are skipped.
+     *
+     * @tparam F the type of the function, must be callable with a const U& and return T
+     * @param ray the ray to test
+     * @param intersect the function to compute the distance of an intersection with a data item
+     * @return the distance of the closest intersection, or NaN if the ray does not intersect with any data item
+     */
+    template <typename F>
+    T findNearestIntersection(const vm::ray<T,S>& ray, F&& intersect) const {
+        auto closestDistance = vm::nan<T>();
+        traverseFrontToBack(ray, [&](const U& data) {
+            closestDistance = vm::safe_min(closestDistance, static_cast<T>(intersect(data)));
+            return closestDistance;
+        });
+        return closestDistance;
     }
 
     /**
@@ -665,20 +426,14 @@ public:
      */
     template <typename O>
     void findContainers(const vm::vec<T,S>& point, O out) const {
-        if (!empty()) {
-            LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
-                            ++out;
-                        }
-                    }
-            );
-            m_root->accept(visitor);
-        }
+        visitNodes(
+            [&](const Node& node) {
+                return node.bounds.contains(point);
+            },
+            [&](const Node& leaf) {
+                out = leaf.data;
+                ++out;
+            });
     }
 
     /**
@@ -688,9 +443,220 @@ public:
      */
     void print(std::ostream& str = std::cout) const {
         if (!empty()) {
-            m_root->appendTo(str);
+            appendTo(str, m_root, "  ", 0);
+        }
+    }
+private:
+    /**
+     * Visits the leafs intersected by the given ray front to back. The given function is called with the data of each
+     * leaf and returns a distance limit; subtrees which the ray enters beyond the smallest limit returned so far are
+     * skipped. The function can return NaN to indicate that there is no limit.
+     */
+    template <typename F>
+    void traverseFrontToBack(const vm::ray<T,S>& ray, F&& visitLeaf) const {
+        if (empty()) {
+            return;
+        }
+
+        const auto rootDistance = BVHUtils::entryDistance(ray, m_nodes[m_root].bounds);
+        if (vm::is_nan(rootDistance)) {
+            return;
+        }
+
+        auto limit = vm::nan<T>();
+        BVHUtils::TraversalStack<std::pair<size_t, T>> stack;
+        stack.push({ m_root, rootDistance });
+
+        while (!stack.empty()) {
+            const auto [index, distance] = stack.pop();
+            if (!vm::is_nan(limit) && distance > limit) {
+                continue;
+            }
+
+            const auto& node = m_nodes[index];
+            if (node.leaf()) {
+                limit = vm::safe_min(limit, visitLeaf(node.data));
+            } else {
+                const auto leftDistance = BVHUtils::entryDistance(ray, m_nodes[node.left].bounds);
+                const auto rightDistance = BVHUtils::entryDistance(ray, m_nodes[node.right].bounds);
+                BVHUtils::pushChildrenFrontToBack(stack, node.left, leftDistance, node.right, rightDistance);
+            }
+        }
+    }
+
+    /**
+     * Visits the nodes of this tree in depth first order, left child first. The children of an inner node are only
+     * visited if the given predicate returns true for it, and the given leaf visitor is only called for leafs for
+     * which the given predicate returns true.
+     */
+    template <typename P, typename L>
+    void visitNodes(const P& predicate, const L& leafVisitor) const {
+        if (empty()) {
+            return;
+        }
+
+        BVHUtils::TraversalStack<size_t> stack;
+        stack.push(m_root);
+        while (!stack.empty()) {
+            const auto& node = m_nodes[stack.pop()];
+            if (predicate(node)) {
+                if (node.leaf()) {
+                    leafVisitor(node);
+                } else {
+                    stack.push(node.right);
+                    stack.push(node.left);
+                }
+            }
         }
     }
+
+    size_t createNode(const Box& bounds, const size_t parent, const size_t left, const size_t height, const U& data) {
+        auto node = Node{ bounds, parent, left, NoNode, height, data };
+        if (!m_freeNodes.empty()) {
+            const auto index = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[index] = std::move(node);
+            return index;
+        } else {
+            m_nodes.push_back(std::move(node));
+            return m_nodes.size() - 1;
+        }
+    }
+
+    void freeNode(const size_t index) {
+        m_freeNodes.push_back(index);
+    }
+
+    void replaceChild(const size_t parent, const size_t child, const size_t replacement) {
+        auto& node = m_nodes[parent];
+        if (node.left == child) {
+            node.left = replacement;
+        } else {
+            assert(node.right == child);
+            node.right = replacement;
+        }
+    }
+
+    /**
+     * Updates the height and bounds of the given inner node and all of its ancestors.
+     */
+    void updateAncestors(size_t index) {
+        while (index != NoNode) {
+            auto& node = m_nodes[index];
+            const auto& left = m_nodes[node.left];
+            const auto& right = m_nodes[node.right];
+            node.height = std::max(left.height, right.height) + 1;
+            node.bounds = merge(left.bounds, right.bounds);
+            index = node.parent;
+        }
+    }
+
+    /**
+     * Selects one of the two given nodes such that it increases the given bounds the least.
+     *
+     * @param node1 the first node to test
+     * @param node2 the second node to test
+     * @param bounds the bounds to test against
+     * @return true if node1 increases the given bounds volume by a smaller or equal amount than node2 would, and
+     *     false otherwise
+     */
+    bool selectLeastIncreaser(const size_t index1, const size_t index2, const Box& bounds) const {
+        const auto& node1 = m_nodes[index1];
+        const auto& node2 = m_nodes[index2];
+
+        const auto node1Contains = node1.bounds.contains(bounds);
+        const auto node2Contains = node2.bounds.contains(bounds);
+
+        if (node1Contains && !node2Contains) {
+            return true;
+        } else if (!node1Contains && node2Contains) {
+            return false;
+        } else if (!node1Contains && !node2Contains) {
+            const auto new1 = vm::merge(node1.bounds, bounds);
+            const auto new2 = vm::merge(node2.bounds, bounds);
+            const auto vol1 = node1.bounds.volume();
+            const auto vol2 = node2.bounds.volume();
+            const auto diff1 = new1.volume() - vol1;
+            const auto diff2 = new2.volume() - vol2;
+
+            if (diff1 < diff2) {
+                return true;
+            } else if (diff2 < diff1) {
+                return false;
+            }
+        }
+
+        static auto choice = 0u;
+
+        if (node1.height < node2.height) {
+            return true;
+        } else if (node2.height < node1.height) {
+            return false;
+        } else {
+            return choice++ % 2 == 0;
+        }
+    }
+
+    using BuildIterator = typename std::vector<BuildItem>::iterator;
+
+    /**
+     * Builds the subtree containing the given items and returns the index of its root. The root of the subtree is
+     * created before its children so that the nodes are laid out in depth first order.
+     */
+    size_t build(BuildIterator begin, BuildIterator end, const size_t parent) {
+        assert(begin != end);
+
+        if (std::next(begin) == end) {
+            if (m_leafForData.count(begin->data) > 0u) {
+                throw NodeTreeException("Data already in tree");
+            }
+
+            const auto leaf = createNode(begin->bounds, parent, NoNode, 1, begin->data);
+            m_leafForData[begin->data] = leaf;
+            return leaf;
+        }
+
+        const auto index = createNode(Box(), parent, NoNode, 0, U());
+        const auto [mid, bounds] = BVHUtils::splitBySurfaceArea<T,S>(begin, end);
+
+        const auto left = build(begin, mid, index);
+        const auto right = build(mid, end, index);
+
+        auto& node = m_nodes[index];
+        node.bounds = bounds;
+        node.left = left;
+        node.right = right;
+        node.height = std::max(m_nodes[left].height, m_nodes[right].height) + 1;
+        return index;
+    }
+
+    /**
+     * Appends a textual representation of the subtree rooted at the given node to the given output stream using the
+     * given indent string and the given level of indentation.
+     */
+    void appendTo(std::ostream& str, const size_t index, const std::string& indent, const size_t level) const {
+        const auto& node = m_nodes[index];
+        for (size_t i = 0; i < level; ++i) {
+            str << indent;
+        }
+
+        if (node.leaf()) {
+            str << "L ";
+            appendBounds(str, node.bounds);
+            str << ": " << node.data << std::endl;
+        } else {
+            str << "O ";
+            appendBounds(str, node.bounds);
+            str << std::endl;
+
+            appendTo(str, node.left, indent, level + 1);
+            appendTo(str, node.right, indent, level + 1);
+        }
+    }
+
+    static void appendBounds(std::ostream& str, const Box& bounds) {
+        str << "[ ( " << bounds.min << " ) ( " << bounds.max  << " ) ]";
+    }
 };
 
 #endif //TRENCHBROOM_AABBTREE_H
@@ -21,178 +21,181 @@
 #define TrenchBroom_Allocator_h
 
 #include <cassert>
-#include <stack>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
-template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
+/**
+ * Replaces the global operator new and operator delete for subclasses of T. Memory is taken from chunks of blocks
+ * which are handed out to threads in batches, so that objects created by a thread are mostly contiguous in memory.
+ *
+ * Every thread keeps its own list of free blocks, so allocating and deallocating does not require any
+ * synchronization unless a thread runs out of free blocks or has too many of them. A thread that runs out takes a
+ * batch of free blocks from the arena, or a new chunk if the arena has no free blocks. A block can be deallocated on a
+ * different thread than the one that allocated it; it is then added to the free list of the deallocating thread. Once
+ * a thread holds more than two chunks' worth of free blocks, it returns one chunk's worth to the arena, and a thread
+ * that exits returns all of its free blocks.
+ *
+ * Chunks are never released, but since free blocks are returned to the arena and reused before new chunks are
+ * created, the number of chunks is bounded by the peak number of live objects plus at most two chunks per thread.
+ */
+template <class T, size_t BlocksPerChunk = 256>
 class Allocator {
 private:
-    class Chunk {
+    union Block {
+        Block* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static_assert(BlocksPerChunk > 0, "chunks must contain at least one block");
+
+    /**
+     * A list of free blocks linked by their next pointers.
+     */
+    struct Batch {
+        Block* first;
+        size_t count;
+    };
+
+    /**
+     * Owns all chunks and the batches of free blocks which were returned by the threads.
+     */
+    class Arena {
     private:
-        unsigned char m_blocks[BlocksPerChunk * sizeof(T)];
-        unsigned char m_firstFreeBlock;
-        unsigned char m_numFreeBlocks;
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<Block[]>> m_chunks;
+        std::vector<Batch> m_batches;
     public:
-        Chunk() :
-        m_firstFreeBlock(0),
-        m_numFreeBlocks(BlocksPerChunk - 1) {
-            for (size_t i = 0; i < BlocksPerChunk - 1; i++)
-                m_blocks[i * sizeof(T)] = static_cast<unsigned char>(i + 1);
-        }
+        /**
+         * Returns a non-empty batch of free blocks.
+         */
+        Batch acquire() {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_batches.empty()) {
+                const Batch result = m_batches.back();
+                m_batches.pop_back();
+                return result;
+            }
+
+            auto chunk = std::make_unique<Block[]>(BlocksPerChunk);
+            for (size_t i = 0; i < BlocksPerChunk - 1; ++i) {
+                chunk[i].next = &chunk[i + 1];
+            }
+            chunk[BlocksPerChunk - 1].next = nullptr;
 
-        bool contains(const T* t) const {
-            const unsigned char* block = reinterpret_cast<const unsigned char*>(t);
-            if (block < m_blocks)
-                return false;
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            return offset < (BlocksPerChunk - 1) * sizeof(T);
+            const Batch result{ chunk.get(), BlocksPerChunk };
+            m_chunks.push_back(std::move(chunk));
+            return result;
         }
 
-        T* allocate() {
-            if (m_numFreeBlocks == 0)
-                return nullptr;
+        /**
+         * Takes ownership of the given non-empty batch of free blocks.
+         */
+        void release(const Batch& batch) {
+            assert(batch.first != nullptr && batch.count > 0);
 
-            unsigned char* block = m_blocks + m_firstFreeBlock * sizeof(T);
-            m_firstFreeBlock = *block;
-            m_numFreeBlocks--;
-            return reinterpret_cast<T*>(block);
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_batches.push_back(batch);
         }
 
-        void deallocate(T* t) {
-            assert(m_numFreeBlocks < BlocksPerChunk - 1);
-            assert(contains(t));
+        size_t chunkCount() {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            return m_chunks.size();
+        }
+    };
 
-            unsigned char* block = reinterpret_cast<unsigned char*>(t);
-            assert(block >= m_blocks);
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            assert(offset % sizeof(T) == 0);
+    class ThreadCache {
+    private:
+        Block* m_freeList;
+        size_t m_freeCount;
+    public:
+        ThreadCache() :
+        m_freeList(nullptr),
+        m_freeCount(0) {}
+
+        ~ThreadCache() {
+            if (m_freeList != nullptr) {
+                arena().release(Batch{ m_freeList, m_freeCount });
+                m_freeList = nullptr;
+                m_freeCount = 0;
+            }
+        }
 
-            size_t index = offset / sizeof(T);
-            assert(index < BlocksPerChunk);
+        void* allocate() {
+            if (m_freeList == nullptr) {
+                const Batch batch = arena().acquire();
+                m_freeList = batch.first;
+                m_freeCount = batch.count;
+            }
 
-            *block = m_firstFreeBlock;
-            m_firstFreeBlock = static_cast<unsigned char>(index);
-            m_numFreeBlocks++;
+            Block* block = m_freeList;
+            m_freeList = block->next;
+            --m_freeCount;
+            return block;
         }
 
-        bool empty() const {
-            return m_numFreeBlocks == BlocksPerChunk - 1;
+        void deallocate(void* p) {
+            Block* block = static_cast<Block*>(p);
+            block->next = m_freeList;
+            m_freeList = block;
+            ++m_freeCount;
+
+            if (m_freeCount > 2 * BlocksPerChunk) {
+                releaseBatch();
+            }
         }
+    private:
+        /**
+         * Returns one chunk's worth of free blocks to the arena. Called once for every BlocksPerChunk deallocations
+         * at most, so the cost of finding the end of the batch is amortized.
+         */
+        void releaseBatch() {
+            Block* last = m_freeList;
+            for (size_t i = 0; i < BlocksPerChunk - 1; ++i) {
+                last = last->next;
+            }
 
-        bool full() const {
-            return m_numFreeBlocks == 0;
+            const Batch batch{ m_freeList, BlocksPerChunk };
+            m_freeList = last->next;
+            m_freeCount -= BlocksPerChunk;
+
+            last->next = nullptr;
+            arena().release(batch);
         }
     };
 
-    using ChunkList = std::vector<Chunk*>;
-    using Pool = std::stack<T*>;
-
-    static Pool& pool() {
-        static Pool p;
-        return p;
+    static Arena& arena() {
+        // The arena is intentionally leaked so that objects which are destroyed during static destruction can still
+        // be deallocated.
+        static Arena* a = new Arena();
+        return *a;
     }
 
-    static ChunkList& fullChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static ThreadCache& threadCache() {
+        thread_local ThreadCache cache;
+        return cache;
     }
-
-    static ChunkList& mixedChunks() {
-        static ChunkList chunks;
-        return chunks;
+public:
+    /**
+     * Returns the number of chunks that were allocated for subclasses of T.
+     */
+    static size_t chunkCount() {
+        return arena().chunkCount();
     }
 
-    static ChunkList emptyChunks() {
-        static ChunkList chunks;
-        return chunks;
-    }
-public:
 #ifdef TB_ENABLE_ALLOCATOR
     void* operator new([[maybe_unused]] size_t size) {
         assert(size == sizeof(T));
-
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
-        }
-
-        Chunk* chunk = nullptr;
-        if (mixedChunks().empty()) {
-            if (!emptyChunks().empty()) {
-                chunk = emptyChunks().back();
-                emptyChunks().pop_back();
-            } else {
-                chunk = new Chunk();
-            }
-        } else {
-            chunk = mixedChunks().back();
-            mixedChunks().pop_back();
-        }
-
-        assert(!chunk->full());
-        T* block = chunk->allocate();
-
-        if (chunk->full()) {
-            fullChunks().push_back(chunk);
-        } else {
-            mixedChunks().push_back(chunk);
-        }
-        return block;
+        return threadCache().allocate();
     }
 
     void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-
-        typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
-        fullIt = fullChunks().rbegin();
-        fullEnd = fullChunks().rend();
-        mixedIt = mixedChunks().rbegin();
-        mixedEnd = mixedChunks().rend();
-
-        Chunk* chunk = nullptr;
-        while (fullIt < fullEnd || mixedIt < mixedEnd) {
-            if (fullIt < fullEnd) {
-                Chunk* fullChunk = *fullIt;
-                if (fullChunk->contains(t)) {
-                    chunk = fullChunk;
-                    break;
-                }
-                ++fullIt;
-            }
-            if (mixedIt < mixedEnd) {
-                Chunk* mixedChunk = *mixedIt;
-                if (mixedChunk->contains(t)) {
-                    chunk = mixedChunk;
-                    break;
-                }
-                ++mixedIt;
-            }
-        }
-
-        assert(chunk != nullptr);
-
-        if (chunk->full()) {
-            fullChunks().erase((fullIt + 1).base());
-            mixedChunks().push_back(chunk);
-        }
-
-        chunk->deallocate(t);
-
-        if (chunk->empty()) {
-            mixedChunks().erase((mixedIt + 1).base());
-            if (emptyChunks().size() < 2)
-                emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+        if (block != nullptr) {
+            threadCache().deallocate(block);
         }
     }
 #endif
@@ -19,7 +19,8 @@
 
 #include "EntityModel.h"
 
-#include "AABBTree.h"
+#include "Exceptions.h"
+#include "TriangleBVH.h"
 #include "Assets/TextureCollection.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/PrimType.h"
@@ -51,7 +52,8 @@ namespace TrenchBroom {
         EntityModelFrame(index),
         m_name(name),
         m_bounds(bounds),
-        m_spacialTree(std::make_unique<SpacialTree>()) {}
+        m_spacialTree(std::make_unique<SpacialTree>()),
+        m_spacialTreeValid(true) {}
 
         EntityModelLoadedFrame::~EntityModelLoadedFrame() = default;
 
@@ -68,17 +70,11 @@ namespace TrenchBroom {
         }
 
         float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const {
-            auto closestDistance = vm::nan<float>();
-
-            const auto candidates = m_spacialTree->findIntersectors(ray);
-            for (const TriNum triNum : candidates) {
-                const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
-                const vm::vec3f& p2 = m_tris[triNum * 3 + 1];
-                const vm::vec3f& p3 = m_tris[triNum * 3 + 2];
-                closestDistance = vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
+            if (!m_spacialTreeValid) {
+                m_spacialTree->clearAndBuild(m_tris);
+                m_spacialTreeValid = true;
             }
-
-            return closestDistance;
+            return m_spacialTree->findNearestIntersection(ray, m_tris);
         }
 
         void EntityModelLoadedFrame::addToSpacialTree(const std::vector<EntityModelVertex>& vertices, const Renderer::PrimType primType, const size_t index, const size_t count) {
@@ -92,19 +88,13 @@ namespace TrenchBroom {
                     assert(count % 3 == 0);
                     m_tris.reserve(m_tris.size() + count);
                     for (size_t i = 0; i < count; i += 3) {
-                        vm::bbox3f::builder bounds;
                         const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
 
-                        const size_t triIndex = m_tris.size() / 3u;
                         m_tris.push_back(p1);
                         m_tris.push_back(p2);
                         m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
@@ -115,18 +105,12 @@ namespace TrenchBroom {
 
                     const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
                     for (size_t i = 1; i < count - 1; ++i) {
-                        vm::bbox3f::builder bounds;
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p2);
 
-                        const size_t triIndex = m_tris.size() / 3u;
                         m_tris.push_back(p1);
                         m_tris.push_back(p2);
                         m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
@@ -136,15 +120,10 @@ namespace TrenchBroom {
                     assert(count > 2);
                     m_tris.reserve(m_tris.size() + (count - 2) * 3);
                     for (size_t i = 0; i < count-2; ++i) {
-                        vm::bbox3f::builder bounds;
                         const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p2);
 
-                        const size_t triIndex = m_tris.size() / 3u;
                         if (i % 2 == 0) {
                             m_tris.push_back(p1);
                             m_tris.push_back(p2);
@@ -154,12 +133,12 @@ namespace TrenchBroom {
                             m_tris.push_back(p3);
                             m_tris.push_back(p2);
                         }
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
                 switchDefault();
             }
+            m_spacialTreeValid = false;
         }
 
         // EntityModel::UnloadedFrame
@@ -31,8 +31,8 @@
 #include <string>
 #include <vector>
 
-template <typename T, size_t S, typename U>
-class AABBTree;
+template <typename T>
+class TriangleBVH;
 
 namespace TrenchBroom {
     namespace Assets {
@@ -99,11 +99,12 @@ namespace TrenchBroom {
             std::string m_name;
             vm::bbox3f m_bounds;
 
-            // For hit testing
-            std::vector<vm::vec3f> m_tris;
-            using TriNum = size_t;
-            using SpacialTree = AABBTree<float, 3, TriNum>;
+            // For hit testing; the spacial tree is built lazily on the first query after triangles were added, and
+            // building it reorders the triangles
+            mutable std::vector<vm::vec3f> m_tris;
+            using SpacialTree = TriangleBVH<float>;
             std::unique_ptr<SpacialTree> m_spacialTree;
+            mutable bool m_spacialTreeValid;
         public:
             /**
              * Creates a new frame with the given index, name and bounds.
@@ -122,7 +123,8 @@ namespace TrenchBroom {
             float intersect(const vm::ray3f& ray) const override;
 
             /**
-             * Adds the given primitives to the spacial tree for this frame.
+             * Adds the given primitives to the spacial tree for this frame. The spacial tree is rebuilt when this
+             * frame is intersected with a ray for the next time.
              *
              * @param vertices the vertices
              * @param primType the primitive type
@@ -24,6 +24,7 @@
 #include "Macros.h"
 #include "Assets/EntityModel.h"
 #include "Assets/ModelDefinition.h"
+#include "IO/AsyncEntityModelLoader.h"
 #include "IO/EntityModelLoader.h"
 #include "Model/Entity.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
@@ -33,6 +34,8 @@ namespace TrenchBroom {
         EntityModelManager::EntityModelManager(const int magFilter, const int minFilter, Logger& logger) :
         m_logger(logger),
         m_loader(nullptr),
+        m_asyncLoader(std::make_unique<IO::AsyncEntityModelLoader>()),
+        m_loadInBackground(false),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
         m_resetTextureMode(false) {}
@@ -42,6 +45,9 @@ namespace TrenchBroom {
         }
 
         void EntityModelManager::clear() {
+            // wait for running jobs because they may still use the current loader
+            m_asyncLoader->cancel();
+
             m_renderers.clear();
             m_models.clear();
             m_rendererMismatches.clear();
@@ -64,8 +70,42 @@ namespace TrenchBroom {
             m_loader = loader;
         }
 
+        void EntityModelManager::setLoadInBackground(const bool loadInBackground) {
+            m_loadInBackground = loadInBackground;
+        }
+
+        std::vector<IO::Path> EntityModelManager::applyLoadedModels() {
+            auto results = m_asyncLoader->takeResults();
+
+            std::vector<IO::Path> paths;
+            paths.reserve(results.size());
+
+            for (auto& result : results) {
+                paths.push_back(result.path);
+
+                for (const auto& message : result.messages) {
+                    m_logger.log(message.level, message.message);
+                }
+
+                if (result.model != nullptr) {
+                    auto* model = result.model.get();
+                    if (m_models.insert({ result.path, std::move(result.model) }).second) {
+                        m_unpreparedModels.push_back(model);
+                        m_logger.debug() << "Loaded entity model " << result.path;
+                    }
+                } else {
+                    m_modelMismatches.insert(result.path);
+                }
+            }
+            return paths;
+        }
+
+        bool EntityModelManager::hasPendingModels() const {
+            return !m_asyncLoader->idle();
+        }
+
         Renderer::TexturedRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
-            auto* entityModel = safeGetModel(spec.path);
+            auto* entityModel = safeGetModel(spec);
 
             if (entityModel == nullptr) {
                 return nullptr;
@@ -80,6 +120,11 @@ namespace TrenchBroom {
                 return nullptr;
             }
 
+            const auto* frame = entityModel->frame(spec.frameIndex);
+            if (frame != nullptr && !frame->loaded()) {
+                loadFrame(spec, *entityModel);
+            }
+
             auto renderer = entityModel->buildRenderer(spec.skinIndex, spec.frameIndex);
             if (renderer != nullptr) {
                 const auto [pos, success] = m_renderers.insert({ spec, std::move(renderer) });
@@ -97,7 +142,7 @@ namespace TrenchBroom {
         }
 
         const EntityModelFrame* EntityModelManager::frame(const Assets::ModelSpecification& spec) const {
-            auto* model = this->safeGetModel(spec.path);
+            auto* model = this->safeGetModel(spec);
             if (model == nullptr) {
                 return nullptr;
             } else if (spec.frameIndex >= model->frameCount()) {
@@ -118,7 +163,8 @@ namespace TrenchBroom {
             return renderer(spec) != nullptr;
         }
 
-        EntityModel* EntityModelManager::model(const IO::Path& path) const {
+        EntityModel* EntityModelManager::model(const Assets::ModelSpecification& spec) const {
+            const auto& path = spec.path;
             if (path.isEmpty()) {
                 return nullptr;
             }
@@ -132,6 +178,14 @@ namespace TrenchBroom {
                 return nullptr;
             }
 
+            if (m_loadInBackground) {
+                ensure(m_loader != nullptr, "loader is null");
+                if (m_asyncLoader->load(path, spec.frameIndex, *m_loader)) {
+                    m_logger.debug() << "Loading entity model " << path << " in the background";
+                }
+                return nullptr;
+            }
+
             try {
                 const auto [pos, success] = m_models.insert({ path, loadModel(path) });
                 assert(success); unused(success);
@@ -149,9 +203,9 @@ namespace TrenchBroom {
             }
         }
 
-        EntityModel* EntityModelManager::safeGetModel(const IO::Path& path) const {
+        EntityModel* EntityModelManager::safeGetModel(const Assets::ModelSpecification& spec) const {
             try {
-                return model(path);
+                return model(spec);
             } catch (const GameException&) {
                 return nullptr;
             }
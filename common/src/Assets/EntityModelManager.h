@@ -49,6 +49,13 @@ namespace TrenchBroom {
             Logger& m_logger;
             const IO::EntityModelLoader* m_loader;
 
+            /**
+             * Loads models in the background if m_loadInBackground is set. Loaded models are moved into m_models by
+             * applyLoadedModels.
+             */
+            std::unique_ptr<IO::AsyncEntityModelLoader> m_asyncLoader;
+            bool m_loadInBackground;
+
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
@@ -68,6 +75,26 @@ namespace TrenchBroom {
 
             void setTextureMode(int minFilter, int magFilter);
             void setLoader(const IO::EntityModelLoader* loader);
+
+            /**
+             * If enabled, models are loaded in the background. Until a model has been loaded, renderer and frame
+             * return nullptr for it, and entities using the model are rendered as boxes. Frames of models which have
+             * already been loaded are still loaded on demand.
+             */
+            void setLoadInBackground(bool loadInBackground);
+
+            /**
+             * Adds the models which have been loaded in the background since the last call to this function.
+             *
+             * @return the paths of the models which were loaded or failed to load
+             */
+            std::vector<IO::Path> applyLoadedModels();
+
+            /**
+             * Indicates whether there are models which are still being loaded in the background or which have not
+             * been added by applyLoadedModels yet.
+             */
+            bool hasPendingModels() const;
             Renderer::TexturedRenderer* renderer(const Assets::ModelSpecification& spec) const;
 
             const EntityModelFrame* frame(const Assets::ModelSpecification& spec) const;
@@ -75,8 +102,8 @@ namespace TrenchBroom {
             bool hasModel(const Model::Entity* entity) const;
             bool hasModel(const Assets::ModelSpecification& spec) const;
         private:
-            EntityModel* model(const IO::Path& path) const;
-            EntityModel* safeGetModel(const IO::Path& path) const;
+            EntityModel* model(const Assets::ModelSpecification& spec) const;
+            EntityModel* safeGetModel(const Assets::ModelSpecification& spec) const;
             std::unique_ptr<EntityModel> loadModel(const IO::Path& path) const;
             void loadFrame(const Assets::ModelSpecification& spec, Assets::EntityModel& model) const;
         public:
@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Exceptions.h"
+#include "IO/BinaryData.h"
 #include "IO/File.h"
 #include "IO/Reader.h"
 #include "IO/FileSystem.h"
@@ -28,11 +29,118 @@
 
 #include <kdl/string_format.h>
 
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TB_PALETTE_AVX2
+#endif
+
 namespace TrenchBroom {
     namespace Assets {
         Palette::Data::Data(std::vector<unsigned char>&& data) :
         m_data(std::move(data)) {
             ensure(!m_data.empty(), "palette is empty");
+
+            for (size_t i = 0; i < m_opaqueRgba.size(); ++i) {
+                unsigned char rgba[4] = { 0x00, 0x00, 0x00, 0xFF };
+                for (size_t j = 0; j < 3; ++j) {
+                    if (i * 3 + j < m_data.size()) {
+                        rgba[j] = m_data[i * 3 + j];
+                    }
+                }
+                std::memcpy(&m_opaqueRgba[i], rgba, 4);
+
+                rgba[3] = (i == 255) ? 0x00 : 0xFF;
+                std::memcpy(&m_maskedRgba[i], rgba, 4);
+            }
+        }
+
+        bool Palette::Data::indexedToRgba(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
+            const auto& table = (transparency == PaletteTransparency::Index255Transparent) ? m_maskedRgba : m_opaqueRgba;
+
+            lookupRgba(table, indexedImage, pixelCount, rgbaImage);
+
+            // Count how often each index occurs and compute the average color from the counts. Using several
+            // histograms avoids stalls on runs of equal indices, which are very common in textures.
+            size_t histograms[4][256] = {};
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4) {
+                ++histograms[0][indexedImage[i + 0]];
+                ++histograms[1][indexedImage[i + 1]];
+                ++histograms[2][indexedImage[i + 2]];
+                ++histograms[3][indexedImage[i + 3]];
+            }
+            for (; i < pixelCount; ++i) {
+                ++histograms[0][indexedImage[i]];
+            }
+
+            double avg[3] = { 0.0, 0.0, 0.0 };
+            size_t transparentCount = 0;
+            for (size_t index = 0; index < 256; ++index) {
+                const auto count = histograms[0][index] + histograms[1][index] + histograms[2][index] + histograms[3][index];
+                if (count > 0) {
+                    unsigned char rgba[4];
+                    std::memcpy(rgba, &table[index], 4);
+                    for (size_t j = 0; j < 3; ++j) {
+                        avg[j] += static_cast<double>(count) * static_cast<double>(rgba[j]);
+                    }
+                    if (index == 255) {
+                        transparentCount = count;
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                averageColor[j] = static_cast<float>(avg[j] / static_cast<double>(pixelCount) / static_cast<double>(0xFF));
+            }
+            averageColor[3] = 1.0f;
+
+            return transparency == PaletteTransparency::Index255Transparent && transparentCount > 0;
+        }
+
+        uint64_t Palette::Data::hash() const {
+            const auto* begin = reinterpret_cast<const char*>(m_data.data());
+            return IO::BinaryData::hash(begin, begin + m_data.size());
+        }
+
+        void Palette::lookupRgba(const RgbaTable& table, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage) {
+#if defined(TB_PALETTE_AVX2)
+            const auto* tableData = reinterpret_cast<const int*>(table.data());
+            size_t i = 0;
+            for (; i + 8 <= pixelCount; i += 8) {
+                const auto indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indexedImage + i)));
+                const auto pixels = _mm256_i32gather_epi32(tableData, indices, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgbaImage + i * 4), pixels);
+            }
+            lookupRgbaScalar(table, indexedImage + i, pixelCount - i, rgbaImage + i * 4);
+#else
+            lookupRgbaScalar(table, indexedImage, pixelCount, rgbaImage);
+#endif
+        }
+
+        void Palette::lookupRgbaScalar(const RgbaTable& table, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage) {
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4) {
+                const uint32_t pixels[4] = {
+                    table[indexedImage[i + 0]],
+                    table[indexedImage[i + 1]],
+                    table[indexedImage[i + 2]],
+                    table[indexedImage[i + 3]]
+                };
+                std::memcpy(rgbaImage + i * 4, pixels, sizeof(pixels));
+            }
+            for (; i < pixelCount; ++i) {
+                std::memcpy(rgbaImage + i * 4, &table[indexedImage[i]], 4);
+            }
+        }
+
+        bool Palette::hasVectorizedLookup() {
+#if defined(TB_PALETTE_AVX2)
+            return true;
+#else
+            return false;
+#endif
         }
 
         Palette::Palette() {}
@@ -88,5 +196,9 @@ namespace TrenchBroom {
         bool Palette::initialized() const {
             return m_data.get() != nullptr;
         }
+
+        uint64_t Palette::hash() const {
+            return initialized() ? m_data->hash() : 0u;
+        }
     }
 }
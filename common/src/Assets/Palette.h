@@ -24,7 +24,9 @@
 #include "IO/IO_Forward.h"
 #include "IO/Reader.h"
 
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -39,6 +41,13 @@ namespace TrenchBroom {
             class Data {
             private:
                 std::vector<unsigned char> m_data;
+
+                /**
+                 * The palette colors as RGBA pixels, one 32 bit value per palette index which holds the four color
+                 * components in memory order. In m_maskedRgba, the pixel for index 255 is fully transparent.
+                 */
+                std::array<uint32_t, 256> m_opaqueRgba;
+                std::array<uint32_t, 256> m_maskedRgba;
             public:
                 Data(std::vector<unsigned char>&& data);
 
@@ -57,8 +66,11 @@ namespace TrenchBroom {
                  */
                 template <typename IndexT, typename ColorT>
                 bool indexedToRgba(const std::vector<IndexT>& indexedImage, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    auto reader = IO::Reader::from(&indexedImage[0], &indexedImage[0] + pixelCount);
-                    return indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
+                    static_assert(sizeof(IndexT) == 1 && sizeof(ColorT) == 1, "indices and color components must be bytes");
+                    assert(indexedImage.size() >= pixelCount);
+                    assert(rgbaImage.size() >= 4u * pixelCount);
+
+                    return indexedToRgba(reinterpret_cast<const unsigned char*>(indexedImage.data()), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.data()), transparency, averageColor);
                 }
 
                 /**
@@ -72,38 +84,36 @@ namespace TrenchBroom {
                  * @param averageColor output parameter for the average color of the generated pixel buffer
                  * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
                  *     indicates that the image is opaque
+                 *
+                 * @throw ReaderException if the given number of pixels cannot be read from the given reader
                  */
                 template <typename ColorT>
                 bool indexedToRgba(IO::Reader& reader, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    double avg[3];
-                    avg[0] = avg[1] = avg[2] = 0.0;
-                    bool hasTransparency = false;
-                    for (size_t i = 0; i < pixelCount; ++i) {
-                        const size_t index = reader.readSize<unsigned char>();
-                        assert(index < m_data.size());
-                        for (size_t j = 0; j < 3; ++j) {
-                            const unsigned char c = m_data[index * 3 + j];
-                            rgbaImage[i * 4 + j] = c;
-                            avg[j] += static_cast<double>(c);
-                        }
-                        switch (transparency) {
-                            case PaletteTransparency::Opaque:
-                                rgbaImage[i * 4 + 3] = 0xFF;
-                                break;
-                            case PaletteTransparency::Index255Transparent:
-                                rgbaImage[i * 4 + 3] = static_cast<ColorT>((index == 255) ? 0x00 : 0xFF);
-                                hasTransparency |= (index == 255);
-                                break;
-                        }
-                    }
-
-                    for (size_t i = 0; i < 3; ++i) {
-                        averageColor[i] = static_cast<float>(avg[i] / static_cast<double>(pixelCount) / static_cast<double>(0xFF));
-                    }
-                    averageColor[3] = 1.0f;
-
-                    return hasTransparency;
+                    static_assert(sizeof(ColorT) == 1, "color components must be bytes");
+                    assert(rgbaImage.size() >= 4u * pixelCount);
+
+                    // convert directly from the reader's memory if possible, otherwise from a temporary buffer
+                    const auto indexedImage = reader.subReaderFromCurrent(pixelCount).buffer();
+                    reader.seekForward(pixelCount);
+
+                    return indexedToRgba(reinterpret_cast<const unsigned char*>(indexedImage.begin()), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.data()), transparency, averageColor);
                 }
+
+                /**
+                 * Converts the given index buffer to an RGBA image by looking up each index in the palette. Afterwards,
+                 * the average color is computed in a separate pass which builds a histogram of the indices.
+                 *
+                 * @param indexedImage the index buffer, must contain at least the given number of pixels
+                 * @param pixelCount the number of pixels
+                 * @param rgbaImage the pixel buffer, must have room for the given number of pixels
+                 * @param transparency controls whether or not the given index buffer contains a transparent index
+                 * @param averageColor output parameter for the average color of the generated pixel buffer
+                 * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
+                 *     indicates that the image is opaque
+                 */
+                bool indexedToRgba(const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage, PaletteTransparency transparency, Color& averageColor) const;
+
+                uint64_t hash() const;
             };
 
             using DataPtr = std::shared_ptr<Data>;
@@ -120,6 +130,12 @@ namespace TrenchBroom {
 
             bool initialized() const;
 
+            /**
+             * Returns a hash of the colors of this palette, which identifies the palette in caches, or 0 if this
+             * palette is not initialized.
+             */
+            uint64_t hash() const;
+
             /**
              * Converts the given index buffer to an RGBA image.
              *
@@ -154,6 +170,21 @@ namespace TrenchBroom {
             bool indexedToRgba(IO::Reader& reader, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
                 return m_data->indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
             }
+        public: // exposed for tests only
+            using RgbaTable = std::array<uint32_t, 256>;
+
+            /**
+             * Looks up the RGBA pixels of the given indices in the given table. Uses AVX2 gathers if the compiler
+             * targets AVX2, see hasVectorizedLookup, and lookupRgbaScalar otherwise.
+             *
+             * @param table the RGBA pixels of the palette indices
+             * @param indexedImage the index buffer
+             * @param pixelCount the number of pixels
+             * @param rgbaImage the pixel buffer, must have room for the given number of pixels
+             */
+            static void lookupRgba(const RgbaTable& table, const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage);
+            static void lookupRgbaScalar(const RgbaTable& table, const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage);
+            static bool hasVectorizedLookup();
         };
     }
 }
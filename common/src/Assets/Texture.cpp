@@ -20,6 +20,7 @@
 #include "Texture.h"
 #include "Assets/TextureBuffer.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureCompression.h"
 #include "Renderer/GL.h"
 
 #include <algorithm> // for std::max
@@ -174,6 +175,71 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        bool Texture::hasBuffers() const {
+            return !m_buffers.empty();
+        }
+
+        size_t Texture::bufferSize() const {
+            size_t result = 0u;
+            for (const auto& buffer : m_buffers) {
+                result += buffer.size();
+            }
+            return result;
+        }
+
+        bool Texture::takeBuffers(Texture& other) {
+            if (isPrepared() || other.m_width != m_width || other.m_height != m_height) {
+                return false;
+            }
+
+            m_averageColor = other.m_averageColor;
+            m_format = other.m_format;
+            m_type = other.m_type;
+            m_buffers = std::move(other.m_buffers);
+            other.m_buffers.clear();
+            return true;
+        }
+
+        bool Texture::compress() {
+            if (isPrepared() || m_buffers.empty() || isCompressed()) {
+                return false;
+            }
+
+            const auto bytesPerPixel = bytesPerPixelForFormat(m_format);
+            if (m_type == TextureType::Masked) {
+                m_buffers.resize(1);
+            } else if (m_buffers.size() == 1) {
+                auto width = m_width;
+                auto height = m_height;
+                while (width > 1 || height > 1) {
+                    m_buffers.push_back(downsampleImage(m_buffers.back(), width, height, bytesPerPixel));
+                    width = std::max(size_t(1), width / 2);
+                    height = std::max(size_t(1), height / 2);
+                }
+            }
+
+            auto hasAlpha = false;
+            if (bytesPerPixel == 4) {
+                const auto& buffer = m_buffers.front();
+                for (size_t i = 3; i < m_width * m_height * 4 && !hasAlpha; i += 4) {
+                    hasAlpha = buffer.data()[i] < 0xFF;
+                }
+            }
+
+            const auto compressedFormat = hasAlpha ? CompressedTextureFormat::BC3 : CompressedTextureFormat::BC1;
+            for (size_t i = 0; i < m_buffers.size(); ++i) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, i);
+                m_buffers[i] = compressImage(m_buffers[i], mipSize.x(), mipSize.y(), m_format, compressedFormat);
+            }
+            m_format = glCompressedTextureFormat(compressedFormat);
+
+            return true;
+        }
+
+        bool Texture::isCompressed() const {
+            return isCompressedTextureFormat(m_format);
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
@@ -201,7 +267,7 @@ namespace TrenchBroom {
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
+                } else if (m_buffers.size() == 1 && !isCompressed()) {
                     // generate mipmaps if we don't have any
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
                 } else {
@@ -215,12 +281,20 @@ namespace TrenchBroom {
                     const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
 
                     const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
+                    if (isCompressed()) {
+                        glAssert(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), m_format,
+                                                        static_cast<GLsizei>(mipSize.x()),
+                                                        static_cast<GLsizei>(mipSize.y()),
+                                                        0, static_cast<GLsizei>(m_buffers[j].size()), data));
+                    } else {
+                        glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                              static_cast<GLsizei>(mipSize.x()),
+                                              static_cast<GLsizei>(mipSize.y()),
+                                              0, m_format, GL_UNSIGNED_BYTE, data));
+                    }
                 }
 
+                // the pixel data now lives on the GPU only
                 m_buffers.clear();
                 m_textureId = textureId;
             }
@@ -307,5 +381,10 @@ namespace TrenchBroom {
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
+
+        void Texture::release() {
+            m_textureId = 0;
+            m_buffers.clear();
+        }
     }
 }
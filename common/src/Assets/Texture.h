@@ -114,6 +114,43 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Indicates whether this texture has pixel data which has not been uploaded yet.
+             */
+            bool hasBuffers() const;
+
+            /**
+             * Returns the number of bytes of pixel data which have not been uploaded yet.
+             */
+            size_t bufferSize() const;
+
+            /**
+             * Moves the pixel data, the average color, the format and the type of the given texture into this texture.
+             * This is used to complete a texture which was created without pixel data, e.g. because its pixel data was
+             * decoded in the background.
+             *
+             * Nothing is moved if this texture is already prepared or if the given texture has different dimensions.
+             *
+             * @param other the texture to take the pixel data from
+             * @return true if the pixel data was moved into this texture and false otherwise
+             */
+            bool takeBuffers(Texture& other);
+
+            /**
+             * Block compresses the pixel data of this texture so that it occupies a quarter or an eighth of the memory
+             * on the GPU and until it is uploaded. Textures with transparent pixels are compressed to BC3 and all other
+             * textures are compressed to BC1.
+             *
+             * Since OpenGL cannot generate mipmaps for compressed textures, missing mipmaps are generated before the
+             * texture is compressed. Masked textures only keep their first mipmap because only that one is uploaded.
+             *
+             * Nothing is compressed if this texture is already prepared or compressed or if it has no pixel data.
+             *
+             * @return true if the pixel data was compressed and false otherwise
+             */
+            bool compress();
+            bool isCompressed() const;
+
             bool isPrepared() const;
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
@@ -127,12 +164,19 @@ namespace TrenchBroom {
              */
             const BufferList& buffersIfUnprepared() const;
             /**
-             * Will be one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA.
+             * Will be one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA, or one of the compressed formats if the texture was
+             * compressed.
              */
             GLenum format() const;
             TextureType type() const;
         private:
             void setCollection(TextureCollection* collection);
+
+            /**
+             * Forgets the texture object of this texture, which must have been deleted by the collection. Called by
+             * TextureCollection::releaseTexture.
+             */
+            void release();
             friend class TextureCollection;
         };
     }
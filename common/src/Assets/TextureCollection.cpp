@@ -23,6 +23,8 @@
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -131,6 +133,39 @@ namespace TrenchBroom {
             }
         }
 
+        void TextureCollection::prepareTexture(Texture* texture, const int minFilter, const int magFilter) {
+            ensure(texture != nullptr, "texture is null");
+            assert(texture->collection() == this);
+
+            if (!prepared() || texture->isPrepared() || !texture->hasBuffers()) {
+                return;
+            }
+
+            const auto it = std::find(std::begin(m_textures), std::end(m_textures), texture);
+            if (it != std::end(m_textures)) {
+                const auto index = static_cast<size_t>(std::distance(std::begin(m_textures), it));
+                texture->prepare(m_textureIds[index], minFilter, magFilter);
+            }
+        }
+
+        void TextureCollection::releaseTexture(Texture* texture) {
+            ensure(texture != nullptr, "texture is null");
+            assert(texture->collection() == this);
+
+            if (!texture->isPrepared()) {
+                return;
+            }
+
+            const auto it = std::find(std::begin(m_textures), std::end(m_textures), texture);
+            if (it != std::end(m_textures)) {
+                // replace the texture object so that the texture can be prepared again later
+                const auto index = static_cast<size_t>(std::distance(std::begin(m_textures), it));
+                glAssert(glDeleteTextures(1, &m_textureIds[index]));
+                glAssert(glGenTextures(1, &m_textureIds[index]));
+                texture->release();
+            }
+        }
+
         void TextureCollection::setTextureMode(const int minFilter, const int magFilter) {
             for (auto* texture : m_textures) {
                 texture->setMode(minFilter, magFilter);
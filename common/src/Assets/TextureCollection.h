@@ -67,6 +67,25 @@ namespace TrenchBroom {
 
             bool prepared() const;
             void prepare(int minFilter, int magFilter);
+
+            /**
+             * Uploads the given texture of this collection if this collection is already prepared and the texture
+             * has pixel data which has not been uploaded yet. Used for textures whose pixel data was not available
+             * when this collection was prepared.
+             *
+             * @param texture the texture to upload, must belong to this collection
+             * @param minFilter the minification filter
+             * @param magFilter the magnification filter
+             */
+            void prepareTexture(Texture* texture, int minFilter, int magFilter);
+
+            /**
+             * Frees the memory occupied by the given texture on the GPU. Afterwards, the texture is no longer
+             * prepared, but it can be prepared again using prepareTexture once it has pixel data again.
+             *
+             * @param texture the texture to release, must belong to this collection
+             */
+            void releaseTexture(Texture* texture);
             void setTextureMode(int minFilter, int magFilter);
         private:
             void incUsageCount();
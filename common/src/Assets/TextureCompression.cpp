@@ -0,0 +1,281 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureCompression.h"
+
+#include "Ensure.h"
+#include "Macros.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+namespace TrenchBroom {
+    namespace Assets {
+        namespace {
+            struct PixelLayout {
+                size_t stride;
+                size_t r, g, b, a;
+                bool hasAlpha;
+            };
+
+            PixelLayout pixelLayout(const GLenum pixelFormat) {
+                switch (pixelFormat) {
+                    case GL_RGB:
+                        return PixelLayout{ 3, 0, 1, 2, 0, false };
+                    case GL_BGR:
+                        return PixelLayout{ 3, 2, 1, 0, 0, false };
+                    case GL_RGBA:
+                        return PixelLayout{ 4, 0, 1, 2, 3, true };
+                    case GL_BGRA:
+                        return PixelLayout{ 4, 2, 1, 0, 3, true };
+                }
+                ensure(false, "unknown pixel format");
+                return PixelLayout{ 4, 0, 1, 2, 3, true };
+            }
+
+            using Block = unsigned char[16][4];
+
+            void fetchBlock(const TextureBuffer& image, const size_t width, const size_t height, const size_t blockX, const size_t blockY, const PixelLayout& layout, Block& block) {
+                for (size_t y = 0; y < 4; ++y) {
+                    const auto sourceY = std::min(blockY * 4 + y, height - 1);
+                    for (size_t x = 0; x < 4; ++x) {
+                        const auto sourceX = std::min(blockX * 4 + x, width - 1);
+                        const auto* pixel = image.data() + (sourceY * width + sourceX) * layout.stride;
+
+                        auto& target = block[y * 4 + x];
+                        target[0] = pixel[layout.r];
+                        target[1] = pixel[layout.g];
+                        target[2] = pixel[layout.b];
+                        target[3] = layout.hasAlpha ? pixel[layout.a] : 0xFF;
+                    }
+                }
+            }
+
+            uint16_t toRgb565(const int rgb[3]) {
+                const auto r = static_cast<uint16_t>((rgb[0] * 31 + 127) / 255);
+                const auto g = static_cast<uint16_t>((rgb[1] * 63 + 127) / 255);
+                const auto b = static_cast<uint16_t>((rgb[2] * 31 + 127) / 255);
+                return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+            }
+
+            void fromRgb565(const uint16_t color, int rgb[3]) {
+                const auto r = (color >> 11) & 0x1F;
+                const auto g = (color >> 5) & 0x3F;
+                const auto b = color & 0x1F;
+                rgb[0] = (r << 3) | (r >> 2);
+                rgb[1] = (g << 2) | (g >> 4);
+                rgb[2] = (b << 3) | (b >> 2);
+            }
+
+            template <typename T>
+            void putLittleEndian(unsigned char* out, const T value, const size_t byteCount) {
+                for (size_t i = 0; i < byteCount; ++i) {
+                    out[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+                }
+            }
+
+            /**
+             * Writes the 8 byte color part of a BC1 or BC3 block. The endpoints are the corners of the bounding box
+             * of the block's colors, inset by 1/16 of its size to reduce the error of the interpolated colors.
+             */
+            void encodeColorBlock(const Block& block, unsigned char* out) {
+                int min[3] = { 255, 255, 255 };
+                int max[3] = { 0, 0, 0 };
+                for (size_t i = 0; i < 16; ++i) {
+                    for (size_t j = 0; j < 3; ++j) {
+                        min[j] = std::min(min[j], static_cast<int>(block[i][j]));
+                        max[j] = std::max(max[j], static_cast<int>(block[i][j]));
+                    }
+                }
+
+                for (size_t j = 0; j < 3; ++j) {
+                    const auto inset = (max[j] - min[j]) >> 4;
+                    min[j] += inset;
+                    max[j] -= inset;
+                }
+
+                auto color0 = toRgb565(max);
+                auto color1 = toRgb565(min);
+                if (color0 < color1) {
+                    std::swap(color0, color1);
+                }
+
+                // color0 > color1 selects the four color mode, if they are equal, all pixels use color0
+                uint32_t indices = 0;
+                if (color0 != color1) {
+                    int palette[4][3];
+                    fromRgb565(color0, palette[0]);
+                    fromRgb565(color1, palette[1]);
+                    for (size_t j = 0; j < 3; ++j) {
+                        palette[2][j] = (2 * palette[0][j] + palette[1][j]) / 3;
+                        palette[3][j] = (palette[0][j] + 2 * palette[1][j]) / 3;
+                    }
+
+                    for (size_t i = 0; i < 16; ++i) {
+                        uint32_t bestIndex = 0;
+                        auto bestDistance = std::numeric_limits<int>::max();
+                        for (uint32_t k = 0; k < 4; ++k) {
+                            auto distance = 0;
+                            for (size_t j = 0; j < 3; ++j) {
+                                const auto d = static_cast<int>(block[i][j]) - palette[k][j];
+                                distance += d * d;
+                            }
+                            if (distance < bestDistance) {
+                                bestDistance = distance;
+                                bestIndex = k;
+                            }
+                        }
+                        indices |= bestIndex << (2 * i);
+                    }
+                }
+
+                putLittleEndian(out + 0, color0, 2);
+                putLittleEndian(out + 2, color1, 2);
+                putLittleEndian(out + 4, indices, 4);
+            }
+
+            /**
+             * Writes the 8 byte alpha part of a BC3 block.
+             */
+            void encodeAlphaBlock(const Block& block, unsigned char* out) {
+                int min = 255;
+                int max = 0;
+                for (size_t i = 0; i < 16; ++i) {
+                    min = std::min(min, static_cast<int>(block[i][3]));
+                    max = std::max(max, static_cast<int>(block[i][3]));
+                }
+
+                // alpha0 > alpha1 selects the eight value mode, if they are equal, all pixels use alpha0
+                uint64_t indices = 0;
+                if (max != min) {
+                    int palette[8];
+                    palette[0] = max;
+                    palette[1] = min;
+                    for (int k = 2; k < 8; ++k) {
+                        palette[k] = ((8 - k) * max + (k - 1) * min) / 7;
+                    }
+
+                    for (size_t i = 0; i < 16; ++i) {
+                        uint64_t bestIndex = 0;
+                        auto bestDistance = std::numeric_limits<int>::max();
+                        for (uint64_t k = 0; k < 8; ++k) {
+                            const auto distance = std::abs(static_cast<int>(block[i][3]) - palette[k]);
+                            if (distance < bestDistance) {
+                                bestDistance = distance;
+                                bestIndex = k;
+                            }
+                        }
+                        indices |= bestIndex << (3 * i);
+                    }
+                }
+
+                out[0] = static_cast<unsigned char>(max);
+                out[1] = static_cast<unsigned char>(min);
+                putLittleEndian(out + 2, indices, 6);
+            }
+
+            size_t blockSize(const CompressedTextureFormat format) {
+                switch (format) {
+                    case CompressedTextureFormat::BC1:
+                        return 8;
+                    case CompressedTextureFormat::BC3:
+                        return 16;
+                    switchDefault()
+                }
+            }
+        }
+
+        GLenum glCompressedTextureFormat(const CompressedTextureFormat format) {
+            switch (format) {
+                case CompressedTextureFormat::BC1:
+                    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case CompressedTextureFormat::BC3:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                switchDefault()
+            }
+        }
+
+        bool isCompressedTextureFormat(const GLenum format) {
+            return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+
+        size_t compressedImageSize(const size_t width, const size_t height, const CompressedTextureFormat format) {
+            const auto blocksX = std::max(size_t(1), (width + 3) / 4);
+            const auto blocksY = std::max(size_t(1), (height + 3) / 4);
+            return blocksX * blocksY * blockSize(format);
+        }
+
+        TextureBuffer compressImage(const TextureBuffer& image, const size_t width, const size_t height, const GLenum pixelFormat, const CompressedTextureFormat format) {
+            ensure(width > 0 && height > 0, "image is not empty");
+
+            const auto layout = pixelLayout(pixelFormat);
+            ensure(image.size() >= width * height * layout.stride, "image has the given size");
+
+            const auto blocksX = (width + 3) / 4;
+            const auto blocksY = (height + 3) / 4;
+            const auto bytesPerBlock = blockSize(format);
+
+            auto result = TextureBuffer(compressedImageSize(width, height, format));
+            Block block;
+            for (size_t blockY = 0; blockY < blocksY; ++blockY) {
+                for (size_t blockX = 0; blockX < blocksX; ++blockX) {
+                    fetchBlock(image, width, height, blockX, blockY, layout, block);
+
+                    auto* out = result.data() + (blockY * blocksX + blockX) * bytesPerBlock;
+                    if (format == CompressedTextureFormat::BC3) {
+                        encodeAlphaBlock(block, out);
+                        out += 8;
+                    }
+                    encodeColorBlock(block, out);
+                }
+            }
+
+            return result;
+        }
+
+        TextureBuffer downsampleImage(const TextureBuffer& image, const size_t width, const size_t height, const size_t bytesPerPixel) {
+            ensure(width > 0 && height > 0, "image is not empty");
+            ensure(image.size() >= width * height * bytesPerPixel, "image has the given size");
+
+            const auto newWidth = std::max(size_t(1), width / 2);
+            const auto newHeight = std::max(size_t(1), height / 2);
+
+            auto result = TextureBuffer(newWidth * newHeight * bytesPerPixel);
+            for (size_t y = 0; y < newHeight; ++y) {
+                const auto* row0 = image.data() + std::min(2 * y, height - 1) * width * bytesPerPixel;
+                const auto* row1 = image.data() + std::min(2 * y + 1, height - 1) * width * bytesPerPixel;
+                for (size_t x = 0; x < newWidth; ++x) {
+                    const auto x0 = std::min(2 * x, width - 1) * bytesPerPixel;
+                    const auto x1 = std::min(2 * x + 1, width - 1) * bytesPerPixel;
+
+                    auto* out = result.data() + (y * newWidth + x) * bytesPerPixel;
+                    for (size_t c = 0; c < bytesPerPixel; ++c) {
+                        const auto sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                        out[c] = static_cast<unsigned char>((sum + 2) / 4);
+                    }
+                }
+            }
+
+            return result;
+        }
+    }
+}
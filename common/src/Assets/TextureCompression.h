@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRENCHBROOM_TEXTURECOMPRESSION_H
+#define TRENCHBROOM_TEXTURECOMPRESSION_H
+
+#include "Assets/TextureBuffer.h"
+#include "Renderer/GL.h"
+
+#include <cstddef>
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * The block compression formats which textures can be compressed to. BC1 stores 4x4 pixels without alpha
+         * in 8 bytes, and BC3 stores 4x4 pixels with alpha in 16 bytes. These formats are also known as DXT1 and
+         * DXT5.
+         */
+        enum class CompressedTextureFormat {
+            BC1,
+            BC3
+        };
+
+        /**
+         * Returns the OpenGL internal format of the given compression format.
+         */
+        GLenum glCompressedTextureFormat(CompressedTextureFormat format);
+
+        /**
+         * Indicates whether the given OpenGL format is one of the formats returned by glCompressedTextureFormat.
+         */
+        bool isCompressedTextureFormat(GLenum format);
+
+        /**
+         * Returns the number of bytes of a compressed image with the given dimensions.
+         */
+        size_t compressedImageSize(size_t width, size_t height, CompressedTextureFormat format);
+
+        /**
+         * Block compresses the given image. Partial blocks at the right and bottom edges are padded by repeating the
+         * edge pixels.
+         *
+         * @param image the image to compress
+         * @param width the width of the image
+         * @param height the height of the image
+         * @param pixelFormat the format of the image, one of GL_RGB, GL_BGR, GL_RGBA and GL_BGRA
+         * @param format the format to compress to
+         * @return the compressed image
+         */
+        TextureBuffer compressImage(const TextureBuffer& image, size_t width, size_t height, GLenum pixelFormat, CompressedTextureFormat format);
+
+        /**
+         * Returns the next smaller mip level of the given image by averaging blocks of 2x2 pixels.
+         *
+         * @param image the image
+         * @param width the width of the image
+         * @param height the height of the image
+         * @param bytesPerPixel the number of bytes per pixel
+         * @return an image of half the size of the given image, but at least 1x1
+         */
+        TextureBuffer downsampleImage(const TextureBuffer& image, size_t width, size_t height, size_t bytesPerPixel);
+    }
+}
+
+#endif //TRENCHBROOM_TEXTURECOMPRESSION_H
@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
+#include "IO/AsyncTextureDecoder.h"
 #include "IO/TextureLoader.h"
 
 #include <kdl/map_utils.h>
@@ -55,16 +56,70 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * The maximum number of bytes of deferred texture data to upload per call to commitChanges. At least one
+         * texture is uploaded per call regardless of its size.
+         */
+        static const size_t UploadBudget = 16u * 1024u * 1024u;
+
+        /**
+         * The default number of bytes which textures decoded on demand may occupy before unused ones are released.
+         */
+        static const size_t DefaultResidentBudget = 256u * 1024u * 1024u;
+
+        /**
+         * Textures which were requested during the last few calls to commitChanges are never released, even if this
+         * exceeds the resident budget, see TextureResidency.
+         */
+        static const size_t MinEvictionAge = 4u;
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
+        m_decoder(std::make_unique<IO::AsyncTextureDecoder>()),
+        m_loadInBackground(false),
+        m_residency(DefaultResidentBudget, MinEvictionAge),
+        m_decodeOnDemand(false),
+        m_usageChanged(false),
+        m_compressTextures(false),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false) {
+            usageCountDidChange.addObserver(this, &TextureManager::textureUsageCountDidChange);
+        }
 
         TextureManager::~TextureManager() {
+            usageCountDidChange.removeObserver(this, &TextureManager::textureUsageCountDidChange);
             clear();
         }
 
+        void TextureManager::setLoadInBackground(const bool loadInBackground) {
+            m_loadInBackground = loadInBackground;
+        }
+
+        void TextureManager::setDecodeOnDemand(const bool decodeOnDemand) {
+            m_decodeOnDemand = decodeOnDemand;
+        }
+
+        void TextureManager::setResidentBudget(const size_t residentBudget) {
+            m_residency.setBudget(residentBudget);
+        }
+
+        const std::shared_ptr<const IO::TextureCache>& TextureManager::textureCache() const {
+            return m_textureCache;
+        }
+
+        void TextureManager::setTextureCache(std::shared_ptr<const IO::TextureCache> textureCache) {
+            m_textureCache = std::move(textureCache);
+        }
+
+        bool TextureManager::compressTextures() const {
+            return m_compressTextures;
+        }
+
+        void TextureManager::setCompressTextures(const bool compressTextures) {
+            m_compressTextures = compressTextures;
+        }
+
         void TextureManager::setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader) {
             auto collections = collectionMap();
             m_collections.clear();
@@ -74,10 +129,20 @@ namespace TrenchBroom {
                 const auto it = collections.find(path);
                 if (it == std::end(collections) || !it->second->loaded()) {
                     try {
-                        auto collection = loader.loadTextureCollection(path);
+                        std::vector<IO::DeferredTexture> deferredTextures;
+                        auto collection = m_loadInBackground || m_decodeOnDemand
+                                          ? loader.loadTextureCollection(path, deferredTextures)
+                                          : loader.loadTextureCollection(path);
                         m_logger.info() << "Loaded texture collection '" << path << "'";
                         collection->usageCountDidChange.addObserver(usageCountDidChange);
-                        addTextureCollection(collection.release());
+
+                        auto* addedCollection = collection.release();
+                        addTextureCollection(addedCollection);
+                        if (m_decodeOnDemand) {
+                            addLazyTextures(std::move(deferredTextures), loader.textureReader());
+                        } else {
+                            m_decoder->decode(addedCollection, std::move(deferredTextures), loader.textureReader());
+                        }
                     } catch (const Exception& e) {
                         addTextureCollection(new Assets::TextureCollection(path));
                         if (it == std::end(collections)) {
@@ -93,7 +158,10 @@ namespace TrenchBroom {
             }
 
             updateTextures();
-            kdl::vec_append(m_toRemove, kdl::map_values(collections));
+
+            const auto removedCollections = kdl::map_values(collections);
+            cancelPendingWork(removedCollections);
+            kdl::vec_append(m_toRemove, removedCollections);
         }
 
         void TextureManager::setTextureCollections(const std::vector<TextureCollection*>& collections) {
@@ -122,7 +190,41 @@ namespace TrenchBroom {
             m_logger.debug() << "Added texture collection " << collection->path();
         }
 
+        void TextureManager::cancelPendingWork(const std::vector<TextureCollection*>& collections) {
+            for (const auto* collection : collections) {
+                m_decoder->cancel(collection);
+            }
+
+            m_toUpload.erase(std::remove_if(std::begin(m_toUpload), std::end(m_toUpload), [&](const auto* texture) {
+                return kdl::vec_contains(collections, texture->collection());
+            }), std::end(m_toUpload));
+
+            for (auto it = std::begin(m_lazyTextures); it != std::end(m_lazyTextures);) {
+                const auto* texture = it->second.texture;
+                if (kdl::vec_contains(collections, texture->collection())) {
+                    m_residency.remove(texture);
+                    it = m_lazyTextures.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void TextureManager::addLazyTextures(std::vector<IO::DeferredTexture> deferredTextures, std::shared_ptr<const IO::TextureReader> reader) {
+            for (auto& deferredTexture : deferredTextures) {
+                auto* texture = deferredTexture.texture;
+                m_lazyTextures.emplace(texture, LazyTexture{ texture, std::move(deferredTexture.file), reader });
+                m_residency.add(texture);
+            }
+
+            // some of the new textures may already be in use
+            m_usageChanged = true;
+        }
+
         void TextureManager::clear() {
+            cancelPendingWork(m_collections);
+            cancelPendingWork(m_toRemove);
+
             kdl::vec_clear_and_delete(m_collections);
             kdl::vec_clear_and_delete(m_toRemove);
 
@@ -142,7 +244,27 @@ namespace TrenchBroom {
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            requestUsedTextures();
+            applyDecodedTextures();
+            upload();
+            evictUnusedTextures();
             kdl::vec_clear_and_delete(m_toRemove);
+            m_residency.nextGeneration();
+        }
+
+        bool TextureManager::hasPendingChanges() const {
+            return m_resetTextureMode ||
+                   !m_toPrepare.empty() ||
+                   !m_toRemove.empty() ||
+                   !m_toUpload.empty() ||
+                   !m_decoder->idle();
+        }
+
+        void TextureManager::requestTexture(const Texture* texture) {
+            const auto it = m_lazyTextures.find(texture);
+            if (it != std::end(m_lazyTextures)) {
+                touch(it->second);
+            }
         }
 
         Texture* TextureManager::texture(const std::string& name) const {
@@ -184,6 +306,76 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
 
+        void TextureManager::requestUsedTextures() {
+            if (m_usageChanged) {
+                for (auto& entry : m_lazyTextures) {
+                    if (entry.second.texture->usageCount() > 0u) {
+                        touch(entry.second);
+                    }
+                }
+                m_usageChanged = false;
+            }
+        }
+
+        void TextureManager::applyDecodedTextures() {
+            for (auto& result : m_decoder->takeResults()) {
+                // a texture which cannot be decoded keeps its dimensions, but it has no pixel data
+                if (result.decoded == nullptr) {
+                    decodingFailed(result.texture, result.error);
+                } else if (!result.decoded->hasBuffers()) {
+                    decodingFailed(result.texture, "Texture has no pixel data");
+                } else if (!result.texture->takeBuffers(*result.decoded)) {
+                    decodingFailed(result.texture, "Decoded texture does not match texture header");
+                } else {
+                    m_toUpload.push_back(result.texture);
+                }
+            }
+        }
+
+        void TextureManager::upload() {
+            size_t uploaded = 0u;
+            auto it = std::begin(m_toUpload);
+            while (it != std::end(m_toUpload) && uploaded < UploadBudget) {
+                auto* texture = *it++;
+                const auto size = texture->bufferSize();
+                uploaded += size;
+                texture->collection()->prepareTexture(texture, m_minFilter, m_magFilter);
+
+                if (m_residency.contains(texture)) {
+                    if (texture->isPrepared()) {
+                        m_residency.setResident(texture, size);
+                    } else {
+                        m_logger.error() << "Could not upload texture '" << texture->name() << "'";
+                        m_residency.setFailed(texture);
+                    }
+                }
+            }
+            m_toUpload.erase(std::begin(m_toUpload), it);
+        }
+
+        void TextureManager::evictUnusedTextures() {
+            for (auto* texture : m_residency.evict()) {
+                texture->collection()->releaseTexture(texture);
+            }
+        }
+
+        void TextureManager::touch(const LazyTexture& lazyTexture) {
+            if (m_residency.touch(lazyTexture.texture)) {
+                m_decoder->decode(lazyTexture.texture->collection(), { IO::DeferredTexture{ lazyTexture.texture, lazyTexture.file } }, lazyTexture.reader);
+            }
+        }
+
+        void TextureManager::decodingFailed(Texture* texture, const std::string& error) {
+            m_logger.error() << "Could not decode texture '" << texture->name() << "': " << error;
+            if (m_residency.contains(texture)) {
+                m_residency.setFailed(texture);
+            }
+        }
+
+        void TextureManager::textureUsageCountDidChange() {
+            m_usageChanged = true;
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -22,11 +22,14 @@
 
 #include "Notifier.h"
 #include "Assets/Asset_Forward.h"
+#include "Assets/TextureResidency.h"
 #include "IO/IO_Forward.h"
 #include "Model/Model_Forward.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -46,6 +49,31 @@ namespace TrenchBroom {
             std::vector<TextureCollection*> m_toPrepare;
             std::vector<TextureCollection*> m_toRemove;
 
+            /**
+             * Decodes the pixel data of textures that were loaded in the background. Decoded textures are moved to
+             * m_toUpload and uploaded a few at a time to avoid stalling the UI.
+             */
+            std::unique_ptr<IO::AsyncTextureDecoder> m_decoder;
+            std::vector<Texture*> m_toUpload;
+            bool m_loadInBackground;
+
+            struct LazyTexture {
+                Texture* texture;
+                std::shared_ptr<IO::File> file;
+                std::shared_ptr<const IO::TextureReader> reader;
+            };
+
+            /**
+             * The textures whose pixel data is decoded on demand, see setDecodeOnDemand, and their states.
+             */
+            std::unordered_map<const Texture*, LazyTexture> m_lazyTextures;
+            TextureResidency m_residency;
+            bool m_decodeOnDemand;
+            bool m_usageChanged;
+
+            std::shared_ptr<const IO::TextureCache> m_textureCache;
+            bool m_compressTextures;
+
             TextureMap m_texturesByName;
             std::vector<Texture*> m_textures;
 
@@ -58,17 +86,63 @@ namespace TrenchBroom {
             TextureManager(int magFilter, int minFilter, Logger& logger);
             ~TextureManager();
 
+            /**
+             * If enabled, texture collections are loaded without decoding the pixel data of their textures if the
+             * texture reader supports this. The pixel data is decoded in the background and uploaded when
+             * commitChanges is called. Until then, the textures have their correct dimensions, but are not prepared.
+             */
+            void setLoadInBackground(bool loadInBackground);
+
+            /**
+             * If enabled, texture collections are loaded without decoding the pixel data of their textures if the
+             * texture reader supports this, like with setLoadInBackground. The pixel data of a texture is only
+             * decoded in the background once it is used by a brush face or passed to requestTexture.
+             *
+             * Once the textures decoded on demand occupy more than the resident budget, the pixel data of the least
+             * recently requested unused textures is released until they fit into the budget again. Released textures
+             * are decoded again when they are requested again. Textures which cannot be decoded or uploaded are
+             * not decoded again.
+             */
+            void setDecodeOnDemand(bool decodeOnDemand);
+            void setResidentBudget(size_t residentBudget);
+
+            /**
+             * The texture cache to use when loading texture collections, or nullptr if no cache should be used.
+             */
+            const std::shared_ptr<const IO::TextureCache>& textureCache() const;
+            void setTextureCache(std::shared_ptr<const IO::TextureCache> textureCache);
+
+            /**
+             * If enabled, the pixel data of newly loaded textures is block compressed, see Texture::compress.
+             */
+            bool compressTextures() const;
+            void setCompressTextures(bool compressTextures);
+
             void setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader);
             void setTextureCollections(const std::vector<TextureCollection*>& collections);
         private:
             TextureCollectionMap collectionMap() const;
             void addTextureCollection(Assets::TextureCollection* collection);
+            void cancelPendingWork(const std::vector<TextureCollection*>& collections);
+            void addLazyTextures(std::vector<IO::DeferredTexture> deferredTextures, std::shared_ptr<const IO::TextureReader> reader);
         public:
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
             void commitChanges();
 
+            /**
+             * Indicates whether there are changes which have not been committed yet, or textures which are still
+             * being decoded in the background.
+             */
+            bool hasPendingChanges() const;
+
+            /**
+             * Marks the given texture as recently used and schedules its pixel data for decoding if it is decoded on
+             * demand and has not been decoded yet. Does nothing for other textures.
+             */
+            void requestTexture(const Texture* texture);
+
             Texture* texture(const std::string& name) const;
             const std::vector<Texture*>& textures() const;
             const std::vector<TextureCollection*>& collections() const;
@@ -76,6 +150,14 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void requestUsedTextures();
+            void applyDecodedTextures();
+            void upload();
+            void evictUnusedTextures();
+
+            void touch(const LazyTexture& lazyTexture);
+            void decodingFailed(Texture* texture, const std::string& error);
+            void textureUsageCountDidChange();
 
             void updateTextures();
         };
@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureResidency.h"
+
+#include "Ensure.h"
+#include "Assets/Texture.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Assets {
+        TextureResidency::TextureResidency(const size_t budget, const size_t minEvictionAge) :
+        m_residentSize(0u),
+        m_budget(budget),
+        m_minEvictionAge(minEvictionAge),
+        m_generation(0u) {}
+
+        void TextureResidency::setBudget(const size_t budget) {
+            m_budget = budget;
+        }
+
+        size_t TextureResidency::residentSize() const {
+            return m_residentSize;
+        }
+
+        bool TextureResidency::contains(const Texture* texture) const {
+            return m_entries.count(texture) > 0u;
+        }
+
+        TextureResidencyState TextureResidency::state(const Texture* texture) const {
+            return m_entries.at(texture).state;
+        }
+
+        void TextureResidency::add(Texture* texture) {
+            ensure(texture != nullptr, "texture is null");
+            m_entries.emplace(texture, Entry{ texture, TextureResidencyState::Deferred, 0u, m_generation, std::end(m_lru) });
+        }
+
+        void TextureResidency::remove(const Texture* texture) {
+            const auto it = m_entries.find(texture);
+            if (it != std::end(m_entries)) {
+                auto& entry = it->second;
+                if (entry.state == TextureResidencyState::Resident) {
+                    m_residentSize -= entry.residentSize;
+                    m_lru.erase(entry.lruPosition);
+                }
+                m_entries.erase(it);
+            }
+        }
+
+        bool TextureResidency::touch(const Texture* texture) {
+            auto& entry = m_entries.at(texture);
+            entry.lastUse = m_generation;
+            switch (entry.state) {
+                case TextureResidencyState::Deferred:
+                    entry.state = TextureResidencyState::Decoding;
+                    return true;
+                case TextureResidencyState::Resident:
+                    m_lru.splice(std::begin(m_lru), m_lru, entry.lruPosition);
+                    return false;
+                case TextureResidencyState::Decoding:
+                case TextureResidencyState::Failed:
+                    return false;
+            }
+            return false;
+        }
+
+        void TextureResidency::setResident(const Texture* texture, const size_t residentSize) {
+            auto& entry = m_entries.at(texture);
+            assert(entry.state == TextureResidencyState::Decoding);
+            entry.state = TextureResidencyState::Resident;
+            entry.residentSize = residentSize;
+            entry.lastUse = m_generation;
+            entry.lruPosition = m_lru.insert(std::begin(m_lru), entry.texture);
+            m_residentSize += residentSize;
+        }
+
+        void TextureResidency::setFailed(const Texture* texture) {
+            auto& entry = m_entries.at(texture);
+            assert(entry.state == TextureResidencyState::Decoding);
+            entry.state = TextureResidencyState::Failed;
+        }
+
+        std::vector<Texture*> TextureResidency::evict() {
+            std::vector<Texture*> result;
+
+            auto it = std::end(m_lru);
+            while (m_residentSize > m_budget && it != std::begin(m_lru)) {
+                auto* texture = *--it;
+                auto& entry = m_entries.at(texture);
+                if (m_generation - entry.lastUse < m_minEvictionAge) {
+                    // all remaining textures were used even more recently
+                    break;
+                }
+
+                if (texture->usageCount() == 0u) {
+                    entry.state = TextureResidencyState::Deferred;
+                    m_residentSize -= entry.residentSize;
+                    entry.residentSize = 0u;
+                    it = m_lru.erase(it);
+                    result.push_back(texture);
+                }
+            }
+
+            return result;
+        }
+
+        void TextureResidency::nextGeneration() {
+            ++m_generation;
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureResidency
+#define TrenchBroom_TextureResidency
+
+#include "Assets/Asset_Forward.h"
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        enum class TextureResidencyState {
+            /**
+             * The texture has no pixel data, it is decoded once it is requested.
+             */
+            Deferred,
+            /**
+             * The pixel data of the texture is being decoded or waiting to be uploaded.
+             */
+            Decoding,
+            /**
+             * The texture has been uploaded.
+             */
+            Resident,
+            /**
+             * The texture could not be decoded or uploaded. It is not decoded again.
+             */
+            Failed
+        };
+
+        /**
+         * Tracks the state of the textures whose pixel data is decoded on demand, and decides which resident textures
+         * to release once they occupy more than a given budget.
+         *
+         * Time is measured in generations, which the owner advances once per frame by calling nextGeneration.
+         * Textures which were requested during the last few generations are never released, even if this exceeds the
+         * budget. Otherwise, if more textures are visible at once than fit into the budget, they would be released
+         * and decoded again on every frame.
+         */
+        class TextureResidency {
+        private:
+            struct Entry {
+                Texture* texture;
+                TextureResidencyState state;
+                size_t residentSize;
+                size_t lastUse;
+                std::list<Texture*>::iterator lruPosition;
+            };
+
+            std::unordered_map<const Texture*, Entry> m_entries;
+            /**
+             * The resident textures, most recently used first.
+             */
+            std::list<Texture*> m_lru;
+            size_t m_residentSize;
+            size_t m_budget;
+            size_t m_minEvictionAge;
+            size_t m_generation;
+        public:
+            TextureResidency(size_t budget, size_t minEvictionAge);
+
+            void setBudget(size_t budget);
+
+            /**
+             * The number of bytes occupied by the resident textures.
+             */
+            size_t residentSize() const;
+
+            bool contains(const Texture* texture) const;
+
+            /**
+             * Returns the state of the given texture, which must have been added.
+             */
+            TextureResidencyState state(const Texture* texture) const;
+
+            /**
+             * Adds the given texture in the deferred state.
+             */
+            void add(Texture* texture);
+            void remove(const Texture* texture);
+
+            /**
+             * Marks the given texture as used in the current generation. Returns true if the texture was deferred and
+             * must now be decoded, in which case its state becomes decoding.
+             */
+            bool touch(const Texture* texture);
+
+            /**
+             * Records that the given texture has been uploaded and occupies the given number of bytes.
+             */
+            void setResident(const Texture* texture, size_t residentSize);
+
+            /**
+             * Records that the given texture could not be decoded or uploaded.
+             */
+            void setFailed(const Texture* texture);
+
+            /**
+             * Selects unused resident textures, least recently used first, until the remaining resident textures fit
+             * into the budget. The selected textures become deferred again, and the caller must release their pixel
+             * data.
+             */
+            std::vector<Texture*> evict();
+
+            void nextGeneration();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureResidency) */
@@ -0,0 +1,233 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_BVHUTILS_H
+#define TRENCHBROOM_BVHUTILS_H
+
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/intersection.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Building blocks shared by the bounding volume hierarchies AABBTree and TriangleBVH.
+ */
+namespace BVHUtils {
+    /**
+     * A stack which keeps its first few elements in place to avoid allocations during queries.
+     */
+    template <typename E>
+    class TraversalStack {
+    private:
+        static constexpr size_t InPlaceCapacity = 64;
+        std::array<E, InPlaceCapacity> m_inPlace;
+        std::vector<E> m_overflow;
+        size_t m_size;
+    public:
+        TraversalStack() :
+        m_size(0) {}
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        void push(const E& element) {
+            if (m_size < InPlaceCapacity) {
+                m_inPlace[m_size] = element;
+            } else {
+                m_overflow.push_back(element);
+            }
+            ++m_size;
+        }
+
+        E pop() {
+            assert(!empty());
+            --m_size;
+            if (m_size < InPlaceCapacity) {
+                return m_inPlace[m_size];
+            } else {
+                const auto result = m_overflow.back();
+                m_overflow.pop_back();
+                return result;
+            }
+        }
+    };
+
+    /**
+     * Returns the distance from the origin of the given ray to the point where it enters the given bounds, which is 0
+     * if the origin is inside the bounds, or NaN if the ray does not intersect with the bounds.
+     */
+    template <typename T, size_t S>
+    T entryDistance(const vm::ray<T,S>& ray, const vm::bbox<T,S>& bounds) {
+        return bounds.contains(ray.origin) ? static_cast<T>(0) : vm::intersect_ray_bbox(ray, bounds);
+    }
+
+    /**
+     * Pushes the children of an inner node which the ray enters at the given distances onto the given stack. The
+     * farther child is pushed first so that the nearer child is visited first, and children which the ray misses are
+     * not pushed at all.
+     */
+    template <typename I, typename T>
+    void pushChildrenFrontToBack(TraversalStack<std::pair<I, T>>& stack, const I left, const T leftDistance, const I right, const T rightDistance) {
+        if (vm::is_nan(leftDistance)) {
+            if (!vm::is_nan(rightDistance)) {
+                stack.push({ right, rightDistance });
+            }
+        } else if (vm::is_nan(rightDistance)) {
+            stack.push({ left, leftDistance });
+        } else if (leftDistance <= rightDistance) {
+            stack.push({ right, rightDistance });
+            stack.push({ left, leftDistance });
+        } else {
+            stack.push({ left, leftDistance });
+            stack.push({ right, rightDistance });
+        }
+    }
+
+    /**
+     * Returns half of the surface area of the given box, which is all that is needed to compare the costs of splits.
+     */
+    template <typename T, size_t S>
+    T halfArea(const vm::bbox<T,S>& box) {
+        const auto size = box.size();
+        if constexpr (S < 3) {
+            auto result = static_cast<T>(0);
+            for (size_t i = 0; i < S; ++i) {
+                result += size[i];
+            }
+            return result;
+        } else {
+            auto result = static_cast<T>(0);
+            for (size_t i = 0; i < S; ++i) {
+                for (size_t j = i + 1; j < S; ++j) {
+                    result += size[i] * size[j];
+                }
+            }
+            return result;
+        }
+    }
+
+    /**
+     * Partitions the given build items into two non-empty ranges. Returns the beginning of the second range and the
+     * bounds of all given items. Every item must have the members `bounds`, `center` and `bin`, the latter is used to
+     * store the bin of the item.
+     *
+     * The items are assigned to a fixed number of bins along the axis on which their centers are spread the most.
+     * Then the boundary between two bins which minimizes the surface area heuristic is chosen as the split. If all
+     * centers coincide, the items are split in half.
+     *
+     * @tparam T the floating point type
+     * @tparam S the number of dimensions
+     * @tparam I the type of the build item iterators
+     */
+    template <typename T, size_t S, typename I>
+    std::pair<I, vm::bbox<T,S>> splitBySurfaceArea(const I begin, const I end) {
+        using Box = vm::bbox<T,S>;
+        using Bin = std::remove_reference_t<decltype(begin->bin)>;
+        static constexpr size_t BinCount = 16;
+
+        assert(std::distance(begin, end) > 1);
+
+        auto centerBounds = Box(begin->center, begin->center);
+        for (auto it = std::next(begin); it != end; ++it) {
+            centerBounds = merge(centerBounds, it->center);
+        }
+
+        const auto centerSize = centerBounds.size();
+        size_t axis = 0;
+        for (size_t i = 1; i < S; ++i) {
+            if (centerSize[i] > centerSize[axis]) {
+                axis = i;
+            }
+        }
+
+        if (centerSize[axis] <= static_cast<T>(0)) {
+            auto bounds = begin->bounds;
+            for (auto it = std::next(begin); it != end; ++it) {
+                bounds = merge(bounds, it->bounds);
+            }
+            return { std::next(begin, std::distance(begin, end) / 2), bounds };
+        }
+
+        std::array<size_t, BinCount> binCounts{};
+        std::array<Box, BinCount> binBounds;
+        const auto binScale = static_cast<T>(BinCount) / centerSize[axis];
+        for (auto it = begin; it != end; ++it) {
+            const auto bin = std::min(BinCount - 1, static_cast<size_t>((it->center[axis] - centerBounds.min[axis]) * binScale));
+            binBounds[bin] = binCounts[bin] == 0 ? it->bounds : merge(binBounds[bin], it->bounds);
+            ++binCounts[bin];
+            it->bin = static_cast<Bin>(bin);
+        }
+
+        // Sweep from the right to compute the area and count of each right hand side, then sweep from the left to
+        // evaluate the cost of each split.
+        std::array<T, BinCount> rightAreas{};
+        std::array<size_t, BinCount> rightCounts{};
+        Box rightBounds;
+        size_t rightCount = 0;
+        for (size_t i = BinCount - 1; i > 0; --i) {
+            if (binCounts[i] > 0) {
+                rightBounds = rightCount == 0 ? binBounds[i] : merge(rightBounds, binBounds[i]);
+                rightCount += binCounts[i];
+            }
+            rightAreas[i] = rightCount == 0 ? static_cast<T>(0) : halfArea(rightBounds);
+            rightCounts[i] = rightCount;
+        }
+
+        auto bestCost = std::numeric_limits<T>::max();
+        size_t bestSplit = 0;
+        Box leftBounds;
+        size_t leftCount = 0;
+        for (size_t i = 0; i < BinCount - 1; ++i) {
+            if (binCounts[i] > 0) {
+                leftBounds = leftCount == 0 ? binBounds[i] : merge(leftBounds, binBounds[i]);
+                leftCount += binCounts[i];
+            }
+
+            if (leftCount > 0 && rightCounts[i + 1] > 0) {
+                const auto cost = halfArea(leftBounds) * static_cast<T>(leftCount) + rightAreas[i + 1] * static_cast<T>(rightCounts[i + 1]);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = i + 1;
+                }
+            }
+        }
+
+        // the bins on both ends are not empty because the centers are spread along the axis
+        assert(bestSplit > 0);
+        if (binCounts[BinCount - 1] > 0) {
+            leftBounds = merge(leftBounds, binBounds[BinCount - 1]);
+        }
+
+        const auto mid = std::partition(begin, end, [&](const auto& item) { return static_cast<size_t>(item.bin) < bestSplit; });
+        return { mid, leftBounds };
+    }
+}
+
+#endif //TRENCHBROOM_BVHUTILS_H
@@ -0,0 +1,159 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AsyncEntityModelLoader.h"
+
+#include "Exceptions.h"
+#include "Assets/EntityModel.h"
+#include "IO/EntityModelLoader.h"
+
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#include <QString>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            class BufferingLogger : public Logger {
+            private:
+                std::vector<AsyncEntityModelLoader::LogMessage>& m_messages;
+            public:
+                explicit BufferingLogger(std::vector<AsyncEntityModelLoader::LogMessage>& messages) :
+                m_messages(messages) {}
+            private:
+                void doLog(const LogLevel level, const std::string& message) override {
+                    m_messages.push_back(AsyncEntityModelLoader::LogMessage{ level, message });
+                }
+
+                void doLog(const LogLevel level, const QString& message) override {
+                    doLog(level, message.toStdString());
+                }
+            };
+        }
+
+        AsyncEntityModelLoader::AsyncEntityModelLoader(WorkerPool& pool) :
+        m_pool(pool),
+        m_generation(0u),
+        m_activeJobs(0u) {}
+
+        AsyncEntityModelLoader::~AsyncEntityModelLoader() {
+            m_pool.cancel(this);
+        }
+
+        bool AsyncEntityModelLoader::load(const Path& path, const size_t frameIndex, const EntityModelLoader& loader) {
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                if (!m_requested.insert(path).second) {
+                    const auto it = std::find_if(std::begin(m_jobs), std::end(m_jobs), [&](const auto& job) { return job.path == path; });
+                    if (it != std::end(m_jobs) && !kdl::vec_contains(it->frameIndices, frameIndex)) {
+                        it->frameIndices.push_back(frameIndex);
+                    }
+                    return false;
+                }
+
+                m_jobs.push_back(Job{ path, { frameIndex }, &loader });
+            }
+
+            // every task runs the oldest job, so cancelled jobs leave surplus tasks which return immediately
+            m_pool.post(this, [this]() { runJob(); });
+            return true;
+        }
+
+        bool AsyncEntityModelLoader::requested(const Path& path) const {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            return m_requested.count(path) > 0u;
+        }
+
+        void AsyncEntityModelLoader::cancel() {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            ++m_generation;
+            m_jobs.clear();
+            m_jobDone.wait(lock, [&]() { return m_activeJobs == 0u; });
+            m_results.clear();
+            m_requested.clear();
+        }
+
+        std::vector<AsyncEntityModelLoader::Result> AsyncEntityModelLoader::takeResults() {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+
+            auto results = std::move(m_results);
+            m_results.clear();
+
+            for (const auto& result : results) {
+                m_requested.erase(result.path);
+            }
+
+            return results;
+        }
+
+        bool AsyncEntityModelLoader::idle() const {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            return m_jobs.empty() && m_activeJobs == 0u && m_results.empty();
+        }
+
+        void AsyncEntityModelLoader::wait() const {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            m_jobDone.wait(lock, [&]() { return m_jobs.empty() && m_activeJobs == 0u; });
+        }
+
+        void AsyncEntityModelLoader::runJob() {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            if (m_jobs.empty()) {
+                return;
+            }
+
+            auto job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            const auto generation = m_generation;
+            ++m_activeJobs;
+
+            lock.unlock();
+            auto result = Result{ job.path, nullptr, {} };
+            BufferingLogger logger(result.messages);
+            try {
+                result.model = job.loader->initializeModel(job.path, logger);
+                for (const auto frameIndex : job.frameIndices) {
+                    const auto* frame = result.model != nullptr ? result.model->frame(frameIndex) : nullptr;
+                    if (frame != nullptr && !frame->loaded()) {
+                        try {
+                            job.loader->loadFrame(job.path, frameIndex, *result.model, logger);
+                        } catch (const Exception& e) {
+                            logger.error() << e.what();
+                        }
+                    }
+                }
+            } catch (const std::exception& e) {
+                result.model = nullptr;
+                logger.error() << e.what();
+            }
+            lock.lock();
+
+            --m_activeJobs;
+            if (generation == m_generation) {
+                m_results.push_back(std::move(result));
+            }
+            m_jobDone.notify_all();
+        }
+    }
+}
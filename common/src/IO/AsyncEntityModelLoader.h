@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_AsyncEntityModelLoader
+#define TrenchBroom_AsyncEntityModelLoader
+
+#include "Logger.h"
+#include "Macros.h"
+#include "Assets/Asset_Forward.h"
+#include "IO/IO_Forward.h"
+#include "IO/Path.h"
+#include "IO/WorkerPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Loads entity models on the given worker pool. The loaded models are collected and must be fetched by
+         * calling takeResults.
+         *
+         * Every model is only loaded once until its result is taken, no matter how often it is requested. Requesting
+         * another frame of a model whose loading has not started yet adds the frame to the pending request.
+         *
+         * The worker threads must not log to the application's logger, so the messages logged while loading a model
+         * are collected and returned with the model.
+         */
+        class AsyncEntityModelLoader {
+        public:
+            struct LogMessage {
+                LogLevel level;
+                std::string message;
+            };
+
+            struct Result {
+                Path path;
+                /**
+                 * The loaded model, or nullptr if the model could not be loaded.
+                 */
+                std::unique_ptr<Assets::EntityModel> model;
+                std::vector<LogMessage> messages;
+            };
+        private:
+            struct Job {
+                Path path;
+                std::vector<size_t> frameIndices;
+                const EntityModelLoader* loader;
+            };
+
+            WorkerPool& m_pool;
+
+            mutable std::mutex m_mutex;
+            mutable std::condition_variable m_jobDone;
+
+            std::deque<Job> m_jobs;
+            std::vector<Result> m_results;
+
+            /**
+             * The paths of all models which were requested and whose results have not been taken yet.
+             */
+            std::set<Path> m_requested;
+
+            /**
+             * Incremented by cancel. The results of jobs which were started before the last call to cancel are
+             * discarded.
+             */
+            size_t m_generation;
+            size_t m_activeJobs;
+        public:
+            explicit AsyncEntityModelLoader(WorkerPool& pool = WorkerPool::instance());
+            ~AsyncEntityModelLoader();
+
+            /**
+             * Schedules the model with the given path for loading by the given loader, and the frame with the given
+             * index for loading once the model is loaded. Does nothing if the model has already been requested and its
+             * result has not been taken yet, except for adding the frame to the request if loading has not started.
+             *
+             * @param path the path of the model to load
+             * @param frameIndex the index of the frame to load
+             * @param loader the loader, must be safe to use concurrently and must remain valid until cancel is called
+             * @return true if the model was not requested before and false otherwise
+             */
+            bool load(const Path& path, size_t frameIndex, const EntityModelLoader& loader);
+
+            /**
+             * Indicates whether the model with the given path has been requested and its result has not been taken
+             * yet.
+             */
+            bool requested(const Path& path) const;
+
+            /**
+             * Discards all pending jobs and results and waits until all running jobs are done.
+             */
+            void cancel();
+
+            /**
+             * Returns the models which have been loaded since the last call to this function.
+             */
+            std::vector<Result> takeResults();
+
+            /**
+             * Indicates whether there is neither any pending work nor any result which has not been taken yet.
+             */
+            bool idle() const;
+
+            /**
+             * Blocks until all pending jobs are done.
+             */
+            void wait() const;
+        private:
+            void runJob();
+
+            deleteCopyAndMove(AsyncEntityModelLoader)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_AsyncEntityModelLoader) */
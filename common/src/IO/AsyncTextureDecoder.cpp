@@ -0,0 +1,145 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AsyncTextureDecoder.h"
+
+#include "Ensure.h"
+#include "Assets/Texture.h"
+#include "IO/TextureReader.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace IO {
+        AsyncTextureDecoder::AsyncTextureDecoder(WorkerPool& pool) :
+        m_pool(pool),
+        m_nextBatch(0u),
+        m_activeJobs(0u) {}
+
+        AsyncTextureDecoder::~AsyncTextureDecoder() {
+            m_pool.cancel(this);
+        }
+
+        void AsyncTextureDecoder::decode(const Assets::TextureCollection* collection, std::vector<DeferredTexture> requests, std::shared_ptr<const TextureReader> reader) {
+            ensure(collection != nullptr, "collection is null");
+            ensure(reader != nullptr, "reader is null");
+
+            if (requests.empty()) {
+                return;
+            }
+
+            const auto jobCount = requests.size();
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+
+                auto it = m_batches.find(collection);
+                if (it == std::end(m_batches)) {
+                    it = m_batches.emplace(collection, m_nextBatch++).first;
+                }
+                const auto batch = it->second;
+
+                for (auto& request : requests) {
+                    m_jobs.push_back(Job{ batch, collection, std::move(request), reader });
+                }
+            }
+
+            // every task runs the oldest job, so cancelled jobs leave surplus tasks which return immediately
+            for (size_t i = 0u; i < jobCount; ++i) {
+                m_pool.post(this, [this]() { runJob(); });
+            }
+        }
+
+        void AsyncTextureDecoder::cancel(const Assets::TextureCollection* collection) {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            if (m_batches.erase(collection) == 0u) {
+                return;
+            }
+
+            m_jobs.erase(std::remove_if(std::begin(m_jobs), std::end(m_jobs),
+                                        [&](const auto& job) { return job.collection == collection; }),
+                         std::end(m_jobs));
+            m_results.erase(std::remove_if(std::begin(m_results), std::end(m_results),
+                                           [&](const auto& result) { return result.collection == collection; }),
+                            std::end(m_results));
+            m_jobDone.notify_all();
+        }
+
+        std::vector<AsyncTextureDecoder::Result> AsyncTextureDecoder::takeResults() {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+
+            std::vector<Result> results;
+            results.reserve(m_results.size());
+            for (auto& pending : m_results) {
+                results.push_back(std::move(pending.result));
+            }
+            m_results.clear();
+
+            // forget about collections that have no more pending work
+            if (m_jobs.empty() && m_activeJobs == 0u) {
+                m_batches.clear();
+            }
+
+            return results;
+        }
+
+        bool AsyncTextureDecoder::idle() const {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            return m_jobs.empty() && m_activeJobs == 0u && m_results.empty();
+        }
+
+        void AsyncTextureDecoder::wait() const {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            m_jobDone.wait(lock, [&]() { return m_jobs.empty() && m_activeJobs == 0u; });
+        }
+
+        void AsyncTextureDecoder::runJob() {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            if (m_jobs.empty()) {
+                return;
+            }
+
+            auto job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_activeJobs;
+
+            lock.unlock();
+            std::unique_ptr<Assets::Texture> decoded;
+            std::string error;
+            try {
+                decoded.reset(job.reader->readTexture(job.request.file));
+                if (decoded == nullptr) {
+                    error = "Unknown texture format";
+                }
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            lock.lock();
+
+            --m_activeJobs;
+            const auto it = m_batches.find(job.collection);
+            if (it != std::end(m_batches) && it->second == job.batch) {
+                m_results.push_back(PendingResult{ job.collection, Result{ job.request.texture, std::move(decoded), std::move(error) } });
+            }
+            m_jobDone.notify_all();
+        }
+    }
+}
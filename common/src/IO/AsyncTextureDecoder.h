@@ -0,0 +1,140 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_AsyncTextureDecoder
+#define TrenchBroom_AsyncTextureDecoder
+
+#include "Macros.h"
+#include "Assets/Asset_Forward.h"
+#include "IO/IO_Forward.h"
+#include "IO/WorkerPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * A texture whose pixel data has not been decoded yet, together with the file it must be decoded from.
+         */
+        struct DeferredTexture {
+            Assets::Texture* texture;
+            std::shared_ptr<File> file;
+        };
+
+        /**
+         * Decodes the pixel data of deferred textures on the given worker pool. The decoded textures are collected
+         * and must be fetched by calling takeResults on the thread that owns the deferred textures, which can then
+         * pass the pixel data to them using Assets::Texture::takeBuffers. Textures that cannot be decoded are returned
+         * with an error message, which the worker threads cannot log themselves.
+         *
+         * The deferred textures are never accessed by the worker threads, so they can be used while they are being
+         * decoded. Before a texture collection is deleted, its pending work must be cancelled by calling cancel.
+         */
+        class AsyncTextureDecoder {
+        public:
+            struct Result {
+                Assets::Texture* texture;
+                /**
+                 * The decoded texture, or nullptr if the texture could not be decoded.
+                 */
+                std::unique_ptr<Assets::Texture> decoded;
+                /**
+                 * Describes why the texture could not be decoded, empty if it was decoded.
+                 */
+                std::string error;
+            };
+        private:
+            struct Job {
+                size_t batch;
+                const Assets::TextureCollection* collection;
+                DeferredTexture request;
+                std::shared_ptr<const TextureReader> reader;
+            };
+
+            struct PendingResult {
+                const Assets::TextureCollection* collection;
+                Result result;
+            };
+
+            WorkerPool& m_pool;
+
+            mutable std::mutex m_mutex;
+            mutable std::condition_variable m_jobDone;
+
+            std::deque<Job> m_jobs;
+            std::vector<PendingResult> m_results;
+
+            /**
+             * Maps each collection with pending work to the batch its work belongs to. The results of jobs whose
+             * batch is no longer current are discarded when the jobs are done.
+             */
+            std::map<const Assets::TextureCollection*, size_t> m_batches;
+            size_t m_nextBatch;
+            size_t m_activeJobs;
+        public:
+            explicit AsyncTextureDecoder(WorkerPool& pool = WorkerPool::instance());
+            ~AsyncTextureDecoder();
+
+            /**
+             * Schedules the given deferred textures of the given collection for decoding by the given reader.
+             *
+             * @param collection the collection which the deferred textures belong to
+             * @param requests the deferred textures
+             * @param reader the reader to decode the textures with, must be safe to use concurrently
+             */
+            void decode(const Assets::TextureCollection* collection, std::vector<DeferredTexture> requests, std::shared_ptr<const TextureReader> reader);
+
+            /**
+             * Discards all pending jobs and results for the given collection. Jobs for the collection that are
+             * currently running will complete, but their results are discarded.
+             *
+             * @param collection the collection
+             */
+            void cancel(const Assets::TextureCollection* collection);
+
+            /**
+             * Returns the textures which have been decoded since the last call to this function.
+             */
+            std::vector<Result> takeResults();
+
+            /**
+             * Indicates whether there is neither any pending work nor any result which has not been taken yet.
+             */
+            bool idle() const;
+
+            /**
+             * Blocks until all pending jobs are done.
+             */
+            void wait() const;
+        private:
+            void runJob();
+
+            deleteCopyAndMove(AsyncTextureDecoder)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_AsyncTextureDecoder) */
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BinaryData.h"
+
+#include "IO/Reader.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace BinaryData {
+            static const uint64_t FnvOffsetBasis = 14695981039346656037ull;
+            static const uint64_t FnvPrime = 1099511628211ull;
+
+            uint64_t hash(const char* begin, const char* end) {
+                auto result = FnvOffsetBasis;
+
+                auto* cur = begin;
+                for (; cur + sizeof(uint64_t) <= end; cur += sizeof(uint64_t)) {
+                    uint64_t word;
+                    std::memcpy(&word, cur, sizeof(uint64_t));
+                    result = (result ^ word) * FnvPrime;
+                    result ^= result >> 32;
+                }
+                for (; cur < end; ++cur) {
+                    result = (result ^ static_cast<uint64_t>(static_cast<unsigned char>(*cur))) * FnvPrime;
+                }
+                return result;
+            }
+
+            void putSize(std::string& data, const size_t value) {
+                put(data, static_cast<uint64_t>(value));
+            }
+
+            void putSize(std::ostream& stream, const size_t value) {
+                put(stream, static_cast<uint64_t>(value));
+            }
+
+            void putString(std::string& data, const std::string& str) {
+                put(data, static_cast<uint32_t>(str.size()));
+                data.append(str);
+            }
+
+            void putString(std::ostream& stream, const std::string& str) {
+                put(stream, static_cast<uint32_t>(str.size()));
+                stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+            }
+
+            size_t getSize(Reader& reader) {
+                return reader.read<uint64_t, size_t>();
+            }
+
+            size_t getSize(std::istream& stream) {
+                return static_cast<size_t>(get<uint64_t>(stream));
+            }
+
+            std::string getString(Reader& reader) {
+                const auto size = reader.read<uint32_t, size_t>();
+                auto result = std::string(size, '\0');
+                reader.read(result.data(), size);
+                return result;
+            }
+
+            std::string getString(std::istream& stream) {
+                const auto size = static_cast<size_t>(get<uint32_t>(stream));
+                auto result = std::string(size, '\0');
+                stream.read(result.data(), static_cast<std::streamsize>(size));
+                return result;
+            }
+        }
+    }
+}
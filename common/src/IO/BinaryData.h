@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_BinaryData
+#define TrenchBroom_BinaryData
+
+#include "IO/IO_Forward.h"
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Functions for encoding and decoding the binary files which TrenchBroom writes for its own use, such as
+         * caches, indices and spilled undo snapshots. Values are stored in the host's byte order, so these files are
+         * not meant to be shared between machines. Sizes are stored as 64 bit and string lengths as 32 bit integers.
+         */
+        namespace BinaryData {
+            /**
+             * Hashes the given range eight bytes at a time. This is not a cryptographic hash, it only has to detect
+             * changes to a file quickly enough to be negligible compared to parsing or decoding the file.
+             */
+            uint64_t hash(const char* begin, const char* end);
+
+            template <typename T>
+            void put(std::string& data, const T value) {
+                char bytes[sizeof(T)];
+                std::memcpy(bytes, &value, sizeof(T));
+                data.append(bytes, sizeof(T));
+            }
+
+            template <typename T>
+            void put(std::ostream& stream, const T value) {
+                stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            void putSize(std::string& data, size_t value);
+            void putSize(std::ostream& stream, size_t value);
+            void putString(std::string& data, const std::string& str);
+            void putString(std::ostream& stream, const std::string& str);
+
+            template <typename T>
+            T get(std::istream& stream) {
+                T value;
+                stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+                return value;
+            }
+
+            size_t getSize(Reader& reader);
+            size_t getSize(std::istream& stream);
+            std::string getString(Reader& reader);
+            std::string getString(std::istream& stream);
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_BinaryData) */
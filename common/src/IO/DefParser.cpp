@@ -207,7 +207,7 @@ namespace TrenchBroom {
                 token = expect(status, DefToken::OParenthesis | DefToken::Word, m_tokenizer.peekToken());
                 if (token.hasType(DefToken::OParenthesis)) {
                     classInfo.setSize(parseBounds(status));
-                } else if (token.data() == "?") {
+                } else if (token.view() == "?") {
                     m_tokenizer.nextToken();
                 }
 
@@ -270,7 +270,7 @@ namespace TrenchBroom {
             if (token.type() != DefToken::Word)
                 return false;
 
-            std::string typeName = token.data();
+            const auto typeName = token.view();
             if (typeName == "default") {
                 // ignore these attributes
                 parseDefaultAttribute(status);
@@ -26,11 +26,14 @@
 
 #include <kdl/string_compare.h>
 
+#include <cstdio>
 #include <fstream>
+#include <memory>
 #include <string>
 
 #include <QDir>
 #include <QFileInfo>
+#include <QSaveFile>
 
 namespace TrenchBroom {
     namespace IO {
@@ -138,7 +141,13 @@ namespace TrenchBroom {
                     throw FileNotFoundException(fixedPath.asString());
                 }
 
-                return std::make_shared<CFile>(fixedPath);
+                const CFile file(fixedPath);
+                const auto size = file.size();
+                auto buffer = std::make_unique<char[]>(size);
+                if (std::fread(buffer.get(), 1, size, file.file()) != size) {
+                    throw FileSystemException("Cannot read file " + fixedPath.asString());
+                }
+                return std::make_shared<OwningBufferFile>(fixedPath, std::move(buffer), size);
             }
 
             Path getCurrentWorkingDir() {
@@ -168,6 +177,45 @@ namespace TrenchBroom {
                 stream  << contents;
             }
 
+            int64_t modificationTime(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                const auto fileInfo = QFileInfo(pathAsQString(fixedPath));
+                if (!fileInfo.exists()) {
+                    throw FileSystemException("File not found: '" + fixedPath.asString() + "'");
+                }
+                return static_cast<int64_t>(fileInfo.lastModified().toMSecsSinceEpoch());
+            }
+
+            uint64_t fileSize(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                const auto fileInfo = QFileInfo(pathAsQString(fixedPath));
+                if (!fileInfo.exists()) {
+                    throw FileSystemException("File not found: '" + fixedPath.asString() + "'");
+                }
+                return static_cast<uint64_t>(fileInfo.size());
+            }
+
+            void writeFileAtomically(const Path& path, const std::string& contents) {
+                const Path fixedPath = fixPath(path);
+                ensureDirectoryExists(fixedPath.deleteLastComponent());
+
+                // QSaveFile writes to a uniquely named temporary file in the same directory and renames it over the
+                // destination on commit, which replaces the destination without removing it first
+                QSaveFile file(pathAsQString(fixedPath));
+                if (!file.open(QIODevice::WriteOnly)) {
+                    throw FileSystemException("Cannot open file: " + fixedPath.asString() + ": " + file.errorString().toStdString());
+                }
+
+                const auto size = static_cast<qint64>(contents.size());
+                if (file.write(contents.data(), size) != size) {
+                    throw FileSystemException("Cannot write file: " + fixedPath.asString() + ": " + file.errorString().toStdString());
+                }
+
+                if (!file.commit()) {
+                    throw FileSystemException("Cannot write file: " + fixedPath.asString() + ": " + file.errorString().toStdString());
+                }
+            }
+
             bool createDirectoryHelper(const Path& path);
 
             void createDirectory(const Path& path) {
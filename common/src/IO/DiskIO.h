@@ -23,6 +23,7 @@
 #include "IO/IO_Forward.h"
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -37,6 +38,15 @@ namespace TrenchBroom {
             bool fileExists(const Path& path);
 
             std::vector<Path> getDirectoryContents(const Path& path);
+
+            /**
+             * Reads the file at the given path into memory and closes it again, so that the file can be changed or
+             * deleted while the returned file is in use. Large read-only files such as archives should be opened as a
+             * MappedFile instead.
+             *
+             * @throw FileNotFoundException if the file does not exist
+             * @throw FileSystemException if the file cannot be read
+             */
             std::shared_ptr<File> openFile(const Path& path);
             Path getCurrentWorkingDir();
 
@@ -69,7 +79,30 @@ namespace TrenchBroom {
 
             std::vector<Path> findItemsRecursively(const Path& path);
 
+            /**
+             * Returns the time at which the file at the given path was last modified, in milliseconds since the epoch.
+             *
+             * @throw FileSystemException if the file does not exist
+             */
+            int64_t modificationTime(const Path& path);
+
+            /**
+             * Returns the size of the file at the given path in bytes.
+             *
+             * @throw FileSystemException if the file does not exist
+             */
+            uint64_t fileSize(const Path& path);
+
             void createFile(const Path& path, const std::string& contents);
+
+            /**
+             * Writes the given contents to a uniquely named temporary file next to the given path and then renames it
+             * over the given path, so that concurrent readers either see the previous file or the complete new file.
+             * Creates the parent directory if necessary.
+             *
+             * @throw FileSystemException if the file cannot be written
+             */
+            void writeFileAtomically(const Path& path, const std::string& contents);
             void createDirectory(const Path& path);
             void ensureDirectoryExists(const Path& path);
             void deleteFile(const Path& path);
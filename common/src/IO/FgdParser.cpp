@@ -223,7 +223,7 @@ namespace TrenchBroom {
                 return;
             }
 
-            if (kdl::ci::str_is_equal(token.data(), "@include")) {
+            if (kdl::ci::str_is_equal(token.view(), "@include")) {
                 const auto includedDefinitions = parseInclude(status);
                 kdl::vec_append(definitions, includedDefinitions);
             } else {
@@ -238,7 +238,7 @@ namespace TrenchBroom {
         Assets::EntityDefinition* FgdParser::parseDefinition(ParserStatus& status) {
             auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
 
-            const auto classname = token.data();
+            const auto classname = token.view();
             if (kdl::ci::str_is_equal(classname, "@SolidClass")) {
                 return parseSolidClass(status);
             } else if (kdl::ci::str_is_equal(classname, "@PointClass")) {
@@ -251,7 +251,7 @@ namespace TrenchBroom {
                 skipMainClass(status);
                 return nullptr;
             } else {
-                const auto msg = "Unknown entity definition class '" + classname + "'";
+                const auto msg = "Unknown entity definition class '" + std::string(classname) + "'";
                 status.error(token.line(), token.column(), msg);
                 throw ParserException(token.line(), token.column(), msg);
             }
@@ -288,7 +288,7 @@ namespace TrenchBroom {
             EntityDefinitionClassInfo classInfo(token.line(), token.column(), m_defaultEntityColor);
 
             while (token.type() == FgdToken::Word) {
-                const auto typeName = token.data();
+                const auto typeName = token.view();
                 if (kdl::ci::str_is_equal(typeName, "base")) {
                     if (!superClasses.empty()) {
                         status.warn(token.line(), token.column(), "Found multiple base attributes");
@@ -312,7 +312,7 @@ namespace TrenchBroom {
                     }
                     classInfo.setModelDefinition(parseModel(status));
                 } else {
-                    status.warn(token.line(), token.column(), "Unknown entity definition header attribute '" + typeName + "'");
+                    status.warn(token.line(), token.column(), "Unknown entity definition header attribute '" + std::string(typeName) + "'");
                     skipClassAttribute(status);
                 }
                 token = expect(status, FgdToken::Equality | FgdToken::Word, m_tokenizer.nextToken());
@@ -422,7 +422,7 @@ namespace TrenchBroom {
                 expect(status, FgdToken::OParenthesis, m_tokenizer.nextToken());
                 token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
 
-                const auto typeName = token.data();
+                const auto typeName = token.view();
                 token = expect(status, FgdToken::CParenthesis, m_tokenizer.nextToken());
 
                 if (kdl::ci::str_is_equal(typeName, "target_source")) {
@@ -560,7 +560,7 @@ namespace TrenchBroom {
 
         bool FgdParser::parseReadOnlyFlag(ParserStatus& /* status */) {
             auto token = m_tokenizer.peekToken();
-            if (token.hasType(FgdToken::Word) && token.data() == "readonly") {
+            if (token.hasType(FgdToken::Word) && token.view() == "readonly") {
                 m_tokenizer.nextToken();
                 return true;
             } else {
@@ -27,6 +27,8 @@
 #include <cstdio>
 #include <memory>
 
+class QFile;
+
 namespace TrenchBroom {
     namespace IO {
         /**
@@ -135,6 +137,47 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is opened and
+         * mapped in the constructor and unmapped and closed in the destructor.
+         *
+         * Readers for this file and for file views into it access the mapped memory directly, so the contents are
+         * never copied into a separate buffer and only the pages that are actually read become resident.
+         *
+         * Only use this for large files which are not modified while they are open, such as archives. The file stays
+         * open as long as it is mapped, which prevents other programs from replacing it on some platforms, and
+         * accessing the mapped memory after another program truncated the file crashes.
+         */
+        class MappedFile : public File {
+        private:
+            std::unique_ptr<QFile> m_file;
+            const char* m_begin;
+            const char* m_end;
+        public:
+            /**
+             * Creates a new file with the given path and maps the file into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            Reader reader() const override;
+            size_t size() const override;
+
+            /**
+             * Returns the start of the mapped memory.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the mapped memory (position after the last byte).
+             */
+            const char* end() const;
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
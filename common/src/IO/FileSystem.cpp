@@ -22,6 +22,7 @@
 #include "Exceptions.h"
 #include "IO/FileMatcher.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <string>
@@ -143,6 +144,27 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::shared_ptr<File>> FileSystem::openFiles(const std::vector<Path>& paths, std::vector<std::string>& errors) const {
+            auto result = std::vector<std::shared_ptr<File>>(paths.size());
+            auto messages = std::vector<std::string>(paths.size());
+
+            kdl::parallel_for(paths.size(), [&](const size_t i) {
+                try {
+                    result[i] = openFile(paths[i]);
+                } catch (const std::exception& e) {
+                    messages[i] = e.what();
+                }
+            });
+
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (result[i] == nullptr) {
+                    errors.push_back(std::move(messages[i]));
+                }
+            }
+
+            return result;
+        }
+
         Path FileSystem::_makeAbsolute(const Path& path) const {
             if (doFileExists(path) || doDirectoryExists(path)) {
                 // If the file is present in this file system, make it absolute here.
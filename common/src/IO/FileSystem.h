@@ -113,6 +113,22 @@ namespace TrenchBroom {
 
             std::vector<Path> getDirectoryContents(const Path& directoryPath) const;
             std::shared_ptr<File> openFile(const Path& path) const;
+
+            /**
+             * Opens the files at the given paths. The files are opened concurrently, which is considerably faster than
+             * opening them one by one if they must be decompressed, e.g. when they are located in zip archives.
+             *
+             * If a file cannot be opened, the corresponding element of the returned vector is null and an error
+             * message is appended to the given vector of errors. The error messages are appended in the order of the
+             * given paths.
+             *
+             * All file systems must support opening files concurrently.
+             *
+             * @param paths the paths of the files to open
+             * @param errors collects the error messages of files that could not be opened
+             * @return the opened files in the order of the given paths
+             */
+            std::vector<std::shared_ptr<File>> openFiles(const std::vector<Path>& paths, std::vector<std::string>& errors) const;
         private: // private API to be used for chaining, avoids multiple checks of parameters
             bool _canMakeAbsolute(const Path& path) const;
             Path _makeAbsolute(const Path& path) const;
@@ -24,15 +24,22 @@ namespace TrenchBroom {
     namespace IO {
         class File;
         class CFile;
+        class MappedFile;
         class Path;
 
         class TextureCollectionLoader;
         class EntityDefinitionLoader;
         class EntityModelLoader;
+        class AsyncEntityModelLoader;
         class TextureLoader;
         class TextureReader;
+        class TextureCache;
+        class AsyncTextureDecoder;
+        struct DeferredTexture;
 
         class ParserStatus;
+        class MapCacheReader;
+        class MapCacheWriter;
 
         class FileSystem;
         class WritableDiskFileSystem;
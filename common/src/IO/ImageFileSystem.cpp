@@ -23,7 +23,9 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 
-#include <cassert>
+#include <kdl/string_format.h>
+
+#include <algorithm>
 #include <memory>
 
 namespace TrenchBroom {
@@ -53,79 +55,14 @@ namespace TrenchBroom {
         ImageFileSystemBase::Directory::Directory(const Path& path) :
         m_path(path) {}
 
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::shared_ptr<File> file) {
-            addFile(path, std::make_unique<SimpleFileEntry>(file));
-        }
-
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
-            ensure(file != nullptr, "file is null");
+        void ImageFileSystemBase::Directory::addFile(const Path& path, std::unique_ptr<FileEntry> file, DirectoryIndex& directoryIndex) {
             const auto filename = path.lastComponent();
             if (path.length() == 1) {
                 // silently overwrite duplicates, the latest entries win
                 m_files[filename] = std::move(file);
             } else {
-                auto& dir = findOrCreateDirectory(path.deleteLastComponent());
-                dir.addFile(filename, std::move(file));
-            }
-        }
-
-        bool ImageFileSystemBase::Directory::directoryExists(const Path& path) const {
-            if (path.isEmpty()) {
-                return true;
-            }
-
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->directoryExists(path.deleteFirstComponent());
-            }
-        }
-
-        bool ImageFileSystemBase::Directory::fileExists(const Path& path) const {
-            if (path.length() == 1) {
-                return m_files.count(path) > 0;
-            }
-
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->fileExists(path.deleteFirstComponent());
-            }
-        }
-
-        const ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findDirectory(const Path& path) const {
-            if (path.isEmpty()) {
-                return *this;
-            }
-
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
-            } else {
-                return it->second->findDirectory(path.deleteFirstComponent());
-            }
-        }
-
-        const ImageFileSystemBase::FileEntry& ImageFileSystemBase::Directory::findFile(const Path& path) const {
-            assert(!path.isEmpty());
-
-            const auto name = path.firstComponent();
-            if (path.length() == 1) {
-                auto it = m_files.find(name);
-                if (it == std::end(m_files)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return *it->second;
-                }
-            } else {
-                auto it = m_directories.find(name);
-                if (it == std::end(m_directories)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return it->second->findFile(path.deleteFirstComponent());
-                }
+                auto& dir = findOrCreateDirectory(path.deleteLastComponent(), directoryIndex);
+                dir.addFile(filename, std::move(file), directoryIndex);
             }
         }
 
@@ -143,7 +80,7 @@ namespace TrenchBroom {
             return contents;
         }
 
-        ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path) {
+        ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path, DirectoryIndex& directoryIndex) {
             if (path.isEmpty()) {
                 return *this;
             }
@@ -152,8 +89,9 @@ namespace TrenchBroom {
             auto it = m_directories.lower_bound(name);
             if (it == std::end(m_directories) || name != it->first) {
                 it = m_directories.insert(it, std::make_pair(name, new Directory(m_path + Path(name))));
+                directoryIndex[indexKey(it->second->m_path)] = it->second.get();
             }
-            return it->second->findOrCreateDirectory(path.deleteFirstComponent());
+            return it->second->findOrCreateDirectory(path.deleteFirstComponent(), directoryIndex);
         }
 
         ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
@@ -165,6 +103,10 @@ namespace TrenchBroom {
         ImageFileSystemBase::~ImageFileSystemBase() = default;
 
         void ImageFileSystemBase::initialize() {
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
+            m_directoryIndex[""] = &m_root;
+
             try {
                 doReadDirectory();
             } catch (const std::exception& e) {
@@ -172,35 +114,70 @@ namespace TrenchBroom {
             }
         }
 
+        void ImageFileSystemBase::addFile(const Path& path, std::shared_ptr<File> file) {
+            addFile(path, std::make_unique<SimpleFileEntry>(std::move(file)));
+        }
+
+        void ImageFileSystemBase::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
+            ensure(file != nullptr, "file is null");
+            const auto* entry = file.get();
+            m_root.addFile(path, std::move(file), m_directoryIndex);
+            m_fileIndex[indexKey(path)] = entry;
+        }
+
         void ImageFileSystemBase::reload() {
             m_root = Directory(Path());
             initialize();
         }
 
+        std::string ImageFileSystemBase::indexKey(const Path& path) {
+            const auto& components = path.components();
+            const auto needsResolving = std::any_of(std::begin(components), std::end(components), [](const auto& component) {
+                return component == "." || component == "..";
+            });
+            if (needsResolving) {
+                return indexKey(path.makeCanonical());
+            }
+
+            std::string key;
+            for (size_t i = 0; i < components.size(); ++i) {
+                if (i > 0) {
+                    key.push_back('/');
+                }
+                for (const auto c : components[i]) {
+                    key.push_back(kdl::str_to_lower(c));
+                }
+            }
+            return key;
+        }
+
         bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.directoryExists(searchPath);
+            return m_directoryIndex.count(indexKey(path)) > 0u;
         }
 
         bool ImageFileSystemBase::doFileExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.fileExists(searchPath);
+            return m_fileIndex.count(indexKey(path)) > 0u;
         }
 
         std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            const auto& directory = m_root.findDirectory(path);
-            return directory.contents();
+            const auto it = m_directoryIndex.find(indexKey(path));
+            if (it == std::end(m_directoryIndex)) {
+                throw FileSystemException("Path does not exist: '" + path.asString() + "'");
+            }
+            return it->second->contents();
         }
 
         std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.findFile(path).open();
+            const auto it = m_fileIndex.find(indexKey(path));
+            if (it == std::end(m_fileIndex)) {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
+            return it->second->open();
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
         ImageFileSystemBase(std::move(next), path),
-        m_file(std::make_shared<CFile>(path)) {
+        m_file(std::make_shared<MappedFile>(path)) {
             ensure(m_path.isAbsolute(), "path must be absolute");
         }
     }
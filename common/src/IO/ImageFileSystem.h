@@ -28,6 +28,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace IO {
@@ -63,6 +65,10 @@ namespace TrenchBroom {
                 virtual std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const = 0;
             };
 
+            class Directory;
+            using FileIndex = std::unordered_map<std::string, const FileEntry*>;
+            using DirectoryIndex = std::unordered_map<std::string, const Directory*>;
+
             class Directory {
             private:
                 using DirMap  = std::map<Path, std::unique_ptr<Directory>, Path::Less<kdl::ci::string_less>>;
@@ -74,33 +80,55 @@ namespace TrenchBroom {
             public:
                 explicit Directory(const Path& path);
 
-                void addFile(const Path& path, std::shared_ptr<File> file);
-                void addFile(const Path& path, std::unique_ptr<FileEntry> file);
-
-                bool directoryExists(const Path& path) const;
-                bool fileExists(const Path& path) const;
+                /**
+                 * Adds the given file at the given path relative to this directory, creating any missing
+                 * subdirectories. Created subdirectories are added to the given index.
+                 */
+                void addFile(const Path& path, std::unique_ptr<FileEntry> file, DirectoryIndex& directoryIndex);
 
-                const Directory& findDirectory(const Path& path) const;
-                const FileEntry& findFile(const Path& path) const;
                 std::vector<Path> contents() const;
             private:
-                Directory& findOrCreateDirectory(const Path& path);
+                Directory& findOrCreateDirectory(const Path& path, DirectoryIndex& directoryIndex);
             };
         protected:
             Path m_path;
+        private:
             Directory m_root;
+
+            /**
+             * Map the lower case, canonical paths of all files and directories to their entries so that lookups need
+             * neither descend the directory tree nor compare paths case insensitively. Kept up to date by addFile.
+             */
+            FileIndex m_fileIndex;
+            DirectoryIndex m_directoryIndex;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
             ~ImageFileSystemBase() override;
         protected:
             void initialize();
+
+            /**
+             * Adds the given file at the given path to this file system. Subclasses call this to populate the file
+             * system when reading their directory. If a file already exists at the given path, it is replaced.
+             *
+             * @param path the path of the file
+             * @param file the file to add
+             */
+            void addFile(const Path& path, std::shared_ptr<File> file);
+            void addFile(const Path& path, std::unique_ptr<FileEntry> file);
         public:
             /**
              * Reload this file system.
              */
             void reload();
         private:
+            /**
+             * Returns the key of the given path in the file and directory indices, which is its canonical form in
+             * lower case with its components separated by slashes.
+             */
+            static std::string indexKey(const Path& path);
+
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
 
@@ -112,7 +140,7 @@ namespace TrenchBroom {
 
         class ImageFileSystem : public ImageFileSystemBase {
         protected:
-            std::shared_ptr<CFile> m_file;
+            std::shared_ptr<MappedFile> m_file;
         protected:
             ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
         };
@@ -0,0 +1,379 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Logger.h"
+#include "IO/BinaryData.h"
+#include "IO/DiskIO.h"
+#include "IO/ParserStatus.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/EntityAttributes.h"
+
+#include <vecmath/vec.h>
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            const char Magic[4] = { 'T', 'B', 'M', 'C' };
+
+            // increment this whenever the layout of the cache file changes
+            const uint32_t Version = 2;
+
+            enum class Record : uint8_t {
+                BeginEntity = 1,
+                EndEntity   = 2,
+                BeginBrush  = 3,
+                EndBrush    = 4,
+                BrushFace   = 5,
+                Message     = 6
+            };
+
+            void putRecord(std::string& data, const Record record) {
+                BinaryData::put(data, static_cast<uint8_t>(record));
+            }
+
+            void putVec(std::string& data, const vm::vec3& vec) {
+                for (size_t i = 0; i < 3; ++i) {
+                    BinaryData::put(data, vec[i]);
+                }
+            }
+
+            vm::vec3 getVec(Reader& reader) {
+                return reader.readVec<double, 3>();
+            }
+
+            /**
+             * The logger of parser statuses which pass their messages elsewhere.
+             */
+            Logger& nullLogger() {
+                static NullLogger logger;
+                return logger;
+            }
+
+            /**
+             * Forwards the progress to another parser status, but discards all messages.
+             */
+            class DiscardMessagesStatus : public ParserStatus {
+            private:
+                ParserStatus& m_status;
+            public:
+                explicit DiscardMessagesStatus(ParserStatus& status) :
+                ParserStatus(nullLogger(), status.prefix()),
+                m_status(status) {}
+            private:
+                void doProgress(const double progress) override {
+                    m_status.progress(progress);
+                }
+
+                void doLog(const LogLevel /* level */, const std::string& /* str */) override {}
+            };
+        }
+
+        MapCacheKey::MapCacheKey(const uint64_t fileSize, const int64_t modificationTime, const uint64_t hash) :
+        m_fileSize(fileSize),
+        m_modificationTime(modificationTime),
+        m_hash(hash) {}
+
+        MapCacheKey MapCacheKey::compute(const Path& path, const char* begin, const char* end) {
+            const auto fileSize = static_cast<uint64_t>(end - begin);
+            return MapCacheKey(fileSize, Disk::modificationTime(path), BinaryData::hash(begin, end));
+        }
+
+        uint64_t MapCacheKey::fileSize() const {
+            return m_fileSize;
+        }
+
+        int64_t MapCacheKey::modificationTime() const {
+            return m_modificationTime;
+        }
+
+        uint64_t MapCacheKey::hash() const {
+            return m_hash;
+        }
+
+        bool operator==(const MapCacheKey& lhs, const MapCacheKey& rhs) {
+            return lhs.m_fileSize == rhs.m_fileSize &&
+                   lhs.m_modificationTime == rhs.m_modificationTime &&
+                   lhs.m_hash == rhs.m_hash;
+        }
+
+        bool operator!=(const MapCacheKey& lhs, const MapCacheKey& rhs) {
+            return !(lhs == rhs);
+        }
+
+        Path mapCachePath(const Path& mapPath) {
+            return mapPath.addExtension("tbcache");
+        }
+
+        MapCacheWriter::MapCacheWriter() :
+        m_format(Model::MapFormat::Unknown) {}
+
+        void MapCacheWriter::formatSet(const Model::MapFormat format) {
+            m_format = format;
+        }
+
+        void MapCacheWriter::beginEntity(const size_t line, const std::list<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes) {
+            putRecord(m_data, Record::BeginEntity);
+            BinaryData::putSize(m_data, line);
+            BinaryData::putSize(m_data, attributes.size());
+            for (const auto& attribute : attributes) {
+                BinaryData::putString(m_data, attribute.name());
+                BinaryData::putString(m_data, attribute.value());
+            }
+            writeExtraAttributes(extraAttributes);
+        }
+
+        void MapCacheWriter::endEntity(const size_t startLine, const size_t lineCount) {
+            putRecord(m_data, Record::EndEntity);
+            BinaryData::putSize(m_data, startLine);
+            BinaryData::putSize(m_data, lineCount);
+        }
+
+        void MapCacheWriter::beginBrush(const size_t line) {
+            putRecord(m_data, Record::BeginBrush);
+            BinaryData::putSize(m_data, line);
+        }
+
+        void MapCacheWriter::endBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+            putRecord(m_data, Record::EndBrush);
+            BinaryData::putSize(m_data, startLine);
+            BinaryData::putSize(m_data, lineCount);
+            writeExtraAttributes(extraAttributes);
+        }
+
+        void MapCacheWriter::brushFace(const size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY) {
+            putRecord(m_data, Record::BrushFace);
+            BinaryData::putSize(m_data, line);
+            putVec(m_data, point1);
+            putVec(m_data, point2);
+            putVec(m_data, point3);
+            putVec(m_data, texAxisX);
+            putVec(m_data, texAxisY);
+
+            BinaryData::putString(m_data, attribs.textureName());
+            BinaryData::put(m_data, attribs.xOffset());
+            BinaryData::put(m_data, attribs.yOffset());
+            BinaryData::put(m_data, attribs.xScale());
+            BinaryData::put(m_data, attribs.yScale());
+            BinaryData::put(m_data, attribs.rotation());
+            BinaryData::put(m_data, static_cast<int32_t>(attribs.surfaceContents()));
+            BinaryData::put(m_data, static_cast<int32_t>(attribs.surfaceFlags()));
+            BinaryData::put(m_data, attribs.surfaceValue());
+
+            const auto& color = attribs.color();
+            BinaryData::put(m_data, color.r());
+            BinaryData::put(m_data, color.g());
+            BinaryData::put(m_data, color.b());
+            BinaryData::put(m_data, color.a());
+        }
+
+        void MapCacheWriter::message(const LogLevel level, const std::string& message) {
+            putRecord(m_data, Record::Message);
+            BinaryData::put(m_data, static_cast<uint8_t>(level));
+            BinaryData::putString(m_data, message);
+        }
+
+        void MapCacheWriter::write(const Path& path, const MapCacheKey& key) const {
+            auto header = std::string(Magic, sizeof(Magic));
+            BinaryData::put(header, Version);
+            BinaryData::put(header, static_cast<uint32_t>(m_format));
+            BinaryData::put(header, key.fileSize());
+            BinaryData::put(header, key.modificationTime());
+            BinaryData::put(header, key.hash());
+
+            header.append(m_data);
+            Disk::writeFileAtomically(path, header);
+        }
+
+        void MapCacheWriter::writeExtraAttributes(const ExtraAttributes& extraAttributes) {
+            BinaryData::putSize(m_data, extraAttributes.size());
+            for (const auto& entry : extraAttributes) {
+                const auto& attribute = entry.second;
+                BinaryData::put(m_data, static_cast<uint8_t>(attribute.type()));
+                BinaryData::putString(m_data, attribute.name());
+                BinaryData::putString(m_data, attribute.strValue());
+                BinaryData::putSize(m_data, attribute.line());
+                BinaryData::putSize(m_data, attribute.column());
+            }
+        }
+
+        MapCacheRecordingStatus::MapCacheRecordingStatus(ParserStatus& status, MapCacheWriter& cacheWriter) :
+        ParserStatus(nullLogger(), status.prefix()),
+        m_status(status),
+        m_cacheWriter(cacheWriter) {}
+
+        void MapCacheRecordingStatus::doProgress(const double progress) {
+            m_status.progress(progress);
+        }
+
+        void MapCacheRecordingStatus::doLog(const LogLevel level, const std::string& str) {
+            m_cacheWriter.message(level, str);
+            m_status.logMessage(level, str);
+        }
+
+        MapCacheReader::MapCacheReader(Reader& reader, const MapCacheKey& key, const Model::MapFormat format) :
+        m_reader(reader),
+        m_format(format),
+        m_valid(readHeader(key, format)) {}
+
+        bool MapCacheReader::valid() const {
+            return m_valid;
+        }
+
+        void MapCacheReader::replay(MapParser& parser, ParserStatus& status) {
+            assert(m_valid);
+
+            // the messages logged by the parser were recorded along with the contents
+            DiscardMessagesStatus parserStatus(status);
+
+            // the recorded messages are only logged once the entire cache was replayed, since the caller falls back to
+            // parsing the map file if the cache turns out to be corrupt, and the messages would be logged twice then
+            std::vector<std::pair<LogLevel, std::string>> messages;
+
+            parser.formatSet(m_format);
+            while (!m_reader.eof()) {
+                const auto record = static_cast<Record>(m_reader.read<uint8_t, uint8_t>());
+                switch (record) {
+                    case Record::BeginEntity: {
+                        const auto line = BinaryData::getSize(m_reader);
+                        const auto attributeCount = BinaryData::getSize(m_reader);
+
+                        std::list<Model::EntityAttribute> attributes;
+                        for (size_t i = 0; i < attributeCount; ++i) {
+                            auto name = BinaryData::getString(m_reader);
+                            auto value = BinaryData::getString(m_reader);
+                            attributes.push_back(Model::EntityAttribute(name, value, nullptr));
+                        }
+                        const auto extraAttributes = readExtraAttributes();
+                        parser.beginEntity(line, attributes, extraAttributes, parserStatus);
+                        break;
+                    }
+                    case Record::EndEntity: {
+                        const auto startLine = BinaryData::getSize(m_reader);
+                        const auto lineCount = BinaryData::getSize(m_reader);
+                        parser.endEntity(startLine, lineCount, parserStatus);
+                        status.progress(static_cast<double>(m_reader.position()) / static_cast<double>(m_reader.size()));
+                        break;
+                    }
+                    case Record::BeginBrush: {
+                        const auto line = BinaryData::getSize(m_reader);
+                        parser.beginBrush(line, parserStatus);
+                        break;
+                    }
+                    case Record::EndBrush: {
+                        const auto startLine = BinaryData::getSize(m_reader);
+                        const auto lineCount = BinaryData::getSize(m_reader);
+                        const auto extraAttributes = readExtraAttributes();
+                        parser.endBrush(startLine, lineCount, extraAttributes, parserStatus);
+                        break;
+                    }
+                    case Record::BrushFace: {
+                        const auto line = BinaryData::getSize(m_reader);
+                        const auto point1 = getVec(m_reader);
+                        const auto point2 = getVec(m_reader);
+                        const auto point3 = getVec(m_reader);
+                        const auto texAxisX = getVec(m_reader);
+                        const auto texAxisY = getVec(m_reader);
+
+                        Model::BrushFaceAttributes attribs(BinaryData::getString(m_reader));
+                        attribs.setXOffset(m_reader.readFloat<float>());
+                        attribs.setYOffset(m_reader.readFloat<float>());
+                        attribs.setXScale(m_reader.readFloat<float>());
+                        attribs.setYScale(m_reader.readFloat<float>());
+                        attribs.setRotation(m_reader.readFloat<float>());
+                        attribs.setSurfaceContents(m_reader.readInt<int32_t>());
+                        attribs.setSurfaceFlags(m_reader.readInt<int32_t>());
+                        attribs.setSurfaceValue(m_reader.readFloat<float>());
+
+                        const auto r = m_reader.readFloat<float>();
+                        const auto g = m_reader.readFloat<float>();
+                        const auto b = m_reader.readFloat<float>();
+                        const auto a = m_reader.readFloat<float>();
+                        attribs.setColor(Color(r, g, b, a));
+
+                        parser.brushFace(line, point1, point2, point3, attribs, texAxisX, texAxisY, parserStatus);
+                        break;
+                    }
+                    case Record::Message: {
+                        const auto level = static_cast<LogLevel>(m_reader.read<uint8_t, int>());
+                        auto message = BinaryData::getString(m_reader);
+                        messages.emplace_back(level, std::move(message));
+                        break;
+                    }
+                    default:
+                        throw ParserException("Invalid record in map cache");
+                }
+            }
+
+            for (const auto& [level, message] : messages) {
+                status.logMessage(level, message);
+            }
+        }
+
+        bool MapCacheReader::readHeader(const MapCacheKey& key, const Model::MapFormat format) {
+            try {
+                char magic[sizeof(Magic)];
+                m_reader.read(magic, sizeof(Magic));
+                if (std::memcmp(magic, Magic, sizeof(Magic)) != 0) {
+                    return false;
+                }
+
+                const auto version = m_reader.read<uint32_t, uint32_t>();
+                const auto cachedFormat = m_reader.read<uint32_t, uint32_t>();
+                const auto fileSize = m_reader.read<uint64_t, uint64_t>();
+                const auto modificationTime = m_reader.read<int64_t, int64_t>();
+                const auto hash = m_reader.read<uint64_t, uint64_t>();
+
+                return version == Version &&
+                       cachedFormat == static_cast<uint32_t>(format) &&
+                       MapCacheKey(fileSize, modificationTime, hash) == key;
+            } catch (const ReaderException&) {
+                return false;
+            }
+        }
+
+        MapCacheReader::ExtraAttributes MapCacheReader::readExtraAttributes() {
+            ExtraAttributes result;
+
+            const auto count = BinaryData::getSize(m_reader);
+            for (size_t i = 0; i < count; ++i) {
+                const auto type = static_cast<ExtraAttribute::Type>(m_reader.read<uint8_t, int>());
+                auto name = BinaryData::getString(m_reader);
+                auto value = BinaryData::getString(m_reader);
+                const auto line = BinaryData::getSize(m_reader);
+                const auto column = BinaryData::getSize(m_reader);
+                result.insert(std::make_pair(name, ExtraAttribute(type, name, value, line, column)));
+            }
+
+            return result;
+        }
+    }
+}
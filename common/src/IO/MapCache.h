@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCache
+#define TrenchBroom_MapCache
+
+#include "TrenchBroom.h"
+#include "IO/IO_Forward.h"
+#include "IO/MapParser.h"
+#include "IO/ParserStatus.h"
+#include "Model/MapFormat.h"
+#include "Model/Model_Forward.h"
+
+#include <vecmath/forward.h>
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Identifies the contents of a map file. A map cache is only used if the key stored in the cache equals the
+         * key of the map file that is being loaded.
+         */
+        class MapCacheKey {
+        private:
+            uint64_t m_fileSize;
+            int64_t m_modificationTime;
+            uint64_t m_hash;
+        public:
+            MapCacheKey(uint64_t fileSize, int64_t modificationTime, uint64_t hash);
+
+            /**
+             * Computes the key of the map file at the given path whose contents are given by the given range.
+             *
+             * @param path the path of the map file
+             * @param begin the beginning of the file contents
+             * @param end the end of the file contents
+             * @return the key
+             *
+             * @throw FileSystemException if the map file does not exist
+             */
+            static MapCacheKey compute(const Path& path, const char* begin, const char* end);
+
+            uint64_t fileSize() const;
+            int64_t modificationTime() const;
+            uint64_t hash() const;
+
+            friend bool operator==(const MapCacheKey& lhs, const MapCacheKey& rhs);
+            friend bool operator!=(const MapCacheKey& lhs, const MapCacheKey& rhs);
+        };
+
+        /**
+         * Returns the path of the sidecar cache file for the map file at the given path.
+         */
+        Path mapCachePath(const Path& mapPath);
+
+        /**
+         * Records the entities and brushes reported by a map parser in a compact binary form. A map parser passes
+         * everything it parses to its cache writer, if it has one.
+         *
+         * The recorded data is written in the host's byte order. Map caches are not meant to be shared between
+         * machines.
+         */
+        class MapCacheWriter {
+        private:
+            using ExtraAttributes = MapParser::ExtraAttributes;
+
+            Model::MapFormat m_format;
+            std::string m_data;
+        public:
+            MapCacheWriter();
+
+            void formatSet(Model::MapFormat format);
+            void beginEntity(size_t line, const std::list<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes);
+            void endEntity(size_t startLine, size_t lineCount);
+            void beginBrush(size_t line);
+            void endBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
+            void brushFace(size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY);
+
+            /**
+             * Records a message that was logged while parsing, so that it can be logged again when the cache is
+             * replayed.
+             */
+            void message(LogLevel level, const std::string& message);
+
+            /**
+             * Writes the recorded data to a cache file at the given path, replacing any existing file.
+             *
+             * @param path the path of the cache file
+             * @param key the key of the map file that was parsed
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void write(const Path& path, const MapCacheKey& key) const;
+        private:
+            void writeExtraAttributes(const ExtraAttributes& extraAttributes);
+        };
+
+        /**
+         * Forwards everything to another parser status and records the logged messages in a cache writer. Pass this to
+         * a map parser that records its contents in the given cache writer.
+         */
+        class MapCacheRecordingStatus : public ParserStatus {
+        private:
+            ParserStatus& m_status;
+            MapCacheWriter& m_cacheWriter;
+        public:
+            MapCacheRecordingStatus(ParserStatus& status, MapCacheWriter& cacheWriter);
+        private:
+            void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
+        };
+
+        /**
+         * Reads a cache file written by MapCacheWriter and passes its contents to a map parser as if the parser had
+         * parsed the original map file.
+         */
+        class MapCacheReader {
+        private:
+            using ExtraAttributes = MapParser::ExtraAttributes;
+            using ExtraAttribute = MapParser::ExtraAttribute;
+
+            Reader& m_reader;
+            Model::MapFormat m_format;
+            bool m_valid;
+        public:
+            /**
+             * Creates a new cache reader and reads the header of the given cache. The cache is valid if it was written
+             * by the current version of the cache writer for a map file with the given key and format.
+             *
+             * @param reader the reader for the cache file
+             * @param key the key of the map file that is being loaded
+             * @param format the format of the map file that is being loaded
+             */
+            MapCacheReader(Reader& reader, const MapCacheKey& key, Model::MapFormat format);
+
+            bool valid() const;
+
+            /**
+             * Passes the contents of the cache to the given parser and logs the recorded messages to the given status.
+             * Messages which the parser logs while it handles the cached contents are discarded because they were
+             * recorded when the map file was parsed. The recorded messages are only logged if the entire cache was
+             * replayed successfully.
+             *
+             * @param parser the parser to pass the contents to
+             * @param status the parser status
+             *
+             * @throw ReaderException if the cache file is truncated
+             * @throw ParserException if the cache file is corrupt
+             */
+            void replay(MapParser& parser, ParserStatus& status);
+        private:
+            bool readHeader(const MapCacheKey& key, Model::MapFormat format);
+            ExtraAttributes readExtraAttributes();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCache) */
@@ -25,127 +25,145 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 
+#include <kdl/parallel.h>
+
+#include <charconv>
+#include <cstdio>
+#include <iterator>
 #include <memory>
-#include <sstream>
+#include <string>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Appends the given value formatted like printf's %.<precision>g conversion.
+         */
+        static void appendFloat(std::string& str, const double value, const int precision) {
+            char buffer[64];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::general, precision);
+            str.append(buffer, result.ptr);
+#else
+            const auto count = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            str.append(buffer, static_cast<size_t>(count));
+#endif
+        }
+
+        static void appendFloat(std::string& str, const float value) {
+            appendFloat(str, static_cast<double>(value), 6);
+        }
+
+        static void appendInt(std::string& str, const int value) {
+            char buffer[16];
+            const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            str.append(buffer, result.ptr);
+        }
+
         class QuakeFileSerializer : public MapFileSerializer {
-        private:
-            std::string FacePointFormat;
-            std::string TextureInfoFormat;
         public:
             QuakeFileSerializer(FILE* stream) :
-            MapFileSerializer(stream),
-            FacePointFormat(getFacePointFormat()),
-            TextureInfoFormat(" %s %.6g %.6g %.6g %.6g %.6g") {}
-        private:
-            static std::string getFacePointFormat() {
-                std::stringstream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g )";
-                return str.str();
-            }
+            MapFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                str.push_back('\n');
                 return 1;
             }
         protected:
-            void writeFacePoints(FILE* stream, Model::BrushFace* face) {
+            void writeFacePoints(std::string& str, const Model::BrushFace* face) const {
                 const Model::BrushFace::Points& points = face->points();
 
-                std::fprintf(stream, FacePointFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z());
+                for (size_t i = 0; i < 3; ++i) {
+                    if (i > 0) {
+                        str.push_back(' ');
+                    }
+                    str.append("( ");
+                    appendFloat(str, points[i].x(), FloatPrecision);
+                    str.push_back(' ');
+                    appendFloat(str, points[i].y(), FloatPrecision);
+                    str.push_back(' ');
+                    appendFloat(str, points[i].z(), FloatPrecision);
+                    str.append(" )");
+                }
             }
 
-            void writeTextureInfo(FILE* stream, Model::BrushFace* face) {
+            void writeTextureName(std::string& str, const Model::BrushFace* face) const {
                 const std::string& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                std::fprintf(stream, TextureInfoFormat.c_str(),
-                             textureName.c_str(),
-                             static_cast<double>(face->xOffset()),
-                             static_cast<double>(face->yOffset()),
-                             static_cast<double>(face->rotation()),
-                             static_cast<double>(face->xScale()),
-                             static_cast<double>(face->yScale()));
+                str.push_back(' ');
+                str.append(textureName);
+            }
+
+            void writeTextureInfo(std::string& str, const Model::BrushFace* face) const {
+                writeTextureName(str, face);
+                str.push_back(' ');
+                appendFloat(str, face->xOffset());
+                str.push_back(' ');
+                appendFloat(str, face->yOffset());
+                str.push_back(' ');
+                appendFloat(str, face->rotation());
+                str.push_back(' ');
+                appendFloat(str, face->xScale());
+                str.push_back(' ');
+                appendFloat(str, face->yScale());
             }
         };
 
         class Quake2FileSerializer : public QuakeFileSerializer {
-        private:
-            std::string SurfaceAttributesFormat;
         public:
             Quake2FileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
-            SurfaceAttributesFormat(" %d %d %.6g") {}
+            QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 // Neverball's "mapc" doesn't like it if surface attributes aren't present.
                 // This suggests the Radiants always output these, so it's probably a compatibility danger.
-                writeSurfaceAttributes(stream, face);
+                writeSurfaceAttributes(str, face);
 
-                std::fprintf(stream, "\n");
+                str.push_back('\n');
                 return 1;
             }
         protected:
-            void writeSurfaceAttributes(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceAttributesFormat.c_str(),
-                             face->surfaceContents(),
-                             face->surfaceFlags(),
-                             static_cast<double>(face->surfaceValue()));
+            void writeSurfaceAttributes(std::string& str, const Model::BrushFace* face) const {
+                str.push_back(' ');
+                appendInt(str, face->surfaceContents());
+                str.push_back(' ');
+                appendInt(str, face->surfaceFlags());
+                str.push_back(' ');
+                appendFloat(str, face->surfaceValue());
             }
         };
 
 
         class DaikatanaFileSerializer : public Quake2FileSerializer {
-        private:
-            std::string SurfaceColorFormat;
         public:
             DaikatanaFileSerializer(FILE* stream) :
-            Quake2FileSerializer(stream),
-            SurfaceColorFormat(" %d %d %d") {}
+            Quake2FileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 if (face->hasSurfaceAttributes() || face->hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(str, face);
                 }
                 if (face->hasColor()) {
-                    writeSurfaceColor(stream, face);
+                    writeSurfaceColor(str, face);
                 }
 
-                std::fprintf(stream, "\n");
+                str.push_back('\n');
                 return 1;
             }
         protected:
-            void writeSurfaceColor(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceColorFormat.c_str(),
-                             static_cast<int>(face->color().r()),
-                             static_cast<int>(face->color().g()),
-                             static_cast<int>(face->color().b()));
+            void writeSurfaceColor(std::string& str, const Model::BrushFace* face) const {
+                str.push_back(' ');
+                appendInt(str, static_cast<int>(face->color().r()));
+                str.push_back(' ');
+                appendInt(str, static_cast<int>(face->color().g()));
+                str.push_back(' ');
+                appendInt(str, static_cast<int>(face->color().b()));
             }
         };
 
@@ -154,50 +172,51 @@ namespace TrenchBroom {
             Hexen2FileSerializer(FILE* stream):
             QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, " 0\n"); // extra value written here
+            size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                str.append(" 0\n"); // extra value written here
                 return 1;
             }
         };
 
         class ValveFileSerializer : public QuakeFileSerializer {
-        private:
-            std::string ValveTextureInfoFormat;
         public:
             ValveFileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
-            ValveTextureInfoFormat(" %s [ %.6g %.6g %.6g %.6g ] [ %.6g %.6g %.6g %.6g ] %.6g %.6g %.6g") {}
+            QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const override {
+                writeFacePoints(str, face);
+                writeValveTextureInfo(str, face);
+                str.push_back('\n');
                 return 1;
             }
         private:
-            void writeValveTextureInfo(FILE* stream, Model::BrushFace* face) {
-                const std::string& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
+            void writeValveTextureInfo(std::string& str, const Model::BrushFace* face) const {
                 const vm::vec3 xAxis = face->textureXAxis();
                 const vm::vec3 yAxis = face->textureYAxis();
 
-                std::fprintf(stream, ValveTextureInfoFormat.c_str(),
-                             textureName.c_str(),
-
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             static_cast<double>(face->xOffset()),
-
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             static_cast<double>(face->yOffset()),
+                writeTextureName(str, face);
+                writeTextureAxis(str, xAxis, face->xOffset());
+                writeTextureAxis(str, yAxis, face->yOffset());
+                str.push_back(' ');
+                appendFloat(str, face->rotation());
+                str.push_back(' ');
+                appendFloat(str, face->xScale());
+                str.push_back(' ');
+                appendFloat(str, face->yScale());
+            }
 
-                             static_cast<double>(face->rotation()),
-                             static_cast<double>(face->xScale()),
-                             static_cast<double>(face->yScale()));
+            void writeTextureAxis(std::string& str, const vm::vec3& axis, const float offset) const {
+                str.append(" [ ");
+                appendFloat(str, axis.x(), 6);
+                str.push_back(' ');
+                appendFloat(str, axis.y(), 6);
+                str.push_back(' ');
+                appendFloat(str, axis.z(), 6);
+                str.push_back(' ');
+                appendFloat(str, offset);
+                str.append(" ]");
             }
         };
 
@@ -224,7 +243,9 @@ namespace TrenchBroom {
 
         MapFileSerializer::MapFileSerializer(FILE* stream) :
         m_line(1),
-        m_stream(stream) {
+        m_stream(stream),
+        m_nextPreparedBrush(0),
+        m_nextPreparedFace(0) {
             ensure(m_stream != nullptr, "stream is null");
         }
 
@@ -252,6 +273,19 @@ namespace TrenchBroom {
             ++m_line;
         }
 
+        void MapFileSerializer::doPrepareBrushes(const std::vector<Model::Brush*>& brushes) {
+            m_preparedBrushes = kdl::vec_parallel_transform(brushes, [&](const Model::Brush* brush) {
+                auto result = PreparedBrush();
+                for (const auto* face : brush->faces()) {
+                    const auto lines = doWriteBrushFace(result.str, face);
+                    result.faces.emplace_back(result.str.size(), lines);
+                }
+                return result;
+            });
+            m_nextPreparedBrush = 0;
+            m_nextPreparedFace = 0;
+        }
+
         void MapFileSerializer::doBeginBrush(const Model::Brush* /* brush */) {
             std::fprintf(m_stream, "// brush %u\n", brushNo());
             ++m_line;
@@ -264,12 +298,27 @@ namespace TrenchBroom {
             std::fprintf(m_stream, "}\n");
             ++m_line;
             setFilePosition(brush);
+
+            if (m_nextPreparedBrush < m_preparedBrushes.size()) {
+                ++m_nextPreparedBrush;
+                m_nextPreparedFace = 0;
+                if (m_nextPreparedBrush == m_preparedBrushes.size()) {
+                    m_preparedBrushes.clear();
+                    m_nextPreparedBrush = 0;
+                }
+            }
         }
 
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
-            face->setFilePosition(m_line, lines);
-            m_line += lines;
+            if (m_nextPreparedBrush < m_preparedBrushes.size()) {
+                writePreparedBrushFace(face);
+            } else {
+                std::string str;
+                const size_t lines = doWriteBrushFace(str, face);
+                std::fwrite(str.data(), 1, str.size(), m_stream);
+                face->setFilePosition(m_line, lines);
+                m_line += lines;
+            }
         }
 
         void MapFileSerializer::setFilePosition(Model::Node* node) {
@@ -277,6 +326,19 @@ namespace TrenchBroom {
             node->setFilePosition(start, m_line - start);
         }
 
+        void MapFileSerializer::writePreparedBrushFace(Model::BrushFace* face) {
+            const auto& brush = m_preparedBrushes[m_nextPreparedBrush];
+            assert(m_nextPreparedFace < brush.faces.size());
+
+            const auto begin = m_nextPreparedFace == 0 ? size_t(0) : brush.faces[m_nextPreparedFace - 1].first;
+            const auto [end, lines] = brush.faces[m_nextPreparedFace];
+            std::fwrite(brush.str.data() + begin, 1, end - begin, m_stream);
+            ++m_nextPreparedFace;
+
+            face->setFilePosition(m_line, lines);
+            m_line += lines;
+        }
+
         size_t MapFileSerializer::startLine() {
             assert(!m_startLineStack.empty());
             const size_t result = m_startLineStack.back();
@@ -27,6 +27,8 @@
 
 #include <cstdio> // for FILE*
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -37,6 +39,19 @@ namespace TrenchBroom {
             LineStack m_startLineStack;
             size_t m_line;
             FILE* m_stream;
+
+            /**
+             * The serialized faces of a brush. Each face is described by the offset where it ends in the serialized
+             * string and by the number of lines it spans.
+             */
+            struct PreparedBrush {
+                std::string str;
+                std::vector<std::pair<size_t, size_t>> faces;
+            };
+
+            std::vector<PreparedBrush> m_preparedBrushes;
+            size_t m_nextPreparedBrush;
+            size_t m_nextPreparedFace;
         public:
             static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, FILE* stream);
         protected:
@@ -48,14 +63,24 @@ namespace TrenchBroom {
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
             void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doPrepareBrushes(const std::vector<Model::Brush*>& brushes) override;
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
         private:
             void setFilePosition(Model::Node* node);
             size_t startLine();
+            void writePreparedBrushFace(Model::BrushFace* face);
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            /**
+             * Appends the serialized representation of the given face to the given string. This may be called
+             * concurrently for different faces.
+             *
+             * @param str the string to append to
+             * @param face the face to serialize
+             * @return the number of lines that were appended
+             */
+            virtual size_t doWriteBrushFace(std::string& str, const Model::BrushFace* face) const = 0;
         };
     }
 }
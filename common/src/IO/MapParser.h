@@ -35,6 +35,9 @@
 namespace TrenchBroom {
     namespace IO {
         class MapParser {
+        private:
+            friend class MapCacheWriter;
+            friend class MapCacheReader;
         protected:
             class ExtraAttribute {
             public:
@@ -54,6 +57,8 @@ namespace TrenchBroom {
                 Type type() const;
                 const std::string& name() const;
                 const std::string& strValue() const;
+                size_t line() const;
+                size_t column() const;
 
                 void assertType(Type expected) const;
 
@@ -65,9 +70,20 @@ namespace TrenchBroom {
             };
 
             using ExtraAttributes = std::map<std::string, ExtraAttribute>;
+        private:
+            MapCacheWriter* m_cacheWriter;
         public:
+            MapParser();
             virtual ~MapParser();
+
+            /**
+             * Sets a cache writer which records everything this parser reports to its subclass. Pass null to stop
+             * recording. The cache writer is not owned by this parser.
+             */
+            void setCacheWriter(MapCacheWriter* cacheWriter);
         protected:
+            MapCacheWriter* cacheWriter() const;
+
             void formatSet(Model::MapFormat format);
             void beginEntity(size_t line, const std::list<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void endEntity(size_t startLine, size_t lineCount, ParserStatus& status);
@@ -19,6 +19,7 @@
 
 #include "MapReader.h"
 
+#include "IO/MapCache.h"
 #include "IO/ParserStatus.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
@@ -29,6 +30,7 @@
 #include "Model/ModelFactory.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
@@ -76,17 +78,47 @@ namespace TrenchBroom {
 
         MapReader::~MapReader() {
             kdl::vec_clear_and_delete(m_faces);
+            clearPendingNodes();
         }
 
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+            try {
+                if (auto* writer = cacheWriter()) {
+                    MapCacheRecordingStatus recordingStatus(status, *writer);
+                    parseEntities(format, recordingStatus);
+                } else {
+                    parseEntities(format, status);
+                }
+            } catch (...) {
+                clearPendingNodes();
+                throw;
+            }
+            addPendingNodes(status);
+            resolveNodes(status);
+        }
+
+        void MapReader::readEntities(MapCacheReader& cache, const vm::bbox3& worldBounds, ParserStatus& status) {
+            m_worldBounds = worldBounds;
+            try {
+                cache.replay(*this, status);
+            } catch (...) {
+                clearPendingNodes();
+                throw;
+            }
+            addPendingNodes(status);
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseBrushes(format, status);
+            try {
+                parseBrushes(format, status);
+            } catch (...) {
+                clearPendingNodes();
+                throw;
+            }
+            addPendingNodes(status);
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -168,7 +200,7 @@ namespace TrenchBroom {
             setExtraAttributes(layer, extraAttributes);
             m_layers.insert(std::make_pair(layerId, layer));
 
-            onLayer(layer, status);
+            m_pendingNodes.push_back(PendingNode{ PendingNode::Type_Layer, nullptr, layer, 0 });
 
             m_currentNode = layer;
             m_brushParent = layer;
@@ -221,19 +253,11 @@ namespace TrenchBroom {
             m_brushParent = entity;
         }
 
-        void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            try {
-                Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
-                setFilePosition(brush, startLine, lineCount);
-                setExtraAttributes(brush, extraAttributes);
-
-                onBrush(m_brushParent, brush, status);
-                m_faces.clear();
-            } catch (GeometryException& e) {
-                status.error(startLine, kdl::str_to_string("Skipping brush: ", e.what()));
-                m_faces.clear(); // the faces will have been deleted by the brush's constructor
-            }
+        void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) {
+            m_pendingBrushes.push_back(PendingBrush{ std::move(m_faces), startLine, lineCount, extraAttributes, nullptr, "" });
+            m_faces.clear();
 
+            m_pendingNodes.push_back(PendingNode{ PendingNode::Type_Brush, m_brushParent, nullptr, m_pendingBrushes.size() - 1u });
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const std::list<Model::EntityAttribute>& attributes, ParserStatus& status) {
@@ -245,7 +269,7 @@ namespace TrenchBroom {
                     Model::Layer* layer = kdl::map_find_or_default(m_layers, layerId,
                         static_cast<Model::Layer*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        addPendingNode(layer, node);
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -261,7 +285,7 @@ namespace TrenchBroom {
                         Model::Group* group = kdl::map_find_or_default(m_groups, groupId,
                             static_cast<Model::Group*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            addPendingNode(group, node);
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -271,7 +295,7 @@ namespace TrenchBroom {
                 }
             }
 
-            onNode(nullptr, node, status);
+            addPendingNode(nullptr, node);
             return ParentInfo::Type_None;
         }
 
@@ -289,6 +313,69 @@ namespace TrenchBroom {
             }
         }
 
+        void MapReader::addPendingNode(Model::Node* parent, Model::Node* node) {
+            m_pendingNodes.push_back(PendingNode{ PendingNode::Type_Node, parent, node, 0 });
+        }
+
+        void MapReader::addPendingNodes(ParserStatus& status) {
+            // The brush geometry is built in parallel, which is safe because the brushes are independent of each other
+            // and of the node tree.
+            const auto& worldBounds = m_worldBounds;
+            const auto* factory = m_factory;
+            kdl::parallel_for(m_pendingBrushes.size(), [&](const size_t i) {
+                auto& pendingBrush = m_pendingBrushes[i];
+                try {
+                    pendingBrush.brush = factory->createBrush(worldBounds, pendingBrush.faces);
+                } catch (const GeometryException& e) {
+                    pendingBrush.error = e.what();
+                }
+                pendingBrush.faces.clear(); // the faces are now owned by the brush, or they were deleted by its constructor
+            });
+
+            auto pendingNodes = std::move(m_pendingNodes);
+            auto pendingBrushes = std::move(m_pendingBrushes);
+            m_pendingNodes.clear();
+            m_pendingBrushes.clear();
+
+            for (const auto& pendingNode : pendingNodes) {
+                switch (pendingNode.type) {
+                    case PendingNode::Type_Layer:
+                        onLayer(static_cast<Model::Layer*>(pendingNode.node), status);
+                        break;
+                    case PendingNode::Type_Node:
+                        onNode(pendingNode.parent, pendingNode.node, status);
+                        break;
+                    case PendingNode::Type_Brush: {
+                        auto& pendingBrush = pendingBrushes[pendingNode.brushIndex];
+                        if (pendingBrush.brush != nullptr) {
+                            setFilePosition(pendingBrush.brush, pendingBrush.startLine, pendingBrush.lineCount);
+                            setExtraAttributes(pendingBrush.brush, pendingBrush.extraAttributes);
+                            onBrush(pendingNode.parent, pendingBrush.brush, status);
+                        } else {
+                            status.error(pendingBrush.startLine, kdl::str_to_string("Skipping brush: ", pendingBrush.error));
+                        }
+                        break;
+                    }
+                    switchDefault();
+                }
+            }
+        }
+
+        void MapReader::clearPendingNodes() {
+            kdl::vec_clear_and_delete(m_faces);
+
+            for (auto& pendingBrush : m_pendingBrushes) {
+                kdl::vec_clear_and_delete(pendingBrush.faces);
+                delete pendingBrush.brush;
+            }
+            m_pendingBrushes.clear();
+
+            for (const auto& pendingNode : m_pendingNodes) {
+                delete pendingNode.node;
+            }
+            m_pendingNodes.clear();
+        }
+
         void MapReader::resolveNodes(ParserStatus& status) {
             for (const auto& entry : m_unresolvedNodes) {
                 Model::Node* node = entry.first;
@@ -70,6 +70,38 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * The faces of a brush whose geometry has not been built yet. Brushes are built in parallel once the
+             * entire file has been parsed.
+             */
+            struct PendingBrush {
+                std::vector<Model::BrushFace*> faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+
+                Model::Brush* brush;
+                std::string error;
+            };
+
+            /**
+             * A node that was created while parsing, but has not been passed to the subclass yet. Pending nodes are
+             * passed to the subclass in the order in which they appear in the file after all pending brushes have been
+             * built, so that the resulting node tree does not depend on how the brushes were built.
+             */
+            struct PendingNode {
+                typedef enum {
+                    Type_Layer,
+                    Type_Node,
+                    Type_Brush
+                } Type;
+
+                Type type;
+                Model::Node* parent;
+                Model::Node* node;
+                size_t brushIndex;
+            };
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -80,11 +112,15 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+
+            std::vector<PendingBrush> m_pendingBrushes;
+            std::vector<PendingNode> m_pendingNodes;
         protected:
             MapReader(const char* begin, const char* end);
             explicit MapReader(const std::string& str);
 
             void readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+            void readEntities(MapCacheReader& cache, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
         public:
@@ -105,6 +141,10 @@ namespace TrenchBroom {
             ParentInfo::Type storeNode(Model::Node* node, const std::list<Model::EntityAttribute>& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
 
+            void addPendingNode(Model::Node* parent, Model::Node* node);
+            void addPendingNodes(ParserStatus& status);
+            void clearPendingNodes();
+
             void resolveNodes(ParserStatus& status);
             Model::Node* resolveParent(const ParentInfo& parentInfo) const;
 
@@ -58,6 +58,33 @@ namespace TrenchBroom {
             }
         }
 
+        static Assets::TextureType mipTextureType(const std::string& name) {
+            return (!name.empty() && name.at(0) == '{') ? Assets::TextureType::Masked : Assets::TextureType::Opaque;
+        }
+
+        Assets::Texture* MipTextureReader::doReadTextureHeader(std::shared_ptr<File> file) const {
+            ensure(!file->path().isEmpty(), "MipTextureReader::doReadTextureHeader requires a path");
+
+            const auto path = file->path();
+            const auto basename = path.lastComponent().deleteExtension().asString();
+            const auto name = textureName(basename, path);
+            try {
+                auto reader = file->reader().buffer();
+                reader.readString(MipLayout::TextureNameLength);
+
+                const auto width = reader.readSize<int32_t>();
+                const auto height = reader.readSize<int32_t>();
+
+                if (!checkTextureDimensions(width, height)) {
+                    return nullptr;
+                }
+
+                return new Assets::Texture(name, width, height, GL_RGBA, mipTextureType(name));
+            } catch (const ReaderException&) {
+                return nullptr;
+            }
+        }
+
         Assets::Texture* MipTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             static const size_t MipLevels = 4;
 
@@ -110,10 +137,7 @@ namespace TrenchBroom {
                     }
                 }
 
-                const auto type = (transparent == Assets::PaletteTransparency::Index255Transparent)
-                                  ? Assets::TextureType::Masked
-                                  : Assets::TextureType::Opaque;
-                return new Assets::Texture(name, width, height, averageColor, std::move(buffers), GL_RGBA, type);
+                return new Assets::Texture(name, width, height, averageColor, std::move(buffers), GL_RGBA, mipTextureType(name));
             } catch (const ReaderException&) {
                 return new Assets::Texture(name, 16, 16);
             }
@@ -41,6 +41,7 @@ namespace TrenchBroom {
             static std::string getTextureName(const BufferedReader& reader);
         protected:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureHeader(std::shared_ptr<File> file) const override;
             virtual Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const = 0;
         };
     }
@@ -30,20 +30,23 @@
 #include <kdl/string_utils.h>
 
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        class NodeSerializer::BrushSerializer : public Model::NodeVisitor {
+        class NodeSerializer::BrushCollector : public Model::NodeVisitor {
         private:
-            NodeSerializer& m_serializer;
+            std::vector<Model::Brush*> m_brushes;
         public:
-            explicit BrushSerializer(NodeSerializer& serializer) : m_serializer(serializer) {}
-
+            const std::vector<Model::Brush*>& brushes() const {
+                return m_brushes;
+            }
+        private:
             void doVisit(Model::World* /* world */) override   {}
             void doVisit(Model::Layer* /* layer */) override   {}
             void doVisit(Model::Group* /* group */) override   {}
             void doVisit(Model::Entity* /* entity */) override {}
-            void doVisit(Model::Brush* brush) override   { m_serializer.brush(brush); }
+            void doVisit(Model::Brush* brush) override   { m_brushes.push_back(brush); }
         };
 
         const std::string& NodeSerializer::IdManager::getId(const Model::Node* t) const {
@@ -102,8 +105,9 @@ namespace TrenchBroom {
         void NodeSerializer::entity(Model::Node* node, const std::list<Model::EntityAttribute>& attributes, const std::list<Model::EntityAttribute>& parentAttributes, Model::Node* brushParent) {
             beginEntity(node, attributes, parentAttributes);
 
-            BrushSerializer brushSerializer(*this);
-            brushParent->iterate(brushSerializer);
+            BrushCollector brushCollector;
+            brushParent->iterate(brushCollector);
+            brushes(brushCollector.brushes());
 
             endEntity(node);
         }
@@ -141,6 +145,7 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::brushes(const std::vector<Model::Brush*>& brushes) {
+            doPrepareBrushes(brushes);
             for (auto* brush : brushes) {
                 this->brush(brush);
             }
@@ -171,6 +176,8 @@ namespace TrenchBroom {
             doBrushFace(face);
         }
 
+        void NodeSerializer::doPrepareBrushes(const std::vector<Model::Brush*>& /* brushes */) {}
+
         class NodeSerializer::GetParentAttributes : public Model::ConstNodeVisitor {
         private:
             const IdManager& m_layerIds;
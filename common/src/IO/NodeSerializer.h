@@ -33,7 +33,7 @@ namespace TrenchBroom {
     namespace IO {
         class NodeSerializer {
         private:
-            class BrushSerializer;
+            class BrushCollector;
         protected:
             static const int FloatPrecision = 17;
             using ObjectNo = unsigned int;
@@ -104,6 +104,11 @@ namespace TrenchBroom {
             virtual void doEndEntity(Model::Node* node) = 0;
             virtual void doEntityAttribute(const Model::EntityAttribute& attribute) = 0;
 
+            /**
+             * Called once before the given brushes are serialized one by one. Serializers can use this to prepare the
+             * serialized representation of the brushes in advance, e.g. in parallel.
+             */
+            virtual void doPrepareBrushes(const std::vector<Model::Brush*>& brushes);
             virtual void doBeginBrush(const Model::Brush* brush) = 0;
             virtual void doEndBrush(Model::Brush* brush) = 0;
             virtual void doBrushFace(Model::BrushFace* face) = 0;
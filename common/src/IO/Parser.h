@@ -66,14 +66,14 @@ namespace TrenchBroom {
             }
 
             void expect(const std::string& expected, const Token& token) const {
-                if (token.data() != expected) {
+                if (token.view() != expected) {
                     throw ParserException(token.line(), token.column(), "Expected string '" + expected + "', but got '" + token.data() + "'");
                 }
             }
 
             void expect(const std::vector<std::string>& expected, const Token& token) const {
                 for (const auto& str : expected) {
-                    if (token.data() == str) {
+                    if (token.view() == str) {
                         return;
                     }
                 }
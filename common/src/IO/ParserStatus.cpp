@@ -33,6 +33,10 @@ namespace TrenchBroom {
 
         ParserStatus::~ParserStatus() {}
 
+        const std::string& ParserStatus::prefix() const {
+            return m_prefix;
+        }
+
         void ParserStatus::progress(const double progress) {
             assert(progress >= 0.0 && progress <= 1.0);
             doProgress(progress);
@@ -101,6 +105,10 @@ namespace TrenchBroom {
             throw ParserException(buildMessage(str));
         }
 
+        void ParserStatus::logMessage(const LogLevel level, const std::string& message) {
+            doLog(level, message);
+        }
+
         void ParserStatus::log(const LogLevel level, const size_t line, const size_t column, const std::string& str) {
             doLog(level, buildMessage(line, column, str));
         }
@@ -36,6 +36,8 @@ namespace TrenchBroom {
         public:
             virtual ~ParserStatus();
         public:
+            const std::string& prefix() const;
+
             void progress(double progress);
 
             void debug(size_t line, size_t column, const std::string& str);
@@ -55,6 +57,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs the given message as is, without adding the prefix or a position. This is used to forward messages
+             * that were already built by another parser status.
+             */
+            void logMessage(LogLevel level, const std::string& message);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
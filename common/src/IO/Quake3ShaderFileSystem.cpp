@@ -19,10 +19,13 @@
 
 #include "Quake3ShaderFileSystem.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Quake3Shader.h"
+#include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Quake3ShaderIndex.h"
 #include "IO/Quake3ShaderParser.h"
 #include "IO/SimpleParserStatus.h"
 
@@ -34,10 +37,45 @@
 
 namespace TrenchBroom {
     namespace IO {
+        Quake3ShaderFileSystem::ShaderFileEntry::ShaderFileEntry(ShaderRef shaderRef) :
+        m_shaderRef(std::move(shaderRef)) {}
+
+        std::shared_ptr<File> Quake3ShaderFileSystem::ShaderFileEntry::doOpen() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_file == nullptr) {
+                const auto& script = *m_shaderRef.script;
+                const auto reader = script.reader().buffer();
+                const auto* begin = reader.begin() + m_shaderRef.offset;
+
+                try {
+                    NullLogger logger;
+                    SimpleParserStatus status(logger, script.path().asString());
+                    Quake3ShaderParser parser(begin, begin + m_shaderRef.length);
+
+                    auto shaders = parser.parse(status);
+                    if (shaders.size() != 1u) {
+                        throw ParserException("Expected one shader, but got " + std::to_string(shaders.size()));
+                    }
+
+                    // the index strips a leading slash from the name, so we use its path
+                    auto& shader = shaders.front();
+                    shader.shaderPath = m_shaderRef.shaderPath;
+                    m_file = std::make_shared<ObjectFile<Assets::Quake3Shader>>(m_shaderRef.shaderPath, std::move(shader));
+                } catch (const ParserException& e) {
+                    throw FileSystemException("Malformed shader '" + m_shaderRef.shaderPath.asString() + "' in " + script.path().asString() + ": " + e.what());
+                }
+            }
+            return m_file;
+        }
+
         Quake3ShaderFileSystem::Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger) :
+        Quake3ShaderFileSystem(std::move(fs), std::move(shaderSearchPath), std::move(textureSearchPaths), Path(), logger) {}
+
+        Quake3ShaderFileSystem::Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Path indexPath, Logger& logger) :
         ImageFileSystemBase(std::move(fs), Path()),
         m_shaderSearchPath(std::move(shaderSearchPath)),
         m_textureSearchPaths(std::move(textureSearchPaths)),
+        m_indexPath(std::move(indexPath)),
         m_logger(logger) {
             initialize();
         }
@@ -49,30 +87,57 @@ namespace TrenchBroom {
             }
         }
 
-        std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders() const {
-            auto result = std::vector<Assets::Quake3Shader>();
+        std::vector<Quake3ShaderFileSystem::ShaderRef> Quake3ShaderFileSystem::loadShaders() const {
+            auto result = std::vector<ShaderRef>();
 
             if (next().directoryExists(m_shaderSearchPath)) {
+                auto index = Quake3ShaderIndex(m_indexPath);
+
                 const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
-                for (const auto& path : paths) {
-                    const auto file = next().openFile(path);
-                    auto bufferedReader = file->reader().buffer();
+
+                auto errors = std::vector<std::string>();
+                const auto files = next().openFiles(paths, errors);
+                for (const auto& error : errors) {
+                    m_logger.warn() << "Skipping shader file: " << error;
+                }
+
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    const auto& file = files[i];
+                    if (file == nullptr) {
+                        continue;
+                    }
 
                     try {
-                        Quake3ShaderParser parser(std::begin(bufferedReader), std::end(bufferedReader));
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        kdl::vec_append(result, parser.parse(status));
+                        for (const auto& entry : index.entries(*file, modificationTime(paths[i]))) {
+                            result.push_back(ShaderRef{ file, entry.shaderPath, entry.offset, entry.length });
+                        }
                     } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        m_logger.warn() << "Skipping malformed shader file " << paths[i] << ": " << e.what();
                     }
                 }
+
+                try {
+                    index.removeUnusedScripts();
+                    index.write();
+                } catch (const FileSystemException& e) {
+                    m_logger.warn() << "Could not write shader index: " << e.what();
+                }
             }
 
             m_logger.info() << "Loaded " << result.size() << " shaders";
             return result;
         }
 
-        void Quake3ShaderFileSystem::linkShaders(std::vector<Assets::Quake3Shader>& shaders) {
+        int64_t Quake3ShaderFileSystem::modificationTime(const Path& path) const {
+            try {
+                // only files on the disk have an absolute path
+                return Disk::modificationTime(next().makeAbsolute(path));
+            } catch (const FileSystemException&) {
+                return Quake3ShaderIndex::UnknownModificationTime;
+            }
+        }
+
+        void Quake3ShaderFileSystem::linkShaders(std::vector<ShaderRef>& shaders) {
             const auto extensions = std::vector<std::string> { "tga", "png", "jpg", "jpeg" };
 
             auto allImages = std::vector<Path>();
@@ -87,7 +152,7 @@ namespace TrenchBroom {
             linkStandaloneShaders(shaders);
         }
 
-        void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders) {
+        void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<ShaderRef>& shaders) {
             m_logger.debug() << "Linking textures...";
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
@@ -100,10 +165,7 @@ namespace TrenchBroom {
 
                     if (shaderIt != std::end(shaders)) {
                         // Found a matching shader.
-                        auto& shader = *shaderIt;
-
-                        auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                        m_root.addFile(shaderPath, shaderFile);
+                        addFile(shaderPath, std::make_unique<ShaderFileEntry>(std::move(*shaderIt)));
 
                         // Remove the shader so that we don't revisit it when linking standalone shaders.
                         shaders.erase(shaderIt);
@@ -114,18 +176,17 @@ namespace TrenchBroom {
                         shader.editorImage = texture;
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, std::move(shader));
-                        m_root.addFile(shaderPath, std::move(shaderFile));
+                        addFile(shaderPath, std::move(shaderFile));
                     }
                 }
             }
         }
 
-        void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
+        void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<ShaderRef>& shaders) {
             m_logger.debug() << "Linking standalone shaders...";
             for (auto& shader : shaders) {
-                const auto& shaderPath = shader.shaderPath;
-                auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                m_root.addFile(shaderPath, std::move(shaderFile));
+                auto shaderPath = shader.shaderPath;
+                addFile(shaderPath, std::make_unique<ShaderFileEntry>(std::move(shader)));
             }
         }
     }
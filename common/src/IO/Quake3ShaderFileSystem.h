@@ -23,6 +23,9 @@
 #include "Assets/Asset_Forward.h"
 #include "IO/ImageFileSystem.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace TrenchBroom {
@@ -35,11 +38,42 @@ namespace TrenchBroom {
          *
          * Also scans for textures available at a list of search paths and generates shaders for such textures which
          * do not already have a shader by the same name.
+         *
+         * The shader scripts are only scanned for the names of the shaders they define. A shader is parsed when its
+         * file is opened for the first time. The results of scanning the scripts can be stored in a shader index file.
+         *
+         * Note that loading a texture collection opens every shader in it because the texture browser and the faces
+         * need the size of the editor image, so the shaders of the enabled collections are still parsed when they are
+         * loaded. Only the shaders outside of the enabled collections are never parsed.
          */
         class Quake3ShaderFileSystem : public ImageFileSystemBase {
         private:
+            struct ShaderRef {
+                std::shared_ptr<File> script;
+                Path shaderPath;
+                size_t offset;
+                size_t length;
+            };
+
+            /**
+             * Parses its shader from the script that defines it when it is opened for the first time. Since shaders
+             * may be opened on worker threads, parser warnings are discarded and a malformed shader is reported by
+             * throwing an exception when it is opened.
+             */
+            class ShaderFileEntry : public FileEntry {
+            private:
+                ShaderRef m_shaderRef;
+                mutable std::mutex m_mutex;
+                mutable std::shared_ptr<File> m_file;
+            public:
+                explicit ShaderFileEntry(ShaderRef shaderRef);
+            private:
+                std::shared_ptr<File> doOpen() const override;
+            };
+
             Path m_shaderSearchPath;
             std::vector<Path> m_textureSearchPaths;
+            Path m_indexPath;
             Logger& m_logger;
         public:
             /**
@@ -54,13 +88,26 @@ namespace TrenchBroom {
              * @param logger the logger to use
              */
             Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger);
+
+            /**
+             * Creates a new instance like the constructor above, but reads the shader index from the file at the
+             * given path and writes it back after the scripts have been scanned.
+             *
+             * @param fs the filesystem to use when searching for shaders and linking image resources
+             * @param shaderSearchPath the path at which to search for shader scripts
+             * @param textureSearchPaths the paths at which to search for texture images
+             * @param indexPath the path of the shader index file, or an empty path to not store the index
+             * @param logger the logger to use
+             */
+            Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Path indexPath, Logger& logger);
         private:
             void doReadDirectory() override;
 
-            std::vector<Assets::Quake3Shader> loadShaders() const;
-            void linkShaders(std::vector<Assets::Quake3Shader>& shaders);
-            void linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders);
-            void linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders);
+            std::vector<ShaderRef> loadShaders() const;
+            int64_t modificationTime(const Path& path) const;
+            void linkShaders(std::vector<ShaderRef>& shaders);
+            void linkTextures(const std::vector<Path>& textures, std::vector<ShaderRef>& shaders);
+            void linkStandaloneShaders(std::vector<ShaderRef>& shaders);
         };
     }
 }
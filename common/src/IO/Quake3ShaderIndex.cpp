@@ -0,0 +1,201 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Quake3ShaderIndex.h"
+
+#include "Exceptions.h"
+#include "IO/BinaryData.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Quake3ShaderParser.h"
+#include "IO/Reader.h"
+
+#include <cstring>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            const char Magic[4] = { 'T', 'B', 'S', 'I' };
+
+            // increment this whenever the layout of the index file or the way scripts are scanned changes
+            const uint32_t Version = 3;
+        }
+
+        Quake3ShaderIndex::Quake3ShaderIndex(const Path& path) :
+        m_path(path),
+        m_modified(false) {
+            read();
+        }
+
+        const std::vector<Quake3ShaderIndex::Entry>& Quake3ShaderIndex::entries(const File& script, const int64_t modificationTime) {
+            const auto reader = script.reader().buffer();
+            const auto fileSize = static_cast<uint64_t>(reader.end() - reader.begin());
+
+            const auto key = script.path().asString();
+            m_usedScripts.insert(key);
+
+            auto it = m_scripts.find(key);
+            if (it != std::end(m_scripts) && it->second.fileSize == fileSize) {
+                auto& stored = it->second;
+                if (modificationTime != UnknownModificationTime && stored.modificationTime == modificationTime) {
+                    return stored.entries;
+                }
+
+                // the script was touched, but its contents may be unchanged
+                if (stored.hash == BinaryData::hash(reader.begin(), reader.end())) {
+                    if (stored.modificationTime != modificationTime) {
+                        stored.modificationTime = modificationTime;
+                        m_modified = true;
+                    }
+                    return stored.entries;
+                }
+            }
+
+            auto entries = scan(reader.begin(), reader.end());
+            const auto hash = BinaryData::hash(reader.begin(), reader.end());
+            it = m_scripts.insert_or_assign(key, Script{ fileSize, modificationTime, hash, std::move(entries) }).first;
+            m_modified = true;
+            return it->second.entries;
+        }
+
+        void Quake3ShaderIndex::removeUnusedScripts() {
+            for (auto it = std::begin(m_scripts); it != std::end(m_scripts);) {
+                if (m_usedScripts.count(it->first) == 0u) {
+                    it = m_scripts.erase(it);
+                    m_modified = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void Quake3ShaderIndex::write() {
+            if (!m_modified || m_path.isEmpty()) {
+                return;
+            }
+
+            auto data = std::string(Magic, sizeof(Magic));
+            BinaryData::put(data, Version);
+            BinaryData::putSize(data, m_scripts.size());
+            for (const auto& [scriptPath, script] : m_scripts) {
+                BinaryData::putString(data, scriptPath);
+                BinaryData::put(data, script.fileSize);
+                BinaryData::put(data, script.modificationTime);
+                BinaryData::put(data, script.hash);
+                BinaryData::putSize(data, script.entries.size());
+                for (const auto& entry : script.entries) {
+                    BinaryData::putString(data, entry.shaderPath.asString("/"));
+                    BinaryData::putSize(data, entry.offset);
+                    BinaryData::putSize(data, entry.length);
+                }
+            }
+
+            Disk::writeFileAtomically(m_path, data);
+
+            m_modified = false;
+        }
+
+        std::vector<Quake3ShaderIndex::Entry> Quake3ShaderIndex::scan(const char* begin, const char* end) {
+            auto result = std::vector<Entry>();
+
+            // use the shader tokenizer so that words and comments are delimited exactly as when parsing the shaders
+            Quake3ShaderTokenizer tokenizer(begin, end);
+            auto token = tokenizer.nextToken(Quake3ShaderToken::Eol);
+            while (!token.hasType(Quake3ShaderToken::Eof)) {
+                if (!token.hasType(Quake3ShaderToken::String)) {
+                    throw ParserException(token.line(), token.column(), "Expected shader name, but got '" + token.data() + "'");
+                }
+
+                const auto nameToken = token;
+                token = tokenizer.nextToken(Quake3ShaderToken::Eol);
+                if (!token.hasType(Quake3ShaderToken::OBrace)) {
+                    throw ParserException(token.line(), token.column(), "Expected '{' after shader '" + nameToken.data() + "'");
+                }
+
+                size_t depth = 1;
+                while (depth > 0) {
+                    token = tokenizer.nextToken(Quake3ShaderToken::Eol);
+                    if (token.hasType(Quake3ShaderToken::OBrace)) {
+                        ++depth;
+                    } else if (token.hasType(Quake3ShaderToken::CBrace)) {
+                        --depth;
+                    } else if (token.hasType(Quake3ShaderToken::Eof)) {
+                        throw ParserException(token.line(), token.column(), "Unexpected end of file in shader '" + nameToken.data() + "'");
+                    }
+                }
+
+                // Q3 accepts absolute shader paths, so we strip the leading slash like the parser does
+                const auto shaderName = nameToken.data();
+                const auto nameOffset = shaderName.front() == '/' ? 1u : 0u;
+                result.push_back(Entry{
+                    Path(shaderName.substr(nameOffset)),
+                    static_cast<size_t>(nameToken.begin() - begin),
+                    static_cast<size_t>(token.end() - nameToken.begin())
+                });
+
+                token = tokenizer.nextToken(Quake3ShaderToken::Eol);
+            }
+
+            return result;
+        }
+
+        void Quake3ShaderIndex::read() {
+            if (m_path.isEmpty() || !Disk::fileExists(m_path)) {
+                return;
+            }
+
+            try {
+                const auto file = Disk::openFile(m_path);
+                auto reader = file->reader();
+
+                char magic[sizeof(Magic)];
+                reader.read(magic, sizeof(Magic));
+                if (std::memcmp(magic, Magic, sizeof(Magic)) != 0 || reader.read<uint32_t, uint32_t>() != Version) {
+                    return;
+                }
+
+                const auto scriptCount = BinaryData::getSize(reader);
+                for (size_t i = 0; i < scriptCount; ++i) {
+                    auto scriptPath = BinaryData::getString(reader);
+                    auto script = Script();
+                    script.fileSize = reader.read<uint64_t, uint64_t>();
+                    script.modificationTime = reader.read<int64_t, int64_t>();
+                    script.hash = reader.read<uint64_t, uint64_t>();
+
+                    const auto entryCount = BinaryData::getSize(reader);
+                    for (size_t j = 0; j < entryCount; ++j) {
+                        auto shaderPath = Path(BinaryData::getString(reader));
+                        const auto offset = BinaryData::getSize(reader);
+                        const auto length = BinaryData::getSize(reader);
+                        if (offset + length > script.fileSize) {
+                            throw ParserException("Shader index entry exceeds its script");
+                        }
+                        script.entries.push_back(Entry{ std::move(shaderPath), offset, length });
+                    }
+
+                    m_scripts.emplace(std::move(scriptPath), std::move(script));
+                }
+            } catch (const Exception&) {
+                // a truncated or otherwise unreadable index is treated like a missing one
+                m_scripts.clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_QUAKE3SHADERINDEX_H
+#define TRENCHBROOM_QUAKE3SHADERINDEX_H
+
+#include "IO/IO_Forward.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Maps the names of the shaders in Quake 3 shader scripts to the ranges of the scripts in which they are
+         * defined, so that a shader can be parsed when it is needed instead of parsing all scripts up front.
+         *
+         * The index can be stored in a file so that the scripts need not be scanned again in later sessions. The
+         * entries of a script are reused if its size and modification time are unchanged. Otherwise, the contents
+         * of the script are hashed, and the script is only scanned again if the hash changed, too.
+         * Index files are written in the host's byte order and are not meant to be shared between machines.
+         */
+        class Quake3ShaderIndex {
+        public:
+            /**
+             * Pass this to entries if the modification time of a script is unknown, e.g. because it is located in
+             * an archive. Such scripts are always hashed.
+             */
+            static const int64_t UnknownModificationTime = 0;
+
+            struct Entry {
+                Path shaderPath;
+                size_t offset;
+                size_t length;
+            };
+        private:
+            struct Script {
+                uint64_t fileSize;
+                int64_t modificationTime;
+                uint64_t hash;
+                std::vector<Entry> entries;
+            };
+
+            Path m_path;
+            std::unordered_map<std::string, Script> m_scripts;
+            std::unordered_set<std::string> m_usedScripts;
+            bool m_modified;
+        public:
+            /**
+             * Creates an index that is stored in the file at the given path, and reads the file if it exists. If the
+             * given path is empty, the index is never stored. An unreadable index file is ignored.
+             *
+             * @param path the path of the index file
+             */
+            explicit Quake3ShaderIndex(const Path& path);
+
+            /**
+             * Returns the entries of the shaders defined in the given script. The script is only scanned if the index
+             * contains no valid entries for it.
+             *
+             * @param script the shader script
+             * @param modificationTime the modification time of the script, see Disk::modificationTime, or
+             *     UnknownModificationTime
+             * @return the entries in the order in which the shaders are defined
+             *
+             * @throws ParserException if the braces in the given script are not balanced
+             */
+            const std::vector<Entry>& entries(const File& script, int64_t modificationTime);
+
+            /**
+             * Removes the scripts which were not passed to entries since this index was created, e.g. because they
+             * were deleted, so that the index does not keep growing.
+             */
+            void removeUnusedScripts();
+
+            /**
+             * Writes this index to its file if it was modified since it was read.
+             *
+             * @throw FileSystemException if the index file cannot be written
+             */
+            void write();
+
+            /**
+             * Finds the shaders defined in the given range without parsing their bodies. An entry spans the name of
+             * a shader up to and including the closing brace of its body.
+             *
+             * @param begin the beginning of the script
+             * @param end the end of the script
+             * @return the entries in the order in which the shaders are defined
+             *
+             * @throws ParserException if the braces in the given range are not balanced
+             */
+            static std::vector<Entry> scan(const char* begin, const char* end);
+        private:
+            void read();
+        };
+    }
+}
+
+#endif //TRENCHBROOM_QUAKE3SHADERINDEX_H
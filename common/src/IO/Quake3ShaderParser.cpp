@@ -63,10 +63,7 @@ namespace TrenchBroom {
                         advance();
                         break;
                     case '$': {
-                        const auto* e = readUntil(Whitespace());
-                        if (e == nullptr) {
-                            throw ParserException(startLine, startColumn, "Unexpected character: " + std::string(c, 1));
-                        }
+                        const auto* e = readWord();
                         return Token(Quake3ShaderToken::Variable, c, e, offset(c), startLine, startColumn);
                     }
                     case '/':
@@ -90,21 +87,30 @@ namespace TrenchBroom {
                         // fall through into the default case to parse a string that starts with '/'
                         switchFallthrough();
                     default:
-                        auto* e = readDecimal(Whitespace());
+                        auto* e = readDecimal(Whitespace() + "{}");
                         if (e != nullptr) {
                             return Token(Quake3ShaderToken::Number, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readUntil(Whitespace());
-                        if (e == nullptr) {
-                            throw ParserException(startLine, startColumn, "Unexpected character: " + std::string(c, 1));
-                        }
+                        e = readWord();
                         return Token(Quake3ShaderToken::String, c, e, offset(c), startLine, startColumn);
                 }
             }
             return Token(Quake3ShaderToken::Eof, nullptr, nullptr, length(), line(), column());
         }
 
+        const char* Quake3ShaderTokenizer::readWord() {
+            // the first character of a word is never a delimiter
+            do {
+                advance();
+            } while (!eof() && !isWhitespace(curChar()) && curChar() != '{' && curChar() != '}' && !isCommentStart());
+            return curPos();
+        }
+
+        bool Quake3ShaderTokenizer::isCommentStart() const {
+            return curChar() == '/' && (lookAhead() == '/' || lookAhead() == '*');
+        }
+
         Quake3ShaderParser::Quake3ShaderParser(const char* begin, const char* end) :
         m_tokenizer(begin, end) {}
 
@@ -47,6 +47,13 @@ namespace TrenchBroom {
             explicit Quake3ShaderTokenizer(const std::string& str);
         private:
             Token emitToken() override;
+
+            /**
+             * Reads a word that is not enclosed in quotes. A word ends at whitespace, at a brace or at the start of a
+             * comment.
+             */
+            const char* readWord();
+            bool isCommentStart() const;
         };
 
         class Quake3ShaderParser : public Parser<Quake3ShaderToken::Type> {
@@ -73,9 +73,19 @@ namespace TrenchBroom {
             return texture;
         }
 
+        bool Quake3ShaderTextureReader::doIsCacheable() const {
+            // the shader attributes are not cached, but the shader images are
+            return false;
+        }
+
         Assets::Texture* Quake3ShaderTextureReader::loadTextureImage(const Path& shaderPath, const Path& imagePath) const {
             if (m_fs.fileExists(imagePath)) {
-                FreeImageTextureReader imageReader(StaticNameStrategy(textureName(shaderPath)));
+                const auto name = textureName(shaderPath);
+                const StaticNameStrategy nameStrategy(name);
+                FreeImageTextureReader imageReader(nameStrategy);
+                // the same image can be used by several shaders, but the cached texture is named after the shader
+                imageReader.setCache(cache(), cacheSalt() + "/" + name);
+                imageReader.setCompressTextures(compressTextures());
                 return imageReader.readTexture(m_fs.openFile(imagePath));
             } else {
                 return new Assets::Texture(textureName(shaderPath), 64, 64);
@@ -46,6 +46,7 @@ namespace TrenchBroom {
             Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs);
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            bool doIsCacheable() const override;
             Assets::Texture* loadTextureImage(const Path& shaderPath, const Path& imagePath) const;
             Path findTexturePath(const Assets::Quake3Shader& shader) const;
             Path findTexture(const Path& texturePath) const;
@@ -19,12 +19,16 @@
 
 #include "StandardMapParser.h"
 
+#include "Logger.h"
 #include "TemporarilySetAny.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/EntityAttributes.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_set.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
@@ -43,6 +47,10 @@ namespace TrenchBroom {
         Tokenizer(begin, end, "\"", '\\'),
         m_skipEol(true) {}
 
+        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end, const size_t line, const size_t column) :
+        Tokenizer(begin, end, "\"", '\\', line, column),
+        m_skipEol(true) {}
+
         QuakeMapTokenizer::QuakeMapTokenizer(const std::string& str) :
         Tokenizer(str, "\"", '\\'),
         m_skipEol(true) {}
@@ -135,13 +143,168 @@ namespace TrenchBroom {
         const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
         const std::string StandardMapParser::PatchId = "patchDef2";
 
+        struct StandardMapParser::ParsedBrushFace {
+            size_t line;
+            vm::vec3 point1;
+            vm::vec3 point2;
+            vm::vec3 point3;
+            Model::BrushFaceAttributes attribs;
+            vm::vec3 texAxisX;
+            vm::vec3 texAxisY;
+        };
+
+        struct StandardMapParser::ParsedBrush {
+            const char* begin;
+            const char* end;
+            size_t line;
+            size_t column;
+
+            bool valid;
+            size_t endLine;
+            size_t endColumn;
+
+            size_t beginBrushLine;
+            std::vector<ParsedBrushFace> faces;
+            size_t endBrushStartLine;
+            size_t endBrushLineCount;
+            ExtraAttributes extraAttributes;
+
+            ParsedBrush(const char* i_begin, const char* i_end, const size_t i_line, const size_t i_column) :
+            begin(i_begin),
+            end(i_end),
+            line(i_line),
+            column(i_column),
+            valid(false),
+            endLine(0),
+            endColumn(0),
+            beginBrushLine(0),
+            endBrushStartLine(0),
+            endBrushLineCount(0) {}
+        };
+
+        namespace {
+            /**
+             * Discards all messages, but remembers whether any message was logged at all.
+             */
+            class ParseAheadStatus : public ParserStatus {
+            private:
+                bool m_messageLogged;
+            public:
+                ParseAheadStatus() :
+                ParserStatus(nullLogger(), ""),
+                m_messageLogged(false) {}
+
+                bool messageLogged() const {
+                    return m_messageLogged;
+                }
+            private:
+                static Logger& nullLogger() {
+                    static NullLogger logger;
+                    return logger;
+                }
+
+                void doProgress(const double /* progress */) override {}
+
+                void doLog(const LogLevel /* level */, const std::string& /* str */) override {
+                    m_messageLogged = true;
+                }
+            };
+        }
+
+        /**
+         * Parses a single brush from a range of the map file and records the callbacks so that they can be replayed
+         * later. The brush is only marked as valid if the parser delivered exactly the callbacks for one brush, logged
+         * no messages and consumed the entire range.
+         */
+        class StandardMapParser::BrushParser : public StandardMapParser {
+        private:
+            ParsedBrush& m_brush;
+            bool m_beginBrushCalled;
+            bool m_endBrushCalled;
+            bool m_unexpectedCallback;
+        public:
+            BrushParser(ParsedBrush& brush, const Model::MapFormat format) :
+            StandardMapParser(brush.begin, brush.end, brush.line, brush.column),
+            m_brush(brush),
+            m_beginBrushCalled(false),
+            m_endBrushCalled(false),
+            m_unexpectedCallback(false) {
+                setFormat(format);
+            }
+
+            void parse() {
+                try {
+                    ParseAheadStatus status;
+                    parseBrushOrBrushPrimitiveOrPatch(status);
+
+                    m_brush.valid = m_beginBrushCalled && m_endBrushCalled && !m_unexpectedCallback && !status.messageLogged() && m_tokenizer.eof();
+                    m_brush.endLine = m_tokenizer.line();
+                    m_brush.endColumn = m_tokenizer.column();
+                } catch (const ParserException&) {
+                    m_brush.valid = false;
+                }
+
+                if (!m_brush.valid) {
+                    m_brush.faces.clear();
+                }
+            }
+        private:
+            void onFormatSet(const Model::MapFormat /* format */) override {}
+
+            void onBeginEntity(const size_t /* line */, const std::list<Model::EntityAttribute>& /* attributes */, const ExtraAttributes& /* extraAttributes */, ParserStatus& /* status */) override {
+                m_unexpectedCallback = true;
+            }
+
+            void onEndEntity(const size_t /* startLine */, const size_t /* lineCount */, ParserStatus& /* status */) override {
+                m_unexpectedCallback = true;
+            }
+
+            void onBeginBrush(const size_t line, ParserStatus& /* status */) override {
+                if (m_beginBrushCalled) {
+                    m_unexpectedCallback = true;
+                }
+                m_beginBrushCalled = true;
+                m_brush.beginBrushLine = line;
+            }
+
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) override {
+                if (!m_beginBrushCalled || m_endBrushCalled) {
+                    m_unexpectedCallback = true;
+                }
+                m_endBrushCalled = true;
+                m_brush.endBrushStartLine = startLine;
+                m_brush.endBrushLineCount = lineCount;
+                m_brush.extraAttributes = extraAttributes;
+            }
+
+            void onBrushFace(const size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& /* status */) override {
+                if (!m_beginBrushCalled || m_endBrushCalled) {
+                    m_unexpectedCallback = true;
+                }
+                m_brush.faces.push_back(ParsedBrushFace{ line, point1, point2, point3, attribs, texAxisX, texAxisY });
+            }
+        };
+
         StandardMapParser::StandardMapParser(const char* begin, const char* end) :
+        m_begin(begin),
+        m_end(end),
         m_tokenizer(QuakeMapTokenizer(begin, end)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_nextParsedBrush(0) {}
 
         StandardMapParser::StandardMapParser(const std::string& str) :
+        m_begin(str.c_str()),
+        m_end(str.c_str() + str.size()),
         m_tokenizer(QuakeMapTokenizer(str)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_nextParsedBrush(0) {}
+
+        StandardMapParser::StandardMapParser(const char* begin, const char* end, const size_t line, const size_t column) :
+        m_begin(begin),
+        m_end(end),
+        m_tokenizer(QuakeMapTokenizer(begin, end, line, column)),
+        m_format(Model::MapFormat::Unknown),
+        m_nextParsedBrush(0) {}
 
         StandardMapParser::~StandardMapParser() {}
 
@@ -200,13 +363,18 @@ namespace TrenchBroom {
 
         void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status) {
             setFormat(format);
+            parseBrushesAhead();
 
             auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
                 expect(QuakeMapToken::OBrace, token);
                 parseEntity(status);
+                status.progress(m_tokenizer.progress());
                 token = m_tokenizer.peekToken();
             }
+
+            m_parsedBrushes.clear();
+            m_nextParsedBrush = 0;
         }
 
         void StandardMapParser::parseBrushes(const Model::MapFormat format, ParserStatus& status) {
@@ -234,6 +402,8 @@ namespace TrenchBroom {
 
         void StandardMapParser::reset() {
             m_tokenizer.reset();
+            m_parsedBrushes.clear();
+            m_nextParsedBrush = 0;
         }
 
         void StandardMapParser::setFormat(const Model::MapFormat format) {
@@ -309,6 +479,154 @@ namespace TrenchBroom {
             }
         }
 
+        namespace {
+            bool isWhitespace(const char c) {
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+
+            struct BrushRange {
+                const char* begin;
+                const char* end;
+                size_t line;
+                size_t column;
+            };
+
+            /**
+             * Finds the brushes of all entities in the given buffer by counting braces, skipping quoted strings and
+             * comments. Only braces which are surrounded by whitespace are counted so that texture names such as
+             * "{fence" do not throw off the count.
+             *
+             * This is only a heuristic since it doesn't tokenize the buffer. The parser must verify that each of the
+             * returned ranges actually contains exactly one brush.
+             *
+             * Lines and columns are counted in the same way as TokenizerState does.
+             */
+            std::vector<BrushRange> findBrushRanges(const char* begin, const char* end) {
+                auto result = std::vector<BrushRange>();
+
+                auto line = size_t(1);
+                auto column = size_t(1);
+                auto depth = size_t(0);
+                auto brush = BrushRange{ nullptr, nullptr, 0, 0 };
+
+                const auto* cur = begin;
+                const auto advance = [&]() {
+                    if (*cur == '\n' || (*cur == '\r' && (cur + 1 == end || *(cur + 1) != '\n'))) {
+                        ++line;
+                        column = 1;
+                    } else {
+                        ++column;
+                    }
+                    ++cur;
+                };
+
+                while (cur < end) {
+                    const auto c = *cur;
+                    if (c == '"') {
+                        advance();
+                        auto escaped = false;
+                        while (cur < end && (*cur != '"' || escaped)) {
+                            // same hack as in QuakeMapTokenizer for paths with trailing backslashes
+                            if (*cur == '"' && cur + 1 < end && (*(cur + 1) == '\n' || *(cur + 1) == '}')) {
+                                break;
+                            }
+                            escaped = *cur == '\\' && !escaped;
+                            advance();
+                        }
+                        if (cur == end) {
+                            // unterminated string, let the parser report the error
+                            return {};
+                        }
+                        advance();
+                    } else if (c == '/' && cur + 1 < end && *(cur + 1) == '/') {
+                        while (cur < end && *cur != '\n' && *cur != '\r') {
+                            advance();
+                        }
+                    } else if ((c == '{' || c == '}') && (cur == begin || isWhitespace(*(cur - 1))) && (cur + 1 == end || isWhitespace(*(cur + 1)))) {
+                        if (c == '{') {
+                            if (depth == 1) {
+                                brush = BrushRange{ cur, nullptr, line, column };
+                            }
+                            ++depth;
+                        } else {
+                            if (depth == 0) {
+                                return {};
+                            }
+                            --depth;
+                            if (depth == 1) {
+                                brush.end = cur + 1;
+                                result.push_back(brush);
+                            }
+                        }
+                        advance();
+                    } else {
+                        advance();
+                    }
+                }
+
+                return result;
+            }
+        }
+
+        /**
+         * Parses the brushes of all entities in parallel and stores the results. When the parser encounters one of
+         * these brushes later on, it replays the stored callbacks instead of parsing the brush again.
+         */
+        void StandardMapParser::parseBrushesAhead() {
+            m_parsedBrushes.clear();
+            m_nextParsedBrush = 0;
+
+            for (const auto& range : findBrushRanges(m_begin, m_end)) {
+                m_parsedBrushes.emplace_back(range.begin, range.end, range.line, range.column);
+            }
+
+            const auto format = m_format;
+            kdl::parallel_for(m_parsedBrushes.size(), [&](const size_t i) {
+                BrushParser parser(m_parsedBrushes[i], format);
+                parser.parse();
+            });
+        }
+
+        /**
+         * Checks whether the brush starting at the given opening brace token was parsed ahead of time, and if so,
+         * replays the recorded callbacks and moves the tokenizer to the end of the brush.
+         *
+         * Returns false if the brush must be parsed normally.
+         */
+        bool StandardMapParser::replayParsedBrush(const Token& token, ParserStatus& status) {
+            // the recorded faces of a brush are released as soon as the brush has been passed, otherwise they would be
+            // kept in memory alongside the faces created from them until the entire map is parsed
+            while (m_nextParsedBrush < m_parsedBrushes.size() && m_parsedBrushes[m_nextParsedBrush].begin < token.begin()) {
+                kdl::vec_clear_to_zero(m_parsedBrushes[m_nextParsedBrush].faces);
+                ++m_nextParsedBrush;
+            }
+
+            if (m_nextParsedBrush == m_parsedBrushes.size()) {
+                return false;
+            }
+
+            auto& brush = m_parsedBrushes[m_nextParsedBrush];
+            if (brush.begin != token.begin()) {
+                return false;
+            }
+
+            ++m_nextParsedBrush;
+            if (!brush.valid || brush.line != token.line() || brush.column != token.column()) {
+                kdl::vec_clear_to_zero(brush.faces);
+                return false;
+            }
+
+            beginBrush(brush.beginBrushLine, status);
+            for (const auto& face : brush.faces) {
+                brushFace(face.line, face.point1, face.point2, face.point3, face.attribs, face.texAxisX, face.texAxisY, status);
+            }
+            kdl::vec_clear_to_zero(brush.faces);
+            endBrush(brush.endBrushStartLine, brush.endBrushLineCount, brush.extraAttributes, status);
+
+            m_tokenizer.seek(brush.end, brush.endLine, brush.endColumn);
+            return true;
+        }
+
         void StandardMapParser::parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status) {
             // consume initial opening brace
             auto token = expect(QuakeMapToken::OBrace | QuakeMapToken::CBrace | QuakeMapToken::Eof, m_tokenizer.nextToken());
@@ -317,6 +635,10 @@ namespace TrenchBroom {
                 return;
             }
 
+            if (replayParsedBrush(token, status)) {
+                return;
+            }
+
             const auto startLine = token.line();
 
             token = m_tokenizer.peekToken();
@@ -325,7 +647,7 @@ namespace TrenchBroom {
                 expect(QuakeMapToken::String | QuakeMapToken::OParenthesis, token);
                 if (token.hasType(QuakeMapToken::String)) {
                     expect(std::vector<std::string>({ BrushPrimitiveId, PatchId }), token);
-                    if (token.data() == BrushPrimitiveId) {
+                    if (token.view() == BrushPrimitiveId) {
                         parseBrushPrimitive(status, startLine);
                     } else {
                         parsePatch(status, startLine);
@@ -638,11 +960,11 @@ namespace TrenchBroom {
         }
 
         std::string StandardMapParser::parseTextureName(ParserStatus& /* status */) {
-            auto textureName = m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
+            const auto textureName = m_tokenizer.readAnyStringView(QuakeMapTokenizer::Whitespace());
             if (textureName == Model::BrushFace::NoTextureName) {
-                textureName = "";
+                return "";
             }
-            return textureName;
+            return std::string(textureName);
         }
 
         std::tuple<vm::vec3, float, vm::vec3, float> StandardMapParser::parseValveTextureAxes(ParserStatus& /* status */) {
@@ -34,6 +34,7 @@
 #include <list>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -60,6 +61,7 @@ namespace TrenchBroom {
             bool m_skipEol;
         public:
             QuakeMapTokenizer(const char* begin, const char* end);
+            QuakeMapTokenizer(const char* begin, const char* end, size_t line, size_t column);
             QuakeMapTokenizer(const std::string& str);
 
             void setSkipEol(bool skipEol);
@@ -75,13 +77,28 @@ namespace TrenchBroom {
             static const std::string BrushPrimitiveId;
             static const std::string PatchId;
 
+            struct ParsedBrushFace;
+            struct ParsedBrush;
+            class BrushParser;
+
+            const char* m_begin;
+            const char* m_end;
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
+
+            /**
+             * Brushes that were parsed ahead of time on worker threads when parsing entities. Sorted by their position
+             * in the buffer.
+             */
+            std::vector<ParsedBrush> m_parsedBrushes;
+            size_t m_nextParsedBrush;
         public:
             StandardMapParser(const char* begin, const char* end);
             StandardMapParser(const std::string& str);
 
             virtual ~StandardMapParser() override;
+        private:
+            StandardMapParser(const char* begin, const char* end, size_t line, size_t column);
         protected:
             Model::MapFormat detectFormat();
 
@@ -96,6 +113,9 @@ namespace TrenchBroom {
             void parseEntity(ParserStatus& status);
             void parseEntityAttribute(std::list<Model::EntityAttribute>& attributes, AttributeNames& names, ParserStatus& status);
 
+            void parseBrushesAhead();
+            bool replayParsedBrush(const Token& token, ParserStatus& status);
+
             void parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status);
             void parseBrushPrimitive(ParserStatus& status, size_t startLine);
             void parseBrush(ParserStatus& status, size_t startLine, bool primitive);
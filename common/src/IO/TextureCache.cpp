@@ -0,0 +1,246 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureCache.h"
+
+#include "Color.h"
+#include "Ensure.h"
+#include "Exceptions.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/BinaryData.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            const char Magic[4] = { 'T', 'B', 'T', 'X' };
+
+            // increment this whenever the layout of the cache entries changes
+            const uint32_t Version = 1;
+
+            // mip chains never have more levels than this
+            const size_t MaxBufferCount = 32;
+
+            const std::string EntryExtension = "tbtex";
+        }
+
+        TextureCacheKey::TextureCacheKey(const std::string& salt, const Path& path, const uint64_t fileSize, const uint64_t hash) :
+        m_salt(salt),
+        m_path(path),
+        m_fileSize(fileSize),
+        m_hash(hash) {}
+
+        TextureCacheKey TextureCacheKey::compute(const File& file, const std::string& salt) {
+            const auto reader = file.reader().buffer();
+            const auto fileSize = static_cast<uint64_t>(reader.end() - reader.begin());
+            return TextureCacheKey(salt, file.path(), fileSize, BinaryData::hash(reader.begin(), reader.end()));
+        }
+
+        const std::string& TextureCacheKey::salt() const {
+            return m_salt;
+        }
+
+        const Path& TextureCacheKey::path() const {
+            return m_path;
+        }
+
+        uint64_t TextureCacheKey::fileSize() const {
+            return m_fileSize;
+        }
+
+        uint64_t TextureCacheKey::hash() const {
+            return m_hash;
+        }
+
+        Path TextureCacheKey::entryName() const {
+            auto data = std::string();
+            BinaryData::putString(data, m_salt);
+            BinaryData::putString(data, m_path.asString());
+            BinaryData::put(data, m_fileSize);
+            BinaryData::put(data, m_hash);
+
+            std::stringstream str;
+            str << std::hex << std::setw(16) << std::setfill('0') << BinaryData::hash(data.data(), data.data() + data.size()) << "." << EntryExtension;
+            return Path(str.str());
+        }
+
+        bool operator==(const TextureCacheKey& lhs, const TextureCacheKey& rhs) {
+            return lhs.m_fileSize == rhs.m_fileSize &&
+                   lhs.m_hash == rhs.m_hash &&
+                   lhs.m_path == rhs.m_path &&
+                   lhs.m_salt == rhs.m_salt;
+        }
+
+        bool operator!=(const TextureCacheKey& lhs, const TextureCacheKey& rhs) {
+            return !(lhs == rhs);
+        }
+
+        TextureCache::TextureCache(const Path& directory) :
+        m_directory(directory) {}
+
+        const Path& TextureCache::directory() const {
+            return m_directory;
+        }
+
+        Assets::Texture* TextureCache::read(const TextureCacheKey& key) const {
+            const auto entryPath = m_directory + key.entryName();
+            if (!Disk::fileExists(entryPath)) {
+                return nullptr;
+            }
+
+            try {
+                const auto file = Disk::openFile(entryPath);
+                auto reader = file->reader();
+
+                char magic[sizeof(Magic)];
+                reader.read(magic, sizeof(Magic));
+                if (std::memcmp(magic, Magic, sizeof(Magic)) != 0 || reader.read<uint32_t, uint32_t>() != Version) {
+                    return nullptr;
+                }
+
+                const auto salt = BinaryData::getString(reader);
+                const auto path = Path(BinaryData::getString(reader));
+                const auto fileSize = reader.read<uint64_t, uint64_t>();
+                const auto hash = reader.read<uint64_t, uint64_t>();
+                if (TextureCacheKey(salt, path, fileSize, hash) != key) {
+                    return nullptr;
+                }
+
+                const auto name = BinaryData::getString(reader);
+                const auto width = BinaryData::getSize(reader);
+                const auto height = BinaryData::getSize(reader);
+                const auto format = reader.read<uint32_t, GLenum>();
+                const auto type = static_cast<Assets::TextureType>(reader.read<uint8_t, int>());
+
+                Color averageColor;
+                for (size_t i = 0; i < 4; ++i) {
+                    averageColor[i] = reader.read<float, float>();
+                }
+
+                const auto bufferCount = BinaryData::getSize(reader);
+                if (bufferCount == 0 || bufferCount > MaxBufferCount) {
+                    return nullptr;
+                }
+
+                auto buffers = Assets::TextureBufferList(bufferCount);
+                for (auto& buffer : buffers) {
+                    const auto size = BinaryData::getSize(reader);
+                    if (!reader.canRead(size)) {
+                        return nullptr;
+                    }
+                    buffer.resize(size);
+                    reader.read(buffer.data(), size);
+                }
+
+                return new Assets::Texture(name, width, height, averageColor, std::move(buffers), format, type);
+            } catch (const Exception&) {
+                // a truncated or otherwise unreadable entry is treated like a missing one
+                return nullptr;
+            }
+        }
+
+        void TextureCache::write(const TextureCacheKey& key, const Assets::Texture& texture) const {
+            const auto& buffers = texture.buffersIfUnprepared();
+            ensure(!buffers.empty(), "texture has pixel data");
+
+            auto data = std::string(Magic, sizeof(Magic));
+            BinaryData::put(data, Version);
+            BinaryData::putString(data, key.salt());
+            BinaryData::putString(data, key.path().asString());
+            BinaryData::put(data, key.fileSize());
+            BinaryData::put(data, key.hash());
+
+            BinaryData::putString(data, texture.name());
+            BinaryData::putSize(data, texture.width());
+            BinaryData::putSize(data, texture.height());
+            BinaryData::put(data, static_cast<uint32_t>(texture.format()));
+            BinaryData::put(data, static_cast<uint8_t>(texture.type()));
+            for (size_t i = 0; i < 4; ++i) {
+                BinaryData::put(data, texture.averageColor()[i]);
+            }
+
+            BinaryData::putSize(data, buffers.size());
+            for (const auto& buffer : buffers) {
+                BinaryData::putSize(data, buffer.size());
+                data.append(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            }
+
+            Disk::writeFileAtomically(m_directory + key.entryName(), data);
+        }
+
+        void TextureCache::prune(const uint64_t maxSize) const {
+            struct Entry {
+                Path path;
+                int64_t modificationTime;
+                uint64_t size;
+            };
+
+            auto paths = std::vector<Path>();
+            try {
+                if (Disk::directoryExists(m_directory)) {
+                    paths = Disk::findItems(m_directory, FileExtensionMatcher(EntryExtension));
+                }
+            } catch (const FileSystemException&) {
+                // an unreadable cache directory is treated like an empty one
+                return;
+            }
+
+            auto entries = std::vector<Entry>();
+            uint64_t totalSize = 0u;
+            for (const auto& path : paths) {
+                try {
+                    const auto size = Disk::fileSize(path);
+                    entries.push_back(Entry{ path, Disk::modificationTime(path), size });
+                    totalSize += size;
+                } catch (const FileSystemException&) {
+                    // the entry was deleted concurrently
+                }
+            }
+
+            std::sort(std::begin(entries), std::end(entries), [](const auto& lhs, const auto& rhs) {
+                return lhs.modificationTime < rhs.modificationTime;
+            });
+
+            for (const auto& entry : entries) {
+                if (totalSize <= maxSize) {
+                    break;
+                }
+
+                try {
+                    Disk::deleteFile(entry.path);
+                    totalSize -= entry.size;
+                } catch (const FileSystemException&) {
+                    // the entry is being read or was deleted concurrently
+                }
+            }
+        }
+    }
+}
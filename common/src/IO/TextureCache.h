@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TextureCache
+#define TrenchBroom_TextureCache
+
+#include "Assets/Asset_Forward.h"
+#include "IO/IO_Forward.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Identifies the contents of a texture file and the settings of the reader that decodes it. A cached texture
+         * is only used if the key stored in the cache entry equals the key of the texture file that is being read.
+         */
+        class TextureCacheKey {
+        private:
+            std::string m_salt;
+            Path m_path;
+            uint64_t m_fileSize;
+            uint64_t m_hash;
+        public:
+            TextureCacheKey(const std::string& salt, const Path& path, uint64_t fileSize, uint64_t hash);
+
+            /**
+             * Computes the key of the given texture file. The key contains the path and the size of the file and a
+             * hash of its contents, so it is valid regardless of whether the file is on the disk or in an archive.
+             *
+             * @param file the texture file
+             * @param salt distinguishes textures which are decoded differently from the same file, e.g. with a
+             *     different palette
+             * @return the key
+             *
+             * @throw ReaderException if the contents of the given file cannot be read
+             */
+            static TextureCacheKey compute(const File& file, const std::string& salt);
+
+            const std::string& salt() const;
+            const Path& path() const;
+            uint64_t fileSize() const;
+            uint64_t hash() const;
+
+            /**
+             * Returns the name of the cache entry for this key.
+             */
+            Path entryName() const;
+
+            friend bool operator==(const TextureCacheKey& lhs, const TextureCacheKey& rhs);
+            friend bool operator!=(const TextureCacheKey& lhs, const TextureCacheKey& rhs);
+        };
+
+        /**
+         * Stores decoded textures in a directory on the disk so that they need not be decoded again in later
+         * sessions. Every texture is stored in a separate file together with its key, its average color, its type
+         * and all of its mip levels.
+         *
+         * The cache can be used concurrently from multiple threads. Cache entries are written in the host's byte
+         * order, so the cache directory is not meant to be shared between machines.
+         */
+        class TextureCache {
+        private:
+            Path m_directory;
+        public:
+            /**
+             * Creates a texture cache in the given directory. The directory is created when the first texture is
+             * written to the cache.
+             *
+             * @param directory the cache directory
+             */
+            explicit TextureCache(const Path& directory);
+
+            const Path& directory() const;
+
+            /**
+             * Reads the texture with the given key from the cache.
+             *
+             * @param key the key of the texture file
+             * @return an Assets::Texture object allocated with new, or nullptr if there is no valid cache entry for
+             *     the given key
+             */
+            Assets::Texture* read(const TextureCacheKey& key) const;
+
+            /**
+             * Writes the given texture to the cache, replacing any existing entry for the given key. The texture must
+             * not be prepared yet.
+             *
+             * @param key the key of the texture file which the given texture was decoded from
+             * @param texture the texture to write
+             *
+             * @throw FileSystemException if the cache entry cannot be written
+             */
+            void write(const TextureCacheKey& key, const Assets::Texture& texture) const;
+
+            /**
+             * Deletes the least recently written entries until the remaining entries occupy at most the given number
+             * of bytes. Entries which cannot be deleted, e.g. because they are being read, are skipped. Never throws.
+             *
+             * @param maxSize the maximum number of bytes which the cache entries may occupy
+             */
+            void prune(uint64_t maxSize) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCache) */
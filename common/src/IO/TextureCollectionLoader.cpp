@@ -21,13 +21,17 @@
 
 #include "Logger.h"
 #include "Assets/TextureCollection.h"
+#include "IO/AsyncTextureDecoder.h"
 #include "IO/DiskIO.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <kdl/vector_utils.h>
+
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,6 +52,21 @@ namespace TrenchBroom {
             return collection;
         }
 
+        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::vector<DeferredTexture>& deferredTextures) {
+            auto collection = std::make_unique<Assets::TextureCollection>(path);
+
+            for (auto file : doFindTextures(path, textureExtensions)) {
+                if (auto* texture = textureReader.readTextureHeader(file)) {
+                    collection->addTexture(texture);
+                    deferredTextures.push_back(DeferredTexture{ texture, file });
+                } else {
+                    collection->addTexture(textureReader.readTexture(file));
+                }
+            }
+
+            return collection;
+        }
+
         FileTextureCollectionLoader::FileTextureCollectionLoader(Logger& logger, const std::vector<IO::Path>& searchPaths) :
         TextureCollectionLoader(logger),
         m_searchPaths(searchPaths) {}
@@ -78,17 +97,13 @@ namespace TrenchBroom {
         TextureCollectionLoader::FileList DirectoryTextureCollectionLoader::doFindTextures(const Path& path, const std::vector<std::string>& extensions) {
             const auto texturePaths = m_gameFS.findItems(path, FileExtensionMatcher(extensions));
 
-            FileList result;
-            result.reserve(texturePaths.size());
-
-            for (const auto& texturePath : texturePaths) {
-                try {
-                    result.push_back(m_gameFS.openFile(texturePath));
-                } catch (const std::exception& e) {
-                    m_logger.warn() << e.what();
-                }
+            auto errors = std::vector<std::string>();
+            auto result = m_gameFS.openFiles(texturePaths, errors);
+            for (const auto& error : errors) {
+                m_logger.warn() << error;
             }
 
+            kdl::vec_erase(result, nullptr);
             return result;
         }
     }
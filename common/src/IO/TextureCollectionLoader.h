@@ -42,6 +42,19 @@ namespace TrenchBroom {
             virtual ~TextureCollectionLoader();
         public:
             std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+
+            /**
+             * Loads the given texture collection without decoding the pixel data of its textures if the given reader
+             * supports this. Every texture whose pixel data was not decoded is added to the given vector of deferred
+             * textures, and its pixel data must be decoded later.
+             *
+             * @param path the path of the texture collection
+             * @param textureExtensions the extensions of the texture files
+             * @param textureReader the texture reader
+             * @param deferredTextures the deferred textures are added to this vector
+             * @return the texture collection
+             */
+            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::vector<DeferredTexture>& deferredTextures);
         private:
             virtual FileList doFindTextures(const Path& path, const std::vector<std::string>& extensions) = 0;
         };
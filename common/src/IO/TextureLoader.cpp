@@ -33,17 +33,23 @@
 #include "IO/Path.h"
 #include "Model/GameConfig.h"
 
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger) :
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, std::shared_ptr<const TextureCache> textureCache, Logger& logger) :
+        TextureLoader(gameFS, fileSearchPaths, textureConfig, loadPalette(gameFS, textureConfig, logger), std::move(textureCache), logger) {}
+
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, const Assets::Palette& palette, std::shared_ptr<const TextureCache> textureCache, Logger& logger) :
         m_textureExtensions(getTextureExtensions(textureConfig)),
-        m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
+        m_textureReader(createTextureReader(gameFS, textureConfig, palette)),
         m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
+            m_textureReader->setCache(std::move(textureCache), getTextureCacheSalt(textureConfig, palette));
         }
 
         TextureLoader::~TextureLoader() = default;
@@ -52,16 +58,23 @@ namespace TrenchBroom {
             return textureConfig.format.extensions;
         }
 
-        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
+        std::string TextureLoader::getTextureCacheSalt(const Model::TextureConfig& textureConfig, const Assets::Palette& palette) {
+            // the palette affects the decoded pixels of indexed textures, and its file may change without its path
+            std::stringstream salt;
+            salt << textureConfig.format.format << ":" << std::hex << std::setw(16) << std::setfill('0') << palette.hash();
+            return salt.str();
+        }
+
+        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, const Assets::Palette& palette) {
             if (textureConfig.format.format == "idmip") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(1, true);
-                return std::make_unique<IdMipTextureReader>(nameStrategy, loadPalette(gameFS, textureConfig, logger));
+                return std::make_unique<IdMipTextureReader>(nameStrategy, palette);
             } else if (textureConfig.format.format == "hlmip") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(1, true);
                 return std::make_unique<HlMipTextureReader>(nameStrategy);
             } else if (textureConfig.format.format == "wal") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(2, true);
-                return std::make_unique<WalTextureReader>(nameStrategy, loadPalette(gameFS, textureConfig, logger));
+                return std::make_unique<WalTextureReader>(nameStrategy, palette);
             } else if (textureConfig.format.format == "image") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(2, true);
                 return std::make_unique<FreeImageTextureReader>(nameStrategy);
@@ -105,6 +118,18 @@ namespace TrenchBroom {
             return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
         }
 
+        std::unique_ptr<Assets::TextureCollection> TextureLoader::loadTextureCollection(const Path& path, std::vector<DeferredTexture>& deferredTextures) {
+            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader, deferredTextures);
+        }
+
+        std::shared_ptr<const TextureReader> TextureLoader::textureReader() const {
+            return m_textureReader;
+        }
+
+        void TextureLoader::setCompressTextures(const bool compressTextures) {
+            m_textureReader->setCompressTextures(compressTextures);
+        }
+
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
             textureManager.setTextureCollections(paths, *this);
         }
@@ -36,18 +36,37 @@ namespace TrenchBroom {
         class TextureLoader {
         private:
             std::vector<std::string> m_textureExtensions;
-            std::unique_ptr<TextureReader> m_textureReader;
+            std::shared_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
-            TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, std::shared_ptr<const TextureCache> textureCache, Logger& logger);
             ~TextureLoader();
         private:
+            TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, const Assets::Palette& palette, std::shared_ptr<const TextureCache> textureCache, Logger& logger);
+
             static std::vector<std::string> getTextureExtensions(const Model::TextureConfig& textureConfig);
-            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
+            static std::string getTextureCacheSalt(const Model::TextureConfig& textureConfig, const Assets::Palette& palette);
+            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, const Assets::Palette& palette);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
         public:
             std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path);
+
+            /**
+             * Loads the given texture collection, but defers decoding the pixel data of its textures if the texture
+             * reader supports this. See TextureCollectionLoader::loadTextureCollection.
+             */
+            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, std::vector<DeferredTexture>& deferredTextures);
+
+            /**
+             * Returns the texture reader, which can be used to decode deferred textures after this loader is gone.
+             */
+            std::shared_ptr<const TextureReader> textureReader() const;
+
+            /**
+             * Sets whether the loaded textures are block compressed, see TextureReader::setCompressTextures.
+             */
+            void setCompressTextures(bool compressTextures);
             void loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndMove(TextureLoader)
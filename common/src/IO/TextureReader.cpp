@@ -19,9 +19,12 @@
 
 #include "TextureReader.h"
 
+#include "Exceptions.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
+#include "IO/File.h"
 #include "IO/FileSystem.h"
+#include "IO/TextureCache.h"
 
 #include <algorithm>
 
@@ -76,14 +79,61 @@ namespace TrenchBroom {
         }
 
         TextureReader::TextureReader(const NameStrategy& nameStrategy) :
-        m_nameStrategy(nameStrategy.clone()) {}
+        m_nameStrategy(nameStrategy.clone()),
+        m_compressTextures(false) {}
 
         TextureReader::~TextureReader() {
             delete m_nameStrategy;
         }
 
+        void TextureReader::setCache(std::shared_ptr<const TextureCache> cache, const std::string& salt) {
+            m_cache = std::move(cache);
+            m_cacheSalt = salt;
+        }
+
+        void TextureReader::setCompressTextures(const bool compressTextures) {
+            m_compressTextures = compressTextures;
+        }
+
         Assets::Texture* TextureReader::readTexture(std::shared_ptr<File> file) const {
-            return doReadTexture(file);
+            if (m_cache == nullptr || !doIsCacheable()) {
+                return decodeTexture(file);
+            }
+
+            const auto key = TextureCacheKey::compute(*file, m_compressTextures ? m_cacheSalt + ":compressed" : m_cacheSalt);
+            if (auto* texture = m_cache->read(key)) {
+                return texture;
+            }
+
+            auto* texture = decodeTexture(file);
+            if (texture != nullptr && texture->hasBuffers()) {
+                try {
+                    m_cache->write(key, *texture);
+                } catch (const FileSystemException&) {
+                    // the texture was decoded successfully, we just have to decode it again next time
+                }
+            }
+            return texture;
+        }
+
+        Assets::Texture* TextureReader::decodeTexture(std::shared_ptr<File> file) const {
+            auto* texture = doReadTexture(file);
+            if (texture != nullptr && m_compressTextures) {
+                texture->compress();
+            }
+            return texture;
+        }
+
+        Assets::Texture* TextureReader::readTextureHeader(std::shared_ptr<File> file) const {
+            return doReadTextureHeader(file);
+        }
+
+        Assets::Texture* TextureReader::doReadTextureHeader(std::shared_ptr<File> /* file */) const {
+            return nullptr;
+        }
+
+        bool TextureReader::doIsCacheable() const {
+            return true;
         }
 
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
@@ -94,6 +144,18 @@ namespace TrenchBroom {
             return m_nameStrategy->textureName(path.lastComponent().asString(), path);
         }
 
+        const std::shared_ptr<const TextureCache>& TextureReader::cache() const {
+            return m_cache;
+        }
+
+        const std::string& TextureReader::cacheSalt() const {
+            return m_cacheSalt;
+        }
+
+        bool TextureReader::compressTextures() const {
+            return m_compressTextures;
+        }
+
         bool TextureReader::checkTextureDimensions(const size_t width, const size_t height) {
             return width <= 8192 && height <= 8192;
         }
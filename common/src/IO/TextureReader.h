@@ -83,16 +83,55 @@ namespace TrenchBroom {
             };
         private:
             NameStrategy* m_nameStrategy;
+            std::shared_ptr<const TextureCache> m_cache;
+            std::string m_cacheSalt;
+            bool m_compressTextures;
         protected:
             explicit TextureReader(const NameStrategy& nameStrategy);
         public:
             virtual ~TextureReader();
 
+            /**
+             * Sets the cache which readTexture consults before decoding a texture, and to which it adds every texture
+             * it decodes. Pass nullptr to disable caching.
+             *
+             * @param cache the texture cache
+             * @param salt identifies the settings of this reader which affect the decoded textures, e.g. the palette
+             */
+            void setCache(std::shared_ptr<const TextureCache> cache, const std::string& salt);
+
+            /**
+             * Sets whether readTexture block compresses the textures it decodes, see Assets::Texture::compress.
+             * Compressed and uncompressed textures are cached separately.
+             */
+            void setCompressTextures(bool compressTextures);
+
             Assets::Texture* readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads the name and the dimensions of the texture in the given file without decoding its pixel data. The
+             * returned texture has no pixel data, which can be decoded later by calling readTexture and passed to the
+             * returned texture with Assets::Texture::takeBuffers.
+             *
+             * Returns nullptr if this reader cannot read a texture without decoding it, or if the texture cannot be
+             * read. In that case, the texture must be read with readTexture.
+             *
+             * This function must be safe to call concurrently with readTexture for different files.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object allocated with new, or nullptr
+             */
+            Assets::Texture* readTextureHeader(std::shared_ptr<File> file) const;
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
+
+            const std::shared_ptr<const TextureCache>& cache() const;
+            const std::string& cacheSalt() const;
+            bool compressTextures() const;
         private:
+            Assets::Texture* decodeTexture(std::shared_ptr<File> file) const;
+
             /**
              * Loads a texture and returns an Assets::Texture object allocated with new. Should not throw exceptions to
              * report errors loading textures except for unrecoverable errors (out of memory, bugs, etc.). In all other
@@ -102,6 +141,13 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             virtual Assets::Texture* doReadTexture(std::shared_ptr<File> file) const = 0;
+            virtual Assets::Texture* doReadTextureHeader(std::shared_ptr<File> file) const;
+
+            /**
+             * Indicates whether the textures read by this reader can be stored in the texture cache. Readers which
+             * add information to their textures that does not come from the texture file must return false.
+             */
+            virtual bool doIsCacheable() const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
@@ -20,10 +20,12 @@
 #ifndef TrenchBroom_Token
 #define TrenchBroom_Token
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstdlib>
 #include <string>
-
-#include <kdl/string_utils.h>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -75,6 +77,14 @@ namespace TrenchBroom {
                 return std::string(m_begin, length());
             }
 
+            /**
+             * Returns a view of this token's characters in the tokenizer's buffer. Unlike data(), this does not copy
+             * the characters, but the returned view is only valid for as long as the buffer is.
+             */
+            std::string_view view() const {
+                return std::string_view(m_begin, length());
+            }
+
             size_t position() const {
                 return m_position;
             }
@@ -91,14 +101,57 @@ namespace TrenchBroom {
                 return m_column;
             }
 
+            /**
+             * Parses this token's characters as a floating point number directly from the tokenizer's buffer. Returns
+             * 0 if the characters cannot be parsed or if the value is out of range.
+             */
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                double result = 0.0;
+                const auto* begin = numberBegin();
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+                if (std::from_chars(begin, m_end, result).ec != std::errc()) {
+                    result = 0.0;
+                }
+#else
+                // floating point from_chars is not available everywhere, so copy into a small buffer for strtod
+                char buffer[64];
+                const auto count = static_cast<size_t>(m_end - begin);
+                if (count >= sizeof(buffer)) {
+                    return static_cast<T>(std::strtod(std::string(begin, m_end).c_str(), nullptr));
+                }
+                std::copy(begin, m_end, buffer);
+                buffer[count] = 0;
+                result = std::strtod(buffer, nullptr);
+#endif
+                return static_cast<T>(result);
             }
 
+            /**
+             * Parses this token's characters as a decimal integer directly from the tokenizer's buffer. Returns 0 if
+             * the characters cannot be parsed or if the value is out of range.
+             */
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                long result = 0l;
+                if (std::from_chars(numberBegin(), m_end, result).ec != std::errc()) {
+                    result = 0l;
+                }
+                return static_cast<T>(result);
+            }
+        private:
+            /**
+             * Skips leading whitespace and a leading plus sign, neither of which is accepted by std::from_chars.
+             */
+            const char* numberBegin() const {
+                const auto* begin = m_begin;
+                while (begin < m_end && (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r')) {
+                    ++begin;
+                }
+                if (begin < m_end && *begin == '+') {
+                    ++begin;
+                }
+                return begin;
             }
         };
     }
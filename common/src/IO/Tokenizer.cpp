@@ -24,18 +24,22 @@
 
 #include <kdl/string_format.h>
 
+#include <cassert>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
-        TokenizerState::TokenizerState(const char* begin, const char* end, const std::string& escapableChars, const char escapeChar) :
+        TokenizerState::TokenizerState(const char* begin, const char* end, const std::string& escapableChars, const char escapeChar, const size_t line, const size_t column) :
         m_begin(begin),
         m_cur(m_begin),
         m_end(end),
         m_escapableChars(escapableChars),
         m_escapeChar(escapeChar),
-        m_line(1),
-        m_column(1),
+        m_initialLine(line),
+        m_initialColumn(column),
+        m_line(m_initialLine),
+        m_column(m_initialColumn),
         m_escaped(false) {}
 
         TokenizerState* TokenizerState::clone(const char* begin, const char* end) const {
@@ -82,7 +86,10 @@ namespace TrenchBroom {
             return !eof() && m_escaped && m_escapableChars.find(curChar()) != std::string::npos;
         }
 
-        std::string TokenizerState::unescape(const std::string& str) {
+        std::string TokenizerState::unescape(const std::string_view str) {
+            if (str.find(m_escapeChar) == std::string_view::npos) {
+                return std::string(str);
+            }
             return kdl::str_unescape(str, m_escapableChars, m_escapeChar);
         }
 
@@ -138,10 +145,18 @@ namespace TrenchBroom {
             ++m_cur;
         }
 
+        void TokenizerState::seek(const char* pos, const size_t line, const size_t column) {
+            assert(pos >= m_begin && pos <= m_end);
+            m_cur = pos;
+            m_line = line;
+            m_column = column;
+            m_escaped = false;
+        }
+
         void TokenizerState::reset() {
             m_cur = m_begin;
-            m_line = 1;
-            m_column = 1;
+            m_line = m_initialLine;
+            m_column = m_initialColumn;
             m_escaped = false;
         }
 
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -34,11 +35,13 @@ namespace TrenchBroom {
             const char* m_end;
             std::string m_escapableChars;
             char m_escapeChar;
+            size_t m_initialLine;
+            size_t m_initialColumn;
             size_t m_line;
             size_t m_column;
             bool m_escaped;
         public:
-            TokenizerState(const char* begin, const char* end, const std::string& escapableChars, char escapeChar);
+            TokenizerState(const char* begin, const char* end, const std::string& escapableChars, char escapeChar, size_t line = 1, size_t column = 1);
 
             TokenizerState* clone(const char* begin, const char* end) const;
 
@@ -55,7 +58,7 @@ namespace TrenchBroom {
             size_t column() const;
 
             bool escaped() const;
-            std::string unescape(const std::string& str);
+            std::string unescape(std::string_view str);
             void resetEscaped();
 
             bool eof() const;
@@ -65,6 +68,7 @@ namespace TrenchBroom {
 
             void advance(size_t offset);
             void advance();
+            void seek(const char* pos, size_t line, size_t column);
             void reset();
 
             void errorIfEof() const;
@@ -109,6 +113,13 @@ namespace TrenchBroom {
             Tokenizer(const std::string& str, const std::string& escapableChars, const char escapeChar) :
             m_state(std::make_shared<TokenizerState>(str.c_str(), str.c_str() + str.size(), escapableChars, escapeChar)) {}
 
+            /**
+             * Creates a tokenizer for a range of a larger buffer. The given line and column are the position of the
+             * given begin pointer within the larger buffer, so that the tokens report their positions relative to it.
+             */
+            Tokenizer(const char* begin, const char* end, const std::string& escapableChars, const char escapeChar, const size_t line, const size_t column) :
+            m_state(std::make_shared<TokenizerState>(begin, end, escapableChars, escapeChar, line, column)) {}
+
             template <typename OtherType>
             explicit Tokenizer(Tokenizer<OtherType>& nestedTokenizer) :
             m_state(nestedTokenizer.m_state) {}
@@ -159,15 +170,22 @@ namespace TrenchBroom {
             }
 
             std::string readAnyString(const std::string& delims) {
+                return std::string(readAnyStringView(delims));
+            }
+
+            /**
+             * Like readAnyString, but returns a view into the tokenizer's buffer instead of copying the string.
+             */
+            std::string_view readAnyStringView(const std::string& delims) {
                 while (isWhitespace(curChar())) {
                     advance();
                 }
                 const char* startPos = curPos();
                 const char* endPos = (curChar() == '"' ? readQuotedString() : readUntil(delims));
-                return std::string(startPos, static_cast<size_t>(endPos - startPos));
+                return std::string_view(startPos, static_cast<size_t>(endPos - startPos));
             }
 
-            std::string unescapeString(const std::string& str) const {
+            std::string unescapeString(const std::string_view str) const {
                 return m_state->unescape(str);
             }
 
@@ -211,6 +229,15 @@ namespace TrenchBroom {
             void restore(const TokenizerState& snapshot) {
                 m_state->restore(snapshot);
             }
+
+            /**
+             * Moves this tokenizer to the given position without tokenizing the skipped characters. The caller must
+             * pass the line and column of the given position, and the given position must not be preceded by an
+             * escape character.
+             */
+            void seek(const char* pos, const size_t line, const size_t column) {
+                m_state->seek(pos, line, column);
+            }
         protected:
             size_t offset(const char* ptr) const {
                 return m_state->offset(ptr);
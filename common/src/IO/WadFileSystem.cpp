@@ -106,7 +106,7 @@ namespace TrenchBroom {
 
                 const auto path = IO::Path(entryName).addExtension(entryType);
                 auto file = std::make_shared<FileView>(path, m_file, entryAddress, entrySize);
-                m_root.addFile(path, file);
+                addFile(path, file);
             }
         }
     }
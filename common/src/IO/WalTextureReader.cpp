@@ -57,11 +57,43 @@ namespace TrenchBroom {
             }
         }
 
+        Assets::Texture* WalTextureReader::doReadTextureHeader(std::shared_ptr<File> file) const {
+            const auto& path = file->path();
+            auto reader = file->reader().buffer();
+
+            try {
+                const char version = reader.readChar<char>();
+                if (version == 3) {
+                    // the type of a Daikatana WAL texture depends on its pixel data
+                    const auto name = reader.readString(WalLayout::TextureNameLength);
+                    reader.seekForward(3); // garbage
+
+                    const auto width = reader.readSize<uint32_t>();
+                    const auto height = reader.readSize<uint32_t>();
+                    if (!checkTextureDimensions(width, height)) {
+                        return nullptr;
+                    }
+                    return new Assets::Texture(textureName(name, path), width, height, GL_RGBA, Assets::TextureType::Opaque);
+                } else {
+                    reader.seekFromBegin(0);
+                    const auto name = reader.readString(WalLayout::TextureNameLength);
+                    const auto width = reader.readSize<uint32_t>();
+                    const auto height = reader.readSize<uint32_t>();
+                    if (!checkTextureDimensions(width, height) || !m_palette.initialized()) {
+                        return nullptr;
+                    }
+                    return new Assets::Texture(textureName(name, path), width, height, GL_RGBA, Assets::TextureType::Opaque);
+                }
+            } catch (const ReaderException&) {
+                return nullptr;
+            }
+        }
+
         Assets::Texture* WalTextureReader::readQ2Wal(Reader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 4;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const std::string name = reader.readString(WalLayout::TextureNameLength);
             const size_t width = reader.readSize<uint32_t>();
@@ -83,9 +115,9 @@ namespace TrenchBroom {
 
         Assets::Texture* WalTextureReader::readDkWal(Reader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 9;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const char version = reader.readChar<char>();
             ensure(version == 3, "Unknown WAL texture version");
@@ -128,7 +160,7 @@ namespace TrenchBroom {
         }
 
         bool WalTextureReader::readMips(const Assets::Palette& palette, const size_t mipLevels, const size_t offsets[], const size_t width, const size_t height, Reader& reader, Assets::TextureBufferList& buffers, Color& averageColor, const Assets::PaletteTransparency transparency) {
-            static Color tempColor;
+            Color tempColor;
 
             auto hasTransparency = false;
             for (size_t i = 0; i < mipLevels; ++i) {
@@ -37,6 +37,7 @@ namespace TrenchBroom {
             WalTextureReader(const NameStrategy& nameStrategy, const Assets::Palette& palette = Assets::Palette());
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureHeader(std::shared_ptr<File> file) const override;
             Assets::Texture* readQ2Wal(Reader& reader, const Path& path) const;
             Assets::Texture* readDkWal(Reader& reader, const Path& path) const;
             size_t readMipOffsets(size_t maxMipLevels, size_t offsets[], size_t width, size_t height, Reader& reader) const;
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorkerPool.h"
+
+#include "Ensure.h"
+
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace IO {
+        WorkerPool& WorkerPool::instance() {
+            // leave one hardware thread to the UI
+            static WorkerPool pool(std::max(size_t(1), kdl::parallel_thread_count() - 1u));
+            return pool;
+        }
+
+        WorkerPool::WorkerPool(const size_t threadCount) :
+        m_threadCount(threadCount),
+        m_stop(false) {
+            ensure(m_threadCount > 0u, "thread count must be positive");
+        }
+
+        WorkerPool::~WorkerPool() {
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                m_stop = true;
+                m_tasks.clear();
+            }
+            m_taskAdded.notify_all();
+
+            for (auto& thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        size_t WorkerPool::threadCount() const {
+            return m_threadCount;
+        }
+
+        void WorkerPool::post(const void* owner, std::function<void()> task) {
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                startThreads();
+                m_tasks.push_back(Task{ owner, std::move(task) });
+            }
+            m_taskAdded.notify_one();
+        }
+
+        void WorkerPool::cancel(const void* owner) {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            m_tasks.erase(std::remove_if(std::begin(m_tasks), std::end(m_tasks),
+                                         [&](const auto& task) { return task.owner == owner; }),
+                          std::end(m_tasks));
+            m_taskDone.wait(lock, [&]() {
+                return std::find(std::begin(m_running), std::end(m_running), owner) == std::end(m_running);
+            });
+        }
+
+        void WorkerPool::startThreads() {
+            if (!m_threads.empty()) {
+                return;
+            }
+
+            m_threads.reserve(m_threadCount);
+            for (size_t i = 0u; i < m_threadCount; ++i) {
+                m_threads.emplace_back([this]() { run(); });
+            }
+        }
+
+        void WorkerPool::run() {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            while (true) {
+                m_taskAdded.wait(lock, [&]() { return m_stop || !m_tasks.empty(); });
+                if (m_stop) {
+                    return;
+                }
+
+                auto task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                m_running.push_back(task.owner);
+
+                lock.unlock();
+                task.function();
+                lock.lock();
+
+                m_running.erase(std::find(std::begin(m_running), std::end(m_running), task.owner));
+                m_taskDone.notify_all();
+            }
+        }
+    }
+}
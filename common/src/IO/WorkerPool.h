@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_WorkerPool
+#define TrenchBroom_WorkerPool
+
+#include "Macros.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Runs tasks on a fixed number of worker threads in the order in which they were posted. The background
+         * loaders share a single pool so that they don't compete for the hardware threads with pools of their own.
+         *
+         * Every task is posted on behalf of an owner. Before an owner is destroyed, it must call cancel to discard its
+         * pending tasks and to wait for its running tasks.
+         */
+        class WorkerPool {
+        private:
+            struct Task {
+                const void* owner;
+                std::function<void()> function;
+            };
+
+            const size_t m_threadCount;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_taskAdded;
+            std::condition_variable m_taskDone;
+
+            std::deque<Task> m_tasks;
+
+            /**
+             * The owners of the tasks that are currently running.
+             */
+            std::vector<const void*> m_running;
+            bool m_stop;
+
+            std::vector<std::thread> m_threads;
+        public:
+            /**
+             * Returns the pool shared by the background loaders. It leaves one hardware thread to the UI.
+             */
+            static WorkerPool& instance();
+
+            explicit WorkerPool(size_t threadCount);
+            ~WorkerPool();
+
+            size_t threadCount() const;
+
+            /**
+             * Schedules the given task. The worker threads are started when the first task is posted.
+             *
+             * @param owner the owner of the task
+             * @param task the task
+             */
+            void post(const void* owner, std::function<void()> task);
+
+            /**
+             * Discards the pending tasks of the given owner and blocks until its running tasks are done. Must not be
+             * called by a task of the given owner.
+             *
+             * @param owner the owner
+             */
+            void cancel(const void* owner);
+        private:
+            void startThreads();
+            void run();
+
+            deleteCopyAndMove(WorkerPool)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_WorkerPool) */
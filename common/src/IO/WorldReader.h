@@ -37,6 +37,12 @@ namespace TrenchBroom {
             WorldReader(const std::string& str);
 
             std::unique_ptr<Model::World> read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Reads the world from the given map cache instead of parsing the map text. The resulting world is the
+             * same as the world returned by read for the map text that the cache was written for.
+             */
+            std::unique_ptr<Model::World> read(MapCacheReader& cache, const vm::bbox3& worldBounds, ParserStatus& status);
         private: // implement MapReader interface
             Model::ModelFactory& initialize(Model::MapFormat format) override;
             Model::Node* onWorldspawn(const std::list<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
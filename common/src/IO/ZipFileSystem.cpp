@@ -22,43 +22,105 @@
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
+        namespace ZipLayout {
+            static const mz_uint32 LocalHeaderSignature  = 0x04034b50;
+            static const size_t LocalHeaderSize          = 30;
+            static const size_t LocalHeaderNameLengthOfs  = 26;
+            static const size_t LocalHeaderExtraLengthOfs = 28;
+        }
+
+        static size_t readUInt16(const char* cur) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(cur);
+            return static_cast<size_t>(bytes[0]) | static_cast<size_t>(bytes[1]) << 8;
+        }
+
+        static mz_uint32 readUInt32(const char* cur) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(cur);
+            return static_cast<mz_uint32>(bytes[0]) | static_cast<mz_uint32>(bytes[1]) << 8 | static_cast<mz_uint32>(bytes[2]) << 16 | static_cast<mz_uint32>(bytes[3]) << 24;
+        }
+
         // ZipFileSystem::ZipCompressedFile
 
-        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(ZipFileSystem* owner, const mz_uint fileIndex) :
+        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(ZipFileSystem* owner, const mz_uint fileIndex, Path path, const mz_zip_archive_file_stat& stat) :
         m_owner(owner),
-        m_fileIndex(fileIndex) {}
+        m_fileIndex(fileIndex),
+        m_path(std::move(path)),
+        m_method(stat.m_method),
+        m_crc32(stat.m_crc32),
+        m_localHeaderOffset(static_cast<size_t>(stat.m_local_header_ofs)),
+        m_compressedSize(static_cast<size_t>(stat.m_comp_size)),
+        m_uncompressedSize(static_cast<size_t>(stat.m_uncomp_size)) {}
 
         std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
+            if (auto file = m_owner->findCachedFile(m_fileIndex)) {
+                return file;
+            }
+
+            auto file = std::make_shared<OwningBufferFile>(m_path, inflate(), m_uncompressedSize);
+            m_owner->cacheFile(m_fileIndex, file, m_uncompressedSize);
+            return file;
+        }
 
-            mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
-                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+        std::unique_ptr<char[]> ZipFileSystem::ZipCompressedFile::inflate() const {
+            const auto* archiveBegin = m_owner->m_file->begin();
+            const auto archiveSize = m_owner->m_file->size();
+
+            if (m_localHeaderOffset + ZipLayout::LocalHeaderSize > archiveSize) {
+                throw FileSystemException("Invalid local header offset for " + m_path.asString());
+            }
+
+            const auto* localHeader = archiveBegin + m_localHeaderOffset;
+            if (readUInt32(localHeader) != ZipLayout::LocalHeaderSignature) {
+                throw FileSystemException("Invalid local header signature for " + m_path.asString());
+            }
+
+            const auto dataOffset = m_localHeaderOffset + ZipLayout::LocalHeaderSize
+                + readUInt16(localHeader + ZipLayout::LocalHeaderNameLengthOfs)
+                + readUInt16(localHeader + ZipLayout::LocalHeaderExtraLengthOfs);
+            if (dataOffset + m_compressedSize > archiveSize) {
+                throw FileSystemException("Compressed data exceeds archive for " + m_path.asString());
             }
 
-            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-            auto data = std::make_unique<char[]>(uncompressedSize);
-            auto* begin = data.get();
+            auto data = std::make_unique<char[]>(m_uncompressedSize);
+            const auto* compressedData = archiveBegin + dataOffset;
 
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
-                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+            if (m_method == 0) {
+                if (m_compressedSize != m_uncompressedSize) {
+                    throw FileSystemException("Size mismatch for stored file " + m_path.asString());
+                }
+                std::copy(compressedData, compressedData + m_compressedSize, data.get());
+            } else if (m_method == MZ_DEFLATED) {
+                const auto size = tinfl_decompress_mem_to_mem(data.get(), m_uncompressedSize, compressedData, m_compressedSize, 0);
+                if (size != m_uncompressedSize) {
+                    throw FileSystemException("Could not inflate " + m_path.asString());
+                }
+            } else {
+                throw FileSystemException("Unsupported compression method for " + m_path.asString());
             }
 
-            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+            if (mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(data.get()), m_uncompressedSize) != m_crc32) {
+                throw FileSystemException("CRC check failed for " + m_path.asString());
+            }
+
+            return data;
         }
 
         // ZipFileSystem
 
+        const size_t ZipFileSystem::MaxCacheSize = 16u * 1024u * 1024u;
+
         ZipFileSystem::ZipFileSystem(const Path& path) :
         ZipFileSystem(nullptr, path) {}
 
         ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
-        ImageFileSystem(std::move(next), path) {
+        ImageFileSystem(std::move(next), path),
+        m_cacheSize(0u) {
             initialize();
         }
 
@@ -69,15 +131,20 @@ namespace TrenchBroom {
         void ZipFileSystem::doReadDirectory() {
             mz_zip_zero_struct(&m_archive);
 
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
+            if (mz_zip_reader_init_mem(&m_archive, m_file->begin(), m_file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Error calling mz_zip_reader_init_mem");
             }
 
             const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
             for (mz_uint i = 0; i < numFiles; ++i) {
                 if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
-                    const auto path = Path(filename(i));
-                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(this, i));
+                    mz_zip_archive_file_stat stat;
+                    if (!mz_zip_reader_file_stat(&m_archive, i, &stat)) {
+                        throw FileSystemException("mz_zip_reader_file_stat failed for " + filename(i));
+                    }
+
+                    auto path = Path(filename(i));
+                    addFile(path, std::make_unique<ZipCompressedFile>(this, i, path, stat));
                 }
             }
 
@@ -105,5 +172,41 @@ namespace TrenchBroom {
 
             return result;
         }
+
+        std::shared_ptr<File> ZipFileSystem::findCachedFile(const mz_uint fileIndex) {
+            const auto lock = std::lock_guard<std::mutex>(m_cacheMutex);
+            auto it = m_cache.find(fileIndex);
+            if (it == std::end(m_cache)) {
+                return nullptr;
+            }
+
+            m_cacheOrder.splice(std::begin(m_cacheOrder), m_cacheOrder, it->second.position);
+            return it->second.file;
+        }
+
+        void ZipFileSystem::cacheFile(const mz_uint fileIndex, std::shared_ptr<File> file, const size_t size) {
+            if (size > MaxCacheSize) {
+                return;
+            }
+
+            const auto lock = std::lock_guard<std::mutex>(m_cacheMutex);
+            if (m_cache.count(fileIndex) > 0u) {
+                // another thread inflated the same file concurrently
+                return;
+            }
+
+            while (m_cacheSize + size > MaxCacheSize) {
+                const auto evictedIndex = m_cacheOrder.back();
+                m_cacheOrder.pop_back();
+
+                auto it = m_cache.find(evictedIndex);
+                m_cacheSize -= it->second.size;
+                m_cache.erase(it);
+            }
+
+            m_cacheOrder.push_front(fileIndex);
+            m_cache[fileIndex] = CacheEntry{ std::move(file), size, std::begin(m_cacheOrder) };
+            m_cacheSize += size;
+        }
     }
 }
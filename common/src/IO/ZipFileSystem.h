@@ -23,7 +23,10 @@
 #include "IO/ImageFileSystem.h"
 #include "IO/IO_Forward.h"
 
+#include <list>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <miniz/miniz.h>
 
@@ -33,16 +36,48 @@ namespace TrenchBroom {
         private:
             mz_zip_archive m_archive;
         private:
+            /**
+             * A compressed file in the archive. Its data is inflated directly from the memory mapped archive
+             * without accessing m_archive, so several files can be opened concurrently.
+             */
             class ZipCompressedFile : public FileEntry {
             private:
                 ZipFileSystem* m_owner;
                 mz_uint m_fileIndex;
+                Path m_path;
+                mz_uint16 m_method;
+                mz_uint32 m_crc32;
+                size_t m_localHeaderOffset;
+                size_t m_compressedSize;
+                size_t m_uncompressedSize;
             public:
-                ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex);
+                ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex, Path path, const mz_zip_archive_file_stat& stat);
             private:
                 std::shared_ptr<File> doOpen() const override;
+                std::unique_ptr<char[]> inflate() const;
             };
             friend class ZipCompressedFile;
+
+            struct CacheEntry {
+                std::shared_ptr<File> file;
+                size_t size;
+                std::list<mz_uint>::iterator position;
+            };
+
+            /**
+             * Recently inflated files by their index in the archive, so that files which are opened repeatedly,
+             * e.g. the images of shaders, are not inflated every time. The cache is bounded by the total uncompressed
+             * size of its files, and the least recently used files are evicted first.
+             */
+            std::unordered_map<mz_uint, CacheEntry> m_cache;
+            std::list<mz_uint> m_cacheOrder;
+            size_t m_cacheSize;
+            std::mutex m_cacheMutex;
+        public:
+            /**
+             * The maximum total uncompressed size of the cached files of one archive.
+             */
+            static const size_t MaxCacheSize;
         public:
             explicit ZipFileSystem(const Path& path);
             ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
@@ -51,6 +86,9 @@ namespace TrenchBroom {
             void doReadDirectory() override;
         private:
             std::string filename(mz_uint fileIndex);
+
+            std::shared_ptr<File> findCachedFile(mz_uint fileIndex);
+            void cacheFile(mz_uint fileIndex, std::shared_ptr<File> file, size_t size);
         };
     }
 }
@@ -1164,6 +1164,14 @@ namespace TrenchBroom {
         }
 
         std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<Brush*>& subtrahends) const {
+            return createBrushes(factory, worldBounds, defaultTextureName, subtractGeometry(subtrahends), subtrahends);
+        }
+
+        std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const {
+            return subtract(factory, worldBounds, defaultTextureName, std::vector<Brush*>{subtrahend});
+        }
+
+        std::vector<BrushGeometry> Brush::subtractGeometry(const std::vector<Brush*>& subtrahends) const {
             auto result = std::vector<BrushGeometry>{*m_geometry};
 
             for (auto* subtrahend : subtrahends) {
@@ -1181,10 +1189,14 @@ namespace TrenchBroom {
                 result = std::move(nextResults);
             }
 
+            return result;
+        }
+
+        std::vector<Brush*> Brush::createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<BrushGeometry>& fragments, const std::vector<Brush*>& subtrahends) const {
             std::vector<Brush*> brushes;
-            brushes.reserve(result.size());
+            brushes.reserve(fragments.size());
 
-            for (const auto& geometry : result) {
+            for (const auto& geometry : fragments) {
                 try {
                     auto* brush = createBrush(factory, worldBounds, defaultTextureName, geometry, subtrahends);
                     brushes.push_back(brush);
@@ -1194,10 +1206,6 @@ namespace TrenchBroom {
             return brushes;
         }
 
-        std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const {
-            return subtract(factory, worldBounds, defaultTextureName, std::vector<Brush*>{subtrahend});
-        }
-
         void Brush::intersect(const vm::bbox3& worldBounds, const Brush* brush) {
             for (const auto* face : brush->faces()) {
                 addFace(face->clone());
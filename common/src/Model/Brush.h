@@ -229,6 +229,30 @@ namespace TrenchBroom {
              */
             std::vector<Brush*> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<Brush*>& subtrahends) const;
             std::vector<Brush*> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const;
+
+            /**
+             * Computes the geometry of subtracting the given subtrahends from `this` without creating any brushes.
+             *
+             * Only the brush geometries are read, and no faces or face attributes are created, so this can be called
+             * concurrently for different brushes. Pass the result to createBrushes to obtain the subtraction result.
+             *
+             * @param subtrahends brushes to subtract from `this`. The passed-in brushes are not modified.
+             * @return the geometries of the fragments
+             */
+            std::vector<BrushGeometry> subtractGeometry(const std::vector<Brush*>& subtrahends) const;
+
+            /**
+             * Turns the fragments computed by subtractGeometry into brushes. Creating the brushes copies face attributes,
+             * which updates the usage counts of their textures, so this must be called on the main thread.
+             *
+             * @param factory the model factory
+             * @param worldBounds the world bounds
+             * @param defaultTextureName default texture name
+             * @param fragments the fragments computed by subtractGeometry
+             * @param subtrahends the subtrahends that were passed to subtractGeometry
+             * @return the subtraction result
+             */
+            std::vector<Brush*> createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<BrushGeometry>& fragments, const std::vector<Brush*>& subtrahends) const;
             void intersect(const vm::bbox3& worldBounds, const Brush* brush);
 
             // transformation
@@ -124,7 +124,7 @@ namespace TrenchBroom {
         }
 
         BrushFaceSnapshot* BrushFace::takeSnapshot() {
-            return new BrushFaceSnapshot(this, *m_texCoordSystem);
+            return new BrushFaceSnapshot(this);
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
@@ -631,6 +631,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -20,22 +20,199 @@
 #include "BrushFaceSnapshot.h"
 
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
 #include "Model/TexCoordSystem.h"
 
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 namespace TrenchBroom {
     namespace Model {
-        BrushFaceSnapshot::BrushFaceSnapshot(BrushFace* face, TexCoordSystem& coordSystem) :
-        m_faceRef(face),
-        m_attribs(face->attribs().takeSnapshot()),
-        m_coordSystemSnapshot(coordSystem.takeSnapshot()) {}
+        const size_t BrushFaceSnapshot::NoIndex = std::numeric_limits<size_t>::max();
+
+        static bool equalAttribs(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs) {
+            // offset, scale and rotation are recorded per face, and snapshots don't reference textures
+            return lhs.textureName() == rhs.textureName() &&
+                lhs.surfaceContents() == rhs.surfaceContents() &&
+                lhs.surfaceFlags() == rhs.surfaceFlags() &&
+                lhs.surfaceValue() == rhs.surfaceValue() &&
+                lhs.color() == rhs.color();
+        }
+
+        static size_t addAttribs(std::vector<BrushFaceAttributes>& table, const BrushFaceAttributes& attribs) {
+            // faces with equal attributes share one copy of them
+            auto it = std::find_if(std::begin(table), std::end(table), [&](const BrushFaceAttributes& other) {
+                return equalAttribs(attribs, other);
+            });
+            if (it == std::end(table)) {
+                it = table.insert(it, attribs.takeSnapshot());
+            }
+            return static_cast<size_t>(std::distance(std::begin(table), it));
+        }
+
+        static size_t addAxes(std::vector<vm::vec3>& axes, const vm::vec3& xAxis, const vm::vec3& yAxis) {
+            const auto index = axes.size();
+            axes.push_back(xAxis);
+            axes.push_back(yAxis);
+            return index;
+        }
+
+        BrushFaceSnapshot::BrushFaceSnapshot() = default;
+
+        BrushFaceSnapshot::BrushFaceSnapshot(BrushFace* face) {
+            takeSnapshot(face);
+        }
 
         BrushFaceSnapshot::~BrushFaceSnapshot() = default;
 
+        void BrushFaceSnapshot::takeSnapshot(BrushFace* face) {
+            const auto& attribs = face->attribs();
+            auto faceSnapshot = FaceSnapshot{
+                BrushFaceReference(face),
+                Field_Offset | Field_Scale | Field_Rotation | Field_Attribs,
+                attribs.offset(),
+                attribs.scale(),
+                attribs.rotation(),
+                addAttribs(m_attribs, attribs),
+                NoIndex
+            };
+
+            // only parallel texture coordinate systems can take a snapshot
+            if (face->takeTexCoordSystemSnapshot() != nullptr) {
+                faceSnapshot.fields |= Field_Axes;
+                faceSnapshot.axesIndex = addAxes(m_axes, face->textureXAxis(), face->textureYAxis());
+            }
+
+            m_faces.push_back(faceSnapshot);
+        }
+
         void BrushFaceSnapshot::restore() {
-            auto* face = m_faceRef.resolve();
-            face->setAttribs(m_attribs);
-            if (m_coordSystemSnapshot != nullptr) {
-                face->restoreTexCoordSystemSnapshot(*m_coordSystemSnapshot);
+            for (const auto& faceSnapshot : m_faces) {
+                restoreFace(faceSnapshot, faceSnapshot.faceRef.resolve());
+            }
+        }
+
+        void BrushFaceSnapshot::compact() {
+            std::vector<FaceSnapshot> changedFaces;
+            std::vector<BrushFaceAttributes> changedAttribs;
+            std::vector<vm::vec3> changedAxes;
+            for (const auto& faceSnapshot : m_faces) {
+                const auto fields = changedFields(faceSnapshot, faceSnapshot.faceRef.resolve());
+                if (fields == 0u) {
+                    continue;
+                }
+
+                auto changedFace = faceSnapshot;
+                changedFace.fields = fields;
+                changedFace.attribsIndex = (fields & Field_Attribs) ? addAttribs(changedAttribs, m_attribs[faceSnapshot.attribsIndex]) : NoIndex;
+                changedFace.axesIndex = (fields & Field_Axes) ? addAxes(changedAxes, m_axes[faceSnapshot.axesIndex], m_axes[faceSnapshot.axesIndex + 1]) : NoIndex;
+                changedFaces.push_back(changedFace);
+            }
+
+            changedFaces.shrink_to_fit();
+            changedAttribs.shrink_to_fit();
+            changedAxes.shrink_to_fit();
+
+            m_faces = std::move(changedFaces);
+            m_attribs = std::move(changedAttribs);
+            m_axes = std::move(changedAxes);
+        }
+
+        void BrushFaceSnapshot::merge(const BrushFaceSnapshot& other) {
+            std::vector<const BrushFace*> faces;
+            faces.reserve(m_faces.size());
+            for (const auto& faceSnapshot : m_faces) {
+                faces.push_back(faceSnapshot.faceRef.resolve());
+            }
+
+            for (const auto& theirs : other.m_faces) {
+                const auto* face = theirs.faceRef.resolve();
+                const auto it = std::find(std::begin(faces), std::end(faces), face);
+                const auto index = static_cast<size_t>(std::distance(std::begin(faces), it));
+                if (it == std::end(faces)) {
+                    m_faces.push_back(FaceSnapshot{ theirs.faceRef, 0u, theirs.offset, theirs.scale, theirs.rotation, NoIndex, NoIndex });
+                    faces.push_back(face);
+                }
+
+                // this snapshot holds the older value of every attribute that both snapshots record
+                auto& mine = m_faces[index];
+                const auto missing = theirs.fields & ~mine.fields;
+                if (missing & Field_Offset) {
+                    mine.offset = theirs.offset;
+                }
+                if (missing & Field_Scale) {
+                    mine.scale = theirs.scale;
+                }
+                if (missing & Field_Rotation) {
+                    mine.rotation = theirs.rotation;
+                }
+                if (missing & Field_Attribs) {
+                    mine.attribsIndex = addAttribs(m_attribs, other.m_attribs[theirs.attribsIndex]);
+                }
+                if (missing & Field_Axes) {
+                    mine.axesIndex = addAxes(m_axes, other.m_axes[theirs.axesIndex], other.m_axes[theirs.axesIndex + 1]);
+                }
+                mine.fields |= missing;
+            }
+        }
+
+        bool BrushFaceSnapshot::empty() const {
+            return m_faces.empty();
+        }
+
+        size_t BrushFaceSnapshot::sizeInBytes() const {
+            auto result = sizeof(*this) +
+                m_faces.capacity() * sizeof(FaceSnapshot) +
+                m_attribs.capacity() * sizeof(BrushFaceAttributes) +
+                m_axes.capacity() * sizeof(vm::vec3);
+            for (const auto& attribs : m_attribs) {
+                result += attribs.textureName().capacity();
+            }
+            return result;
+        }
+
+        unsigned BrushFaceSnapshot::changedFields(const FaceSnapshot& faceSnapshot, const BrushFace* face) const {
+            const auto& attribs = face->attribs();
+
+            unsigned result = 0u;
+            if ((faceSnapshot.fields & Field_Offset) && faceSnapshot.offset != attribs.offset()) {
+                result |= Field_Offset;
+            }
+            if ((faceSnapshot.fields & Field_Scale) && faceSnapshot.scale != attribs.scale()) {
+                result |= Field_Scale;
+            }
+            if ((faceSnapshot.fields & Field_Rotation) && faceSnapshot.rotation != attribs.rotation()) {
+                result |= Field_Rotation;
+            }
+            if ((faceSnapshot.fields & Field_Attribs) && !equalAttribs(m_attribs[faceSnapshot.attribsIndex], attribs)) {
+                result |= Field_Attribs;
+            }
+            if (faceSnapshot.fields & Field_Axes) {
+                // restoring the rotation also rotates the texture axes, so they must be restored along with it
+                if ((result & Field_Rotation) ||
+                    m_axes[faceSnapshot.axesIndex] != face->textureXAxis() ||
+                    m_axes[faceSnapshot.axesIndex + 1] != face->textureYAxis()) {
+                    result |= Field_Axes;
+                }
+            }
+            return result;
+        }
+
+        void BrushFaceSnapshot::restoreFace(const FaceSnapshot& faceSnapshot, BrushFace* face) const {
+            const auto& current = face->attribs();
+
+            // attributes that are not recorded keep their current values
+            auto attribs = (faceSnapshot.fields & Field_Attribs) ? m_attribs[faceSnapshot.attribsIndex] : current;
+            attribs.setOffset((faceSnapshot.fields & Field_Offset) ? faceSnapshot.offset : current.offset());
+            attribs.setScale((faceSnapshot.fields & Field_Scale) ? faceSnapshot.scale : current.scale());
+            attribs.setRotation((faceSnapshot.fields & Field_Rotation) ? faceSnapshot.rotation : current.rotation());
+            face->setAttribs(attribs);
+
+            if (faceSnapshot.fields & Field_Axes) {
+                face->restoreTexCoordSystemSnapshot(ParallelTexCoordSystemSnapshot(m_axes[faceSnapshot.axesIndex], m_axes[faceSnapshot.axesIndex + 1]));
             }
         }
     }
@@ -24,20 +24,85 @@
 #include "Model/BrushFaceReference.h"
 #include "Model/Model_Forward.h"
 
-#include <memory>
+#include <vecmath/vec.h>
+
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Records the attributes of a set of brush faces in a packed form, see BrushSnapshot. The texture name,
+         * surface attributes and color are stored in a table that is shared by faces with equal values, and the
+         * texture axes are only stored for faces with a parallel texture coordinate system.
+         *
+         * For each face, the snapshot tracks which attributes it records. Once the faces have been changed, the
+         * snapshot can be compacted so that it only records the attributes that differ from the current state of the
+         * faces. Restoring the snapshot then only updates those attributes and leaves the others untouched.
+         */
         class BrushFaceSnapshot {
         private:
-            BrushFaceReference m_faceRef;
-            BrushFaceAttributes m_attribs;
-            std::unique_ptr<TexCoordSystemSnapshot> m_coordSystemSnapshot;
+            static const size_t NoIndex;
+
+            enum Field : unsigned {
+                Field_Offset   = 1 << 0,
+                Field_Scale    = 1 << 1,
+                Field_Rotation = 1 << 2,
+                // the texture name, the surface attributes and the color
+                Field_Attribs  = 1 << 3,
+                Field_Axes     = 1 << 4
+            };
+
+            struct FaceSnapshot {
+                BrushFaceReference faceRef;
+                unsigned fields;
+                vm::vec2f offset;
+                vm::vec2f scale;
+                float rotation;
+                size_t attribsIndex;
+                size_t axesIndex;
+            };
+
+            std::vector<FaceSnapshot> m_faces;
+            std::vector<BrushFaceAttributes> m_attribs;
+
+            /**
+             * The texture axes of faces with a parallel texture coordinate system, two consecutive entries per face.
+             */
+            std::vector<vm::vec3> m_axes;
         public:
-            BrushFaceSnapshot(BrushFace* face, TexCoordSystem& coordSystemSnapshot);
+            BrushFaceSnapshot();
+            explicit BrushFaceSnapshot(BrushFace* face);
             ~BrushFaceSnapshot();
 
+            /**
+             * Records all attributes of the given face.
+             */
+            void takeSnapshot(BrushFace* face);
+
             void restore();
+
+            /**
+             * Drops the attributes that are equal to the current attributes of their faces, and the faces for which
+             * no attributes remain.
+             */
+            void compact();
+
+            /**
+             * Adds the attributes recorded by the given snapshot, which must have been taken after this one, unless this
+             * snapshot already records them for the same face. Restoring the result undoes the changes recorded by both
+             * snapshots.
+             */
+            void merge(const BrushFaceSnapshot& other);
+
+            bool empty() const;
+
+            /**
+             * Returns the approximate number of bytes of memory used by this snapshot.
+             */
+            size_t sizeInBytes() const;
+        private:
+            unsigned changedFields(const FaceSnapshot& faceSnapshot, const BrushFace* face) const;
+            void restoreFace(const FaceSnapshot& faceSnapshot, BrushFace* face) const;
         };
     }
 }
@@ -19,33 +19,328 @@
 
 #include "BrushSnapshot.h"
 
+#include "Ensure.h"
+#include "IO/BinaryData.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/TexCoordSystem.h"
 
-#include <kdl/vector_utils.h>
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
 
 namespace TrenchBroom {
     namespace Model {
+        const size_t BrushSnapshot::NoAxes = std::numeric_limits<size_t>::max();
+
+        static bool equalAttribs(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs) {
+            // the texture is not compared because snapshots don't reference textures
+            return lhs.textureName() == rhs.textureName() &&
+                lhs.offset() == rhs.offset() &&
+                lhs.scale() == rhs.scale() &&
+                lhs.rotation() == rhs.rotation() &&
+                lhs.surfaceContents() == rhs.surfaceContents() &&
+                lhs.surfaceFlags() == rhs.surfaceFlags() &&
+                lhs.surfaceValue() == rhs.surfaceValue() &&
+                lhs.color() == rhs.color();
+        }
+
+        static bool equalPoints(const std::array<vm::vec3, 3>& lhs, const BrushFace::Points& rhs) {
+            return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2];
+        }
+
+        static void putVec(std::ostream& stream, const vm::vec3& vec) {
+            for (size_t i = 0; i < 3; ++i) {
+                IO::BinaryData::put(stream, vec[i]);
+            }
+        }
+
+        static vm::vec3 getVec(std::istream& stream) {
+            vm::vec3 result;
+            for (size_t i = 0; i < 3; ++i) {
+                result[i] = IO::BinaryData::get<FloatType>(stream);
+            }
+            return result;
+        }
+
+        static void putAttribs(std::ostream& stream, const BrushFaceAttributes& attribs) {
+            IO::BinaryData::putString(stream, attribs.textureName());
+            IO::BinaryData::put(stream, attribs.xOffset());
+            IO::BinaryData::put(stream, attribs.yOffset());
+            IO::BinaryData::put(stream, attribs.xScale());
+            IO::BinaryData::put(stream, attribs.yScale());
+            IO::BinaryData::put(stream, attribs.rotation());
+            IO::BinaryData::put(stream, attribs.surfaceContents());
+            IO::BinaryData::put(stream, attribs.surfaceFlags());
+            IO::BinaryData::put(stream, attribs.surfaceValue());
+            const auto& color = attribs.color();
+            IO::BinaryData::put(stream, color.r());
+            IO::BinaryData::put(stream, color.g());
+            IO::BinaryData::put(stream, color.b());
+            IO::BinaryData::put(stream, color.a());
+        }
+
+        static BrushFaceAttributes getAttribs(std::istream& stream) {
+            auto attribs = BrushFaceAttributes(IO::BinaryData::getString(stream));
+            const auto xOffset = IO::BinaryData::get<float>(stream);
+            const auto yOffset = IO::BinaryData::get<float>(stream);
+            attribs.setOffset(vm::vec2f(xOffset, yOffset));
+            const auto xScale = IO::BinaryData::get<float>(stream);
+            const auto yScale = IO::BinaryData::get<float>(stream);
+            attribs.setScale(vm::vec2f(xScale, yScale));
+            attribs.setRotation(IO::BinaryData::get<float>(stream));
+            attribs.setSurfaceContents(IO::BinaryData::get<int>(stream));
+            attribs.setSurfaceFlags(IO::BinaryData::get<int>(stream));
+            attribs.setSurfaceValue(IO::BinaryData::get<float>(stream));
+            const auto r = IO::BinaryData::get<float>(stream);
+            const auto g = IO::BinaryData::get<float>(stream);
+            const auto b = IO::BinaryData::get<float>(stream);
+            const auto a = IO::BinaryData::get<float>(stream);
+            attribs.setColor(Color(r, g, b, a));
+            return attribs;
+        }
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
-        m_brush(brush) {
+        m_brush(brush),
+        m_relative(false) {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            kdl::vec_clear_and_delete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
+            const auto& faces = brush->faces();
+            m_faces.reserve(faces.size());
+            for (const BrushFace* face : faces) {
+                m_faces.push_back(takeSnapshot(face));
+            }
+
+            m_attribs.shrink_to_fit();
+            m_axes.shrink_to_fit();
+        }
+
+        BrushSnapshot::FaceSnapshot BrushSnapshot::takeSnapshot(const BrushFace* face) {
+            const auto& points = face->points();
+            const auto attribs = face->attribs().takeSnapshot();
+
+            // faces with equal attributes share one copy of them
+            auto attribsIt = std::find_if(std::begin(m_attribs), std::end(m_attribs), [&](const BrushFaceAttributes& other) {
+                return equalAttribs(attribs, other);
+            });
+            if (attribsIt == std::end(m_attribs)) {
+                attribsIt = m_attribs.insert(attribsIt, attribs);
+            }
+
+            // only parallel texture coordinate systems can take a snapshot
+            auto axesIndex = NoAxes;
+            if (face->takeTexCoordSystemSnapshot() != nullptr) {
+                axesIndex = m_axes.size();
+                m_axes.push_back(face->textureXAxis());
+                m_axes.push_back(face->textureYAxis());
+            }
+
+            return FaceSnapshot{
+                { points[0], points[1], points[2] },
+                static_cast<size_t>(std::distance(std::begin(m_attribs), attribsIt)),
+                axesIndex,
+                face->lineNumber(),
+                face->lineCount(),
+                face->selected()
+            };
+        }
+
+        BrushFace* BrushSnapshot::createFace(const FaceSnapshot& faceSnapshot) const {
+            const auto& points = faceSnapshot.points;
+            const auto& attribs = m_attribs[faceSnapshot.attribsIndex];
+
+            std::unique_ptr<TexCoordSystem> coordSystem;
+            if (faceSnapshot.axesIndex != NoAxes) {
+                coordSystem = std::make_unique<ParallelTexCoordSystem>(m_axes[faceSnapshot.axesIndex], m_axes[faceSnapshot.axesIndex + 1]);
+            } else {
+                coordSystem = std::make_unique<ParaxialTexCoordSystem>(points[0], points[1], points[2], attribs);
+            }
+
+            auto* face = new BrushFace(points[0], points[1], points[2], attribs, std::move(coordSystem));
+            face->setFilePosition(faceSnapshot.lineNumber, faceSnapshot.lineCount);
+            if (faceSnapshot.selected) {
+                face->select();
             }
+            return face;
+        }
+
+        void BrushSnapshot::restoreFace(const FaceSnapshot& faceSnapshot, BrushFace* face) const {
+            face->setAttribs(m_attribs[faceSnapshot.attribsIndex]);
+            if (faceSnapshot.axesIndex != NoAxes) {
+                face->restoreTexCoordSystemSnapshot(ParallelTexCoordSystemSnapshot(m_axes[faceSnapshot.axesIndex], m_axes[faceSnapshot.axesIndex + 1]));
+            }
+            face->setFilePosition(faceSnapshot.lineNumber, faceSnapshot.lineCount);
+        }
+
+        bool BrushSnapshot::equals(const FaceSnapshot& faceSnapshot, const BrushFace* face) const {
+            if (!equalAttribs(m_attribs[faceSnapshot.attribsIndex], face->attribs()) ||
+                faceSnapshot.lineNumber != face->lineNumber() ||
+                faceSnapshot.lineCount != face->lineCount()) {
+                return false;
+            }
+
+            if (faceSnapshot.axesIndex != NoAxes) {
+                return m_axes[faceSnapshot.axesIndex] == face->textureXAxis() &&
+                    m_axes[faceSnapshot.axesIndex + 1] == face->textureYAxis();
+            }
+            return true;
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            if (m_relative) {
+                // the face planes are unchanged, so only the recorded faces need to be updated
+                const auto& faces = m_brush->faces();
+                for (const auto& faceSnapshot : m_faces) {
+                    const auto it = std::find_if(std::begin(faces), std::end(faces), [&](const BrushFace* face) {
+                        return equalPoints(faceSnapshot.points, face->points());
+                    });
+                    ensure(it != std::end(faces), "snapshot face not found");
+                    restoreFace(faceSnapshot, *it);
+                }
+            } else {
+                std::vector<BrushFace*> faces;
+                faces.reserve(m_faces.size());
+                for (const auto& faceSnapshot : m_faces) {
+                    faces.push_back(createFace(faceSnapshot));
+                }
+                m_brush->setFaces(worldBounds, faces);
+            }
+
             m_faces.clear();
         }
+
+        void BrushSnapshot::doCompact() {
+            if (m_relative) {
+                return;
+            }
+
+            // if any plane of the brush has changed, the faces must be rebuilt from the full snapshot when restoring
+            const auto& faces = m_brush->faces();
+            if (faces.size() != m_faces.size()) {
+                return;
+            }
+
+            std::vector<const BrushFace*> matchingFaces;
+            matchingFaces.reserve(m_faces.size());
+            for (const auto& faceSnapshot : m_faces) {
+                const auto it = std::find_if(std::begin(faces), std::end(faces), [&](const BrushFace* face) {
+                    return equalPoints(faceSnapshot.points, face->points());
+                });
+                if (it == std::end(faces) || (*it)->selected() != faceSnapshot.selected) {
+                    // face selection cannot be restored in place
+                    return;
+                }
+                matchingFaces.push_back(*it);
+            }
+
+            // keep only the faces that differ from the current ones, along with their attributes and axes
+            std::vector<FaceSnapshot> changedFaces;
+            std::vector<BrushFaceAttributes> changedAttribs;
+            std::vector<vm::vec3> changedAxes;
+            for (size_t i = 0; i < m_faces.size(); ++i) {
+                const auto& faceSnapshot = m_faces[i];
+                if (!equals(faceSnapshot, matchingFaces[i])) {
+                    auto changedFace = faceSnapshot;
+                    changedFace.attribsIndex = changedAttribs.size();
+                    changedAttribs.push_back(m_attribs[faceSnapshot.attribsIndex]);
+                    if (faceSnapshot.axesIndex != NoAxes) {
+                        changedFace.axesIndex = changedAxes.size();
+                        changedAxes.push_back(m_axes[faceSnapshot.axesIndex]);
+                        changedAxes.push_back(m_axes[faceSnapshot.axesIndex + 1]);
+                    }
+                    changedFaces.push_back(changedFace);
+                }
+            }
+
+            m_faces = std::move(changedFaces);
+            m_attribs = std::move(changedAttribs);
+            m_axes = std::move(changedAxes);
+            m_relative = true;
+        }
+
+        bool BrushSnapshot::doGetRelative() const {
+            return m_relative;
+        }
+
+        size_t BrushSnapshot::doGetSizeInBytes() const {
+            auto result = sizeof(*this) +
+                m_faces.capacity() * sizeof(FaceSnapshot) +
+                m_attribs.capacity() * sizeof(BrushFaceAttributes) +
+                m_axes.capacity() * sizeof(vm::vec3);
+            for (const auto& attribs : m_attribs) {
+                result += attribs.textureName().capacity();
+            }
+            return result;
+        }
+
+        void BrushSnapshot::doSpill(std::ostream& stream) {
+            IO::BinaryData::putSize(stream, m_faces.size());
+            for (const auto& faceSnapshot : m_faces) {
+                for (const auto& point : faceSnapshot.points) {
+                    putVec(stream, point);
+                }
+                IO::BinaryData::putSize(stream, faceSnapshot.attribsIndex);
+                IO::BinaryData::putSize(stream, faceSnapshot.axesIndex);
+                IO::BinaryData::putSize(stream, faceSnapshot.lineNumber);
+                IO::BinaryData::putSize(stream, faceSnapshot.lineCount);
+                IO::BinaryData::put(stream, faceSnapshot.selected);
+            }
+
+            IO::BinaryData::putSize(stream, m_attribs.size());
+            for (const auto& attribs : m_attribs) {
+                putAttribs(stream, attribs);
+            }
+
+            IO::BinaryData::putSize(stream, m_axes.size());
+            for (const auto& axis : m_axes) {
+                putVec(stream, axis);
+            }
+
+            // swap with empty vectors to actually release the memory
+            std::vector<FaceSnapshot>().swap(m_faces);
+            std::vector<BrushFaceAttributes>().swap(m_attribs);
+            std::vector<vm::vec3>().swap(m_axes);
+        }
+
+        void BrushSnapshot::doUnspill(std::istream& stream) {
+            assert(m_faces.empty() && m_attribs.empty() && m_axes.empty());
+
+            const auto faceCount = IO::BinaryData::getSize(stream);
+            m_faces.reserve(faceCount);
+            for (size_t i = 0; i < faceCount; ++i) {
+                FaceSnapshot faceSnapshot;
+                for (auto& point : faceSnapshot.points) {
+                    point = getVec(stream);
+                }
+                faceSnapshot.attribsIndex = IO::BinaryData::getSize(stream);
+                faceSnapshot.axesIndex = IO::BinaryData::getSize(stream);
+                faceSnapshot.lineNumber = IO::BinaryData::getSize(stream);
+                faceSnapshot.lineCount = IO::BinaryData::getSize(stream);
+                faceSnapshot.selected = IO::BinaryData::get<bool>(stream);
+                m_faces.push_back(faceSnapshot);
+            }
+
+            const auto attribsCount = IO::BinaryData::getSize(stream);
+            m_attribs.reserve(attribsCount);
+            for (size_t i = 0; i < attribsCount; ++i) {
+                m_attribs.push_back(getAttribs(stream));
+            }
+
+            const auto axesCount = IO::BinaryData::getSize(stream);
+            m_axes.reserve(axesCount);
+            for (size_t i = 0; i < axesCount; ++i) {
+                m_axes.push_back(getVec(stream));
+            }
+        }
     }
 }
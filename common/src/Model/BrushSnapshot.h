@@ -20,23 +20,65 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "TrenchBroom.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/Model_Forward.h"
 #include "Model/NodeSnapshot.h"
 
+#include <vecmath/vec.h>
+
+#include <array>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Records the faces of a brush in a packed form instead of cloning them. Faces that share the same attributes
+         * share a single copy of them, and the brush faces are only reconstructed when the snapshot is restored.
+         *
+         * Once the brush has been changed, the snapshot can be compacted. If the change left the face planes of the
+         * brush untouched, e.g. because it only changed texture attributes, only the faces that differ from the current
+         * faces of the brush are kept, and restoring the snapshot updates those faces in place.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            static const size_t NoAxes;
+
+            struct FaceSnapshot {
+                std::array<vm::vec3, 3> points;
+                size_t attribsIndex;
+                size_t axesIndex;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+            };
+
             Brush* m_brush;
-            std::vector<BrushFace*> m_faces;
+            std::vector<FaceSnapshot> m_faces;
+            std::vector<BrushFaceAttributes> m_attribs;
+
+            /**
+             * The texture axes of faces with a parallel texture coordinate system, two consecutive entries per face.
+             * The axes of faces with a paraxial texture coordinate system are derived from their plane and attributes.
+             */
+            std::vector<vm::vec3> m_axes;
+            bool m_relative;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
+            FaceSnapshot takeSnapshot(const BrushFace* face);
+            BrushFace* createFace(const FaceSnapshot& faceSnapshot) const;
+            void restoreFace(const FaceSnapshot& faceSnapshot, BrushFace* face) const;
+            bool equals(const FaceSnapshot& faceSnapshot, const BrushFace* face) const;
+
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doCompact() override;
+            bool doGetRelative() const override;
+            size_t doGetSizeInBytes() const override;
+            void doSpill(std::ostream& stream) override;
+            void doUnspill(std::istream& stream) override;
         };
     }
 }
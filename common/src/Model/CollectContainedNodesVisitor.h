@@ -23,20 +23,66 @@
 #include "Model/CollectMatchingNodesVisitor.h"
 #include "Model/MatchSelectableNodes.h"
 #include "Model/NodePredicates.h"
+#include "Model/World.h"
+
+#include <iterator>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         template <typename I>
         class MatchContainedNodes {
         private:
+            using QueryNode = typename std::iterator_traits<I>::value_type;
+
             const I m_begin;
             const I m_end;
+
+            /**
+             * Maps each entity and brush whose bounds intersect with the bounds of a query node to those query nodes.
+             * Only used if a world was given, in which case nodes that are not in this map cannot be contained in any
+             * query node.
+             */
+            std::unordered_map<const Node*, std::vector<QueryNode>> m_candidates;
+            bool m_useCandidates;
         public:
             MatchContainedNodes(I begin, I end) :
             m_begin(begin),
-            m_end(end) {}
+            m_end(end),
+            m_useCandidates(false) {}
+
+            /**
+             * Creates a matcher that uses the spatial index of the given world to find the entities and brushes that
+             * might be contained in the query nodes.
+             */
+            MatchContainedNodes(I begin, I end, const World& world) :
+            m_begin(begin),
+            m_end(end),
+            m_useCandidates(true) {
+                for (auto it = m_begin; it != m_end; ++it) {
+                    auto cur = *it;
+                    for (const auto* candidate : world.findNodesIntersecting(cur->logicalBounds())) {
+                        m_candidates[candidate].push_back(cur);
+                    }
+                }
+            }
 
             bool operator()(const Node* node) const {
+                if (m_useCandidates && node->shouldAddToSpacialIndex()) {
+                    const auto it = m_candidates.find(node);
+                    if (it == std::end(m_candidates)) {
+                        return false;
+                    }
+
+                    for (const auto* cur : it->second) {
+                        if (cur != node && cur->contains(node)) {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+
                 I cur = m_begin;
                 while (cur != m_end) {
                     if (*cur != node && (*cur)->contains(node))
@@ -52,6 +98,9 @@ namespace TrenchBroom {
         public:
             CollectContainedNodesVisitor(I begin, I end, const Model::EditorContext& editorContext) :
             CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >(MatchSelectableNodes(editorContext), MatchContainedNodes<I>(begin, end))) {}
+
+            CollectContainedNodesVisitor(I begin, I end, const World& world, const Model::EditorContext& editorContext) :
+            CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >(MatchSelectableNodes(editorContext), MatchContainedNodes<I>(begin, end, world))) {}
         };
     }
 }
@@ -32,6 +32,13 @@
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Collects the issues matching the given predicate.
+         *
+         * The issues are not generated here. Nodes whose issues are not valid are skipped, so World::validateInvalidIssues
+         * must be called until World::hasInvalidIssues returns false before visiting the nodes, otherwise the collected
+         * issues are incomplete.
+         */
         template <typename P>
         class CollectMatchingIssuesVisitor : public NodeVisitor {
         private:
@@ -54,6 +61,9 @@ namespace TrenchBroom {
             void doVisit(Brush* brush)   override { collectIssues(brush);  }
 
             void collectIssues(Node* node) {
+                if (!node->issuesValid()) {
+                    return;
+                }
                 for (Issue* issue : node->issues(m_issueGenerators)) {
                     if (m_p(issue))
                         m_issues.push_back(issue);
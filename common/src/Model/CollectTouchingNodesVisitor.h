@@ -24,25 +24,72 @@
 #include "Model/MatchSelectableNodes.h"
 #include "Model/Model_Forward.h"
 #include "Model/NodePredicates.h"
+#include "Model/World.h"
+
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         template <typename I>
         class MatchTouchingNodes {
         private:
+            using QueryNode = typename std::iterator_traits<I>::value_type;
+
             const I m_begin;
             const I m_end;
+            std::unordered_set<const Node*> m_queryNodes;
+
+            /**
+             * Maps each entity and brush whose bounds intersect with the bounds of a query node to those query nodes.
+             * Only used if a world was given, in which case nodes that are not in this map cannot touch any query node.
+             */
+            std::unordered_map<const Node*, std::vector<QueryNode>> m_candidates;
+            bool m_useCandidates;
         public:
             MatchTouchingNodes(I begin, I end) :
             m_begin(begin),
-            m_end(end) {}
+            m_end(end),
+            m_queryNodes(begin, end),
+            m_useCandidates(false) {}
+
+            /**
+             * Creates a matcher that uses the spatial index of the given world to find the entities and brushes that
+             * might touch the query nodes. All query nodes must belong to the given world.
+             */
+            MatchTouchingNodes(I begin, I end, const World& world) :
+            m_begin(begin),
+            m_end(end),
+            m_queryNodes(begin, end),
+            m_useCandidates(true) {
+                for (auto it = m_begin; it != m_end; ++it) {
+                    auto cur = *it;
+                    for (const auto* candidate : world.findNodesIntersecting(cur->logicalBounds())) {
+                        m_candidates[candidate].push_back(cur);
+                    }
+                }
+            }
 
             bool operator()(const Node* node) const {
                 // if `node` is one of the search query nodes, don't count it as touching
-                for (auto it = m_begin; it != m_end; ++it) {
-                    if (node == *it) {
+                if (m_queryNodes.count(node) > 0u) {
+                    return false;
+                }
+
+                if (m_useCandidates && node->shouldAddToSpacialIndex()) {
+                    const auto it = m_candidates.find(node);
+                    if (it == std::end(m_candidates)) {
                         return false;
                     }
+
+                    for (const auto* cur : it->second) {
+                        if (cur->intersects(node)) {
+                            return true;
+                        }
+                    }
+                    return false;
                 }
 
                 for (auto it = m_begin; it != m_end; ++it) {
@@ -52,7 +99,7 @@ namespace TrenchBroom {
                     }
                 }
 
-                return true;
+                return false;
             }
         };
 
@@ -61,6 +108,9 @@ namespace TrenchBroom {
         public:
                 CollectTouchingNodesVisitor(I begin, I end, const Model::EditorContext& editorContext) :
                 CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >(MatchSelectableNodes(editorContext), MatchTouchingNodes<I>(begin, end))) {}
+
+                CollectTouchingNodesVisitor(I begin, I end, const World& world, const Model::EditorContext& editorContext) :
+                CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >(MatchSelectableNodes(editorContext), MatchTouchingNodes<I>(begin, end, world))) {}
         };
     }
 }
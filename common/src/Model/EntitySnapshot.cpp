@@ -48,5 +48,11 @@ namespace TrenchBroom {
             restoreAttribute(m_entity, m_origin);
             restoreAttribute(m_entity, m_rotation);
         }
+
+        size_t EntitySnapshot::doGetSizeInBytes() const {
+            return sizeof(*this) +
+                m_origin.name().capacity() + m_origin.value().capacity() +
+                m_rotation.name().capacity() + m_rotation.value().capacity();
+        }
     }
 }
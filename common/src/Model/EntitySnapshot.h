@@ -35,6 +35,7 @@ namespace TrenchBroom {
             EntitySnapshot(Entity* entity, const EntityAttribute& origin, const EntityAttribute& rotation);
         private:
             void doRestore(const vm::bbox3& worldBounds) override;
+            size_t doGetSizeInBytes() const override;
         };
     }
 }
@@ -69,8 +69,8 @@ namespace TrenchBroom {
             return doNewMap(format, worldBounds, logger);
         }
 
-        std::unique_ptr<World> Game::loadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
-            return doLoadMap(format, worldBounds, path, logger);
+        std::unique_ptr<World> Game::loadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, const bool useCache, IO::ParserStatus& status) const {
+            return doLoadMap(format, worldBounds, path, useCache, status);
         }
 
         void Game::writeMap(World& world, const IO::Path& path) const {
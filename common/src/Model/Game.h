@@ -60,7 +60,7 @@ namespace TrenchBroom {
             const std::vector<SmartTag>& smartTags() const;
         public: // loading and writing map files
             std::unique_ptr<World> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
-            std::unique_ptr<World> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
+            std::unique_ptr<World> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, bool useCache, IO::ParserStatus& status) const;
             void writeMap(World& world, const IO::Path& path) const;
             void exportMap(World& world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
@@ -102,7 +102,7 @@ namespace TrenchBroom {
             virtual const std::vector<SmartTag>& doSmartTags() const = 0;
 
             virtual std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
-            virtual std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
+            virtual std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, bool useCache, IO::ParserStatus& status) const = 0;
             virtual void doWriteMap(World& world, const IO::Path& path) const = 0;
             virtual void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const = 0;
 
@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "PreferenceManager.h"
+#include "Preferences.h"
 #include "RecoverableExceptions.h"
 #include "IO/CompilationConfigParser.h"
 #include "IO/CompilationConfigWriter.h"
@@ -77,7 +78,8 @@ namespace TrenchBroom {
         }
 
         std::shared_ptr<Game> GameFactory::createGame(const std::string& gameName, Logger& logger) {
-            return std::make_shared<GameImpl>(gameConfig(gameName), gamePath(gameName), logger);
+            const auto shaderIndexPath = pref(Preferences::UseShaderIndex) ? IO::SystemPaths::userDataDirectory() + IO::Path("ShaderIndex") + IO::Path(gameName + ".tbsi") : IO::Path();
+            return std::make_shared<GameImpl>(gameConfig(gameName), gamePath(gameName), shaderIndexPath, logger);
         }
 
         std::vector<std::string> GameFactory::fileFormats(const std::string& gameName) const {
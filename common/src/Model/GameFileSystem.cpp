@@ -41,7 +41,7 @@ namespace TrenchBroom {
         FileSystem(),
         m_shaderFS(nullptr) {}
 
-        void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
+        void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, const IO::Path& shaderIndexPath, Logger& logger) {
             // delete the existing file system
             releaseNext();
             m_shaderFS = nullptr;
@@ -50,7 +50,7 @@ namespace TrenchBroom {
 
             if (!gamePath.isEmpty() && IO::Disk::directoryExists(gamePath)) {
                 addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
-                addShaderFileSystem(config, logger);
+                addShaderFileSystem(config, shaderIndexPath, logger);
             }
         }
 
@@ -122,7 +122,7 @@ namespace TrenchBroom {
             }
         }
 
-        void GameFileSystem::addShaderFileSystem(const GameConfig& config, Logger& logger) {
+        void GameFileSystem::addShaderFileSystem(const GameConfig& config, const IO::Path& shaderIndexPath, Logger& logger) {
             // To support Quake 3 shaders, we add a shader file system that loads the shaders
             // and makes them available as virtual files.
             const auto& textureConfig = config.textureConfig();
@@ -134,7 +134,7 @@ namespace TrenchBroom {
                     textureConfig.package.rootDirectory,
                     IO::Path("models")
                 };
-                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(m_next, std::move(shaderSearchPath), std::move(textureSearchPaths), logger);
+                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(m_next, std::move(shaderSearchPath), std::move(textureSearchPaths), shaderIndexPath, logger);
                 m_shaderFS = shaderFS.get();
                 m_next = std::move(shaderFS);
             }
@@ -24,6 +24,7 @@
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/TextureManager.h"
 #include "IO/AseParser.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/Bsp29Parser.h"
@@ -36,6 +37,7 @@
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -68,13 +70,17 @@
 namespace TrenchBroom {
     namespace Model {
         GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, Logger& logger) :
+        GameImpl(config, gamePath, IO::Path(), logger) {}
+
+        GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, const IO::Path& shaderIndexPath, Logger& logger) :
         m_config(config),
-        m_gamePath(gamePath) {
+        m_gamePath(gamePath),
+        m_shaderIndexPath(shaderIndexPath) {
             initializeFileSystem(logger);
         }
 
         void GameImpl::initializeFileSystem(Logger& logger) {
-            m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
+            m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, m_shaderIndexPath, logger);
         }
 
         const std::string& GameImpl::doGameName() const {
@@ -125,7 +131,8 @@ namespace TrenchBroom {
         std::unique_ptr<World> GameImpl::doNewMap(const MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const {
             const auto initialMapFilePath = m_config.findInitialMap(formatName(format));
             if (!initialMapFilePath.isEmpty() && IO::Disk::fileExists(initialMapFilePath)) {
-                return doLoadMap(format, worldBounds, initialMapFilePath, logger);
+                IO::SimpleParserStatus parserStatus(logger);
+                return doLoadMap(format, worldBounds, initialMapFilePath, false, parserStatus);
             } else {
                 auto world = std::make_unique<World>(format);
 
@@ -141,12 +148,53 @@ namespace TrenchBroom {
             }
         }
 
-        std::unique_ptr<World> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
-            IO::SimpleParserStatus parserStatus(logger);
+        std::unique_ptr<World> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, const bool useCache, IO::ParserStatus& status) const {
             auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
             auto fileReader = file->reader().buffer();
+            if (!useCache) {
+                IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+                return worldReader.read(format, worldBounds, status);
+            }
+
+            const auto cachePath = IO::mapCachePath(file->path());
+            const auto cacheKey = IO::MapCacheKey::compute(file->path(), std::begin(fileReader), std::end(fileReader));
+            if (auto world = loadMapCache(format, worldBounds, cachePath, cacheKey, std::begin(fileReader), std::end(fileReader), status)) {
+                return world;
+            }
+
+            IO::MapCacheWriter cacheWriter;
             IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
-            return worldReader.read(format, worldBounds, parserStatus);
+            worldReader.setCacheWriter(&cacheWriter);
+            auto world = worldReader.read(format, worldBounds, status);
+
+            try {
+                cacheWriter.write(cachePath, cacheKey);
+            } catch (const FileSystemException& e) {
+                status.warn(std::string("Could not write map cache: ") + e.what());
+            }
+            return world;
+        }
+
+        std::unique_ptr<World> GameImpl::loadMapCache(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& cachePath, const IO::MapCacheKey& cacheKey, const char* begin, const char* end, IO::ParserStatus& status) const {
+            if (!IO::Disk::fileExists(cachePath)) {
+                return nullptr;
+            }
+
+            try {
+                auto cacheFile = IO::Disk::openFile(cachePath);
+                auto cacheReader = cacheFile->reader();
+                IO::MapCacheReader mapCacheReader(cacheReader, cacheKey, format);
+                if (!mapCacheReader.valid()) {
+                    status.debug("Ignoring stale map cache " + cachePath.asString());
+                    return nullptr;
+                }
+
+                IO::WorldReader worldReader(begin, end);
+                return worldReader.read(mapCacheReader, worldBounds, status);
+            } catch (const Exception& e) {
+                status.warn(std::string("Ignoring invalid map cache: ") + e.what());
+                return nullptr;
+            }
         }
 
         void GameImpl::doWriteMap(World& world, const IO::Path& path) const {
@@ -206,7 +254,8 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(node);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), textureManager.textureCache(), logger);
+            textureLoader.setCompressTextures(textureManager.compressTextures());
             textureLoader.loadTextures(paths, textureManager);
         }
 
@@ -34,6 +34,10 @@
 namespace TrenchBroom {
     class Logger;
 
+    namespace IO {
+        class MapCacheKey;
+    }
+
     namespace Model {
         class GameImpl : public Game {
         private:
@@ -41,8 +45,14 @@ namespace TrenchBroom {
             GameFileSystem m_fs;
             IO::Path m_gamePath;
             std::vector<IO::Path> m_additionalSearchPaths;
+            IO::Path m_shaderIndexPath;
         public:
             GameImpl(GameConfig& config, const IO::Path& gamePath, Logger& logger);
+
+            /**
+             * Creates a game that stores the index of its Quake 3 shader scripts in the file at the given path.
+             */
+            GameImpl(GameConfig& config, const IO::Path& gamePath, const IO::Path& shaderIndexPath, Logger& logger);
         private:
             void initializeFileSystem(Logger& logger);
         private:
@@ -59,7 +69,7 @@ namespace TrenchBroom {
             const std::vector<SmartTag>& doSmartTags() const override;
 
             std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const override;
-            std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const override;
+            std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, bool useCache, IO::ParserStatus& status) const override;
             void doWriteMap(World& world, const IO::Path& path) const override;
             void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const override;
 
@@ -98,6 +108,7 @@ namespace TrenchBroom {
             const FlagsConfig& doSurfaceFlags() const override;
             const FlagsConfig& doContentFlags() const override;
         private:
+            std::unique_ptr<World> loadMapCache(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& cachePath, const IO::MapCacheKey& cacheKey, const char* begin, const char* end, IO::ParserStatus& status) const;
             void writeLongAttribute(AttributableNode& node, const AttributeName& baseName, const AttributeValue& value, size_t maxLength) const;
             std::string readLongAttribute(const AttributableNode& node, const AttributeName& baseName) const;
         };
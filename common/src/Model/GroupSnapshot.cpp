@@ -26,6 +26,8 @@
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Model {
         GroupSnapshot::GroupSnapshot(Group* group) {
@@ -48,5 +50,35 @@ namespace TrenchBroom {
             for (NodeSnapshot* snapshot : m_snapshots)
                 snapshot->restore(worldBounds);
         }
+
+        void GroupSnapshot::doCompact() {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->compact();
+            }
+        }
+
+        bool GroupSnapshot::doGetRelative() const {
+            return std::any_of(std::begin(m_snapshots), std::end(m_snapshots), [](const NodeSnapshot* snapshot) { return snapshot->relative(); });
+        }
+
+        size_t GroupSnapshot::doGetSizeInBytes() const {
+            size_t result = sizeof(*this) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_snapshots) {
+                result += snapshot->sizeInBytes();
+            }
+            return result;
+        }
+
+        void GroupSnapshot::doSpill(std::ostream& stream) {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->spill(stream);
+            }
+        }
+
+        void GroupSnapshot::doUnspill(std::istream& stream) {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->unspill(stream);
+            }
+        }
     }
 }
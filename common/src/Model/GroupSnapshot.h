@@ -36,6 +36,11 @@ namespace TrenchBroom {
         private:
             void takeSnapshot(Group* group);
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doCompact() override;
+            bool doGetRelative() const override;
+            size_t doGetSizeInBytes() const override;
+            void doSpill(std::ostream& stream) override;
+            void doUnspill(std::istream& stream) override;
         };
     }
 }
@@ -26,6 +26,7 @@
 
 #include <kdl/vector_utils.h>
 
+#include <atomic>
 #include <string>
 
 namespace TrenchBroom {
@@ -90,7 +91,8 @@ namespace TrenchBroom {
         }
 
         size_t Issue::nextSeqId() {
-            static size_t seqId = 0;
+            // issues are generated concurrently by World::validateInvalidIssues
+            static std::atomic<size_t> seqId(0);
             return seqId++;
         }
 
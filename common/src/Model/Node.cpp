@@ -617,9 +617,23 @@ namespace TrenchBroom {
             }
         }
 
-        void Node::invalidateIssues() const {
+        void Node::invalidateIssues() {
             clearIssues();
-            m_issuesValid = false;
+            if (m_issuesValid) {
+                m_issuesValid = false;
+                issuesWereInvalidated(this);
+            }
+        }
+
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
+        void Node::issuesWereInvalidated(Node* node) {
+            doIssuesWereInvalidated(node);
+            if (m_parent != nullptr) {
+                m_parent->issuesWereInvalidated(node);
+            }
         }
 
         void Node::clearIssues() const {
@@ -677,6 +691,8 @@ namespace TrenchBroom {
         void Node::doDescendantWillChange(Node* /* node */) {}
         void Node::doDescendantDidChange(Node* /* node */)  {}
 
+        void Node::doIssuesWereInvalidated(Node* /* node */) {}
+
         void Node::doFindAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, std::vector<AttributableNode*>& result) const {
             if (m_parent != nullptr)
                 m_parent->findAttributableNodesWithAttribute(name, value, result);
@@ -274,9 +274,15 @@ namespace TrenchBroom {
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
-            void invalidateIssues() const;
-        private:
+            /**
+             * Discards the issues of this node. If the issues were valid, the ancestors of this node are notified so
+             * that the world can keep track of the nodes whose issues must be regenerated.
+             */
+            void invalidateIssues();
+            bool issuesValid() const;
             void validateIssues(const std::vector<IssueGenerator*>& issueGenerators);
+        private:
+            void issuesWereInvalidated(Node* node);
             void clearIssues() const;
         public: // visitors
             template <class V>
@@ -454,6 +460,8 @@ namespace TrenchBroom {
             virtual void doDescendantWillChange(Node* node);
             virtual void doDescendantDidChange(Node* node);
 
+            virtual void doIssuesWereInvalidated(Node* node);
+
             virtual bool doSelectable() const = 0;
 
             virtual void doPick(const vm::ray3& ray, PickResult& pickResult) const = 0;
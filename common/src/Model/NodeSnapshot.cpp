@@ -26,5 +26,35 @@ namespace TrenchBroom {
         void NodeSnapshot::restore(const vm::bbox3& worldBounds) {
             doRestore(worldBounds);
         }
+
+        void NodeSnapshot::compact() {
+            doCompact();
+        }
+
+        bool NodeSnapshot::relative() const {
+            return doGetRelative();
+        }
+
+        size_t NodeSnapshot::sizeInBytes() const {
+            return doGetSizeInBytes();
+        }
+
+        void NodeSnapshot::spill(std::ostream& stream) {
+            doSpill(stream);
+        }
+
+        void NodeSnapshot::unspill(std::istream& stream) {
+            doUnspill(stream);
+        }
+
+        void NodeSnapshot::doCompact() {}
+
+        bool NodeSnapshot::doGetRelative() const {
+            return false;
+        }
+
+        void NodeSnapshot::doSpill(std::ostream& /* stream */) {}
+
+        void NodeSnapshot::doUnspill(std::istream& /* stream */) {}
     }
 }
@@ -23,14 +23,51 @@
 #include "TrenchBroom.h"
 #include "Model/Model_Forward.h"
 
+#include <cstddef>
+#include <iosfwd>
+
 namespace TrenchBroom {
     namespace Model {
         class NodeSnapshot {
         public:
             virtual ~NodeSnapshot();
             void restore(const vm::bbox3& worldBounds);
+
+            /**
+             * Discards the parts of this snapshot that are equal to the current state of the snapshotted node. Must
+             * only be called while the node is in the state that it will be in when this snapshot is restored, i.e.,
+             * directly after the change that this snapshot is meant to undo.
+             */
+            void compact();
+
+            /**
+             * Indicates whether this snapshot was compacted and only records the differences to the state that the
+             * node was in when it was compacted.
+             */
+            bool relative() const;
+
+            /**
+             * Returns the approximate number of bytes of memory used by this snapshot.
+             */
+            size_t sizeInBytes() const;
+
+            /**
+             * Writes the recorded state to the given stream and releases the memory it occupied. The snapshot must
+             * be unspilled from a stream positioned at the written data before it can be restored.
+             */
+            void spill(std::ostream& stream);
+
+            /**
+             * Reads back the state that was written by a previous call to spill.
+             */
+            void unspill(std::istream& stream);
         private:
             virtual void doRestore(const vm::bbox3& worldBounds) = 0;
+            virtual void doCompact();
+            virtual bool doGetRelative() const;
+            virtual size_t doGetSizeInBytes() const = 0;
+            virtual void doSpill(std::ostream& stream);
+            virtual void doUnspill(std::istream& stream);
         };
     }
 }
@@ -26,7 +26,7 @@
 
 #include <vecmath/util.h>
 
-#include <algorithm>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Model {
@@ -68,7 +68,12 @@ namespace TrenchBroom {
 
         void PickResult::addHit(const Hit& hit) {
             ensure(m_compare.get() != nullptr, "compare is null");
-            auto pos = std::upper_bound(std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
+            // hits are usually added roughly in order, so search for the insertion position from the back
+            const auto less = CompareWrapper(m_compare.get());
+            auto pos = std::end(m_hits);
+            while (pos != std::begin(m_hits) && less(hit, *std::prev(pos))) {
+                --pos;
+            }
             m_hits.insert(pos, hit);
         }
 
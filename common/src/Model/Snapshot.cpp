@@ -26,11 +26,13 @@
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Model {
         Snapshot::~Snapshot() {
             kdl::vec_clear_and_delete(m_nodeSnapshots);
-            kdl::vec_clear_and_delete(m_brushFaceSnapshots);
+            delete m_brushFaceSnapshot;
         }
 
         void Snapshot::restoreNodes(const vm::bbox3& worldBounds) {
@@ -39,8 +41,55 @@ namespace TrenchBroom {
         }
 
         void Snapshot::restoreBrushFaces() {
-            for (BrushFaceSnapshot* snapshot : m_brushFaceSnapshots)
-                snapshot->restore();
+            if (m_brushFaceSnapshot != nullptr)
+                m_brushFaceSnapshot->restore();
+        }
+
+        void Snapshot::compact() {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->compact();
+            }
+            if (m_brushFaceSnapshot != nullptr) {
+                m_brushFaceSnapshot->compact();
+            }
+        }
+
+        void Snapshot::mergeBrushFaces(const Snapshot& other) {
+            if (other.m_brushFaceSnapshot == nullptr) {
+                return;
+            }
+            if (m_brushFaceSnapshot == nullptr) {
+                m_brushFaceSnapshot = new BrushFaceSnapshot();
+            }
+            m_brushFaceSnapshot->merge(*other.m_brushFaceSnapshot);
+        }
+
+        bool Snapshot::relative() const {
+            return std::any_of(std::begin(m_nodeSnapshots), std::end(m_nodeSnapshots), [](const NodeSnapshot* snapshot) { return snapshot->relative(); });
+        }
+
+        size_t Snapshot::sizeInBytes() const {
+            size_t result = sizeof(*this) +
+                m_nodeSnapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots) {
+                result += snapshot->sizeInBytes();
+            }
+            if (m_brushFaceSnapshot != nullptr) {
+                result += m_brushFaceSnapshot->sizeInBytes();
+            }
+            return result;
+        }
+
+        void Snapshot::spill(std::ostream& stream) {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->spill(stream);
+            }
+        }
+
+        void Snapshot::unspill(std::istream& stream) {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->unspill(stream);
+            }
         }
 
         void Snapshot::takeSnapshot(Node* node) {
@@ -50,9 +99,9 @@ namespace TrenchBroom {
         }
 
         void Snapshot::takeSnapshot(BrushFace* face) {
-            BrushFaceSnapshot* snapshot = face->takeSnapshot();
-            if (snapshot != nullptr)
-                m_brushFaceSnapshots.push_back(snapshot);
+            if (m_brushFaceSnapshot == nullptr)
+                m_brushFaceSnapshot = new BrushFaceSnapshot();
+            m_brushFaceSnapshot->takeSnapshot(face);
         }
     }
 }
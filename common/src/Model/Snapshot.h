@@ -23,6 +23,7 @@
 #include "TrenchBroom.h"
 #include "Model/Model_Forward.h"
 
+#include <iosfwd>
 #include <vector>
 
 namespace TrenchBroom {
@@ -30,10 +31,11 @@ namespace TrenchBroom {
         class Snapshot {
         private:
             std::vector<NodeSnapshot*> m_nodeSnapshots;
-            std::vector<BrushFaceSnapshot*> m_brushFaceSnapshots;
+            BrushFaceSnapshot* m_brushFaceSnapshot;
         public:
             template <typename I>
-            Snapshot(I cur, I end) {
+            Snapshot(I cur, I end) :
+            m_brushFaceSnapshot(nullptr) {
                 while (cur != end) {
                     takeSnapshot(*cur);
                     ++cur;
@@ -44,6 +46,39 @@ namespace TrenchBroom {
 
             void restoreNodes(const vm::bbox3& worldBounds);
             void restoreBrushFaces();
+
+            /**
+             * Compacts the node snapshots and the brush face snapshot, see NodeSnapshot::compact and
+             * BrushFaceSnapshot::compact.
+             */
+            void compact();
+
+            /**
+             * Merges the brush face snapshot of the given snapshot, which must have been taken after this one, into
+             * this snapshot, see BrushFaceSnapshot::merge.
+             */
+            void mergeBrushFaces(const Snapshot& other);
+
+            /**
+             * Indicates whether any node snapshot only records the differences to the current state of its node.
+             */
+            bool relative() const;
+
+            /**
+             * Returns the approximate number of bytes of memory used by this snapshot.
+             */
+            size_t sizeInBytes() const;
+
+            /**
+             * Spills the node snapshots to the given stream, see NodeSnapshot::spill. Brush face snapshots are small
+             * and remain in memory.
+             */
+            void spill(std::ostream& stream);
+
+            /**
+             * Reads back the node snapshots written by a previous call to spill.
+             */
+            void unspill(std::istream& stream);
         private:
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
@@ -31,10 +31,12 @@
 #include "Model/ModelFactoryImpl.h"
 #include "Model/TagVisitor.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox_io.h>
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -48,6 +50,7 @@ namespace TrenchBroom {
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
         m_updateNodeTree(true) {
+            m_nodesWithInvalidIssues.insert(this);
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer();
         }
@@ -81,6 +84,10 @@ namespace TrenchBroom {
             return *m_attributableIndex;
         }
 
+        std::vector<Node*> World::findNodesIntersecting(const vm::bbox3& bounds) const {
+            return m_nodeTree->findIntersectors(bounds);
+        }
+
         const std::vector<IssueGenerator*>& World::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry->registeredGenerators();
         }
@@ -183,10 +190,75 @@ namespace TrenchBroom {
         };
 
         void World::invalidateAllIssues() {
+            // every node whose issues were valid reports the invalidation and is revalidated by validateInvalidIssues
             InvalidateAllIssuesVisitor visitor;
             acceptAndRecurse(visitor);
         }
 
+        /**
+         * Adds the visited nodes whose issues are invalid to the given set. Nodes only report the invalidation of their
+         * issues while they belong to this world, so this is necessary when a subtree is connected to this world.
+         */
+        class World::AddNodesWithInvalidIssues : public NodeVisitor {
+        private:
+            std::unordered_set<Node*>& m_nodes;
+        public:
+            explicit AddNodesWithInvalidIssues(std::unordered_set<Node*>& nodes) :
+            m_nodes(nodes) {}
+        private:
+            void doVisit(World* world) override   { add(world);  }
+            void doVisit(Layer* layer) override   { add(layer);  }
+            void doVisit(Group* group) override   { add(group);  }
+            void doVisit(Entity* entity) override { add(entity); }
+            void doVisit(Brush* brush) override   { add(brush);  }
+
+            void add(Node* node) {
+                if (!node->issuesValid()) {
+                    m_nodes.insert(node);
+                }
+            }
+        };
+
+        class World::RemoveNodesWithInvalidIssues : public NodeVisitor {
+        private:
+            std::unordered_set<Node*>& m_nodes;
+        public:
+            explicit RemoveNodesWithInvalidIssues(std::unordered_set<Node*>& nodes) :
+            m_nodes(nodes) {}
+        private:
+            void doVisit(World* world) override   { m_nodes.erase(world);  }
+            void doVisit(Layer* layer) override   { m_nodes.erase(layer);  }
+            void doVisit(Group* group) override   { m_nodes.erase(group);  }
+            void doVisit(Entity* entity) override { m_nodes.erase(entity); }
+            void doVisit(Brush* brush) override   { m_nodes.erase(brush);  }
+        };
+
+        std::vector<Node*> World::validateInvalidIssues(const size_t maxNodes) {
+            auto nodes = std::vector<Node*>();
+            nodes.reserve(std::min(maxNodes, m_nodesWithInvalidIssues.size()));
+
+            auto it = std::begin(m_nodesWithInvalidIssues);
+            while (it != std::end(m_nodesWithInvalidIssues) && nodes.size() < maxNodes) {
+                if (!(*it)->issuesValid()) {
+                    nodes.push_back(*it);
+                }
+                it = m_nodesWithInvalidIssues.erase(it);
+            }
+
+            // the issue generators only read the node they are passed and the attributable node index, and every node
+            // only stores its own issues
+            const auto& issueGenerators = registeredIssueGenerators();
+            kdl::parallel_for(nodes.size(), [&](const size_t i) {
+                nodes[i]->validateIssues(issueGenerators);
+            });
+
+            return nodes;
+        }
+
+        bool World::hasInvalidIssues() const {
+            return !m_nodesWithInvalidIssues.empty();
+        }
+
         const vm::bbox3& World::doGetLogicalBounds() const {
             // TODO: this should probably return the world bounds, as it does in Layer::doGetLogicalBounds
             static const vm::bbox3 bounds;
@@ -273,6 +345,9 @@ namespace TrenchBroom {
                 AddNodeToNodeTree visitor(*m_nodeTree);
                 node->acceptAndRecurse(visitor);
             }
+
+            AddNodesWithInvalidIssues visitor(m_nodesWithInvalidIssues);
+            node->acceptAndRecurse(visitor);
         }
 
         void World::doDescendantWillBeRemoved(Node* node, const size_t /* depth */) {
@@ -282,6 +357,13 @@ namespace TrenchBroom {
             }
         }
 
+        void World::doDescendantWasRemoved(Node* /* oldParent */, Node* node, const size_t /* depth */) {
+            // the subtree has already been disconnected from this world, so its nodes cannot report any further
+            // invalidations
+            RemoveNodesWithInvalidIssues visitor(m_nodesWithInvalidIssues);
+            node->acceptAndRecurse(visitor);
+        }
+
         void World::doDescendantPhysicalBoundsDidChange(Node* node) {
             if (m_updateNodeTree) {
                 UpdateNodeInNodeTree visitor(*m_nodeTree);
@@ -289,14 +371,18 @@ namespace TrenchBroom {
             }
         }
 
+        void World::doIssuesWereInvalidated(Node* node) {
+            m_nodesWithInvalidIssues.insert(node);
+        }
+
         bool World::doSelectable() const {
             return false;
         }
 
         void World::doPick(const vm::ray3& ray, PickResult& pickResult) const {
-            for (const auto* node : m_nodeTree->findIntersectors(ray)) {
+            m_nodeTree->visitIntersectors(ray, [&](const Node* node) {
                 node->pick(ray, pickResult);
-            }
+            });
         }
 
         void World::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
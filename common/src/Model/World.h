@@ -30,6 +30,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 template <typename T, size_t S, typename U>
@@ -45,6 +46,7 @@ namespace TrenchBroom {
             Layer* m_defaultLayer;
             std::unique_ptr<AttributableNodeIndex> m_attributableIndex;
             std::unique_ptr<IssueGeneratorRegistry> m_issueGeneratorRegistry;
+            std::unordered_set<Node*> m_nodesWithInvalidIssues;
 
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
@@ -60,12 +62,40 @@ namespace TrenchBroom {
             void createDefaultLayer();
         public: // index
             const AttributableNodeIndex& attributableNodeIndex() const;
+        public: // spatial queries
+            /**
+             * Returns the entities and brushes whose physical bounds intersect with the given bounds. The result is
+             * only a broad phase candidate set and must be refined by the caller using exact tests.
+             *
+             * @param bounds the bounds to test
+             * @return the nodes whose physical bounds intersect with the given bounds
+             */
+            std::vector<Node*> findNodesIntersecting(const vm::bbox3& bounds) const;
         public: // selection
             // issue generator registration
             const std::vector<IssueGenerator*>& registeredIssueGenerators() const;
             std::vector<IssueQuickFix*> quickFixes(IssueType issueTypes) const;
             void registerIssueGenerator(IssueGenerator* issueGenerator);
             void unregisterAllIssueGenerators();
+
+            /**
+             * Regenerates the issues of at most the given number of nodes whose issues were invalidated since they
+             * were last validated. The issue generators are run concurrently for different nodes, so this can be
+             * called repeatedly to validate the issues of a large map in steps without blocking for long.
+             *
+             * The world keeps track of the nodes whose issues were invalidated, so only these nodes are visited.
+             * CollectMatchingIssuesVisitor skips nodes whose issues are not valid, so this must be called before
+             * collecting issues.
+             *
+             * @param maxNodes the maximum number of nodes to validate
+             * @return the nodes whose issues were regenerated
+             */
+            std::vector<Node*> validateInvalidIssues(size_t maxNodes);
+
+            /**
+             * Indicates whether the issues of any node in this world are invalid.
+             */
+            bool hasInvalidIssues() const;
         private:
             class AddNodeToNodeTree;
             class RemoveNodeFromNodeTree;
@@ -77,6 +107,8 @@ namespace TrenchBroom {
             void rebuildNodeTree();
         private:
             class InvalidateAllIssuesVisitor;
+            class AddNodesWithInvalidIssues;
+            class RemoveNodesWithInvalidIssues;
             void invalidateAllIssues();
         private: // implement Node interface
             const vm::bbox3& doGetLogicalBounds() const override;
@@ -90,7 +122,9 @@ namespace TrenchBroom {
 
             void doDescendantWasAdded(Node* node, size_t depth) override;
             void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+            void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
             void doDescendantPhysicalBoundsDidChange(Node* node) override;
+            void doIssuesWereInvalidated(Node* node) override;
 
             bool doSelectable() const override;
             void doPick(const vm::ray3& ray, PickResult& pickResult) const override;
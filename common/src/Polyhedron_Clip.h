@@ -23,6 +23,7 @@
 #include "Ensure.h"
 #include "Macros.h"
 #include "Exceptions.h"
+#include "Polyhedron_ClipKernel.h"
 
 #include <vecmath/plane.h>
 #include <vecmath/scalar.h>
@@ -101,32 +102,36 @@ typename Polyhedron<T,FP,VP>::ClipResult Polyhedron<T,FP,VP>::clip(const vm::pla
 
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T,FP,VP>::ClipResult Polyhedron<T,FP,VP>::checkIntersects(const vm::plane<T,3>& plane) const {
-    std::size_t above = 0u;
-    std::size_t below = 0u;
-    std::size_t inside = 0u;
-
-
+    // The vertex positions are copied into small blocks of coordinate arrays so that the signed distances can be
+    // computed for several vertices at once. We can stop as soon as we have found vertices on both sides of the plane.
+    static constexpr std::size_t BlockSize = 32u;
+    T x[BlockSize];
+    T y[BlockSize];
+    T z[BlockSize];
+
+    Polyhedron_PlaneStatusCount count;
+    std::size_t blockCount = 0u;
     for (const Vertex* currentVertex : m_vertices) {
-        const vm::plane_status status = plane.point_status(currentVertex->position());
-        switch (status) {
-            case vm::plane_status::above:
-                ++above;
-                break;
-            case vm::plane_status::below:
-                ++below;
-                break;
-            case vm::plane_status::inside:
-                ++inside;
-                break;
-                switchDefault()
+        const auto& position = currentVertex->position();
+        x[blockCount] = position.x();
+        y[blockCount] = position.y();
+        z[blockCount] = position.z();
+
+        if (++blockCount == BlockSize) {
+            polyhedron_countPlaneStatus(plane, x, y, z, blockCount, count);
+            blockCount = 0u;
+            if (count.intersects()) {
+                return ClipResult(ClipResult::Type_ClipSuccess);
+            }
         }
     }
+    polyhedron_countPlaneStatus(plane, x, y, z, blockCount, count);
 
-    assert(above + below + inside == m_vertices.size());
+    assert(count.above + count.below + count.inside == m_vertices.size());
 
-    if (below + inside == m_vertices.size()) {
+    if (count.below + count.inside == m_vertices.size()) {
         return ClipResult(ClipResult::Type_ClipUnchanged);
-    } else if (above + inside == m_vertices.size()) {
+    } else if (count.above + count.inside == m_vertices.size()) {
         return ClipResult(ClipResult::Type_ClipEmpty);
     } else {
         return ClipResult(ClipResult::Type_ClipSuccess);
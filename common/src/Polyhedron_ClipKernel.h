@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_Polyhedron_ClipKernel_h
+#define TrenchBroom_Polyhedron_ClipKernel_h
+
+#include <vecmath/constants.h>
+#include <vecmath/plane.h>
+
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TB_POLYHEDRON_CLIP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TB_POLYHEDRON_CLIP_SSE2
+#endif
+
+/**
+ * The number of points that are above, below and inside of a plane.
+ */
+struct Polyhedron_PlaneStatusCount {
+    std::size_t above = 0u;
+    std::size_t below = 0u;
+    std::size_t inside = 0u;
+
+    /**
+     * Indicates whether there are points on both sides of the plane.
+     */
+    bool intersects() const {
+        return above > 0u && below > 0u;
+    }
+};
+
+template <typename T>
+void polyhedron_countPlaneStatusScalar(const vm::plane<T,3>& plane, const T* x, const T* y, const T* z, const std::size_t count, Polyhedron_PlaneStatusCount& result) {
+    const T epsilon = vm::constants<T>::point_status_epsilon();
+    const T nx = plane.normal.x(), ny = plane.normal.y(), nz = plane.normal.z();
+    for (std::size_t i = 0u; i < count; ++i) {
+        const T distance = x[i] * nx + y[i] * ny + z[i] * nz - plane.distance;
+        if (distance > epsilon) {
+            ++result.above;
+        } else if (distance < -epsilon) {
+            ++result.below;
+        } else {
+            ++result.inside;
+        }
+    }
+}
+
+/**
+ * Classifies the given points against the given plane and adds the results to the given count. The points are given
+ * as separate arrays of their x, y and z coordinates.
+ *
+ * A point is classified exactly like `vm::plane::point_status` with the default epsilon would classify it. The
+ * generic version is scalar; for double precision points, a vectorized version is used if the target supports it.
+ *
+ * @tparam T the component type
+ * @param plane the plane
+ * @param x the x coordinates of the points
+ * @param y the y coordinates of the points
+ * @param z the z coordinates of the points
+ * @param count the number of points
+ * @param result the count to add to
+ */
+template <typename T>
+void polyhedron_countPlaneStatus(const vm::plane<T,3>& plane, const T* x, const T* y, const T* z, const std::size_t count, Polyhedron_PlaneStatusCount& result) {
+    polyhedron_countPlaneStatusScalar(plane, x, y, z, count, result);
+}
+
+#if defined(TB_POLYHEDRON_CLIP_AVX2) || defined(TB_POLYHEDRON_CLIP_SSE2)
+inline std::size_t polyhedron_countMaskBits(const int mask) {
+    static const std::size_t bitCounts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+    return bitCounts[mask & 0xF];
+}
+
+template <>
+inline void polyhedron_countPlaneStatus<double>(const vm::plane<double,3>& plane, const double* x, const double* y, const double* z, const std::size_t count, Polyhedron_PlaneStatusCount& result) {
+    const double epsilon = vm::constants<double>::point_status_epsilon();
+    std::size_t i = 0u;
+
+    // The distances must be computed in the same order of operations as vm::plane::point_distance so that the
+    // results are identical to those of the scalar version.
+#if defined(TB_POLYHEDRON_CLIP_AVX2)
+    const __m256d nx = _mm256_set1_pd(plane.normal.x());
+    const __m256d ny = _mm256_set1_pd(plane.normal.y());
+    const __m256d nz = _mm256_set1_pd(plane.normal.z());
+    const __m256d d = _mm256_set1_pd(plane.distance);
+    const __m256d posEpsilon = _mm256_set1_pd(epsilon);
+    const __m256d negEpsilon = _mm256_set1_pd(-epsilon);
+
+    for (; i + 4u <= count; i += 4u) {
+        const __m256d dot = _mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(_mm256_loadu_pd(x + i), nx),
+            _mm256_mul_pd(_mm256_loadu_pd(y + i), ny)),
+            _mm256_mul_pd(_mm256_loadu_pd(z + i), nz));
+        const __m256d distance = _mm256_sub_pd(dot, d);
+        const auto above = polyhedron_countMaskBits(_mm256_movemask_pd(_mm256_cmp_pd(distance, posEpsilon, _CMP_GT_OQ)));
+        const auto below = polyhedron_countMaskBits(_mm256_movemask_pd(_mm256_cmp_pd(distance, negEpsilon, _CMP_LT_OQ)));
+        result.above += above;
+        result.below += below;
+        result.inside += 4u - above - below;
+    }
+#else
+    const __m128d nx = _mm_set1_pd(plane.normal.x());
+    const __m128d ny = _mm_set1_pd(plane.normal.y());
+    const __m128d nz = _mm_set1_pd(plane.normal.z());
+    const __m128d d = _mm_set1_pd(plane.distance);
+    const __m128d posEpsilon = _mm_set1_pd(epsilon);
+    const __m128d negEpsilon = _mm_set1_pd(-epsilon);
+
+    for (; i + 2u <= count; i += 2u) {
+        const __m128d dot = _mm_add_pd(_mm_add_pd(
+            _mm_mul_pd(_mm_loadu_pd(x + i), nx),
+            _mm_mul_pd(_mm_loadu_pd(y + i), ny)),
+            _mm_mul_pd(_mm_loadu_pd(z + i), nz));
+        const __m128d distance = _mm_sub_pd(dot, d);
+        const auto above = polyhedron_countMaskBits(_mm_movemask_pd(_mm_cmpgt_pd(distance, posEpsilon)));
+        const auto below = polyhedron_countMaskBits(_mm_movemask_pd(_mm_cmplt_pd(distance, negEpsilon)));
+        result.above += above;
+        result.below += below;
+        result.inside += 2u - above - below;
+    }
+#endif
+
+    polyhedron_countPlaneStatusScalar(plane, x + i, y + i, z + i, count - i, result);
+}
+#endif
+
+#endif
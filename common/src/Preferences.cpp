@@ -124,6 +124,16 @@ namespace TrenchBroom {
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<bool> UseMapCache(IO::Path("Editor/Use map cache"), false);
+        Preference<bool> LoadTexturesInBackground(IO::Path("Editor/Load textures in background"), false);
+        Preference<bool> DecodeTexturesOnDemand(IO::Path("Editor/Decode textures on demand"), false);
+        Preference<bool> LoadEntityModelsInBackground(IO::Path("Editor/Load entity models in background"), false);
+        Preference<bool> UseTextureCache(IO::Path("Editor/Use texture cache"), false);
+        Preference<bool> UseShaderIndex(IO::Path("Editor/Use shader index"), false);
+        Preference<bool> CompressTextures(IO::Path("Editor/Compress textures"), false);
+        Preference<int> UndoMemoryBudget(IO::Path("Editor/Undo memory budget"), 0);
+        Preference<bool> SpillUndoHistory(IO::Path("Editor/Spill undo history to disk"), true);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -249,6 +259,15 @@ namespace TrenchBroom {
                 &TextureMagFilter,
                 &TextureLock,
                 &UVLock,
+                &UseMapCache,
+                &LoadTexturesInBackground,
+                &DecodeTexturesOnDemand,
+                &LoadEntityModelsInBackground,
+                &UseTextureCache,
+                &UseShaderIndex,
+                &CompressTextures,
+                &UndoMemoryBudget,
+                &SpillUndoHistory,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
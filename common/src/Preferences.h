@@ -121,6 +121,20 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> UseMapCache;
+        extern Preference<bool> LoadTexturesInBackground;
+        extern Preference<bool> DecodeTexturesOnDemand;
+        extern Preference<bool> LoadEntityModelsInBackground;
+        extern Preference<bool> UseTextureCache;
+        extern Preference<bool> UseShaderIndex;
+        extern Preference<bool> CompressTextures;
+
+        /**
+         * The memory budget of the undo history in megabytes, or 0 to not limit it.
+         */
+        extern Preference<int> UndoMemoryBudget;
+        extern Preference<bool> SpillUndoHistory;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
@@ -29,8 +29,12 @@
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/ViewFrustum.h"
+
+#include <vecmath/bbox.h>
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <vector>
 
@@ -113,6 +117,7 @@ namespace TrenchBroom {
 
         BrushRenderer::BrushRenderer() :
         m_filter(std::make_unique<NoFilter>()),
+        m_renderersValid(false),
         m_showEdges(false),
         m_grayscale(false),
         m_tint(false),
@@ -158,8 +163,7 @@ namespace TrenchBroom {
             m_invalidBrushes = m_allBrushes;
 
             assert(m_brushInfo.empty());
-            assert(m_transparentFaces->empty());
-            assert(m_opaqueFaces->empty());
+            assert(m_chunks.empty());
         }
 
         void BrushRenderer::invalidateBrushes(const std::vector<Model::Brush*>& brushes) {
@@ -187,17 +191,20 @@ namespace TrenchBroom {
             m_invalidBrushes.clear();
 
             m_vertexArray = std::make_shared<BrushVertexArray>();
-            m_edgeIndices = std::make_shared<BrushIndexArray>();
-            m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-            m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+            m_chunks.clear();
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_opaqueFaceRenderer = FaceRenderer();
+            m_transparentFaceRenderer = FaceRenderer();
+            m_edgeRenderer = IndexedEdgeRenderer();
+            m_renderedChunks.clear();
+            m_renderersValid = false;
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
-            m_faceColor = faceColor;
+            if (faceColor != m_faceColor) {
+                m_faceColor = faceColor;
+                m_renderersValid = false;
+            }
         }
 
         void BrushRenderer::setShowEdges(const bool showEdges) {
@@ -259,6 +266,7 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                updateRenderers(visibleChunks(renderContext));
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -274,11 +282,41 @@ namespace TrenchBroom {
                     validate();
                 }
                 if (renderContext.showFaces()) {
+                    updateRenderers(visibleChunks(renderContext));
                     renderTransparentFaces(renderBatch);
                 }
             }
         }
 
+        std::shared_ptr<FaceRenderer::TextureToBrushIndicesMap> BrushRenderer::collectFaces(const std::vector<const Chunk*>& chunks, const bool transparent) {
+            auto result = std::make_shared<FaceRenderer::TextureToBrushIndicesMap>();
+            for (const auto* chunk : chunks) {
+                for (const auto& [texture, indexArray] : transparent ? chunk->transparentFaces : chunk->opaqueFaces) {
+                    (*result)[texture].push_back(indexArray);
+                }
+            }
+            return result;
+        }
+
+        void BrushRenderer::updateRenderers(const std::vector<const Chunk*>& chunks) {
+            if (m_renderersValid && chunks == m_renderedChunks) {
+                return;
+            }
+
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, collectFaces(chunks, false), m_faceColor);
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, collectFaces(chunks, true), m_faceColor);
+
+            IndexedEdgeRenderer::IndexArrayList edgeIndices;
+            edgeIndices.reserve(chunks.size());
+            for (const auto* chunk : chunks) {
+                edgeIndices.push_back(chunk->edgeIndices);
+            }
+            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, std::move(edgeIndices));
+
+            m_renderedChunks = chunks;
+            m_renderersValid = true;
+        }
+
         void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
@@ -301,6 +339,19 @@ namespace TrenchBroom {
             m_edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
+        std::vector<const BrushRenderer::Chunk*> BrushRenderer::visibleChunks(const RenderContext& renderContext) const {
+            const auto frustum = ViewFrustum(renderContext.camera());
+
+            std::vector<const Chunk*> result;
+            result.reserve(m_chunks.size());
+            for (const auto& [key, chunk] : m_chunks) {
+                if (frustum.intersects(chunk.bounds)) {
+                    result.push_back(&chunk);
+                }
+            }
+            return result;
+        }
+
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
         private:
             const Filter& m_filter;
@@ -331,11 +382,8 @@ namespace TrenchBroom {
                 validateBrush(brush);
             }
             m_invalidBrushes.clear();
+            m_renderersValid = false;
             assert(valid());
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -442,6 +490,8 @@ namespace TrenchBroom {
             }
 
             BrushInfo& info = m_brushInfo[brush];
+            info.chunkKey = chunkKey(brush);
+            Chunk& chunk = addBrushToChunk(brush, info.chunkKey);
 
             // collect vertices
             auto& brushCache = brush->brushRendererBrushCache();
@@ -460,7 +510,7 @@ namespace TrenchBroom {
             {
                 const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
                 if (edgeIndexCount > 0) {
-                    auto [key, insertDest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
+                    auto [key, insertDest] = chunk.edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
                     info.edgeIndicesKey = key;
                     getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, insertDest);
                 } else {
@@ -500,7 +550,7 @@ namespace TrenchBroom {
                 }
 
                 if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
+                    TextureToBrushIndicesMap& faceVboMap = chunk.transparentFaces;
                     auto& holderPtr = faceVboMap[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
@@ -527,7 +577,7 @@ namespace TrenchBroom {
                 }
 
                 if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
+                    TextureToBrushIndicesMap& faceVboMap = chunk.opaqueFaces;
                     auto& holderPtr = faceVboMap[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
@@ -555,6 +605,37 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * The edge length of the grid cells which determine the chunk of a brush.
+         */
+        static const FloatType ChunkSize = 1024.0;
+
+        BrushRenderer::ChunkKey BrushRenderer::chunkKey(const Model::Brush* brush) {
+            const auto center = brush->logicalBounds().center() / ChunkSize;
+            return {
+                static_cast<int>(std::floor(center.x())),
+                static_cast<int>(std::floor(center.y())),
+                static_cast<int>(std::floor(center.z()))
+            };
+        }
+
+        BrushRenderer::Chunk& BrushRenderer::addBrushToChunk(const Model::Brush* brush, const ChunkKey& key) {
+            const auto bounds = vm::bbox3f(brush->logicalBounds());
+
+            auto [it, inserted] = m_chunks.try_emplace(key);
+            Chunk& chunk = it->second;
+            if (inserted) {
+                chunk.bounds = bounds;
+                chunk.brushCount = 0u;
+                chunk.edgeIndices = std::make_shared<BrushIndexArray>();
+            } else {
+                chunk.bounds = vm::merge(chunk.bounds, bounds);
+            }
+
+            ++chunk.brushCount;
+            return chunk;
+        }
+
         void BrushRenderer::addBrush(const Model::Brush* brush) {
             // i.e. insert the brush as "invalid" if it's not already present.
             // if it is present, its validity is unchanged.
@@ -586,33 +667,43 @@ namespace TrenchBroom {
                 return;
             }
 
+            // the chunk's index arrays change, and the chunk may be removed
+            m_renderersValid = false;
+
             const BrushInfo& info = it->second;
+            auto chunkIt = m_chunks.find(info.chunkKey);
+            assert(chunkIt != std::end(m_chunks));
+            Chunk& chunk = chunkIt->second;
 
             // update Vbo's
             m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
-                m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+                chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
             }
 
             for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.opaqueFaces.at(texture);
                 faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_opaqueFaces->erase(texture);
+                    chunk.opaqueFaces.erase(texture);
                 }
             }
             for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.transparentFaces.at(texture);
                 faceIndexHolder->zeroElementsWithKey(transparentKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_transparentFaces->erase(texture);
+                    chunk.transparentFaces.erase(texture);
                 }
             }
 
+            if (--chunk.brushCount == 0u) {
+                m_chunks.erase(chunkIt);
+            }
+
             m_brushInfo.erase(it);
         }
     }
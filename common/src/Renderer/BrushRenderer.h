@@ -28,6 +28,10 @@
 #include "Renderer/FaceRenderer.h"
 #include "Renderer/Renderer_Forward.h"
 
+#include <vecmath/bbox.h>
+
+#include <array>
+#include <map>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -114,7 +118,27 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<Filter> m_filter;
 
+            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+            /**
+             * Brushes are grouped into chunks by the grid cell which contains the center of their bounds. Every chunk
+             * has its own index arrays, so that the faces and edges of chunks which are not in the view frustum can be
+             * skipped when rendering.
+             *
+             * The bounds of a chunk contain the bounds of all brushes in the chunk. They only grow as brushes are
+             * added, and the chunk is removed once it contains no more brushes.
+             */
+            struct Chunk {
+                vm::bbox3f bounds;
+                size_t brushCount;
+                std::shared_ptr<BrushIndexArray> edgeIndices;
+                TextureToBrushIndicesMap opaqueFaces;
+                TextureToBrushIndicesMap transparentFaces;
+            };
+            using ChunkKey = std::array<int, 3>;
+
             struct BrushInfo {
+                ChunkKey chunkKey;
                 AllocationTracker::Block* vertexHolderKey;
                 AllocationTracker::Block* edgeIndicesKey;
                 std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
@@ -136,16 +160,19 @@ namespace TrenchBroom {
             std::unordered_set<const Model::Brush*> m_invalidBrushes;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<BrushIndexArray> m_edgeIndices;
-
-            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-            std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-            std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
+            std::map<ChunkKey, Chunk> m_chunks;
 
             FaceRenderer m_opaqueFaceRenderer;
             FaceRenderer m_transparentFaceRenderer;
             IndexedEdgeRenderer m_edgeRenderer;
 
+            /**
+             * The chunks which the face and edge renderers were last set up for. The renderers are only set up again
+             * if the visible chunks change or if the chunks were modified since, which clears m_renderersValid.
+             */
+            std::vector<const Chunk*> m_renderedChunks;
+            bool m_renderersValid;
+
             Color m_faceColor;
             bool m_showEdges;
             Color m_edgeColor;
@@ -191,8 +218,8 @@ namespace TrenchBroom {
              *
              * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the Brush object for modification.
              *
-             * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces, and m_opaqueFaces
-             * maps will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
+             * Additionally, calling `invalidate()` guarantees the m_brushInfo and m_chunks maps will be empty, so the
+             * BrushRenderer will not have any lingering Texture* pointers.
              */
             void invalidate();
             void invalidateBrushes(const std::vector<Model::Brush*>& brushes);
@@ -271,6 +298,21 @@ namespace TrenchBroom {
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
 
+            /**
+             * Sets up the face and edge renderers for the given chunks unless they are already set up for them.
+             */
+            void updateRenderers(const std::vector<const Chunk*>& chunks);
+
+            /**
+             * Returns the chunks whose bounds intersect with the view frustum of the camera of the given context.
+             */
+            std::vector<const Chunk*> visibleChunks(const RenderContext& renderContext) const;
+
+            /**
+             * Collects the opaque or transparent face index arrays of the given chunks by texture.
+             */
+            static std::shared_ptr<FaceRenderer::TextureToBrushIndicesMap> collectFaces(const std::vector<const Chunk*>& chunks, bool transparent);
+
         public:
             /**
              * Only exposed for benchmarking.
@@ -279,6 +321,8 @@ namespace TrenchBroom {
         private:
             bool shouldDrawFaceInTransparentPass(const Model::Brush* brush, const Model::BrushFace* face) const;
             void validateBrush(const Model::Brush* brush);
+            static ChunkKey chunkKey(const Model::Brush* brush);
+            Chunk& addBrushToChunk(const Model::Brush* brush, const ChunkKey& key);
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
@@ -28,6 +28,8 @@
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/RenderBatch.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Renderer {
         EdgeRenderer::Params::Params(const float i_width, const double i_offset, const bool i_onTop) :
@@ -165,18 +167,23 @@ namespace TrenchBroom {
 
         // IndexedEdgeRenderer::Render
 
-        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray) :
+        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, std::shared_ptr<BrushVertexArray> vertexArray, IndexArrayList indexArrays) :
         RenderBase(params),
         m_vertexArray(std::move(vertexArray)),
-        m_indexArray(std::move(indexArray)) {}
+        m_indexArrays(std::move(indexArrays)) {}
 
         void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(VboManager& vboManager) {
             m_vertexArray->prepare(vboManager);
-            m_indexArray->prepare(vboManager);
+            for (auto& indexArray : m_indexArrays) {
+                indexArray->prepare(vboManager);
+            }
         }
 
         void IndexedEdgeRenderer::Render::doRender(RenderContext& renderContext) {
-            if (!m_indexArray->hasValidIndices()) {
+            const auto hasValidIndices = std::any_of(std::begin(m_indexArrays), std::end(m_indexArrays), [](const auto& indexArray) {
+                return indexArray->hasValidIndices();
+            });
+            if (!hasValidIndices) {
                 return;
             }
             renderEdges(renderContext);
@@ -184,23 +191,27 @@ namespace TrenchBroom {
 
         void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&) {
             m_vertexArray->setupVertices();
-            m_indexArray->setupIndices();
-            m_indexArray->render(PrimType::Lines);
+            for (auto& indexArray : m_indexArrays) {
+                if (indexArray->hasValidIndices()) {
+                    indexArray->setupIndices();
+                    indexArray->render(PrimType::Lines);
+                    indexArray->cleanupIndices();
+                }
+            }
             m_vertexArray->cleanupVertices();
-            m_indexArray->cleanupIndices();
         }
 
         // IndexedEdgeRenderer
 
         IndexedEdgeRenderer::IndexedEdgeRenderer() {}
 
-        IndexedEdgeRenderer::IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray) :
+        IndexedEdgeRenderer::IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, IndexArrayList indexArrays) :
         m_vertexArray(std::move(vertexArray)),
-        m_indexArray(std::move(indexArray)) {}
+        m_indexArrays(std::move(indexArrays)) {}
 
         IndexedEdgeRenderer::IndexedEdgeRenderer(const IndexedEdgeRenderer& other) :
         m_vertexArray(other.m_vertexArray),
-        m_indexArray(other.m_indexArray) {}
+        m_indexArrays(other.m_indexArrays) {}
 
         IndexedEdgeRenderer& IndexedEdgeRenderer::operator=(IndexedEdgeRenderer other) {
             using std::swap;
@@ -211,11 +222,11 @@ namespace TrenchBroom {
         void swap(IndexedEdgeRenderer& left, IndexedEdgeRenderer& right) {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
-            swap(left.m_indexArray, right.m_indexArray);
+            swap(left.m_indexArrays, right.m_indexArrays);
         }
 
         void IndexedEdgeRenderer::doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) {
-            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArray));
+            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArrays));
         }
     }
 }
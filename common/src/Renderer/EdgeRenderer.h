@@ -27,6 +27,7 @@
 #include "Renderer/VertexArray.h"
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -98,13 +99,15 @@ namespace TrenchBroom {
         };
 
         class IndexedEdgeRenderer : public EdgeRenderer {
+        public:
+            using IndexArrayList = std::vector<std::shared_ptr<BrushIndexArray>>;
         private:
             class Render : public RenderBase, public IndexedRenderable {
             private:
                 std::shared_ptr<BrushVertexArray> m_vertexArray;
-                std::shared_ptr<BrushIndexArray> m_indexArray;
+                IndexArrayList m_indexArrays;
             public:
-                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
+                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, IndexArrayList indexArrays);
             private:
                 void prepareVerticesAndIndices(VboManager& vboManager) override;
                 void doRender(RenderContext& renderContext) override;
@@ -112,10 +115,13 @@ namespace TrenchBroom {
             };
         private:
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<BrushIndexArray> m_indexArray;
+            IndexArrayList m_indexArrays;
         public:
             IndexedEdgeRenderer();
-            IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
+            /**
+             * Creates a renderer for the edges given by the given index arrays, which are rendered one after another.
+             */
+            IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, IndexArrayList indexArrays);
 
             IndexedEdgeRenderer(const IndexedEdgeRenderer& other);
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
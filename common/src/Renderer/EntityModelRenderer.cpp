@@ -33,7 +33,9 @@
 #include "Renderer/ShaderManager.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
+#include "Renderer/ViewFrustum.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
 
 namespace TrenchBroom {
@@ -124,11 +126,15 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
+            const auto frustum = ViewFrustum(renderContext.camera());
             for (const auto& entry : m_entities) {
                 auto* entity = entry.first;
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (!frustum.intersects(vm::bbox3f(entity->physicalBounds()))) {
+                    continue;
+                }
 
                 auto* renderer = entry.second;
 
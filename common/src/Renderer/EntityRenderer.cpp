@@ -33,9 +33,11 @@
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderService.h"
 #include "Renderer/TextAnchor.h"
+#include "Renderer/ViewFrustum.h"
 #include "Renderer/GLVertexType.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/bbox.h>
 #include <vecmath/vec.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -212,7 +214,11 @@ namespace TrenchBroom {
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
 
+                const auto frustum = ViewFrustum(renderContext.camera());
                 for (const Model::Entity* entity : m_entities) {
+                    if (!frustum.intersects(vm::bbox3f(entity->logicalBounds()))) {
+                        continue;
+                    }
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
                         if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
                             if (m_showOccludedOverlays)
@@ -238,11 +244,18 @@ namespace TrenchBroom {
             renderService.setShowOccludedObjectsTransparent();
             renderService.setForegroundColor(m_angleColor);
 
+            // the arrows are rendered outside of the entity bounds, so the bounds must be expanded for culling
+            const auto frustum = ViewFrustum(renderContext.camera());
+            const auto arrowLength = 16.0f + 9.0f;
+
             std::vector<vm::vec3f> vertices(3);
             for (const auto* entity : m_entities) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (!frustum.intersects(vm::bbox3f(entity->logicalBounds()).expand(arrowLength))) {
+                    continue;
+                }
 
                 const auto rotation = vm::mat4x4f(entity->rotation());
                 const auto direction = rotation * vm::vec3f::pos_x();
@@ -67,7 +67,7 @@ namespace TrenchBroom {
         m_tint(false),
         m_alpha(1.0f) {}
 
-        FaceRenderer::FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor) :
+        FaceRenderer::FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<const TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor) :
         m_vertexArray(std::move(vertexArray)),
         m_indexArrayMap(std::move(indexArrayMap)),
         m_faceColor(faceColor),
@@ -126,8 +126,9 @@ namespace TrenchBroom {
             m_vertexArray->prepare(vboManager);
 
             for (const auto& pair : *m_indexArrayMap) {
-                const auto& brushIndexHolderPtr = pair.second;
-                brushIndexHolderPtr->prepare(vboManager);
+                for (const auto& brushIndexHolderPtr : pair.second) {
+                    brushIndexHolderPtr->prepare(vboManager);
+                }
             }
         }
 
@@ -180,8 +181,8 @@ namespace TrenchBroom {
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_FALSE));
                 }
-                for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                    if (!brushIndexHolderPtr->hasValidIndices()) {
+                for (const auto& [texture, brushIndexHolderPtrs] : *m_indexArrayMap) {
+                    if (brushIndexHolderPtrs.empty()) {
                         continue;
                     }
 
@@ -189,9 +190,13 @@ namespace TrenchBroom {
                     shader.set("GridColor", gridColorForTexture(texture));
 
                     func.before(texture);
-                    brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
-                    brushIndexHolderPtr->cleanupIndices();
+                    for (const auto& brushIndexHolderPtr : brushIndexHolderPtrs) {
+                        if (brushIndexHolderPtr->hasValidIndices()) {
+                            brushIndexHolderPtr->setupIndices();
+                            brushIndexHolderPtr->render(PrimType::Triangles);
+                            brushIndexHolderPtr->cleanupIndices();
+                        }
+                    }
                     func.after(texture);
                 }
                 if (m_alpha < 1.0f) {
@@ -30,17 +30,22 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         class FaceRenderer : public IndexedRenderable {
+        public:
+            /**
+             * Maps each texture to the index arrays containing the faces with that texture. The faces of one texture
+             * can be spread over several index arrays, which are rendered one after another.
+             */
+            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::vector<std::shared_ptr<BrushIndexArray>>>;
         private:
             struct RenderFunc;
 
-            using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+            std::shared_ptr<const TextureToBrushIndicesMap> m_indexArrayMap;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -48,7 +53,7 @@ namespace TrenchBroom {
             float m_alpha;
         public:
             FaceRenderer();
-            FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor);
+            FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<const TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor);
 
             FaceRenderer(const FaceRenderer& other);
             FaceRenderer& operator=(FaceRenderer other);
@@ -414,6 +414,18 @@ namespace TrenchBroom {
             }
         }
 
+        void MapRenderer::invalidateEntitiesInRenderers(Renderer renderers) {
+            if ((renderers & Renderer_Default) != 0) {
+                m_defaultRenderer->invalidateEntities();
+            }
+            if ((renderers & Renderer_Selection) != 0) {
+                m_selectionRenderer->invalidateEntities();
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                m_lockedRenderer->invalidateEntities();
+            }
+        }
+
         void MapRenderer::invalidateEntityLinkRenderer() {
             m_entityLinkRenderer->invalidate();
         }
@@ -441,6 +453,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapRenderer::selectionDidChange);
             document->textureCollectionsWillChangeNotifier.addObserver(this, &MapRenderer::textureCollectionsWillChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapRenderer::entityDefinitionsDidChange);
+            document->entityModelsDidLoadNotifier.addObserver(this, &MapRenderer::entityModelsDidLoad);
             document->modsDidChangeNotifier.addObserver(this, &MapRenderer::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapRenderer::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -466,6 +479,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapRenderer::selectionDidChange);
                 document->textureCollectionsWillChangeNotifier.removeObserver(this, &MapRenderer::textureCollectionsWillChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapRenderer::entityDefinitionsDidChange);
+                document->entityModelsDidLoadNotifier.removeObserver(this, &MapRenderer::entityModelsDidLoad);
                 document->modsDidChangeNotifier.removeObserver(this, &MapRenderer::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapRenderer::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -552,6 +566,10 @@ namespace TrenchBroom {
             invalidateEntityLinkRenderer();
         }
 
+        void MapRenderer::entityModelsDidLoad(const std::vector<IO::Path>& /* modelPaths */) {
+            invalidateEntitiesInRenderers(Renderer_All);
+        }
+
         void MapRenderer::modsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
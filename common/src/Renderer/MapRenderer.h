@@ -105,6 +105,7 @@ namespace TrenchBroom {
             void updateRenderers(Renderer renderers);
             void invalidateRenderers(Renderer renderers);
             void invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::Brush*>& brushes);
+            void invalidateEntitiesInRenderers(Renderer renderers);
             void invalidateEntityLinkRenderer();
             void reloadEntityModels();
         private: // notification
@@ -130,6 +131,7 @@ namespace TrenchBroom {
 
             void textureCollectionsWillChange();
             void entityDefinitionsDidChange();
+            void entityModelsDidLoad(const std::vector<IO::Path>& modelPaths);
             void modsDidChange();
 
             void editorContextDidChange();
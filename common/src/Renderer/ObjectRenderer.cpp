@@ -39,6 +39,12 @@ namespace TrenchBroom {
             m_brushRenderer.invalidateBrushes(brushes);
         }
 
+        void ObjectRenderer::invalidateEntities() {
+            // the bounds of groups depend on the bounds of the contained entities
+            m_groupRenderer.invalidate();
+            m_entityRenderer.invalidate();
+        }
+
         void ObjectRenderer::clear() {
             m_groupRenderer.clear();
             m_entityRenderer.clear();
@@ -50,6 +50,7 @@ namespace TrenchBroom {
             void setObjects(const std::vector<Model::Group*>& groups, const std::vector<Model::Entity*>& entities, const std::vector<Model::Brush*>& brushes);
             void invalidate();
             void invalidateBrushes(const std::vector<Model::Brush*>& brushes);
+            void invalidateEntities();
             void clear();
             void reloadModels();
         public: // configuration
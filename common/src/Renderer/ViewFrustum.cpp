@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ViewFrustum.h"
+
+#include "Renderer/Camera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        ViewFrustum::ViewFrustum(const Camera& camera) :
+        m_planeCount(4) {
+            camera.frustumPlanes(m_planes[0], m_planes[1], m_planes[2], m_planes[3]);
+            if (camera.perspectiveProjection()) {
+                m_planes[m_planeCount++] = vm::plane3f(camera.position() + camera.farPlane() * camera.direction(), camera.direction());
+            }
+        }
+
+        bool ViewFrustum::intersects(const vm::bbox3f& bounds) const {
+            const auto center = bounds.center();
+            const auto extents = bounds.size() / 2.0f;
+
+            // the normals of the planes point out of the frustum, so the bounds are outside of the frustum if their
+            // closest point to any plane is above that plane
+            for (size_t i = 0; i < m_planeCount; ++i) {
+                const auto& plane = m_planes[i];
+                const auto radius = vm::dot(vm::abs(plane.normal), extents);
+                if (plane.point_distance(center) - radius > 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool ViewFrustum::contains(const vm::vec3f& point) const {
+            for (size_t i = 0; i < m_planeCount; ++i) {
+                if (m_planes[i].point_distance(point) > 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
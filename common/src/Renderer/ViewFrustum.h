@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ViewFrustum
+#define TrenchBroom_ViewFrustum
+
+#include "Renderer/Renderer_Forward.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/plane.h>
+
+#include <array>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * The view frustum of a camera, used to cull objects which are not visible.
+         *
+         * The frustum is bounded by the side planes of the camera and, for a perspective camera, by its far plane.
+         * Objects in front of the near plane are not culled.
+         */
+        class ViewFrustum {
+        private:
+            std::array<vm::plane3f, 5> m_planes;
+            size_t m_planeCount;
+        public:
+            explicit ViewFrustum(const Camera& camera);
+
+            /**
+             * Indicates whether the given bounds intersect with or are contained in this frustum. May return true for
+             * some bounds which are close to, but not in the frustum.
+             */
+            bool intersects(const vm::bbox3f& bounds) const;
+
+            /**
+             * Indicates whether the given point is contained in this frustum.
+             */
+            bool contains(const vm::vec3f& point) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_ViewFrustum) */
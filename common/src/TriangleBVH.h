@@ -0,0 +1,246 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRENCHBROOM_TRIANGLEBVH_H
+#define TRENCHBROOM_TRIANGLEBVH_H
+
+#include "BVHUtils.h"
+
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/intersection.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * A bounding volume hierarchy over a flat array of triangles that allows for quick ray intersection queries.
+ *
+ * The triangles are given as an array of vertices where every three consecutive vertices form a triangle. Unlike
+ * AABBTree, this tree cannot be modified once it is built, and its leafs refer to small ranges of triangles instead
+ * of single objects. Building the tree reorders the triangles so that the triangles of every leaf are adjacent,
+ * therefore a leaf only stores an offset and a count and no per triangle data is allocated.
+ *
+ * The nodes are stored in a flat array in depth first order, so the left child of an inner node immediately follows
+ * its parent, and only the index of the right child must be stored.
+ *
+ * @tparam T the floating point type
+ */
+template <typename T>
+class TriangleBVH {
+public:
+    using Vec = vm::vec<T,3>;
+    using Box = vm::bbox<T,3>;
+    using Ray = vm::ray<T,3>;
+private:
+    static constexpr size_t MaxLeafSize = 4;
+
+    /**
+     * A node of the tree. An inner node has a count of 0 and stores the index of its right child in offset. A leaf
+     * stores the index of its first triangle in offset and the number of its triangles in count.
+     */
+    struct Node {
+        Box bounds;
+        uint32_t offset;
+        uint32_t count;
+
+        bool leaf() const {
+            return count > 0;
+        }
+    };
+
+    /**
+     * A triangle to be inserted when building the tree.
+     */
+    struct BuildItem {
+        Box bounds;
+        Vec center;
+        uint32_t triangle;
+        uint32_t bin;
+    };
+
+    using BuildIterator = typename std::vector<BuildItem>::iterator;
+
+    std::vector<Node> m_nodes;
+public:
+    /**
+     * Indicates whether this tree is empty.
+     */
+    bool empty() const {
+        return m_nodes.empty();
+    }
+
+    /**
+     * Returns the bounds of all triangles in this tree.
+     */
+    const Box& bounds() const {
+        static const auto EmptyBox = Box();
+        return empty() ? EmptyBox : m_nodes.front().bounds;
+    }
+
+    /**
+     * Returns the number of nodes of this tree.
+     */
+    size_t nodeCount() const {
+        return m_nodes.size();
+    }
+
+    /**
+     * Clears this tree and rebuilds it from the given triangles. The tree is built top down, and every inner node
+     * splits its triangles such that the expected cost of intersecting the tree is minimized according to the surface
+     * area heuristic.
+     *
+     * The given vertices are reordered so that the triangles of every leaf are adjacent. Every triangle keeps its
+     * winding order. The reordered vertices must be passed to every query.
+     *
+     * @param vertices the vertices of the triangles, its size must be a multiple of 3
+     */
+    void clearAndBuild(std::vector<Vec>& vertices) {
+        assert(vertices.size() % 3u == 0u);
+        assert(vertices.size() / 3u <= std::numeric_limits<uint32_t>::max());
+
+        m_nodes.clear();
+
+        const auto triangleCount = vertices.size() / 3u;
+        if (triangleCount == 0u) {
+            m_nodes.shrink_to_fit();
+            return;
+        }
+
+        std::vector<BuildItem> items;
+        items.reserve(triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            auto bounds = Box(vertices[3u * i], vertices[3u * i]);
+            bounds = merge(bounds, vertices[3u * i + 1u]);
+            bounds = merge(bounds, vertices[3u * i + 2u]);
+            items.push_back(BuildItem{ bounds, bounds.center(), static_cast<uint32_t>(i), 0u });
+        }
+
+        m_nodes.reserve(2u * triangleCount - 1u);
+        build(std::begin(items), std::begin(items), std::end(items));
+        m_nodes.shrink_to_fit();
+
+        std::vector<Vec> sortedVertices;
+        sortedVertices.reserve(vertices.size());
+        for (const auto& item : items) {
+            sortedVertices.push_back(vertices[3u * item.triangle + 0u]);
+            sortedVertices.push_back(vertices[3u * item.triangle + 1u]);
+            sortedVertices.push_back(vertices[3u * item.triangle + 2u]);
+        }
+        vertices = std::move(sortedVertices);
+    }
+
+    /**
+     * Removes all nodes from this tree.
+     */
+    void clear() {
+        m_nodes.clear();
+        m_nodes.shrink_to_fit();
+    }
+
+    /**
+     * Finds the closest intersection of the given ray with the triangles of this tree. The nodes are visited front to
+     * back, and subtrees which the ray enters beyond the closest intersection found so far are skipped.
+     *
+     * @param ray the ray to test
+     * @param vertices the vertices which were passed to clearAndBuild
+     * @return the distance to the closest intersection or NaN if the ray does not intersect any triangle
+     */
+    T findNearestIntersection(const Ray& ray, const std::vector<Vec>& vertices) const {
+        auto closestDistance = vm::nan<T>();
+        if (empty()) {
+            return closestDistance;
+        }
+
+        const auto rootDistance = BVHUtils::entryDistance(ray, m_nodes.front().bounds);
+        if (vm::is_nan(rootDistance)) {
+            return closestDistance;
+        }
+
+        BVHUtils::TraversalStack<std::pair<uint32_t, T>> stack;
+        stack.push({ 0u, rootDistance });
+
+        while (!stack.empty()) {
+            const auto [index, distance] = stack.pop();
+            if (!vm::is_nan(closestDistance) && distance > closestDistance) {
+                continue;
+            }
+
+            const auto& node = m_nodes[index];
+            if (node.leaf()) {
+                for (size_t i = node.offset; i < node.offset + node.count; ++i) {
+                    const auto triangleDistance = vm::intersect_ray_triangle(ray, vertices[3u * i + 0u], vertices[3u * i + 1u], vertices[3u * i + 2u]);
+                    closestDistance = vm::safe_min(closestDistance, triangleDistance);
+                }
+            } else {
+                const auto left = static_cast<uint32_t>(index + 1u);
+                const auto right = node.offset;
+                const auto leftDistance = BVHUtils::entryDistance(ray, m_nodes[left].bounds);
+                const auto rightDistance = BVHUtils::entryDistance(ray, m_nodes[right].bounds);
+                BVHUtils::pushChildrenFrontToBack(stack, left, leftDistance, right, rightDistance);
+            }
+        }
+
+        return closestDistance;
+    }
+private:
+    /**
+     * Builds the subtree containing the given items. The root of the subtree is appended to the node array before its
+     * children so that the nodes are laid out in depth first order.
+     *
+     * @param first the beginning of all items, used to compute the offsets of leafs
+     * @param begin the beginning of the items of the subtree
+     * @param end the end of the items of the subtree
+     */
+    void build(const BuildIterator first, const BuildIterator begin, const BuildIterator end) {
+        assert(begin != end);
+
+        const auto index = m_nodes.size();
+        m_nodes.push_back(Node{ Box(), 0u, 0u });
+
+        auto bounds = begin->bounds;
+        for (auto it = std::next(begin); it != end; ++it) {
+            bounds = merge(bounds, it->bounds);
+        }
+
+        const auto count = static_cast<size_t>(std::distance(begin, end));
+        if (count <= MaxLeafSize) {
+            m_nodes[index] = Node{ bounds, static_cast<uint32_t>(std::distance(first, begin)), static_cast<uint32_t>(count) };
+            return;
+        }
+
+        const auto mid = BVHUtils::splitBySurfaceArea<T,3>(begin, end).first;
+        build(first, begin, mid);
+
+        const auto right = m_nodes.size();
+        build(first, mid, end);
+
+        m_nodes[index] = Node{ bounds, static_cast<uint32_t>(right), 0u };
+    }
+};
+
+#endif //TRENCHBROOM_TRIANGLEBVH_H
@@ -20,7 +20,14 @@
 #include "AddRemoveNodesCommand.h"
 
 #include "Macros.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
 #include "Model/Node.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <kdl/map_utils.h>
@@ -32,6 +39,43 @@ namespace TrenchBroom {
     namespace View {
         const Command::CommandType AddRemoveNodesCommand::Type = Command::freeType();
 
+        class AddRemoveNodesCommand::EstimateNodeSize : public Model::NodeVisitor {
+        private:
+            // the brush geometry stores a few vertices, edges and half edges per face
+            static const size_t GeometryBytesPerFace = 256u;
+            size_t m_result;
+        public:
+            EstimateNodeSize() :
+            m_result(0u) {}
+
+            size_t result() const {
+                return m_result;
+            }
+        private:
+            void doVisit(Model::World*) override {
+                m_result += sizeof(Model::World);
+            }
+
+            void doVisit(Model::Layer* layer) override {
+                m_result += sizeof(Model::Layer) + layer->name().capacity();
+            }
+
+            void doVisit(Model::Group* group) override {
+                m_result += sizeof(Model::Group) + group->name().capacity();
+            }
+
+            void doVisit(Model::Entity* entity) override {
+                m_result += sizeof(Model::Entity);
+                for (const auto& attribute : entity->attributes()) {
+                    m_result += sizeof(attribute) + attribute.name().capacity() + attribute.value().capacity();
+                }
+            }
+
+            void doVisit(Model::Brush* brush) override {
+                m_result += sizeof(Model::Brush) + brush->faceCount() * (sizeof(Model::BrushFace) + GeometryBytesPerFace);
+            }
+        };
+
         std::unique_ptr<AddRemoveNodesCommand> AddRemoveNodesCommand::add(Model::Node* parent, const std::vector<Model::Node*>& children) {
             ensure(parent != nullptr, "parent is null");
             std::map<Model::Node*, std::vector<Model::Node*>> nodes;
@@ -115,5 +159,15 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        size_t AddRemoveNodesCommand::doGetSizeInBytes() const {
+            // only the nodes that are not currently part of the document are owned by this command
+            EstimateNodeSize visitor;
+            for (const auto& entry : m_nodesToAdd) {
+                const auto& children = entry.second;
+                Model::Node::acceptAndRecurse(std::begin(children), std::end(children), visitor);
+            }
+            return visitor.result();
+        }
     }
 }
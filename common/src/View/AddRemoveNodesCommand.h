@@ -43,6 +43,8 @@ namespace TrenchBroom {
             Action m_action;
             std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToAdd;
             std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToRemove;
+
+            class EstimateNodeSize;
         public:
             static std::unique_ptr<AddRemoveNodesCommand> add(Model::Node* parent, const std::vector<Model::Node*>& children);
             static std::unique_ptr<AddRemoveNodesCommand> add(const std::map<Model::Node*, std::vector<Model::Node*>>& nodes);
@@ -60,6 +62,8 @@ namespace TrenchBroom {
 
             bool doCollateWith(UndoableCommand* command) override;
 
+            size_t doGetSizeInBytes() const override;
+
             deleteCopyAndMove(AddRemoveNodesCommand)
         };
     }
@@ -47,6 +47,9 @@ namespace TrenchBroom {
             m_snapshot = std::make_unique<Model::Snapshot>(std::begin(faces), std::end(faces));
 
             document->performChangeBrushFaceAttributes(m_request);
+
+            // only keep the attributes that were actually changed
+            m_snapshot->compact();
             return std::make_unique<CommandResult>(true);
         }
 
@@ -69,7 +72,18 @@ namespace TrenchBroom {
 
         bool ChangeBrushFaceAttributesCommand::doCollateWith(UndoableCommand* command) {
             ChangeBrushFaceAttributesCommand* other = static_cast<ChangeBrushFaceAttributesCommand*>(command);
-            return m_request.collateWith(other->m_request);
+            if (!m_request.collateWith(other->m_request)) {
+                return false;
+            }
+
+            // our snapshot only records what this command changed, so add what the other command changed
+            m_snapshot->mergeBrushFaces(*other->m_snapshot);
+            m_snapshot->compact();
+            return true;
+        }
+
+        size_t ChangeBrushFaceAttributesCommand::doGetSizeInBytes() const {
+            return m_snapshot != nullptr ? m_snapshot->sizeInBytes() : 0u;
         }
     }
 }
@@ -49,6 +49,8 @@ namespace TrenchBroom {
             std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand* command) override;
+
+            size_t doGetSizeInBytes() const override;
         private:
             ChangeBrushFaceAttributesCommand(const ChangeBrushFaceAttributesCommand& other);
             ChangeBrushFaceAttributesCommand& operator=(const ChangeBrushFaceAttributesCommand& other);
@@ -29,8 +29,11 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <deque>
+#include <sstream>
 
 #include <QDateTime>
+#include <QTemporaryFile>
 
 namespace TrenchBroom {
     namespace View {
@@ -142,13 +145,115 @@ namespace TrenchBroom {
             bool doCollateWith(UndoableCommand*) override {
                 return false;
             }
+
+            size_t doGetSizeInBytes() const override {
+                size_t result = 0u;
+                for (const auto& command : m_commands) {
+                    result += command->sizeInBytes();
+                }
+                return result;
+            }
+
+            void doSpill(std::ostream& stream) override {
+                for (auto& command : m_commands) {
+                    command->spill(stream);
+                }
+            }
+
+            void doUnspill(std::istream& stream) override {
+                for (auto& command : m_commands) {
+                    command->unspill(stream);
+                }
+            }
         };
 
         const Command::CommandType CommandProcessor::TransactionCommand::Type = Command::freeType();
 
+        /**
+         * Stores the state of spilled commands in a temporary file. Since only the oldest commands of the undo stack
+         * are spilled and the most recently spilled command is the first to be read back, the file is used like a
+         * stack.
+         */
+        class CommandProcessor::SpillFile {
+        private:
+            struct Entry {
+                qint64 offset;
+                qint64 size;
+            };
+
+            QTemporaryFile m_file;
+            std::deque<Entry> m_entries;
+        public:
+            size_t count() const {
+                return m_entries.size();
+            }
+
+            /**
+             * Spills the given command and appends its state to the file. If the file cannot be written, the command
+             * is restored from memory and false is returned.
+             */
+            bool spill(UndoableCommand& command) {
+                std::ostringstream stream;
+                command.spill(stream);
+                const auto data = stream.str();
+
+                const auto offset = m_entries.empty() ? qint64(0) : m_entries.back().offset + m_entries.back().size;
+                const auto size = static_cast<qint64>(data.size());
+                if ((!m_file.isOpen() && !m_file.open()) || !m_file.seek(offset) || m_file.write(data.data(), size) != size) {
+                    std::istringstream restoreStream(data);
+                    command.unspill(restoreStream);
+                    return false;
+                }
+
+                m_entries.push_back(Entry{offset, size});
+                return true;
+            }
+
+            /**
+             * Reads back the state of the most recently spilled command, which must be the given command.
+             */
+            bool unspill(UndoableCommand& command) {
+                assert(!m_entries.empty());
+
+                const auto entry = m_entries.back();
+                m_entries.pop_back();
+
+                auto data = std::string(static_cast<size_t>(entry.size), '\0');
+                if (!m_file.seek(entry.offset) || m_file.read(data.data(), entry.size) != entry.size) {
+                    return false;
+                }
+
+                std::istringstream stream(data);
+                command.unspill(stream);
+                truncateIfEmpty();
+                return true;
+            }
+
+            void dropOldest() {
+                assert(!m_entries.empty());
+                m_entries.pop_front();
+                truncateIfEmpty();
+            }
+
+            void clear() {
+                m_entries.clear();
+                truncateIfEmpty();
+            }
+        private:
+            void truncateIfEmpty() {
+                if (m_entries.empty() && m_file.isOpen()) {
+                    m_file.resize(0);
+                }
+            }
+        };
+
         CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval) :
         m_document(document),
         m_collationInterval(collationInterval),
+        m_undoStackSize(0u),
+        m_undoMemoryBudget(0u),
+        m_spillToDisk(false),
+        m_spillFile(std::make_unique<SpillFile>()),
         m_lastCommandTimestamp(std::chrono::time_point<std::chrono::system_clock>()) {}
 
         CommandProcessor::~CommandProcessor() = default;
@@ -204,7 +309,7 @@ namespace TrenchBroom {
         std::unique_ptr<CommandResult> CommandProcessor::execute(std::unique_ptr<Command> command) {
             auto result = executeCommand(command.get());
             if (result->success()) {
-                m_undoStack.clear();
+                clearUndoStack();
                 m_redoStack.clear();
             }
             return result;
@@ -219,6 +324,8 @@ namespace TrenchBroom {
                 throw CommandProcessorException("Cannot undo individual commands of a transaction");
             } else if (m_undoStack.empty()) {
                 throw CommandProcessorException("Undo stack is empty");
+            } else if (!unspillTopmostUndoCommand()) {
+                return std::make_unique<CommandResult>(false);
             } else {
                 auto command = popFromUndoStack();
                 auto result = undoCommand(command.get());
@@ -279,11 +386,23 @@ namespace TrenchBroom {
             assert(m_transactionStack.empty());
 
             clearRepeatStack();
-            m_undoStack.clear();
+            clearUndoStack();
             m_redoStack.clear();
             m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
         }
 
+        void CommandProcessor::setUndoMemoryBudget(const size_t budget, const bool spillToDisk) {
+            m_undoMemoryBudget = budget;
+            m_spillToDisk = spillToDisk;
+            if (m_transactionStack.empty()) {
+                enforceUndoMemoryBudget();
+            }
+        }
+
+        size_t CommandProcessor::undoMemoryUsage() const {
+            return m_undoStackSize;
+        }
+
         CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(std::unique_ptr<UndoableCommand> command, const bool collate, const bool repeatable) {
             auto commandResult = executeCommand(command.get());
             if (!commandResult->success()) {
@@ -379,6 +498,7 @@ namespace TrenchBroom {
             if (collatable(collate, timestamp)) {
                 auto& lastCommand = m_undoStack.back();
                 if (lastCommand->collateWith(command.get())) {
+                    updateUndoStackSize(m_undoStack.size() - 1u);
                     return false;
                 }
             }
@@ -388,20 +508,97 @@ namespace TrenchBroom {
             }
 
             m_undoStack.push_back(std::move(command));
+            m_undoStackSizes.push_back(0u);
+            updateUndoStackSize(m_undoStack.size() - 1u);
+
+            enforceUndoMemoryBudget();
             return true;
         }
 
         std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack() {
             assert(m_transactionStack.empty());
             assert(!m_undoStack.empty());
+            assert(m_spillFile->count() < m_undoStack.size());
 
             auto lastCommand = kdl::vec_pop_back(m_undoStack);
+            m_undoStackSize -= kdl::vec_pop_back(m_undoStackSizes);
             popFromRepeatStack(lastCommand.get());
             return lastCommand;
         }
 
+        void CommandProcessor::clearUndoStack() {
+            m_undoStack.clear();
+            m_undoStackSizes.clear();
+            m_undoStackSize = 0u;
+            m_spillFile->clear();
+        }
+
+        void CommandProcessor::updateUndoStackSize(const size_t index) {
+            assert(index < m_undoStack.size());
+
+            m_undoStackSize -= m_undoStackSizes[index];
+            m_undoStackSizes[index] = m_undoStack[index]->sizeInBytes();
+            m_undoStackSize += m_undoStackSizes[index];
+        }
+
+        void CommandProcessor::enforceUndoMemoryBudget() {
+            assert(m_transactionStack.empty());
+
+            if (m_undoMemoryBudget == 0u) {
+                return;
+            }
+
+            if (m_spillToDisk) {
+                while (m_undoStackSize > m_undoMemoryBudget && m_spillFile->count() + 1u < m_undoStack.size()) {
+                    const auto index = m_spillFile->count();
+                    if (!m_spillFile->spill(*m_undoStack[index])) {
+                        // fall back to discarding commands if the spill file cannot be written
+                        break;
+                    }
+                    updateUndoStackSize(index);
+                }
+            }
+
+            // discards the commands that could not be spilled, e.g. because they own removed nodes
+            while (m_undoStackSize > m_undoMemoryBudget && m_undoStack.size() > 1u) {
+                dropOldestUndoCommand();
+            }
+        }
+
+        void CommandProcessor::dropOldestUndoCommand() {
+            assert(!m_undoStack.empty());
+
+            auto command = std::move(m_undoStack.front());
+            m_undoStack.erase(std::begin(m_undoStack));
+            m_undoStackSize -= m_undoStackSizes.front();
+            m_undoStackSizes.erase(std::begin(m_undoStackSizes));
+
+            if (m_spillFile->count() > 0u) {
+                m_spillFile->dropOldest();
+            }
+            kdl::vec_erase(m_repeatStack, command.get());
+        }
+
+        bool CommandProcessor::unspillTopmostUndoCommand() {
+            assert(!m_undoStack.empty());
+
+            if (m_spillFile->count() < m_undoStack.size()) {
+                return true;
+            }
+
+            if (m_spillFile->unspill(*m_undoStack.back())) {
+                updateUndoStackSize(m_undoStack.size() - 1u);
+                return true;
+            }
+
+            // the state of the topmost command is lost, so it and all older commands can no longer be undone
+            clearRepeatStack();
+            clearUndoStack();
+            return false;
+        }
+
         bool CommandProcessor::collatable(const bool collate, const std::chrono::system_clock::time_point timestamp) const {
-            return collate && !m_undoStack.empty() && timestamp - m_lastCommandTimestamp <= m_collationInterval;
+            return collate && m_spillFile->count() < m_undoStack.size() && timestamp - m_lastCommandTimestamp <= m_collationInterval;
         }
 
         void CommandProcessor::pushToRedoStack(std::unique_ptr<UndoableCommand> command) {
@@ -47,6 +47,10 @@ namespace TrenchBroom {
          *
          * The command processor supports nested transactions. Each transaction can be committed or rolled back
          * individually. Committing a nested transaction adds it as a command to the containing transaction.
+         *
+         * The memory used by the undo stack can be limited by a budget. Once the commands on the undo stack exceed the
+         * budget, the oldest commands are either spilled to a temporary file and read back when they are undone, or
+         * they are discarded. The most recently executed command is always kept in memory.
          */
         class CommandProcessor {
         private:
@@ -66,6 +70,35 @@ namespace TrenchBroom {
              */
             std::vector<std::unique_ptr<UndoableCommand>> m_undoStack;
 
+            /**
+             * Holds the approximate number of bytes used by each command on the undo stack, in the same order as the
+             * undo stack.
+             */
+            std::vector<size_t> m_undoStackSizes;
+
+            /**
+             * The sum of the sizes in `m_undoStackSizes`.
+             */
+            size_t m_undoStackSize;
+
+            /**
+             * The maximum number of bytes that the commands on the undo stack may use, or 0 if unlimited.
+             */
+            size_t m_undoMemoryBudget;
+
+            /**
+             * Whether commands that exceed the memory budget are spilled to disk instead of being discarded.
+             */
+            bool m_spillToDisk;
+
+            class SpillFile;
+
+            /**
+             * Holds the state of the spilled commands. The spilled commands are always the oldest commands on the
+             * undo stack.
+             */
+            std::unique_ptr<SpillFile> m_spillFile;
+
             /**
              * Holds the commands that were undone, with the most recently undone command at the beginning of
              * the vector.
@@ -290,6 +323,21 @@ namespace TrenchBroom {
              * commands are deleted as well.
              */
             void clear();
+
+            /**
+             * Sets the memory budget for the undo stack. If the commands on the undo stack exceed the budget, the oldest
+             * commands are spilled to a temporary file if `spillToDisk` is true, and discarded otherwise. Commands that
+             * cannot release their memory by spilling are discarded, too.
+             *
+             * @param budget the maximum number of bytes that the undo stack may use, or 0 to not limit it
+             * @param spillToDisk whether to spill the oldest commands to disk instead of discarding them
+             */
+            void setUndoMemoryBudget(size_t budget, bool spillToDisk);
+
+            /**
+             * Returns the approximate number of bytes held in memory by the commands on the undo stack.
+             */
+            size_t undoMemoryUsage() const;
         private:
             /**
              * Executes and stores the given command. The command will only be stored if it was executed successfully
@@ -391,6 +439,34 @@ namespace TrenchBroom {
              */
             std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+            /**
+             * Clears the undo stack and discards the spilled commands.
+             */
+            void clearUndoStack();
+
+            /**
+             * Recomputes the size of the command at the given index of the undo stack.
+             */
+            void updateUndoStackSize(size_t index);
+
+            /**
+             * Spills or discards the oldest commands on the undo stack until it fits into the memory budget.
+             */
+            void enforceUndoMemoryBudget();
+
+            /**
+             * Removes the oldest command from the undo stack and deletes it.
+             */
+            void dropOldestUndoCommand();
+
+            /**
+             * Reads back the state of the topmost command of the undo stack if that command was spilled. If the state
+             * cannot be read, the spilled commands are discarded.
+             *
+             * @return true if the topmost command of the undo stack can be undone, and false otherwise
+             */
+            bool unspillTopmostUndoCommand();
+
             bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
             /**
@@ -77,5 +77,9 @@ namespace TrenchBroom {
         bool CopyTexCoordSystemFromFaceCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        size_t CopyTexCoordSystemFromFaceCommand::doGetSizeInBytes() const {
+            return m_snapshot != nullptr ? m_snapshot->sizeInBytes() : 0u;
+        }
     }
 }
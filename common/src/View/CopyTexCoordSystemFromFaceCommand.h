@@ -57,6 +57,8 @@ namespace TrenchBroom {
 
             bool doCollateWith(UndoableCommand* command) override;
 
+            size_t doGetSizeInBytes() const override;
+
             deleteCopyAndMove(CopyTexCoordSystemFromFaceCommand)
         };
     }
@@ -138,6 +138,7 @@ namespace TrenchBroom {
             document->documentWasLoadedNotifier.addObserver(this, &EntityBrowser::documentWasLoaded);
             document->modsDidChangeNotifier.addObserver(this, &EntityBrowser::modsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &EntityBrowser::entityDefinitionsDidChange);
+            document->entityModelsDidLoadNotifier.addObserver(this, &EntityBrowser::entityModelsDidLoad);
 
             PreferenceManager& prefs = PreferenceManager::instance();
             prefs.preferenceDidChangeNotifier.addObserver(this, &EntityBrowser::preferenceDidChange);
@@ -150,6 +151,7 @@ namespace TrenchBroom {
                 document->documentWasLoadedNotifier.removeObserver(this, &EntityBrowser::documentWasLoaded);
                 document->modsDidChangeNotifier.removeObserver(this, &EntityBrowser::modsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &EntityBrowser::entityDefinitionsDidChange);
+                document->entityModelsDidLoadNotifier.removeObserver(this, &EntityBrowser::entityModelsDidLoad);
             }
 
             PreferenceManager& prefs = PreferenceManager::instance();
@@ -172,6 +174,13 @@ namespace TrenchBroom {
             reload();
         }
 
+        void EntityBrowser::entityModelsDidLoad(const std::vector<IO::Path>& modelPaths) {
+            // the layout only depends on the models of the point entity definitions
+            if (m_view != nullptr && m_view->usesAnyModel(modelPaths)) {
+                reload();
+            }
+        }
+
         void EntityBrowser::preferenceDidChange(const IO::Path& path) {
             auto document = lock(m_document);
             if (document->isGamePathPreference(path)) {
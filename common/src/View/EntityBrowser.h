@@ -24,6 +24,7 @@
 #include "View/View_Forward.h"
 
 #include <memory>
+#include <vector>
 
 #include <QWidget>
 
@@ -60,6 +61,7 @@ namespace TrenchBroom {
 
             void modsDidChange();
             void entityDefinitionsDidChange();
+            void entityModelsDidLoad(const std::vector<IO::Path>& modelPaths);
             void preferenceDidChange(const IO::Path& path);
         };
     }
@@ -126,6 +126,18 @@ namespace TrenchBroom {
             update();
         }
 
+        bool EntityBrowserView::usesAnyModel(const std::vector<IO::Path>& modelPaths) const {
+            for (const auto* definition : m_entityDefinitionManager.definitions()) {
+                if (definition->type() == Assets::EntityDefinitionType::PointEntity) {
+                    const auto* pointEntityDefinition = static_cast<const Assets::PointEntityDefinition*>(definition);
+                    if (kdl::vec_contains(modelPaths, pointEntityDefinition->defaultModel().path)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
         void EntityBrowserView::usageCountDidChange() {
             invalidate();
             update();
@@ -21,6 +21,7 @@
 #define TrenchBroom_EntityBrowserView
 
 #include "Assets/Asset_Forward.h"
+#include "IO/IO_Forward.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/Renderer_Forward.h"
@@ -80,6 +81,11 @@ namespace TrenchBroom {
             void setGroup(bool group);
             void setHideUnused(bool hideUnused);
             void setFilterText(const std::string& filterText);
+
+            /**
+             * Indicates whether any point entity definition uses one of the models with the given paths.
+             */
+            bool usesAnyModel(const std::vector<IO::Path>& modelPaths) const;
         private:
             void usageCountDidChange();
 
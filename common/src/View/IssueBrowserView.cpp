@@ -43,7 +43,8 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_validationStepPending(false) {
             createGui();
             bindEvents();
         }
@@ -131,6 +132,7 @@ namespace TrenchBroom {
             auto document = lock(m_document);
             Model::World* world = document->world();
             if (world != nullptr) {
+                // only the issues which are already valid are shown here, the remaining nodes are validated in steps
                 const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
                 Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
                 world->acceptAndRecurse(visitor);
@@ -138,6 +140,10 @@ namespace TrenchBroom {
                 std::vector<Model::Issue*> issues = visitor.issues();
                 kdl::vec_sort(issues, IssueCmp());
                 m_tableModel->setIssues(std::move(issues));
+
+                if (world->hasInvalidIssues()) {
+                    scheduleValidationStep();
+                }
             }
         }
 
@@ -266,6 +272,41 @@ namespace TrenchBroom {
             }
         }
 
+        void IssueBrowserView::scheduleValidationStep() {
+            if (!m_validationStepPending) {
+                m_validationStepPending = true;
+
+                QMetaObject::invokeMethod(this, "validationStep", Qt::QueuedConnection);
+            }
+        }
+
+        void IssueBrowserView::validationStep() {
+            m_validationStepPending = false;
+
+            // if the list is about to be rebuilt, the issues validated in this step will be collected then
+            auto document = lock(m_document);
+            Model::World* world = document->world();
+            if (world != nullptr && m_valid) {
+                // Validating the issues of a large map takes a while, so it is done in steps. The issues of the nodes
+                // validated in each step are added to the list, and the next step runs after pending events have been
+                // processed.
+                const size_t maxNodesPerStep = 4096u;
+                const std::vector<Model::Node*> nodes = world->validateInvalidIssues(maxNodesPerStep);
+
+                const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
+                Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
+                Model::Node::accept(std::begin(nodes), std::end(nodes), visitor);
+
+                std::vector<Model::Issue*> issues = visitor.issues();
+                kdl::vec_sort(issues, IssueCmp());
+                m_tableModel->addIssues(std::move(issues));
+
+                if (world->hasInvalidIssues()) {
+                    scheduleValidationStep();
+                }
+            }
+        }
+
         // IssueBrowserModel
 
         IssueBrowserModel::IssueBrowserModel(QObject* parent)
@@ -278,6 +319,16 @@ namespace TrenchBroom {
             endResetModel();
         }
 
+        void IssueBrowserModel::addIssues(std::vector<Model::Issue*> issues) {
+            if (issues.empty()) {
+                return;
+            }
+
+            beginInsertRows(QModelIndex(), 0, static_cast<int>(issues.size()) - 1);
+            m_issues.insert(std::begin(m_issues), std::begin(issues), std::end(issues));
+            endInsertRows();
+        }
+
         const std::vector<Model::Issue*>& IssueBrowserModel::issues() {
             return m_issues;
         }
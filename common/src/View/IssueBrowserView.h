@@ -43,6 +43,7 @@ namespace TrenchBroom {
             bool m_showHiddenIssues;
 
             bool m_valid;
+            bool m_validationStepPending;
 
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
@@ -79,13 +80,15 @@ namespace TrenchBroom {
             void applyQuickFix(const Model::IssueQuickFix* quickFix);
         private:
             void invalidate();
+            void scheduleValidationStep();
         public slots:
             void validate();
+            void validationStep();
         };
 
         /**
-         * Trivial QAbstractTableModel subclass, when the issues list changes,
-         * it just refreshes the entire list with beginResetModel()/endResetModel().
+         * Trivial QAbstractTableModel subclass. When the issues list is replaced, it refreshes the entire list with
+         * beginResetModel()/endResetModel(), and newly generated issues are inserted with beginInsertRows()/endInsertRows().
          */
         class IssueBrowserModel : public QAbstractTableModel {
             Q_OBJECT
@@ -95,6 +98,12 @@ namespace TrenchBroom {
             explicit IssueBrowserModel(QObject* parent);
 
             void setIssues(std::vector<Model::Issue*> issues);
+
+            /**
+             * Inserts the given issues at the top of the list. The list is ordered by descending sequence ID, and the
+             * given issues must be ordered in the same way and be newer than the issues already in the list.
+             */
+            void addIssues(std::vector<Model::Issue*> issues);
             const std::vector<Model::Issue*>& issues();
         public: // QAbstractTableModel overrides
             int rowCount(const QModelIndex& parent) const override;
@@ -32,8 +32,10 @@
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/ParserStatus.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
 #include "Model/AttributeValueWithDoubleQuotationMarksIssueGenerator.h"
 #include "Model/Brush.h"
@@ -119,6 +121,7 @@
 
 #include <kdl/collection_utils.h>
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/util.h>
@@ -126,7 +129,10 @@
 #include <vecmath/vec_io.h>
 
 #include <cassert>
+#include <cstdint>
 #include <map>
+#include <optional>
+#include <set>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -137,6 +143,30 @@ namespace TrenchBroom {
         const vm::bbox3 MapDocument::DefaultWorldBounds(-16384.0, 16384.0);
         const std::string MapDocument::DefaultDocumentName("unnamed.map");
 
+        namespace {
+            /**
+             * The maximum number of bytes which the texture cache may occupy on the disk. The oldest entries are
+             * deleted when textures are loaded and the cache exceeds this size.
+             */
+            const uint64_t MaxTextureCacheSize = 1024u * 1024u * 1024u;
+
+            /**
+             * Forwards the progress of loading a map to the given document's load progress notifier.
+             */
+            class LoadWorldParserStatus : public IO::ParserStatus {
+            private:
+                MapDocument* m_document;
+            public:
+                LoadWorldParserStatus(MapDocument* document, Logger& logger) :
+                ParserStatus(logger, ""),
+                m_document(document) {}
+            private:
+                void doProgress(const double progress) override {
+                    m_document->documentLoadProgressNotifier(m_document, progress);
+                }
+            };
+        }
+
         MapDocument::MapDocument() :
         m_worldBounds(DefaultWorldBounds),
         m_world(nullptr),
@@ -572,7 +602,7 @@ namespace TrenchBroom {
         void MapDocument::selectTouching(const bool del) {
             const std::vector<Model::Brush*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectTouchingNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
+            Model::CollectTouchingNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), *m_world, editorContext());
             m_world->acceptAndRecurse(visitor);
 
             const std::vector<Model::Node*> nodes = visitor.nodes();
@@ -588,7 +618,7 @@ namespace TrenchBroom {
         void MapDocument::selectInside(const bool del) {
             const std::vector<Model::Brush*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectContainedNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
+            Model::CollectContainedNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), *m_world, editorContext());
             m_world->acceptAndRecurse(visitor);
 
             const std::vector<Model::Node*> nodes = visitor.nodes();
@@ -1185,8 +1215,30 @@ namespace TrenchBroom {
                 toRemove.push_back(subtrahend);
             }
 
-            for (auto* minuend : minuends) {
-                const std::vector<Model::Brush*> result = minuend->subtract(*m_world, m_worldBounds, currentTextureName(), subtrahends);
+            // only subtract the brushes that can actually touch each minuend
+            const auto candidates = kdl::vec_transform(minuends, [&](const Model::Brush* minuend) {
+                const auto& minuendBounds = minuend->logicalBounds();
+                std::vector<Model::Brush*> result;
+                for (auto* subtrahend : subtrahends) {
+                    if (subtrahend->logicalBounds().intersects(minuendBounds)) {
+                        result.push_back(subtrahend);
+                    }
+                }
+                return result;
+            });
+
+            // the minuends are independent of each other, so compute their fragments concurrently; creating the brushes
+            // copies face attributes, which notifies the texture manager, so that happens here in the order of the
+            // minuends
+            auto fragments = std::vector<std::vector<Model::BrushGeometry>>(minuends.size());
+            kdl::parallel_for(minuends.size(), [&](const size_t i) {
+                fragments[i] = minuends[i]->subtractGeometry(candidates[i]);
+            });
+
+            const auto textureName = currentTextureName();
+            for (size_t i = 0; i < minuends.size(); ++i) {
+                auto* minuend = minuends[i];
+                const auto result = minuend->createBrushes(*m_world, m_worldBounds, textureName, fragments[i], candidates[i]);
 
                 if (!result.empty()) {
                     kdl::vec_append(toAdd[minuend->parent()], result);
@@ -1246,20 +1298,33 @@ namespace TrenchBroom {
             std::map<Model::Node*, std::vector<Model::Node*>> toAdd;
             std::vector<Model::Node*> toRemove;
 
-            for (Model::Brush* brush : brushes) {
-                // make an shrunken copy of brush
-                Model::Brush* shrunken = brush->clone(m_worldBounds);
-                if (shrunken->expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)) {
-                    // shrinking gave us a valid brush, so subtract it from `brush`
-                    const std::vector<Model::Brush*> fragments = brush->subtract(*m_world, m_worldBounds, currentTextureName(), shrunken);
+            // cloning and deleting brushes updates the usage counts of their textures, which notifies the texture
+            // manager, so only shrinking the clones and computing the fragments happens concurrently
+            const auto grid = static_cast<FloatType>(m_grid->actualSize());
+            auto shrunken = kdl::vec_transform(brushes, [&](const Model::Brush* brush) {
+                return brush->clone(m_worldBounds);
+            });
 
-                    kdl::vec_append(toAdd[brush->parent()], fragments);
-                    toRemove.push_back(brush);
+            // an empty optional indicates that a brush could not be hollowed
+            auto fragments = std::vector<std::optional<std::vector<Model::BrushGeometry>>>(brushes.size());
+            kdl::parallel_for(brushes.size(), [&](const size_t i) {
+                if (shrunken[i]->expand(m_worldBounds, -1.0 * grid, true)) {
+                    // shrinking gave us a valid brush, so subtract it from the original brush
+                    fragments[i] = brushes[i]->subtractGeometry({ shrunken[i] });
                 }
+            });
 
-                delete shrunken;
+            const auto textureName = currentTextureName();
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (const auto& brushFragments = fragments[i]) {
+                    auto* brush = brushes[i];
+                    kdl::vec_append(toAdd[brush->parent()], brush->createBrushes(*m_world, m_worldBounds, textureName, *brushFragments, { shrunken[i] }));
+                    toRemove.push_back(brush);
+                }
             }
 
+            kdl::vec_clear_and_delete(shrunken);
+
             Transaction transaction(this, "CSG Hollow");
             deselectAll();
             const std::vector<Model::Node*> added = addNodes(toAdd);
@@ -1540,6 +1605,10 @@ namespace TrenchBroom {
             doClearRepeatableCommands();
         }
 
+        size_t MapDocument::undoMemoryUsage() const {
+            return doGetUndoMemoryUsage();
+        }
+
         void MapDocument::startTransaction(const std::string& name) {
             debug("Starting transaction '" + name + "'");
             doStartTransaction(name);
@@ -1571,6 +1640,16 @@ namespace TrenchBroom {
 
         void MapDocument::commitPendingAssets() {
             m_textureManager->commitChanges();
+            const auto loadedModelPaths = m_entityModelManager->applyLoadedModels();
+            if (!loadedModelPaths.empty()) {
+                // entities whose models were loaded in the background can now get their frames
+                setLoadedEntityModels(loadedModelPaths);
+                entityModelsDidLoadNotifier(loadedModelPaths);
+            }
+        }
+
+        bool MapDocument::hasPendingAssets() const {
+            return m_textureManager->hasPendingChanges() || m_entityModelManager->hasPendingModels();
         }
 
         void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const {
@@ -1599,7 +1678,8 @@ namespace TrenchBroom {
         void MapDocument::loadWorld(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path) {
             m_worldBounds = worldBounds;
             m_game = game;
-            m_world = m_game->loadMap(mapFormat, m_worldBounds, path, logger());
+            LoadWorldParserStatus status(this, logger());
+            m_world = m_game->loadMap(mapFormat, m_worldBounds, path, pref(Preferences::UseMapCache), status);
             setCurrentLayer(m_world->defaultLayer());
 
             updateGameSearchPaths();
@@ -1699,6 +1779,7 @@ namespace TrenchBroom {
 
         void MapDocument::loadEntityModels() {
             m_entityModelManager->setLoader(m_game.get());
+            m_entityModelManager->setLoadInBackground(pref(Preferences::LoadEntityModelsInBackground));
             setEntityModels();
         }
 
@@ -1716,6 +1797,15 @@ namespace TrenchBroom {
         void MapDocument::loadTextures() {
             try {
                 const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
+                m_textureManager->setLoadInBackground(pref(Preferences::LoadTexturesInBackground));
+                m_textureManager->setDecodeOnDemand(pref(Preferences::DecodeTexturesOnDemand));
+                auto textureCache = std::shared_ptr<IO::TextureCache>();
+                if (pref(Preferences::UseTextureCache)) {
+                    textureCache = std::make_shared<IO::TextureCache>(IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache"));
+                    textureCache->prune(MaxTextureCacheSize);
+                }
+                m_textureManager->setTextureCache(std::move(textureCache));
+                m_textureManager->setCompressTextures(pref(Preferences::CompressTextures));
                 m_game->loadTextureCollections(*m_world, docDir, *m_textureManager, logger());
             } catch (const Exception& e) {
                 error(e.what());
@@ -1861,6 +1951,27 @@ namespace TrenchBroom {
             void doVisit(Model::Brush*) override         {}
         };
 
+        class MapDocument::SetLoadedEntityModels : public Model::NodeVisitor {
+        private:
+            Assets::EntityModelManager& m_manager;
+            const std::set<IO::Path> m_modelPaths;
+        public:
+            SetLoadedEntityModels(Assets::EntityModelManager& manager, const std::vector<IO::Path>& modelPaths) :
+            m_manager(manager),
+            m_modelPaths(std::begin(modelPaths), std::end(modelPaths)) {}
+        private:
+            void doVisit(Model::World*) override         {}
+            void doVisit(Model::Layer*) override         {}
+            void doVisit(Model::Group*) override         {}
+            void doVisit(Model::Entity* entity) override {
+                const auto spec = entity->modelSpecification();
+                if (m_modelPaths.count(spec.path) > 0) {
+                    entity->setModelFrame(m_manager.frame(spec));
+                }
+            }
+            void doVisit(Model::Brush*) override         {}
+        };
+
         class MapDocument::UnsetEntityModels : public Model::NodeVisitor {
         private:
             void doVisit(Model::World*) override         {}
@@ -1880,6 +1991,11 @@ namespace TrenchBroom {
             Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), visitor);
         }
 
+        void MapDocument::setLoadedEntityModels(const std::vector<IO::Path>& modelPaths) {
+            SetLoadedEntityModels visitor(*m_entityModelManager, modelPaths);
+            m_world->acceptAndRecurse(visitor);
+        }
+
         void MapDocument::unsetEntityModels() {
             UnsetEntityModels visitor;
             m_world->acceptAndRecurse(visitor);
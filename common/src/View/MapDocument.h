@@ -99,6 +99,7 @@ namespace TrenchBroom {
             Notifier<MapDocument*> documentWillBeClearedNotifier;
             Notifier<MapDocument*> documentWasClearedNotifier;
             Notifier<MapDocument*> documentWasNewedNotifier;
+            Notifier<MapDocument*, double> documentLoadProgressNotifier;
             Notifier<MapDocument*> documentWasLoadedNotifier;
             Notifier<MapDocument*> documentWasSavedNotifier;
             Notifier<> documentModificationStateDidChangeNotifier;
@@ -129,6 +130,7 @@ namespace TrenchBroom {
             Notifier<> textureCollectionsDidChangeNotifier;
 
             Notifier<> entityDefinitionsDidChangeNotifier;
+            Notifier<const std::vector<IO::Path>&> entityModelsDidLoadNotifier;
             Notifier<> modsDidChangeNotifier;
 
             Notifier<> pointFileWasLoadedNotifier;
@@ -373,6 +375,11 @@ namespace TrenchBroom {
             bool canRepeatCommands() const;
             std::unique_ptr<CommandResult> repeatCommands();
             void clearRepeatableCommands();
+
+            /**
+             * Returns the approximate number of bytes held in memory by the undo history.
+             */
+            size_t undoMemoryUsage() const;
         public: // transactions
             void startTransaction(const std::string& name = "");
             void rollbackTransaction();
@@ -391,6 +398,7 @@ namespace TrenchBroom {
             virtual bool doCanRepeatCommands() const = 0;
             virtual std::unique_ptr<CommandResult> doRepeatCommands() = 0;
             virtual void doClearRepeatableCommands() = 0;
+            virtual size_t doGetUndoMemoryUsage() const = 0;
 
             virtual void doStartTransaction(const std::string& name) = 0;
             virtual void doCommitTransaction() = 0;
@@ -400,6 +408,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> doExecuteAndStore(std::unique_ptr<UndoableCommand>&& command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            bool hasPendingAssets() const;
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
             std::vector<Model::Node*> findNodesContaining(const vm::vec3& point) const;
@@ -454,9 +463,15 @@ namespace TrenchBroom {
             void clearEntityModels();
 
             class SetEntityModels;
+            class SetLoadedEntityModels;
             class UnsetEntityModels;
             void setEntityModels();
             void setEntityModels(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Sets the model frames of the entities which use any of the models with the given paths.
+             */
+            void setLoadedEntityModels(const std::vector<IO::Path>& modelPaths);
             void unsetEntityModels();
             void unsetEntityModels(const std::vector<Model::Node*>& nodes);
         protected: // search paths and mods
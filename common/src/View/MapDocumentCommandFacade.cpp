@@ -53,6 +53,7 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -988,10 +989,17 @@ namespace TrenchBroom {
 
         void MapDocumentCommandFacade::documentWasNewed(MapDocument*) {
             m_commandProcessor->clear();
+            updateUndoMemoryBudget();
         }
 
         void MapDocumentCommandFacade::documentWasLoaded(MapDocument*) {
             m_commandProcessor->clear();
+            updateUndoMemoryBudget();
+        }
+
+        void MapDocumentCommandFacade::updateUndoMemoryBudget() {
+            const auto budget = static_cast<size_t>(std::max(0, pref(Preferences::UndoMemoryBudget))) * 1024u * 1024u;
+            m_commandProcessor->setUndoMemoryBudget(budget, pref(Preferences::SpillUndoHistory));
         }
 
         bool MapDocumentCommandFacade::doCanUndoCommand() const {
@@ -1030,6 +1038,10 @@ namespace TrenchBroom {
             m_commandProcessor->clearRepeatStack();
         }
 
+        size_t MapDocumentCommandFacade::doGetUndoMemoryUsage() const {
+            return m_commandProcessor->undoMemoryUsage();
+        }
+
         void MapDocumentCommandFacade::doStartTransaction(const std::string& name) {
             m_commandProcessor->startTransaction(name);
         }
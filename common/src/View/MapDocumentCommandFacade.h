@@ -123,6 +123,7 @@ namespace TrenchBroom {
             void bindObservers();
             void documentWasNewed(MapDocument* document);
             void documentWasLoaded(MapDocument* document);
+            void updateUndoMemoryBudget();
         private: // implement MapDocument interface
             bool doCanUndoCommand() const override;
             bool doCanRedoCommand() const override;
@@ -133,6 +134,7 @@ namespace TrenchBroom {
             bool doCanRepeatCommands() const override;
             std::unique_ptr<CommandResult> doRepeatCommands() override;
             void doClearRepeatableCommands() override;
+            size_t doGetUndoMemoryUsage() const override;
 
             void doStartTransaction(const std::string& name) override;
             void doCommitTransaction() override;
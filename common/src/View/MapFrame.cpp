@@ -547,6 +547,7 @@ namespace TrenchBroom {
             m_document->documentWasNewedNotifier.addObserver(this, &MapFrame::documentDidChange);
             m_document->documentWasLoadedNotifier.addObserver(this, &MapFrame::documentDidChange);
             m_document->documentWasSavedNotifier.addObserver(this, &MapFrame::documentDidChange);
+            m_document->documentLoadProgressNotifier.addObserver(this, &MapFrame::documentLoadProgress);
             m_document->documentModificationStateDidChangeNotifier.addObserver(this, &MapFrame::documentModificationStateDidChange);
             m_document->transactionDoneNotifier.addObserver(this, &MapFrame::transactionDone);
             m_document->transactionUndoneNotifier.addObserver(this, &MapFrame::transactionUndone);
@@ -570,6 +571,7 @@ namespace TrenchBroom {
             m_document->documentWasNewedNotifier.removeObserver(this, &MapFrame::documentDidChange);
             m_document->documentWasLoadedNotifier.removeObserver(this, &MapFrame::documentDidChange);
             m_document->documentWasSavedNotifier.removeObserver(this, &MapFrame::documentDidChange);
+            m_document->documentLoadProgressNotifier.removeObserver(this, &MapFrame::documentLoadProgress);
             m_document->documentModificationStateDidChangeNotifier.removeObserver(this, &MapFrame::documentModificationStateDidChange);
             m_document->transactionDoneNotifier.removeObserver(this, &MapFrame::transactionDone);
             m_document->transactionUndoneNotifier.removeObserver(this, &MapFrame::transactionUndone);
@@ -588,12 +590,23 @@ namespace TrenchBroom {
         void MapFrame::documentWasCleared(View::MapDocument*) {
             updateTitle();
             updateActionState();
+            updateStatusBar();
         }
 
         void MapFrame::documentDidChange(View::MapDocument*) {
             updateTitle();
             updateActionState();
             updateRecentDocumentsMenu();
+            updateStatusBar();
+        }
+
+        void MapFrame::documentLoadProgress(View::MapDocument*, const double progress) {
+            const auto text = tr("Loading map... %1%").arg(static_cast<int>(progress * 100.0));
+            if (m_statusBarLabel->text() != text) {
+                m_statusBarLabel->setText(text);
+                // the map is loaded on the UI thread, so the label must be repainted right away
+                m_statusBarLabel->repaint();
+            }
         }
 
         void MapFrame::documentModificationStateDidChange() {
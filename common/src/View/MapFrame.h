@@ -119,6 +119,7 @@ namespace TrenchBroom {
 
             void documentWasCleared(View::MapDocument* document);
             void documentDidChange(View::MapDocument* document);
+            void documentLoadProgress(View::MapDocument* document, double progress);
             void documentModificationStateDidChange();
 
             void transactionDone(const std::string&);
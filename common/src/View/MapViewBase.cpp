@@ -878,6 +878,11 @@ namespace TrenchBroom {
             renderFPS(renderContext, renderBatch);
 
             renderBatch.render(renderContext);
+
+            // keep rendering until all textures that are loaded in the background have been uploaded
+            if (document->hasPendingAssets()) {
+                update();
+            }
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
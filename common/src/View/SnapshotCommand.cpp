@@ -36,6 +36,9 @@ namespace TrenchBroom {
             auto result = DocumentCommand::performDo(document);
             if (!result->success()) {
                 deleteSnapshot();
+            } else {
+                // drop whatever the command did not change
+                m_snapshot->compact();
             }
             return result;
         }
@@ -44,6 +47,15 @@ namespace TrenchBroom {
             return restoreSnapshot(document);
         }
 
+        bool SnapshotCommand::collateWith(UndoableCommand* command) {
+            // a compacted snapshot only records the differences to the state after this command was performed, so
+            // collating the changes of another command into this one would make the snapshot restore the wrong state
+            if (m_snapshot != nullptr && m_snapshot->relative()) {
+                return false;
+            }
+            return DocumentCommand::collateWith(command);
+        }
+
         void SnapshotCommand::takeSnapshot(MapDocumentCommandFacade *document) {
             assert(m_snapshot == nullptr);
             m_snapshot = doTakeSnapshot(document);
@@ -65,5 +77,21 @@ namespace TrenchBroom {
             const auto& nodes = document->selectedNodes().nodes();
             return std::make_unique<Model::Snapshot>(std::begin(nodes), std::end(nodes));
         }
+
+        size_t SnapshotCommand::doGetSizeInBytes() const {
+            return m_snapshot != nullptr ? m_snapshot->sizeInBytes() : 0u;
+        }
+
+        void SnapshotCommand::doSpill(std::ostream& stream) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->spill(stream);
+            }
+        }
+
+        void SnapshotCommand::doUnspill(std::istream& stream) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->unspill(stream);
+            }
+        }
     }
 }
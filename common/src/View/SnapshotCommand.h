@@ -38,6 +38,7 @@ namespace TrenchBroom {
         public:
             std::unique_ptr<CommandResult> performDo(MapDocumentCommandFacade* document) override;
             std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) override;
+            bool collateWith(UndoableCommand* command) override;
         private:
             void takeSnapshot(MapDocumentCommandFacade* document);
             std::unique_ptr<CommandResult> restoreSnapshot(MapDocumentCommandFacade* document);
@@ -45,6 +46,10 @@ namespace TrenchBroom {
         private:
             virtual std::unique_ptr<Model::Snapshot> doTakeSnapshot(MapDocumentCommandFacade* document) const;
 
+            size_t doGetSizeInBytes() const override;
+            void doSpill(std::ostream& stream) override;
+            void doUnspill(std::istream& stream) override;
+
             deleteCopyAndMove(SnapshotCommand)
         };
     }
@@ -302,6 +302,11 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderTextures(layout, y, height);
             renderNames(layout, y, height);
+
+            if (doc->textureManager().hasPendingChanges()) {
+                // render again once the requested textures are available
+                update();
+            }
         }
 
         bool TextureBrowserView::doShouldRenderFocusIndicator() const {
@@ -351,6 +356,9 @@ namespace TrenchBroom {
         void TextureBrowserView::renderTextures(Layout& layout, const float y, const float height) {
             using TextureVertex = Renderer::GLVertexTypes::P2T2::Vertex;
 
+            auto doc = lock(m_document);
+            auto& textureManager = doc->textureManager();
+
             Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::TextureBrowserShader);
             shader.set("ApplyTinting", false);
             shader.set("Texture", 0);
@@ -376,6 +384,9 @@ namespace TrenchBroom {
                                     TextureVertex(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f))
                                 }));
 
+                                // textures which are decoded on demand are decoded once they are visible
+                                textureManager.requestTexture(texture);
+
                                 shader.set("GrayScale", texture->overridden());
                                 texture->activate();
 
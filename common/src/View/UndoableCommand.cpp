@@ -60,6 +60,18 @@ namespace TrenchBroom {
             return doCollateWith(command);
         }
 
+        size_t UndoableCommand::sizeInBytes() const {
+            return doGetSizeInBytes();
+        }
+
+        void UndoableCommand::spill(std::ostream& stream) {
+            doSpill(stream);
+        }
+
+        void UndoableCommand::unspill(std::istream& stream) {
+            doUnspill(stream);
+        }
+
         bool UndoableCommand::doIsRepeatDelimiter() const {
             return false;
         }
@@ -68,6 +80,14 @@ namespace TrenchBroom {
             throw CommandProcessorException("Command is not repeatable");
         }
 
+        size_t UndoableCommand::doGetSizeInBytes() const {
+            return 0u;
+        }
+
+        void UndoableCommand::doSpill(std::ostream& /* stream */) {}
+
+        void UndoableCommand::doUnspill(std::istream& /* stream */) {}
+
         size_t UndoableCommand::documentModificationCount() const {
             throw CommandProcessorException("Command does not modify the document");
         }
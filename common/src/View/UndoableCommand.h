@@ -24,6 +24,7 @@
 #include "View/Command.h"
 #include "View/View_Forward.h"
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 
@@ -44,6 +45,22 @@ namespace TrenchBroom {
             std::unique_ptr<UndoableCommand> repeat(MapDocumentCommandFacade* document) const;
 
             virtual bool collateWith(UndoableCommand* command);
+
+            /**
+             * Returns the approximate number of bytes of memory that this command holds on to in order to be undone.
+             */
+            size_t sizeInBytes() const;
+
+            /**
+             * Writes the state that this command needs to be undone to the given stream and releases the memory it
+             * occupied, as far as possible. The command must be unspilled before it is undone.
+             */
+            void spill(std::ostream& stream);
+
+            /**
+             * Reads back the state written by a previous call to spill.
+             */
+            void unspill(std::istream& stream);
         private:
             virtual std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) = 0;
 
@@ -52,6 +69,10 @@ namespace TrenchBroom {
             virtual std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade* document) const;
 
             virtual bool doCollateWith(UndoableCommand* command) = 0;
+
+            virtual size_t doGetSizeInBytes() const;
+            virtual void doSpill(std::ostream& stream);
+            virtual void doUnspill(std::istream& stream);
         public: // this method is just a service for DocumentCommand and should never be called from anywhere else
             virtual size_t documentModificationCount() const;
 
@@ -157,6 +157,22 @@ namespace TrenchBroom {
             return false;
         }
 
+        size_t VertexCommand::doGetSizeInBytes() const {
+            return m_snapshot != nullptr ? m_snapshot->sizeInBytes() : 0u;
+        }
+
+        void VertexCommand::doSpill(std::ostream& stream) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->spill(stream);
+            }
+        }
+
+        void VertexCommand::doUnspill(std::istream& stream) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->unspill(stream);
+            }
+        }
+
         void VertexCommand::takeSnapshot() {
             assert(m_snapshot == nullptr);
             m_snapshot = std::make_unique<Model::Snapshot>(std::begin(m_brushes), std::end(m_brushes));
@@ -87,6 +87,10 @@ namespace TrenchBroom {
             std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) override;
             void restoreAndTakeNewSnapshot(MapDocumentCommandFacade* document);
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
+
+            size_t doGetSizeInBytes() const override;
+            void doSpill(std::ostream& stream) override;
+            void doUnspill(std::istream& stream) override;
         private:
             void takeSnapshot();
             void deleteSnapshot();
@@ -23,6 +23,11 @@
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
 using AABB = AABBTree<double, 3, size_t>;
 using BOX = AABB::Box;
 using RAY = vm::ray<AABB::FloatType, AABB::Components>;
@@ -483,6 +488,194 @@ TEST(AABBTreeTest, findIntersectorsFromInsideRootBBox) {
     assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
 }
 
+static std::vector<std::pair<BOX, size_t>> makeGrid(const size_t count) {
+    std::vector<std::pair<BOX, size_t>> result;
+    for (size_t i = 0; i < count; ++i) {
+        const auto min = VEC(static_cast<double>(i % 10), static_cast<double>((i / 10) % 10), static_cast<double>(i / 100)) * 3.0;
+        const auto size = VEC(1.0 + static_cast<double>(i % 3), 1.0, 1.0 + static_cast<double>(i % 5));
+        result.emplace_back(BOX(min, min + size), i);
+    }
+    return result;
+}
+
+static AABB buildTree(const std::vector<std::pair<BOX, size_t>>& boxes) {
+    std::vector<size_t> data;
+    for (const auto& [bounds, i] : boxes) {
+        data.push_back(i);
+    }
+
+    AABB tree;
+    tree.clearAndBuild(data, [&](const size_t i) { return boxes[i].first; });
+    return tree;
+}
+
+TEST(AABBTreeTest, clearAndBuildEmpty) {
+    AABB tree;
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+    tree.clearAndBuild(std::vector<size_t>{}, [](const size_t) { return BOX(); });
+
+    ASSERT_TRUE(tree.empty());
+    ASSERT_FALSE(tree.contains(1u));
+}
+
+TEST(AABBTreeTest, clearAndBuildWithDuplicates) {
+    AABB tree;
+    ASSERT_THROW(tree.clearAndBuild(std::vector<size_t>{ 1u, 2u, 1u }, [](const size_t) { return BOX(); }), NodeTreeException);
+    ASSERT_TRUE(tree.empty());
+    ASSERT_FALSE(tree.contains(2u));
+}
+
+TEST(AABBTreeTest, clearAndBuildFindsSameItemsAsBruteForce) {
+    const auto boxes = makeGrid(1000);
+    const auto tree = buildTree(boxes);
+
+    ASSERT_FALSE(tree.empty());
+    ASSERT_LT(tree.height(), 30u);
+    for (const auto& [bounds, i] : boxes) {
+        assertTreeContains(tree, bounds, i);
+    }
+
+    const auto rays = std::vector<RAY>{
+        RAY(VEC(-1.0, 1.5, 1.5), VEC::pos_x()),
+        RAY(VEC(4.5, -1.0, 7.5), VEC::pos_y()),
+        RAY(VEC(4.5, 4.5, 40.0), VEC::neg_z()),
+        RAY(VEC(-1.0, -1.0, -1.0), vm::normalize(VEC(1.0, 1.0, 1.0))),
+    };
+
+    for (const auto& ray : rays) {
+        std::set<size_t> expected;
+        for (const auto& [bounds, i] : boxes) {
+            if (bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds))) {
+                expected.insert(i);
+            }
+        }
+
+        std::set<size_t> actual;
+        tree.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST(AABBTreeTest, findBoxIntersectorsFindsSameItemsAsBruteForce) {
+    const auto boxes = makeGrid(1000);
+    const auto tree = buildTree(boxes);
+
+    const auto queries = std::vector<BOX>{
+        BOX(VEC(-2.0, -2.0, -2.0), VEC(-1.0, -1.0, -1.0)),
+        BOX(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0)),
+        BOX(VEC(2.0, 2.0, 2.0), VEC(3.0, 3.0, 3.0)),
+        BOX(VEC(4.5, 4.5, 4.5), VEC(10.5, 5.5, 20.0)),
+        tree.bounds(),
+    };
+
+    for (const auto& query : queries) {
+        std::set<size_t> expected;
+        for (const auto& [bounds, i] : boxes) {
+            if (bounds.intersects(query)) {
+                expected.insert(i);
+            }
+        }
+
+        const auto list = tree.findIntersectors(query);
+        ASSERT_EQ(expected, std::set<size_t>(std::begin(list), std::end(list)));
+    }
+}
+
+TEST(AABBTreeTest, updateAfterClearAndBuild) {
+    const auto boxes = makeGrid(100);
+    auto tree = buildTree(boxes);
+
+    ASSERT_TRUE(tree.remove(5u));
+    assertTreeDoesNotContain(tree, boxes[5].first, 5u);
+
+    const auto newBounds = BOX(VEC(100.0, 100.0, 100.0), VEC(101.0, 101.0, 101.0));
+    tree.update(newBounds, 7u);
+    assertTreeContains(tree, newBounds, 7u);
+    ASSERT_TRUE(tree.bounds().contains(newBounds));
+
+    tree.insert(boxes[5].first, 5u);
+    for (const auto& [bounds, i] : boxes) {
+        if (i != 7u) {
+            assertTreeContains(tree, bounds, i);
+        }
+    }
+}
+
+TEST(AABBTreeTest, visitIntersectorsFrontToBack) {
+    std::vector<std::pair<BOX, size_t>> boxes;
+    for (size_t i = 0; i < 100; ++i) {
+        const auto x = static_cast<double>((i * 37) % 100) * 3.0;
+        boxes.emplace_back(BOX(VEC(x, 0.0, 0.0), VEC(x + 1.0, 1.0, 1.0)), i);
+    }
+    const auto tree = buildTree(boxes);
+
+    std::vector<size_t> visited;
+    tree.visitIntersectors(RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()), [&](const size_t i) { visited.push_back(i); });
+    ASSERT_EQ(boxes.size(), visited.size());
+    for (size_t i = 1; i < visited.size(); ++i) {
+        ASSERT_LT(boxes[visited[i - 1]].first.min.x(), boxes[visited[i]].first.min.x());
+    }
+
+    visited.clear();
+    tree.visitIntersectors(RAY(VEC(400.0, 0.5, 0.5), VEC::neg_x()), [&](const size_t i) { visited.push_back(i); });
+    ASSERT_EQ(boxes.size(), visited.size());
+    for (size_t i = 1; i < visited.size(); ++i) {
+        ASSERT_GT(boxes[visited[i - 1]].first.min.x(), boxes[visited[i]].first.min.x());
+    }
+
+    visited.clear();
+    tree.visitIntersectors(RAY(VEC(-1.0, 2.0, 0.5), VEC::pos_x()), [&](const size_t i) { visited.push_back(i); });
+    ASSERT_TRUE(visited.empty());
+}
+
+TEST(AABBTreeTest, findNearestIntersection) {
+    const auto boxes = makeGrid(1000);
+    const auto tree = buildTree(boxes);
+
+    const auto distanceTo = [](const RAY& ray, const BOX& bounds) {
+        return bounds.contains(ray.origin) ? 0.0 : vm::intersect_ray_bbox(ray, bounds);
+    };
+
+    const auto rays = std::vector<RAY>{
+        RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()),
+        RAY(VEC(40.0, 3.5, 0.5), VEC::neg_x()),
+        RAY(VEC(3.5, 3.5, 40.0), VEC::neg_z()),
+        RAY(VEC(-1.0, -1.0, -1.0), vm::normalize(VEC(1.0, 1.0, 1.0))),
+        RAY(VEC(12.5, 13.5, 12.5), VEC::pos_y()),
+    };
+
+    for (const auto& ray : rays) {
+        auto expected = vm::nan<double>();
+        size_t intersectorCount = 0;
+        for (const auto& [bounds, i] : boxes) {
+            const auto distance = distanceTo(ray, bounds);
+            if (!vm::is_nan(distance)) {
+                expected = vm::safe_min(expected, distance);
+                ++intersectorCount;
+            }
+        }
+
+        ASSERT_GT(intersectorCount, 0u);
+
+        size_t callCount = 0;
+        const auto actual = tree.findNearestIntersection(ray, [&](const size_t i) {
+            ++callCount;
+            return distanceTo(ray, boxes[i].first);
+        });
+
+        ASSERT_EQ(expected, actual);
+        ASSERT_LE(callCount, intersectorCount);
+        if (intersectorCount > 4) {
+            ASSERT_LT(callCount, intersectorCount);
+        }
+    }
+
+    const auto missingRay = RAY(VEC(-1.0, -1.0, -1.0), VEC::neg_x());
+    ASSERT_TRUE(vm::is_nan(tree.findNearestIntersection(missingRay, [&](const size_t i) {
+        return distanceTo(missingRay, boxes[i].first);
+    })));
+}
+
 void assertTree(const std::string& exp, const AABB& actual) {
     std::stringstream str;
     actual.print(str);
@@ -0,0 +1,213 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Allocator.h"
+#include "Polyhedron.h"
+#include "Polyhedron_DefaultPayload.h"
+#include "Polyhedron_Instantiation.h"
+
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+using Polyhedron3d = Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
+
+namespace {
+    struct Allocated : public Allocator<Allocated> {
+        size_t value[4];
+
+        explicit Allocated(const size_t i_value) {
+            for (auto& v : value) {
+                v = i_value;
+            }
+        }
+
+        bool valid(const size_t i_value) const {
+            for (const auto& v : value) {
+                if (v != i_value) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    constexpr size_t RecycledBlocksPerChunk = 256;
+
+    struct Recycled : public Allocator<Recycled, RecycledBlocksPerChunk> {
+        size_t value[4];
+    };
+}
+
+static constexpr size_t NumObjects = 100'000;
+static constexpr size_t NumPolyhedra = 2'000;
+
+TEST(AllocatorStressTest, allocateAndDeallocateOnDifferentThreads) {
+    std::vector<Allocated*> objects(NumObjects, nullptr);
+    kdl::parallel_for(NumObjects, [&](const size_t i) {
+        objects[i] = new Allocated(i);
+    });
+
+    ASSERT_EQ(NumObjects, std::set<Allocated*>(std::begin(objects), std::end(objects)).size());
+    for (size_t i = 0; i < NumObjects; ++i) {
+        ASSERT_TRUE(objects[i]->valid(i));
+    }
+
+    // free every other object on a worker thread and reuse the blocks on this thread
+    kdl::parallel_for(NumObjects / 2, [&](const size_t i) {
+        delete objects[2 * i];
+        objects[2 * i] = nullptr;
+    });
+    for (size_t i = 0; i < NumObjects; i += 2) {
+        objects[i] = new Allocated(i);
+    }
+
+    ASSERT_EQ(NumObjects, std::set<Allocated*>(std::begin(objects), std::end(objects)).size());
+    for (size_t i = 0; i < NumObjects; ++i) {
+        ASSERT_TRUE(objects[i]->valid(i));
+    }
+
+    kdl::parallel_for(NumObjects, [&](const size_t i) {
+        delete objects[i];
+    });
+}
+
+TEST(AllocatorStressTest, allocateOnWorkerThreadsAndDeallocateRepeatedly) {
+    // like loading maps on worker threads and closing them on the main thread, every cycle with new worker threads
+    constexpr size_t NumCycles = 20;
+    constexpr size_t NumThreads = 4;
+    for (size_t cycle = 0; cycle < NumCycles; ++cycle) {
+        std::vector<Recycled*> objects(NumObjects, nullptr);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < NumThreads; ++t) {
+            threads.emplace_back([&objects, t]() {
+                for (size_t i = t; i < NumObjects; i += NumThreads) {
+                    objects[i] = new Recycled();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto* object : objects) {
+            delete object;
+        }
+    }
+
+    // a new chunk is only created if all free blocks are held by other threads, each of which holds at most two
+    // chunks' worth of free blocks, so the number of chunks must not grow with the number of cycles
+    const auto maxLiveChunks = (NumObjects + RecycledBlocksPerChunk - 1) / RecycledBlocksPerChunk;
+    const auto maxCachedChunks = 2 * (NumThreads + 1);
+    ASSERT_LE(Recycled::chunkCount(), maxLiveChunks + maxCachedChunks + 1);
+}
+
+static vm::vec3d offset(const size_t i) {
+    return vm::vec3d(static_cast<double>(i % 16), static_cast<double>((i / 16) % 16), static_cast<double>(i / 256)) * 256.0;
+}
+
+static Polyhedron3d makeClippedCube(const size_t i) {
+    const auto o = offset(i);
+    Polyhedron3d result(vm::bbox3d(o - vm::vec3d(64.0, 64.0, 64.0), o + vm::vec3d(64.0, 64.0, 64.0)));
+    result.clip(vm::plane3d(o + vm::vec3d(0.0, 0.0, static_cast<double>(i % 32)), vm::normalize(vm::vec3d(1.0, 1.0, 1.0))));
+    result.clip(vm::plane3d(o, vm::vec3d::neg_x()));
+    return result;
+}
+
+static Polyhedron3d makeConvexHull(const size_t i) {
+    const auto o = offset(i);
+    return Polyhedron3d{
+        o + vm::vec3d(-32.0, -32.0, -32.0),
+        o + vm::vec3d(+32.0, -32.0, -32.0),
+        o + vm::vec3d(  0.0, +32.0, -32.0),
+        o + vm::vec3d(  0.0,   0.0, +32.0),
+        o + vm::vec3d(  0.0,   0.0, static_cast<double>(i % 64)),
+        o + vm::vec3d(+16.0, +16.0, +16.0),
+    };
+}
+
+static std::vector<Polyhedron3d> makeFragments(const size_t i) {
+    const auto o = offset(i);
+    const Polyhedron3d minuend(vm::bbox3d(o - vm::vec3d(64.0, 64.0, 64.0), o + vm::vec3d(64.0, 64.0, 64.0)));
+    const Polyhedron3d subtrahend(vm::bbox3d(o - vm::vec3d(32.0, 32.0, 128.0), o + vm::vec3d(32.0, 32.0, 0.0)));
+    return minuend.subtract(subtrahend);
+}
+
+TEST(AllocatorStressTest, buildPolyhedraOnWorkerThreads) {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < NumPolyhedra; ++i) {
+        indices.push_back(i);
+    }
+
+    const auto expectedCubes = kdl::vec_transform(indices, makeClippedCube);
+    const auto expectedHulls = kdl::vec_transform(indices, makeConvexHull);
+
+    auto cubes = kdl::vec_parallel_transform(indices, makeClippedCube);
+    auto hulls = kdl::vec_parallel_transform(indices, makeConvexHull);
+
+    for (size_t i = 0; i < NumPolyhedra; ++i) {
+        ASSERT_TRUE(cubes[i].polyhedron());
+        ASSERT_TRUE(cubes[i].closed());
+        ASSERT_EQ(expectedCubes[i], cubes[i]);
+
+        ASSERT_TRUE(hulls[i].polyhedron());
+        ASSERT_TRUE(hulls[i].closed());
+        ASSERT_EQ(expectedHulls[i], hulls[i]);
+    }
+
+    // copy and destroy on worker threads what was built on other threads
+    kdl::parallel_for(NumPolyhedra, [&](const size_t i) {
+        auto copy = cubes[NumPolyhedra - i - 1];
+        cubes[NumPolyhedra - i - 1] = Polyhedron3d();
+        hulls[i] = std::move(copy);
+    });
+
+    for (size_t i = 0; i < NumPolyhedra; ++i) {
+        ASSERT_EQ(0u, cubes[i].vertexCount());
+        ASSERT_EQ(expectedCubes[i], hulls[i]);
+    }
+}
+
+TEST(AllocatorStressTest, subtractPolyhedraOnWorkerThreads) {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < NumPolyhedra; ++i) {
+        indices.push_back(i);
+    }
+
+    const auto expected = kdl::vec_transform(indices, makeFragments);
+    const auto fragments = kdl::vec_parallel_transform(indices, makeFragments);
+
+    for (size_t i = 0; i < NumPolyhedra; ++i) {
+        ASSERT_EQ(expected[i].size(), fragments[i].size());
+        for (size_t j = 0; j < expected[i].size(); ++j) {
+            ASSERT_TRUE(fragments[i][j].polyhedron());
+            ASSERT_EQ(expected[i][j], fragments[i][j]);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Color.h"
+#include "Assets/Palette.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<unsigned char> randomBytes(const size_t count, std::mt19937& random) {
+            auto dist = std::uniform_int_distribution<int>(0, 255);
+            auto result = std::vector<unsigned char>(count);
+            for (auto& byte : result) {
+                byte = static_cast<unsigned char>(dist(random));
+            }
+            return result;
+        }
+
+        /**
+         * Converts the given indices one pixel at a time. Indices which are not covered by the given palette data are
+         * opaque black.
+         */
+        static std::vector<unsigned char> referenceRgba(const std::vector<unsigned char>& paletteData, const std::vector<unsigned char>& indices, const PaletteTransparency transparency, Color& averageColor, bool& hasTransparency) {
+            auto result = std::vector<unsigned char>(indices.size() * 4);
+            double sum[3] = { 0.0, 0.0, 0.0 };
+            hasTransparency = false;
+
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const auto index = static_cast<size_t>(indices[i]);
+                for (size_t j = 0; j < 3; ++j) {
+                    const auto component = index * 3 + j < paletteData.size() ? paletteData[index * 3 + j] : 0x00;
+                    result[i * 4 + j] = component;
+                    sum[j] += static_cast<double>(component);
+                }
+
+                if (transparency == PaletteTransparency::Index255Transparent && index == 255) {
+                    result[i * 4 + 3] = 0x00;
+                    hasTransparency = true;
+                } else {
+                    result[i * 4 + 3] = 0xFF;
+                }
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                averageColor[j] = static_cast<float>(sum[j] / static_cast<double>(indices.size()) / 255.0);
+            }
+            averageColor[3] = 1.0f;
+
+            return result;
+        }
+
+        TEST(PaletteTest, lookupRgba) {
+            auto random = std::mt19937(42);
+
+            auto table = Palette::RgbaTable();
+            for (auto& pixel : table) {
+                pixel = static_cast<uint32_t>(random());
+            }
+
+            // lengths which are not multiples of the vector width exercise the scalar tail
+            for (const size_t pixelCount : { 0u, 1u, 3u, 7u, 8u, 9u, 15u, 17u, 31u, 33u, 1021u, 65537u }) {
+                const auto indices = randomBytes(pixelCount, random);
+
+                auto expected = std::vector<unsigned char>(pixelCount * 4);
+                for (size_t i = 0; i < pixelCount; ++i) {
+                    std::memcpy(&expected[i * 4], &table[indices[i]], 4);
+                }
+
+                auto scalar = std::vector<unsigned char>(pixelCount * 4);
+                Palette::lookupRgbaScalar(table, indices.data(), pixelCount, scalar.data());
+                ASSERT_EQ(expected, scalar) << "scalar, " << pixelCount << " pixels";
+
+                // uses AVX2 gathers if available, see Palette::hasVectorizedLookup
+                auto vectorized = std::vector<unsigned char>(pixelCount * 4);
+                Palette::lookupRgba(table, indices.data(), pixelCount, vectorized.data());
+                ASSERT_EQ(expected, vectorized) << "vectorized, " << pixelCount << " pixels";
+            }
+        }
+
+        TEST(PaletteTest, indexedToRgba) {
+            auto random = std::mt19937(7);
+
+            // a palette with fewer than 256 colors, so that most indices are out of its range
+            const auto paletteData = randomBytes(100u * 3u, random);
+            const auto palette = Palette(paletteData);
+
+            const auto withTransparentIndex = randomBytes(4099u, random);
+            auto withoutTransparentIndex = withTransparentIndex;
+            for (auto& index : withoutTransparentIndex) {
+                if (index == 255) {
+                    index = 254;
+                }
+            }
+
+            for (const auto transparency : { PaletteTransparency::Opaque, PaletteTransparency::Index255Transparent }) {
+                for (const auto& indices : { withTransparentIndex, withoutTransparentIndex }) {
+                    Color expectedAverage;
+                    bool expectedTransparency;
+                    const auto expected = referenceRgba(paletteData, indices, transparency, expectedAverage, expectedTransparency);
+
+                    Color average;
+                    auto rgba = std::vector<unsigned char>(indices.size() * 4);
+                    const auto hasTransparency = palette.indexedToRgba(indices, indices.size(), rgba, transparency, average);
+
+                    ASSERT_EQ(expected, rgba);
+                    ASSERT_EQ(expectedTransparency, hasTransparency);
+                    for (size_t j = 0; j < 4; ++j) {
+                        ASSERT_NEAR(expectedAverage[j], average[j], 1.0e-5f);
+                    }
+                }
+            }
+        }
+    }
+}
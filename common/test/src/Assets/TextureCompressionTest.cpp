@@ -0,0 +1,238 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCompression.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static TextureBuffer solidImage(const size_t width, const size_t height, const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a) {
+            auto result = TextureBuffer(width * height * 4);
+            for (size_t i = 0; i < width * height; ++i) {
+                result.data()[4 * i + 0] = r;
+                result.data()[4 * i + 1] = g;
+                result.data()[4 * i + 2] = b;
+                result.data()[4 * i + 3] = a;
+            }
+            return result;
+        }
+
+        static void decodeRgb565(const uint16_t color, int rgb[3]) {
+            const auto r = (color >> 11) & 0x1F;
+            const auto g = (color >> 5) & 0x3F;
+            const auto b = color & 0x1F;
+            rgb[0] = (r << 3) | (r >> 2);
+            rgb[1] = (g << 2) | (g >> 4);
+            rgb[2] = (b << 3) | (b >> 2);
+        }
+
+        // decodes the color of the pixel with the given index from a BC1 color block
+        static void decodeColor(const unsigned char* block, const size_t pixel, int rgb[3]) {
+            const auto color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+            const auto color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+            const auto indices = static_cast<uint32_t>(block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24));
+            const auto index = (indices >> (2 * pixel)) & 0x3;
+
+            int c0[3], c1[3];
+            decodeRgb565(color0, c0);
+            decodeRgb565(color1, c1);
+            for (size_t j = 0; j < 3; ++j) {
+                switch (index) {
+                    case 0: rgb[j] = c0[j]; break;
+                    case 1: rgb[j] = c1[j]; break;
+                    case 2: rgb[j] = (2 * c0[j] + c1[j]) / 3; break;
+                    default: rgb[j] = (c0[j] + 2 * c1[j]) / 3; break;
+                }
+            }
+        }
+
+        // decodes the alpha value of the pixel with the given index from a BC3 alpha block
+        static int decodeAlpha(const unsigned char* block, const size_t pixel) {
+            const int alpha0 = block[0];
+            const int alpha1 = block[1];
+            uint64_t indices = 0;
+            for (size_t i = 0; i < 6; ++i) {
+                indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+            }
+            const auto index = static_cast<int>((indices >> (3 * pixel)) & 0x7);
+            switch (index) {
+                case 0: return alpha0;
+                case 1: return alpha1;
+                default: return ((8 - index) * alpha0 + (index - 1) * alpha1) / 7;
+            }
+        }
+
+        TEST(TextureCompressionTest, compressedImageSize) {
+            ASSERT_EQ(8u, compressedImageSize(1, 1, CompressedTextureFormat::BC1));
+            ASSERT_EQ(8u, compressedImageSize(4, 4, CompressedTextureFormat::BC1));
+            ASSERT_EQ(16u, compressedImageSize(5, 4, CompressedTextureFormat::BC1));
+            ASSERT_EQ(16u, compressedImageSize(4, 4, CompressedTextureFormat::BC3));
+
+            // BC1 uses half a byte per pixel and BC3 uses one byte per pixel
+            ASSERT_EQ(64u * 32u * 4u / 8u, compressedImageSize(64, 32, CompressedTextureFormat::BC1));
+            ASSERT_EQ(64u * 32u * 4u / 4u, compressedImageSize(64, 32, CompressedTextureFormat::BC3));
+        }
+
+        TEST(TextureCompressionTest, compressSolidColor) {
+            const auto image = solidImage(8, 8, 255, 0, 0, 255);
+            const auto compressed = compressImage(image, 8, 8, GL_RGBA, CompressedTextureFormat::BC1);
+            ASSERT_EQ(compressedImageSize(8, 8, CompressedTextureFormat::BC1), compressed.size());
+
+            for (size_t block = 0; block < 4; ++block) {
+                for (size_t pixel = 0; pixel < 16; ++pixel) {
+                    int rgb[3];
+                    decodeColor(compressed.data() + 8 * block, pixel, rgb);
+                    ASSERT_EQ(255, rgb[0]);
+                    ASSERT_EQ(0, rgb[1]);
+                    ASSERT_EQ(0, rgb[2]);
+                }
+            }
+        }
+
+        TEST(TextureCompressionTest, compressBgrImage) {
+            auto image = TextureBuffer(4 * 4 * 3);
+            for (size_t i = 0; i < 16; ++i) {
+                image.data()[3 * i + 0] = 255;
+                image.data()[3 * i + 1] = 0;
+                image.data()[3 * i + 2] = 0;
+            }
+
+            const auto compressed = compressImage(image, 4, 4, GL_BGR, CompressedTextureFormat::BC1);
+            int rgb[3];
+            decodeColor(compressed.data(), 0, rgb);
+            ASSERT_EQ(0, rgb[0]);
+            ASSERT_EQ(0, rgb[1]);
+            ASSERT_EQ(255, rgb[2]);
+        }
+
+        TEST(TextureCompressionTest, compressTwoColors) {
+            // left half black, right half white
+            auto image = solidImage(4, 4, 0, 0, 0, 255);
+            for (size_t y = 0; y < 4; ++y) {
+                for (size_t x = 2; x < 4; ++x) {
+                    for (size_t c = 0; c < 3; ++c) {
+                        image.data()[(y * 4 + x) * 4 + c] = 255;
+                    }
+                }
+            }
+
+            // the endpoints are inset slightly, so the colors are not reproduced exactly
+            const auto compressed = compressImage(image, 4, 4, GL_RGBA, CompressedTextureFormat::BC1);
+            for (size_t y = 0; y < 4; ++y) {
+                for (size_t x = 0; x < 4; ++x) {
+                    int rgb[3];
+                    decodeColor(compressed.data(), y * 4 + x, rgb);
+                    for (size_t c = 0; c < 3; ++c) {
+                        ASSERT_NEAR(x < 2 ? 0 : 255, rgb[c], 16);
+                    }
+                }
+            }
+        }
+
+        TEST(TextureCompressionTest, compressAlpha) {
+            // top half transparent, bottom half opaque
+            auto image = solidImage(4, 4, 0, 0, 255, 255);
+            for (size_t i = 0; i < 8; ++i) {
+                image.data()[4 * i + 3] = 0;
+            }
+
+            const auto compressed = compressImage(image, 4, 4, GL_RGBA, CompressedTextureFormat::BC3);
+            ASSERT_EQ(16u, compressed.size());
+            for (size_t pixel = 0; pixel < 16; ++pixel) {
+                ASSERT_EQ(pixel < 8 ? 0 : 255, decodeAlpha(compressed.data(), pixel));
+
+                int rgb[3];
+                decodeColor(compressed.data() + 8, pixel, rgb);
+                ASSERT_EQ(255, rgb[2]);
+            }
+        }
+
+        TEST(TextureCompressionTest, downsampleImage) {
+            auto image = TextureBuffer(2 * 2 * 3);
+            const unsigned char pixels[] = { 0, 10, 20, 4, 10, 20, 8, 10, 20, 12, 10, 21 };
+            std::copy(std::begin(pixels), std::end(pixels), image.data());
+
+            const auto result = downsampleImage(image, 2, 2, 3);
+            ASSERT_EQ(3u, result.size());
+            ASSERT_EQ(6, result.data()[0]);
+            ASSERT_EQ(10, result.data()[1]);
+            ASSERT_EQ(20, result.data()[2]);
+
+            // odd dimensions are clamped
+            ASSERT_EQ(1u * 2u * 4u, downsampleImage(solidImage(3, 5, 1, 2, 3, 4), 3, 5, 4).size());
+        }
+
+        TEST(TextureCompressionTest, compressTexture) {
+            auto texture = Texture("texture", 64, 32, Color(), solidImage(64, 32, 10, 20, 30, 255), GL_RGBA, TextureType::Opaque);
+            ASSERT_EQ(64u * 32u * 4u, texture.bufferSize());
+            ASSERT_FALSE(texture.isCompressed());
+
+            ASSERT_TRUE(texture.compress());
+            ASSERT_TRUE(texture.isCompressed());
+            ASSERT_EQ(glCompressedTextureFormat(CompressedTextureFormat::BC1), texture.format());
+
+            // the missing mipmaps were generated
+            const auto& buffers = texture.buffersIfUnprepared();
+            ASSERT_EQ(7u, buffers.size());
+
+            size_t expectedSize = 0;
+            for (size_t level = 0; level < buffers.size(); ++level) {
+                const auto mipSize = sizeAtMipLevel(64, 32, level);
+                const auto levelSize = compressedImageSize(mipSize.x(), mipSize.y(), CompressedTextureFormat::BC1);
+                ASSERT_EQ(levelSize, buffers[level].size());
+                expectedSize += levelSize;
+            }
+            ASSERT_EQ(expectedSize, texture.bufferSize());
+            ASSERT_LT(texture.bufferSize(), 64u * 32u * 4u / 4u);
+
+            // compressing twice does nothing
+            ASSERT_FALSE(texture.compress());
+        }
+
+        TEST(TextureCompressionTest, compressMaskedTexture) {
+            auto image = solidImage(16, 16, 10, 20, 30, 255);
+            image.data()[3] = 0;
+
+            TextureBufferList buffers;
+            buffers.push_back(std::move(image));
+            buffers.push_back(solidImage(8, 8, 10, 20, 30, 255));
+
+            auto texture = Texture("masked", 16, 16, Color(), std::move(buffers), GL_RGBA, TextureType::Masked);
+            ASSERT_TRUE(texture.compress());
+            ASSERT_EQ(glCompressedTextureFormat(CompressedTextureFormat::BC3), texture.format());
+
+            // only the first mipmap of masked textures is uploaded
+            ASSERT_EQ(1u, texture.buffersIfUnprepared().size());
+            ASSERT_EQ(compressedImageSize(16, 16, CompressedTextureFormat::BC3), texture.bufferSize());
+        }
+
+        TEST(TextureCompressionTest, compressEmptyTexture) {
+            auto texture = Texture("empty", 64, 64);
+            ASSERT_FALSE(texture.compress());
+            ASSERT_FALSE(texture.isCompressed());
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Assets/Texture.h"
+#include "Assets/TextureResidency.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static void makeResident(TextureResidency& residency, Texture& texture, const size_t size) {
+            ASSERT_TRUE(residency.touch(&texture));
+            ASSERT_EQ(TextureResidencyState::Decoding, residency.state(&texture));
+            residency.setResident(&texture, size);
+            ASSERT_EQ(TextureResidencyState::Resident, residency.state(&texture));
+        }
+
+        TEST(TextureResidencyTest, evictLeastRecentlyUsedTextures) {
+            Texture a("a", 16, 16), b("b", 16, 16), c("c", 16, 16), d("d", 16, 16);
+
+            TextureResidency residency(300u, 2u);
+            for (auto* texture : { &a, &b, &c, &d }) {
+                residency.add(texture);
+                ASSERT_EQ(TextureResidencyState::Deferred, residency.state(texture));
+                makeResident(residency, *texture, 100u);
+            }
+            ASSERT_EQ(400u, residency.residentSize());
+
+            // all textures were used too recently
+            ASSERT_TRUE(residency.evict().empty());
+            ASSERT_EQ(400u, residency.residentSize());
+
+            residency.nextGeneration();
+            residency.nextGeneration();
+            ASSERT_FALSE(residency.touch(&a));
+
+            // a was used recently, b is the least recently used texture
+            ASSERT_EQ(std::vector<Texture*>({ &b }), residency.evict());
+            ASSERT_EQ(300u, residency.residentSize());
+            ASSERT_EQ(TextureResidencyState::Deferred, residency.state(&b));
+
+            residency.setBudget(100u);
+            ASSERT_EQ(std::vector<Texture*>({ &c, &d }), residency.evict());
+            ASSERT_EQ(100u, residency.residentSize());
+            ASSERT_EQ(TextureResidencyState::Resident, residency.state(&a));
+            ASSERT_EQ(TextureResidencyState::Deferred, residency.state(&c));
+            ASSERT_EQ(TextureResidencyState::Deferred, residency.state(&d));
+        }
+
+        TEST(TextureResidencyTest, keepTexturesInUse) {
+            Texture a("a", 16, 16), b("b", 16, 16);
+
+            TextureResidency residency(0u, 1u);
+            residency.add(&a);
+            residency.add(&b);
+            makeResident(residency, a, 100u);
+            makeResident(residency, b, 100u);
+
+            a.incUsageCount();
+            residency.nextGeneration();
+
+            ASSERT_EQ(std::vector<Texture*>({ &b }), residency.evict());
+            ASSERT_EQ(100u, residency.residentSize());
+            ASSERT_EQ(TextureResidencyState::Resident, residency.state(&a));
+
+            a.decUsageCount();
+            ASSERT_EQ(std::vector<Texture*>({ &a }), residency.evict());
+            ASSERT_EQ(0u, residency.residentSize());
+        }
+
+        TEST(TextureResidencyTest, decodeEvictedTexturesAgain) {
+            Texture a("a", 16, 16);
+
+            TextureResidency residency(0u, 1u);
+            residency.add(&a);
+            makeResident(residency, a, 100u);
+
+            residency.nextGeneration();
+            ASSERT_EQ(std::vector<Texture*>({ &a }), residency.evict());
+
+            makeResident(residency, a, 100u);
+            ASSERT_EQ(100u, residency.residentSize());
+        }
+
+        TEST(TextureResidencyTest, doNotDecodeFailedTexturesAgain) {
+            Texture a("a", 16, 16);
+
+            TextureResidency residency(0u, 1u);
+            residency.add(&a);
+            ASSERT_TRUE(residency.touch(&a));
+
+            residency.setFailed(&a);
+            ASSERT_EQ(TextureResidencyState::Failed, residency.state(&a));
+
+            residency.nextGeneration();
+            ASSERT_FALSE(residency.touch(&a));
+            ASSERT_EQ(TextureResidencyState::Failed, residency.state(&a));
+            ASSERT_TRUE(residency.evict().empty());
+        }
+
+        TEST(TextureResidencyTest, removeResidentTexture) {
+            Texture a("a", 16, 16), b("b", 16, 16);
+
+            TextureResidency residency(0u, 1u);
+            residency.add(&a);
+            residency.add(&b);
+            makeResident(residency, a, 100u);
+            makeResident(residency, b, 50u);
+
+            residency.remove(&a);
+            ASSERT_FALSE(residency.contains(&a));
+            ASSERT_EQ(50u, residency.residentSize());
+
+            residency.nextGeneration();
+            ASSERT_EQ(std::vector<Texture*>({ &b }), residency.evict());
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/EntityModel.h"
+#include "IO/AsyncEntityModelLoader.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/GameConfigParser.h"
+#include "IO/IOUtils.h"
+#include "IO/Path.h"
+#include "Model/GameConfig.h"
+#include "Model/GameImpl.h"
+
+#include <vecmath/bbox.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Loads the fixture models with a Quake 3 game whose search paths are the fixture directories.
+         */
+        class FixtureGame {
+        private:
+            NullLogger m_logger;
+            Model::GameConfig m_config;
+        public:
+            Model::GameImpl game;
+
+            FixtureGame() :
+            m_config(loadConfig()),
+            game(m_config, Disk::getCurrentWorkingDir() + Path("fixture/test/IO"), m_logger) {
+                game.setAdditionalSearchPaths({
+                    Path("Md3/bfg"),
+                    Path("Md3/armor"),
+                    Path("Ase/wedge_with_shader"),
+                    Path("Ase/steelstorm_player")
+                }, m_logger);
+            }
+        private:
+            static Model::GameConfig loadConfig() {
+                const auto configPath = Disk::getCurrentWorkingDir() + Path("fixture/games/Quake3/GameConfig.cfg");
+                const auto configStr = OpenStream(configPath, false).readAll();
+                auto configParser = GameConfigParser(configStr, configPath);
+                return configParser.parse();
+            }
+        };
+
+        /**
+         * Counts how often a model is initialized by the given loader.
+         */
+        class CountingModelLoader : public EntityModelLoader {
+        private:
+            const EntityModelLoader& m_loader;
+        public:
+            mutable std::atomic<size_t> initializeCount;
+
+            explicit CountingModelLoader(const EntityModelLoader& loader) :
+            m_loader(loader),
+            initializeCount(0u) {}
+        private:
+            std::unique_ptr<Assets::EntityModel> doInitializeModel(const Path& path, Logger& logger) const override {
+                ++initializeCount;
+                return m_loader.initializeModel(path, logger);
+            }
+
+            void doLoadFrame(const Path& path, const size_t frameIndex, Assets::EntityModel& model, Logger& logger) const override {
+                m_loader.loadFrame(path, frameIndex, model, logger);
+            }
+        };
+
+        static const std::vector<Path> FixtureModels = {
+            Path("models/weapons2/bfg/bfg.md3"),
+            Path("models/armor_red.md3"),
+            Path("models/mapobjects/wedges/wedge_45.ase"),
+            Path("player.ase"),
+        };
+
+        TEST(AsyncEntityModelLoaderTest, loadModelsConcurrently) {
+            NullLogger logger;
+            FixtureGame fixture;
+            const auto& loader = fixture.game;
+
+            AsyncEntityModelLoader asyncLoader;
+            for (const auto& path : FixtureModels) {
+                ASSERT_TRUE(asyncLoader.load(path, 0u, loader));
+            }
+            asyncLoader.wait();
+
+            auto results = asyncLoader.takeResults();
+            ASSERT_EQ(FixtureModels.size(), results.size());
+            ASSERT_TRUE(asyncLoader.idle());
+
+            std::map<Path, std::unique_ptr<Assets::EntityModel>> asyncModels;
+            for (auto& result : results) {
+                asyncModels[result.path] = std::move(result.model);
+            }
+
+            for (const auto& path : FixtureModels) {
+                auto serialModel = loader.initializeModel(path, logger);
+                loader.loadFrame(path, 0u, *serialModel, logger);
+
+                const auto& asyncModel = asyncModels[path];
+                ASSERT_NE(nullptr, asyncModel) << path;
+                ASSERT_EQ(serialModel->frameCount(), asyncModel->frameCount()) << path;
+                ASSERT_EQ(serialModel->surfaceCount(), asyncModel->surfaceCount()) << path;
+
+                const auto* serialFrame = serialModel->frame(0u);
+                const auto* asyncFrame = asyncModel->frame(0u);
+                ASSERT_TRUE(asyncFrame->loaded()) << path;
+                ASSERT_EQ(serialFrame->name(), asyncFrame->name()) << path;
+                ASSERT_EQ(serialFrame->bounds(), asyncFrame->bounds()) << path;
+            }
+        }
+
+        TEST(AsyncEntityModelLoaderTest, deduplicateRequests) {
+            FixtureGame fixture;
+            CountingModelLoader loader(fixture.game);
+
+            AsyncEntityModelLoader asyncLoader;
+            const auto& path = FixtureModels.front();
+            ASSERT_TRUE(asyncLoader.load(path, 0u, loader));
+            ASSERT_FALSE(asyncLoader.load(path, 0u, loader));
+            ASSERT_TRUE(asyncLoader.requested(path));
+            asyncLoader.wait();
+
+            // the model is still considered in flight until its result has been taken
+            ASSERT_FALSE(asyncLoader.load(path, 0u, loader));
+
+            const auto results = asyncLoader.takeResults();
+            ASSERT_EQ(1u, results.size());
+            ASSERT_EQ(1u, loader.initializeCount.load());
+            ASSERT_FALSE(asyncLoader.requested(path));
+        }
+
+        TEST(AsyncEntityModelLoaderTest, reportFailure) {
+            FixtureGame fixture;
+            const auto& loader = fixture.game;
+
+            AsyncEntityModelLoader asyncLoader;
+            const auto path = Path("models/missing.md3");
+            asyncLoader.load(path, 0u, loader);
+            asyncLoader.wait();
+
+            const auto results = asyncLoader.takeResults();
+            ASSERT_EQ(1u, results.size());
+            ASSERT_EQ(nullptr, results.front().model);
+            ASSERT_FALSE(results.front().messages.empty());
+            ASSERT_EQ(LogLevel::Error, results.front().messages.front().level);
+        }
+
+        TEST(AsyncEntityModelLoaderTest, cancelDiscardsResults) {
+            FixtureGame fixture;
+            const auto& loader = fixture.game;
+
+            AsyncEntityModelLoader asyncLoader;
+            for (const auto& path : FixtureModels) {
+                asyncLoader.load(path, 0u, loader);
+            }
+            asyncLoader.cancel();
+
+            ASSERT_TRUE(asyncLoader.idle());
+            ASSERT_TRUE(asyncLoader.takeResults().empty());
+            ASSERT_FALSE(asyncLoader.requested(FixtureModels.front()));
+        }
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/AsyncTextureDecoder.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/WadFileSystem.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::shared_ptr<const TextureReader> createReader() {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const auto palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            return std::make_shared<IdMipTextureReader>(nameStrategy, palette);
+        }
+
+        namespace {
+            class ThrowingTextureReader : public TextureReader {
+            public:
+                ThrowingTextureReader() :
+                TextureReader(TextureNameStrategy()) {}
+            private:
+                Assets::Texture* doReadTexture(std::shared_ptr<File> /* file */) const override {
+                    throw AssetException("corrupt texture");
+                }
+            };
+        }
+
+        static std::vector<std::shared_ptr<File>> openTextures(const FileSystem& fs) {
+            std::vector<std::shared_ptr<File>> result;
+            for (const auto& path : fs.findItems(Path(""), FileExtensionMatcher("D"))) {
+                result.push_back(fs.openFile(path));
+            }
+            return result;
+        }
+
+        TEST(AsyncTextureDecoderTest, readTextureHeader) {
+            const auto reader = createReader();
+
+            const auto wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            for (const auto& file : openTextures(wadFS)) {
+                const auto header = std::unique_ptr<Assets::Texture>(reader->readTextureHeader(file));
+                const auto texture = std::unique_ptr<Assets::Texture>(reader->readTexture(file));
+                ASSERT_NE(nullptr, header);
+
+                ASSERT_EQ(texture->name(), header->name());
+                ASSERT_EQ(texture->width(), header->width());
+                ASSERT_EQ(texture->height(), header->height());
+                ASSERT_EQ(texture->type(), header->type());
+                ASSERT_FALSE(header->hasBuffers());
+                ASSERT_TRUE(texture->hasBuffers());
+            }
+        }
+
+        TEST(AsyncTextureDecoderTest, decodeDeferredTextures) {
+            const auto reader = createReader();
+
+            const auto wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            Assets::TextureCollection collection(wadPath);
+            std::vector<DeferredTexture> deferredTextures;
+            for (const auto& file : openTextures(wadFS)) {
+                auto* texture = reader->readTextureHeader(file);
+                collection.addTexture(texture);
+                deferredTextures.push_back(DeferredTexture{ texture, file });
+            }
+
+            ASSERT_EQ(21u, deferredTextures.size());
+
+            AsyncTextureDecoder decoder;
+            decoder.decode(&collection, deferredTextures, reader);
+            decoder.wait();
+
+            auto results = decoder.takeResults();
+            ASSERT_EQ(deferredTextures.size(), results.size());
+            ASSERT_TRUE(decoder.idle());
+
+            for (auto& result : results) {
+                ASSERT_TRUE(result.texture->takeBuffers(*result.decoded));
+            }
+
+            for (const auto& deferredTexture : deferredTextures) {
+                const auto expected = std::unique_ptr<Assets::Texture>(reader->readTexture(deferredTexture.file));
+                const auto* texture = deferredTexture.texture;
+
+                ASSERT_TRUE(texture->hasBuffers());
+                ASSERT_EQ(expected->buffersIfUnprepared(), texture->buffersIfUnprepared());
+                ASSERT_EQ(expected->averageColor(), texture->averageColor());
+                ASSERT_EQ(expected->type(), texture->type());
+            }
+        }
+
+        TEST(AsyncTextureDecoderTest, cancelDiscardsResults) {
+            const auto reader = createReader();
+
+            const auto wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            Assets::TextureCollection collection(wadPath);
+            std::vector<DeferredTexture> deferredTextures;
+            for (const auto& file : openTextures(wadFS)) {
+                auto* texture = reader->readTextureHeader(file);
+                collection.addTexture(texture);
+                deferredTextures.push_back(DeferredTexture{ texture, file });
+            }
+
+            AsyncTextureDecoder decoder;
+            decoder.decode(&collection, deferredTextures, reader);
+            decoder.cancel(&collection);
+            decoder.wait();
+
+            ASSERT_TRUE(decoder.takeResults().empty());
+            ASSERT_TRUE(decoder.idle());
+        }
+
+        TEST(AsyncTextureDecoderTest, returnDecodingErrors) {
+            const auto reader = createReader();
+
+            const auto wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            Assets::TextureCollection collection(wadPath);
+            std::vector<DeferredTexture> deferredTextures;
+            for (const auto& file : openTextures(wadFS)) {
+                auto* texture = reader->readTextureHeader(file);
+                collection.addTexture(texture);
+                deferredTextures.push_back(DeferredTexture{ texture, file });
+            }
+
+            AsyncTextureDecoder decoder;
+            decoder.decode(&collection, deferredTextures, std::make_shared<ThrowingTextureReader>());
+            decoder.wait();
+
+            const auto results = decoder.takeResults();
+            ASSERT_EQ(deferredTextures.size(), results.size());
+            for (const auto& result : results) {
+                ASSERT_EQ(nullptr, result.decoded);
+                ASSERT_EQ(std::string("corrupt texture"), result.error);
+                ASSERT_FALSE(result.texture->hasBuffers());
+            }
+        }
+    }
+}
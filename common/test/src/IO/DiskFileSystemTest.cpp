@@ -23,12 +23,15 @@
 #include "Macros.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/PathQt.h"
 #include "IO/TestEnvironment.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include <QFileInfo>
 
@@ -124,6 +127,35 @@ namespace TrenchBroom {
             ASSERT_TRUE(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
         }
 
+        TEST(DiskTest, openFileReleasesFile) {
+            FSTestEnvironment env;
+
+            const auto path = env.dir() + Path("test.txt");
+            const auto file = Disk::openFile(path);
+
+            // the file was read into memory, so it can be deleted while it is still in use
+            Disk::deleteFile(path);
+            ASSERT_FALSE(Disk::fileExists(path));
+
+            auto reader = file->reader().buffer();
+            ASSERT_EQ(std::string("some content"), std::string(std::begin(reader), std::end(reader)));
+        }
+
+        TEST(DiskTest, writeFileAtomically) {
+            FSTestEnvironment env;
+
+            const auto path = env.dir() + Path("cache/entry.bin");
+            Disk::writeFileAtomically(path, "first");
+            Disk::writeFileAtomically(path, "second contents");
+
+            const auto file = Disk::openFile(path);
+            auto reader = file->reader().buffer();
+            ASSERT_EQ(std::string("second contents"), std::string(std::begin(reader), std::end(reader)));
+
+            // no temporary files are left behind
+            ASSERT_EQ(std::vector<Path>({ Path("entry.bin") }), Disk::getDirectoryContents(env.dir() + Path("cache")));
+        }
+
         TEST(DiskTest, resolvePath) {
             FSTestEnvironment env;
 
@@ -37,6 +37,7 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.directoryExists(Path("gfx")));
             ASSERT_TRUE(fs.directoryExists(Path("GFX")));
+            ASSERT_TRUE(fs.directoryExists(Path("./Gfx")));
             ASSERT_FALSE(fs.directoryExists(Path("gfx/palette.lmp")));
         }
 
@@ -49,6 +50,8 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.fileExists(Path("gfx/palette.lmp")));
             ASSERT_TRUE(fs.fileExists(Path("GFX/Palette.LMP")));
+            ASSERT_TRUE(fs.fileExists(Path("gfx/../GFX/./Palette.LMP")));
+            ASSERT_FALSE(fs.fileExists(Path("gfx")));
         }
 
         TEST(IdPakFileSystemTest, findItems) {
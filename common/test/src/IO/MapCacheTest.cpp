@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string CachedMap(R"(
+{
+"classname" "worldspawn"
+"message" "cached"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+{
+"classname" "func_door"
+"speed" "100"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) metal [ 0 -1 0 8 ] [ 0 0 -1 16 ] 45 0.5 2
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) metal [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) metal [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) metal [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) metal [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) metal [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+{
+"classname" "light"
+"origin" "0 0 32"
+}
+)");
+
+        // the duplicate property is reported by the parser, the nameless layer by the world reader
+        static const std::string MapWithMessages(CachedMap + R"(
+{
+"classname" "info_null"
+"origin" "0 0 0"
+"origin" "8 8 8"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_id" "1"
+}
+)");
+
+        static std::string writeWorld(Model::World& world) {
+            std::stringstream str;
+            NodeWriter writer(world, str);
+            writer.writeMap();
+            return str.str();
+        }
+
+        TEST(MapCacheTest, readWorldFromCache) {
+            const vm::bbox3 worldBounds(8192.0);
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+            const auto key = MapCacheKey(CachedMap.size(), 1, 2);
+
+            TestParserStatus status;
+
+            MapCacheWriter cacheWriter;
+            WorldReader worldReader(CachedMap);
+            worldReader.setCacheWriter(&cacheWriter);
+            auto parsedWorld = worldReader.read(Model::MapFormat::Valve, worldBounds, status);
+            cacheWriter.write(cachePath, key);
+
+            auto cacheFile = Disk::openFile(cachePath);
+            auto reader = cacheFile->reader();
+            MapCacheReader cacheReader(reader, key, Model::MapFormat::Valve);
+            ASSERT_TRUE(cacheReader.valid());
+
+            WorldReader cachedWorldReader(CachedMap);
+            auto cachedWorld = cachedWorldReader.read(cacheReader, worldBounds, status);
+
+            ASSERT_EQ(writeWorld(*parsedWorld), writeWorld(*cachedWorld));
+            ASSERT_EQ(parsedWorld->lineNumber(), cachedWorld->lineNumber());
+        }
+
+        TEST(MapCacheTest, replayParserMessages) {
+            const vm::bbox3 worldBounds(8192.0);
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+            const auto key = MapCacheKey(CachedMap.size(), 1, 2);
+
+            const auto& map = MapWithMessages;
+
+            TestParserStatus parseStatus;
+
+            MapCacheWriter cacheWriter;
+            WorldReader worldReader(map);
+            worldReader.setCacheWriter(&cacheWriter);
+            worldReader.read(Model::MapFormat::Valve, worldBounds, parseStatus);
+            cacheWriter.write(cachePath, key);
+
+            ASSERT_EQ(1u, parseStatus.countStatus(LogLevel::Debug));
+            ASSERT_EQ(1u, parseStatus.countStatus(LogLevel::Error));
+
+            auto cacheFile = Disk::openFile(cachePath);
+            auto reader = cacheFile->reader();
+            MapCacheReader cacheReader(reader, key, Model::MapFormat::Valve);
+            ASSERT_TRUE(cacheReader.valid());
+
+            TestParserStatus replayStatus;
+            WorldReader cachedWorldReader(map);
+            cachedWorldReader.read(cacheReader, worldBounds, replayStatus);
+
+            for (const auto level : { LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error }) {
+                ASSERT_EQ(parseStatus.countStatus(level), replayStatus.countStatus(level));
+            }
+        }
+
+        TEST(MapCacheTest, discardMessagesOfCorruptCache) {
+            const vm::bbox3 worldBounds(8192.0);
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+            const auto key = MapCacheKey(MapWithMessages.size(), 1, 2);
+
+            TestParserStatus parseStatus;
+
+            MapCacheWriter cacheWriter;
+            WorldReader worldReader(MapWithMessages);
+            worldReader.setCacheWriter(&cacheWriter);
+            worldReader.read(Model::MapFormat::Valve, worldBounds, parseStatus);
+            cacheWriter.write(cachePath, key);
+
+            // append an invalid record after all recorded messages
+            std::ifstream stream(cachePath.asString(), std::ios::binary);
+            auto data = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            data.push_back('\xff');
+
+            auto reader = Reader::from(data.data(), data.data() + data.size());
+            MapCacheReader cacheReader(reader, key, Model::MapFormat::Valve);
+            ASSERT_TRUE(cacheReader.valid());
+
+            TestParserStatus replayStatus;
+            WorldReader cachedWorldReader(MapWithMessages);
+            ASSERT_THROW(cachedWorldReader.read(cacheReader, worldBounds, replayStatus), ParserException);
+
+            for (const auto level : { LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error }) {
+                ASSERT_EQ(0u, replayStatus.countStatus(level));
+            }
+        }
+
+        TEST(MapCacheTest, rejectStaleCache) {
+            const vm::bbox3 worldBounds(8192.0);
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+            const auto key = MapCacheKey(CachedMap.size(), 1, 2);
+
+            TestParserStatus status;
+
+            MapCacheWriter cacheWriter;
+            WorldReader worldReader(CachedMap);
+            worldReader.setCacheWriter(&cacheWriter);
+            worldReader.read(Model::MapFormat::Valve, worldBounds, status);
+            cacheWriter.write(cachePath, key);
+
+            auto cacheFile = Disk::openFile(cachePath);
+
+            auto reader1 = cacheFile->reader();
+            ASSERT_FALSE(MapCacheReader(reader1, MapCacheKey(CachedMap.size(), 1, 3), Model::MapFormat::Valve).valid());
+
+            auto reader2 = cacheFile->reader();
+            ASSERT_FALSE(MapCacheReader(reader2, MapCacheKey(CachedMap.size(), 2, 2), Model::MapFormat::Valve).valid());
+
+            auto reader3 = cacheFile->reader();
+            ASSERT_FALSE(MapCacheReader(reader3, key, Model::MapFormat::Standard).valid());
+
+            const auto garbage = std::string("not a map cache");
+            auto reader4 = Reader::from(garbage.data(), garbage.data() + garbage.size());
+            ASSERT_FALSE(MapCacheReader(reader4, key, Model::MapFormat::Valve).valid());
+        }
+
+        TEST(MapCacheTest, computeKey) {
+            TestEnvironment env("MapCacheTest");
+            env.createFile(Path("test.map"), CachedMap);
+
+            const auto path = env.dir() + Path("test.map");
+            const auto* begin = CachedMap.data();
+            const auto* end = begin + CachedMap.size();
+
+            const auto key = MapCacheKey::compute(path, begin, end);
+            ASSERT_EQ(CachedMap.size(), key.fileSize());
+            ASSERT_EQ(key, MapCacheKey::compute(path, begin, end));
+
+            const auto changed = std::string(CachedMap).replace(CachedMap.find("cached"), 6, "cachef");
+            ASSERT_NE(key, MapCacheKey::compute(path, changed.data(), changed.data() + changed.size()));
+        }
+    }
+}
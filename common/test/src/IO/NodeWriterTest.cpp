@@ -20,10 +20,12 @@
 #include <gtest/gtest.h>
 
 #include "IO/NodeWriter.h"
+#include "IO/PrintfMapFileSerializer.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceAttributes.h"
+#include "Model/Entity.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
@@ -31,10 +33,25 @@
 
 #include <kdl/string_compare.h>
 
+#include <cstdio>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        static std::string readFile(FILE* file) {
+            std::fflush(file);
+            std::rewind(file);
+
+            std::string result;
+            char buffer[4096];
+            size_t count;
+            while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                result.append(buffer, count);
+            }
+            return result;
+        }
+
         TEST(NodeWriterTest, writeEmptyMap) {
             Model::World map(Model::MapFormat::Standard);
 
@@ -443,6 +460,58 @@ R"(( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1
             delete brush;
         }
 
+        TEST(NodeWriterTest, writeMapFileLikePrintf) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            for (const auto format : { Model::MapFormat::Standard, Model::MapFormat::Valve }) {
+                Model::World map(format);
+                map.addOrUpdateAttribute("classname", "worldspawn");
+
+                Model::Entity* entity = map.createEntity();
+                entity->addOrUpdateAttribute("classname", "func_door");
+                map.defaultLayer()->addChild(entity);
+
+                // fractional coordinates and attributes are written with many digits
+                Model::BrushBuilder builder(&map, worldBounds);
+                for (size_t i = 0; i < 64; ++i) {
+                    const auto n = static_cast<FloatType>(i);
+                    const auto min = vm::vec3(n * 96.0 - 3072.0 + 1.0 / 3.0, 1.0 / 7.0 - n, n / 9.0);
+                    Model::Brush* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(64.0 + 1.0 / 3.0, 32.0 / 7.0, 0.1)), "texture");
+                    for (Model::BrushFace* face : brush->faces()) {
+                        face->setXOffset(static_cast<float>(n / 3.0));
+                        face->setYOffset(static_cast<float>(-n / 7.0));
+                        face->setRotation(static_cast<float>(n * 7.3));
+                        face->setXScale(static_cast<float>(1.0 + n / 9.0));
+                        face->setYScale(static_cast<float>(1.0 / (n + 3.0)));
+                    }
+
+                    if (i % 4 == 0) {
+                        entity->addChild(brush);
+                    } else {
+                        map.defaultLayer()->addChild(brush);
+                    }
+                }
+
+                FILE* bufferedFile = std::tmpfile();
+                ASSERT_NE(nullptr, bufferedFile);
+                NodeWriter bufferedWriter(map, bufferedFile);
+                bufferedWriter.writeMap();
+
+                FILE* printfFile = std::tmpfile();
+                ASSERT_NE(nullptr, printfFile);
+                NodeWriter printfWriter(map, PrintfMapFileSerializer::create(format, printfFile).release());
+                printfWriter.writeMap();
+
+                const auto expected = readFile(printfFile);
+                const auto actual = readFile(bufferedFile);
+                std::fclose(printfFile);
+                std::fclose(bufferedFile);
+
+                ASSERT_FALSE(expected.empty());
+                ASSERT_EQ(expected, actual);
+            }
+        }
+
         TEST(NodeWriterTest, writePropertiesWithQuotationMarks) {
             Model::World map(Model::MapFormat::Standard);
             map.addOrUpdateAttribute("classname", "worldspawn");
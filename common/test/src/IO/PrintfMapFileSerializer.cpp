@@ -0,0 +1,161 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrintfMapFileSerializer.h"
+
+#include "Ensure.h"
+#include "Exceptions.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Node.h"
+
+#include <vecmath/vec.h>
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        std::unique_ptr<NodeSerializer> PrintfMapFileSerializer::create(const Model::MapFormat format, FILE* stream) {
+            if (format != Model::MapFormat::Standard && format != Model::MapFormat::Valve) {
+                throw FileFormatException("Unsupported map file format");
+            }
+            return std::unique_ptr<NodeSerializer>(new PrintfMapFileSerializer(format, stream));
+        }
+
+        PrintfMapFileSerializer::PrintfMapFileSerializer(const Model::MapFormat format, FILE* stream) :
+        m_format(format),
+        m_line(1),
+        m_stream(stream) {
+            ensure(m_stream != nullptr, "stream is null");
+        }
+
+        void PrintfMapFileSerializer::doBeginFile() {}
+        void PrintfMapFileSerializer::doEndFile() {}
+
+        void PrintfMapFileSerializer::doBeginEntity(const Model::Node* /* node */) {
+            std::fprintf(m_stream, "// entity %u\n", entityNo());
+            ++m_line;
+            m_startLineStack.push_back(m_line);
+            std::fprintf(m_stream, "{\n");
+            ++m_line;
+        }
+
+        void PrintfMapFileSerializer::doEndEntity(Model::Node* node) {
+            std::fprintf(m_stream, "}\n");
+            ++m_line;
+            setFilePosition(node);
+        }
+
+        void PrintfMapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
+            std::fprintf(m_stream, "\"%s\" \"%s\"\n",
+                         escapeEntityAttribute( attribute.name()).c_str(),
+                         escapeEntityAttribute(attribute.value()).c_str());
+            ++m_line;
+        }
+
+        void PrintfMapFileSerializer::doBeginBrush(const Model::Brush* /* brush */) {
+            std::fprintf(m_stream, "// brush %u\n", brushNo());
+            ++m_line;
+            m_startLineStack.push_back(m_line);
+            std::fprintf(m_stream, "{\n");
+            ++m_line;
+        }
+
+        void PrintfMapFileSerializer::doEndBrush(Model::Brush* brush) {
+            std::fprintf(m_stream, "}\n");
+            ++m_line;
+            setFilePosition(brush);
+        }
+
+        void PrintfMapFileSerializer::doBrushFace(Model::BrushFace* face) {
+            writeFacePoints(face);
+            if (m_format == Model::MapFormat::Valve) {
+                writeValveTextureInfo(face);
+            } else {
+                writeTextureInfo(face);
+            }
+            std::fprintf(m_stream, "\n");
+
+            face->setFilePosition(m_line, 1u);
+            ++m_line;
+        }
+
+        void PrintfMapFileSerializer::writeFacePoints(const Model::BrushFace* face) {
+            const Model::BrushFace::Points& points = face->points();
+
+            std::fprintf(m_stream, "( %.*g %.*g %.*g ) ( %.*g %.*g %.*g ) ( %.*g %.*g %.*g )",
+                         FloatPrecision, points[0].x(),
+                         FloatPrecision, points[0].y(),
+                         FloatPrecision, points[0].z(),
+                         FloatPrecision, points[1].x(),
+                         FloatPrecision, points[1].y(),
+                         FloatPrecision, points[1].z(),
+                         FloatPrecision, points[2].x(),
+                         FloatPrecision, points[2].y(),
+                         FloatPrecision, points[2].z());
+        }
+
+        void PrintfMapFileSerializer::writeTextureInfo(const Model::BrushFace* face) {
+            const std::string& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
+            std::fprintf(m_stream, " %s %.6g %.6g %.6g %.6g %.6g",
+                         textureName.c_str(),
+                         static_cast<double>(face->xOffset()),
+                         static_cast<double>(face->yOffset()),
+                         static_cast<double>(face->rotation()),
+                         static_cast<double>(face->xScale()),
+                         static_cast<double>(face->yScale()));
+        }
+
+        void PrintfMapFileSerializer::writeValveTextureInfo(const Model::BrushFace* face) {
+            const std::string& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
+            const vm::vec3 xAxis = face->textureXAxis();
+            const vm::vec3 yAxis = face->textureYAxis();
+
+            std::fprintf(m_stream, " %s [ %.6g %.6g %.6g %.6g ] [ %.6g %.6g %.6g %.6g ] %.6g %.6g %.6g",
+                         textureName.c_str(),
+
+                         xAxis.x(),
+                         xAxis.y(),
+                         xAxis.z(),
+                         static_cast<double>(face->xOffset()),
+
+                         yAxis.x(),
+                         yAxis.y(),
+                         yAxis.z(),
+                         static_cast<double>(face->yOffset()),
+
+                         static_cast<double>(face->rotation()),
+                         static_cast<double>(face->xScale()),
+                         static_cast<double>(face->yScale()));
+        }
+
+        void PrintfMapFileSerializer::setFilePosition(Model::Node* node) {
+            const size_t start = startLine();
+            node->setFilePosition(start, m_line - start);
+        }
+
+        size_t PrintfMapFileSerializer::startLine() {
+            assert(!m_startLineStack.empty());
+            const size_t result = m_startLineStack.back();
+            m_startLineStack.pop_back();
+            return result;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_PrintfMapFileSerializer
+#define TrenchBroom_PrintfMapFileSerializer
+
+#include "IO/NodeSerializer.h"
+#include "Model/MapFormat.h"
+#include "Model/Model_Forward.h"
+
+#include <cstdio> // for FILE*
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Writes map files by calling fprintf for every brush face, like MapFileSerializer did before it formatted
+         * the brushes into buffers. Serves as a reference for the output and the performance of MapFileSerializer.
+         *
+         * Only the Standard and Valve map formats are supported.
+         */
+        class PrintfMapFileSerializer : public NodeSerializer {
+        private:
+            Model::MapFormat m_format;
+            std::vector<size_t> m_startLineStack;
+            size_t m_line;
+            FILE* m_stream;
+        public:
+            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, FILE* stream);
+        private:
+            PrintfMapFileSerializer(Model::MapFormat format, FILE* stream);
+
+            void doBeginFile() override;
+            void doEndFile() override;
+
+            void doBeginEntity(const Model::Node* node) override;
+            void doEndEntity(Model::Node* node) override;
+            void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doBeginBrush(const Model::Brush* brush) override;
+            void doEndBrush(Model::Brush* brush) override;
+            void doBrushFace(Model::BrushFace* face) override;
+
+            void writeFacePoints(const Model::BrushFace* face);
+            void writeTextureInfo(const Model::BrushFace* face);
+            void writeValveTextureInfo(const Model::BrushFace* face);
+
+            void setFilePosition(Model::Node* node);
+            size_t startLine();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_PrintfMapFileSerializer) */
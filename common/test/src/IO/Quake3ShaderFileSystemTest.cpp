@@ -23,9 +23,11 @@
 #include "Assets/Quake3Shader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/Quake3ShaderFileSystem.h"
+#include "IO/TestEnvironment.h"
 
 #include <memory>
 
@@ -87,6 +89,36 @@ namespace TrenchBroom {
             assertShader(items, texturePrefix + Path("test/not_existing2"));
         }
 
+        TEST(Quake3ShaderFileSystemTest, testParseShadersWhenOpened) {
+            NullLogger logger;
+            TestEnvironment env("Quake3ShaderFileSystemTest");
+
+            const auto workDir = IO::Disk::getCurrentWorkingDir();
+            const auto testDir = workDir + Path("fixture/test/IO/Shader/fs/linking");
+            const auto fallbackDir = testDir + Path("fallback");
+            const auto texturePrefix = Path("textures");
+            const auto shaderSearchPath = Path("scripts");
+            const auto textureSearchPaths = std::vector<Path> { texturePrefix };
+            const auto indexPath = env.dir() + Path("shaders.tbsi");
+
+            std::shared_ptr<FileSystem> fs = std::make_shared<DiskFileSystem>(fallbackDir);
+            fs = std::make_shared<DiskFileSystem>(fs, testDir);
+            fs = std::make_shared<Quake3ShaderFileSystem>(fs, shaderSearchPath, textureSearchPaths, indexPath, logger);
+            ASSERT_TRUE(IO::Disk::fileExists(indexPath));
+
+            const auto file = fs->openFile(texturePrefix + Path("test/test"));
+            const auto* shaderFile = dynamic_cast<const ObjectFile<Assets::Quake3Shader>*>(file.get());
+            ASSERT_NE(nullptr, shaderFile);
+
+            const auto& shader = shaderFile->object();
+            ASSERT_EQ(texturePrefix + Path("test/test"), shader.shaderPath);
+            ASSERT_EQ(texturePrefix + Path("test/editor_image.jpg"), shader.editorImage);
+            ASSERT_EQ(1u, shader.surfaceParms.count("noimpact"));
+
+            // the shader is only parsed once
+            ASSERT_EQ(file, fs->openFile(texturePrefix + Path("test/test")));
+        }
+
         void assertShader(const std::vector<Path>& paths, const Path& path) {
             ASSERT_EQ(1, std::count_if(std::begin(paths), std::end(paths), [&path](const auto& item) { return item == path; }));
         }
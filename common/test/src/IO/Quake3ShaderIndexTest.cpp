@@ -0,0 +1,207 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "Assets/Quake3Shader.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderIndex.h"
+#include "IO/Quake3ShaderParser.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string ShaderScript(R"(
+// a { comment } with braces
+textures/test/first
+{
+    qer_editorimage textures/test/first.tga
+    {
+        map $lightmap /* another } comment */
+    }
+}
+
+/textures/test/second // absolute path
+{
+}
+)");
+
+        static std::string entryText(const std::string& script, const Quake3ShaderIndex::Entry& entry) {
+            return script.substr(entry.offset, entry.length);
+        }
+
+        TEST(Quake3ShaderIndexTest, scanShaders) {
+            const auto entries = Quake3ShaderIndex::scan(ShaderScript.data(), ShaderScript.data() + ShaderScript.size());
+            ASSERT_EQ(2u, entries.size());
+
+            ASSERT_EQ(Path("textures/test/first"), entries[0].shaderPath);
+            ASSERT_EQ(0u, entryText(ShaderScript, entries[0]).find("textures/test/first\n{"));
+            ASSERT_EQ('}', entryText(ShaderScript, entries[0]).back());
+            ASSERT_NE(std::string::npos, entryText(ShaderScript, entries[0]).find("/* another } comment */\n    }\n}"));
+
+            ASSERT_EQ(Path("textures/test/second"), entries[1].shaderPath);
+            ASSERT_EQ("/textures/test/second // absolute path\n{\n}", entryText(ShaderScript, entries[1]));
+        }
+
+        TEST(Quake3ShaderIndexTest, scanMalformedShaders) {
+            const auto scan = [](const std::string& script) {
+                return Quake3ShaderIndex::scan(script.data(), script.data() + script.size());
+            };
+
+            ASSERT_TRUE(scan("").empty());
+            ASSERT_TRUE(scan("// only a comment").empty());
+            ASSERT_THROW(scan("textures/test/first { }}"), ParserException);
+            ASSERT_THROW(scan("textures/test/first { { }"), ParserException);
+            ASSERT_THROW(scan("textures/test/first"), ParserException);
+            ASSERT_THROW(scan("textures/test/first textures/test/second { }"), ParserException);
+            ASSERT_THROW(scan("{ }"), ParserException);
+            ASSERT_THROW(scan("textures/test/first { /* }"), ParserException);
+        }
+
+        TEST(Quake3ShaderIndexTest, scanWordsLikeParser) {
+            // words end at braces and comments, so the index and the parser agree on the shader names
+            const auto script = std::string("textures/test/first{\n}\ntextures/test/second// comment\n{\n}\ntextures/test/third/* comment */{}");
+            const auto entries = Quake3ShaderIndex::scan(script.data(), script.data() + script.size());
+            ASSERT_EQ(3u, entries.size());
+            ASSERT_EQ(Path("textures/test/first"), entries[0].shaderPath);
+            ASSERT_EQ("textures/test/first{\n}", entryText(script, entries[0]));
+            ASSERT_EQ(Path("textures/test/second"), entries[1].shaderPath);
+            ASSERT_EQ(Path("textures/test/third"), entries[2].shaderPath);
+
+            TestParserStatus status;
+            Quake3ShaderParser parser(script);
+            const auto shaders = parser.parse(status);
+            ASSERT_EQ(entries.size(), shaders.size());
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                ASSERT_EQ(entries[i].shaderPath, shaders[i].shaderPath);
+            }
+        }
+
+        TEST(Quake3ShaderIndexTest, reuseStoredEntries) {
+            TestEnvironment env("Quake3ShaderIndexTest");
+            const auto indexPath = env.dir() + Path("index/shaders.tbsi");
+
+            const auto script = NonOwningBufferFile(Path("scripts/test.shader"), ShaderScript.data(), ShaderScript.data() + ShaderScript.size());
+
+            auto index = Quake3ShaderIndex(indexPath);
+            const auto entries = index.entries(script, 1);
+            ASSERT_EQ(2u, entries.size());
+            index.write();
+            ASSERT_TRUE(Disk::fileExists(indexPath));
+
+            // An index that is only read is not written again, so deleting the file shows whether the entries were
+            // read from it or the script was scanned again.
+            auto storedIndex = Quake3ShaderIndex(indexPath);
+            Disk::deleteFile(indexPath);
+
+            const auto storedEntries = storedIndex.entries(script, 1);
+            ASSERT_EQ(entries.size(), storedEntries.size());
+            for (size_t i = 0; i < entries.size(); ++i) {
+                ASSERT_EQ(entries[i].shaderPath, storedEntries[i].shaderPath);
+                ASSERT_EQ(entries[i].offset, storedEntries[i].offset);
+                ASSERT_EQ(entries[i].length, storedEntries[i].length);
+            }
+            storedIndex.write();
+            ASSERT_FALSE(Disk::fileExists(indexPath));
+
+            // A changed script is scanned again.
+            const auto changedContents = "textures/test/third\n{\n}\n" + ShaderScript;
+            const auto changedScript = NonOwningBufferFile(Path("scripts/test.shader"), changedContents.data(), changedContents.data() + changedContents.size());
+
+            const auto& changedEntries = storedIndex.entries(changedScript, 1);
+            ASSERT_EQ(3u, changedEntries.size());
+            ASSERT_EQ(Path("textures/test/third"), changedEntries[0].shaderPath);
+            storedIndex.write();
+            ASSERT_TRUE(Disk::fileExists(indexPath));
+        }
+
+        TEST(Quake3ShaderIndexTest, removeUnusedScripts) {
+            TestEnvironment env("Quake3ShaderIndexTest");
+            const auto indexPath = env.dir() + Path("index/shaders.tbsi");
+
+            const auto kept = NonOwningBufferFile(Path("scripts/kept.shader"), ShaderScript.data(), ShaderScript.data() + ShaderScript.size());
+            const auto removed = NonOwningBufferFile(Path("scripts/removed.shader"), ShaderScript.data(), ShaderScript.data() + ShaderScript.size());
+
+            auto index = Quake3ShaderIndex(indexPath);
+            index.entries(kept, 1);
+            index.entries(removed, 1);
+            index.write();
+
+            // only the kept script exists in the next session
+            auto nextIndex = Quake3ShaderIndex(indexPath);
+            nextIndex.entries(kept, 1);
+            nextIndex.removeUnusedScripts();
+            nextIndex.write();
+
+            // An index that is only read is not written again, so deleting the file shows which scripts were stored.
+            auto prunedIndex = Quake3ShaderIndex(indexPath);
+            Disk::deleteFile(indexPath);
+
+            prunedIndex.entries(kept, 1);
+            prunedIndex.write();
+            ASSERT_FALSE(Disk::fileExists(indexPath));
+
+            prunedIndex.entries(removed, 1);
+            prunedIndex.write();
+            ASSERT_TRUE(Disk::fileExists(indexPath));
+        }
+
+        TEST(Quake3ShaderIndexTest, hashScriptsWithChangedModificationTime) {
+            TestEnvironment env("Quake3ShaderIndexTest");
+            const auto indexPath = env.dir() + Path("index/shaders.tbsi");
+
+            const auto script = NonOwningBufferFile(Path("scripts/test.shader"), ShaderScript.data(), ShaderScript.data() + ShaderScript.size());
+
+            // same size, but different contents
+            auto changedContents = ShaderScript;
+            changedContents.replace(changedContents.find("textures/test/first\n"), 19, "textures/test/third");
+            const auto changedScript = NonOwningBufferFile(Path("scripts/test.shader"), changedContents.data(), changedContents.data() + changedContents.size());
+
+            auto index = Quake3ShaderIndex(indexPath);
+            ASSERT_EQ(Path("textures/test/first"), index.entries(script, 1).front().shaderPath);
+            index.write();
+
+            // The contents of a script whose size and modification time are unchanged are not hashed.
+            auto storedIndex = Quake3ShaderIndex(indexPath);
+            Disk::deleteFile(indexPath);
+            ASSERT_EQ(Path("textures/test/first"), storedIndex.entries(changedScript, 1).front().shaderPath);
+            storedIndex.write();
+            ASSERT_FALSE(Disk::fileExists(indexPath));
+
+            // A script which was touched, but not changed, is not scanned again, but its modification time is updated.
+            ASSERT_EQ(Path("textures/test/first"), storedIndex.entries(script, 2).front().shaderPath);
+            storedIndex.write();
+            ASSERT_TRUE(Disk::fileExists(indexPath));
+
+            // A script which was changed is scanned again.
+            ASSERT_EQ(Path("textures/test/third"), storedIndex.entries(changedScript, 3).front().shaderPath);
+
+            // Scripts with an unknown modification time are always hashed.
+            ASSERT_EQ(Path("textures/test/first"), storedIndex.entries(script, Quake3ShaderIndex::UnknownModificationTime).front().shaderPath);
+            ASSERT_EQ(Path("textures/test/third"), storedIndex.entries(changedScript, Quake3ShaderIndex::UnknownModificationTime).front().shaderPath);
+        }
+    }
+}
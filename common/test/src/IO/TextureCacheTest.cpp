@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string TextureFileContents("not really a texture, but the cache doesn't care");
+
+        static std::unique_ptr<Assets::Texture> createTexture() {
+            auto buffers = Assets::TextureBufferList(2);
+            buffers[0] = Assets::TextureBuffer(4 * 4 * 4, 0x80);
+            buffers[1] = Assets::TextureBuffer(2 * 2 * 4, 0x40);
+            return std::make_unique<Assets::Texture>("some/texture", 4, 4, Color(0.5f, 0.25f, 0.125f, 1.0f), std::move(buffers), GL_RGBA, Assets::TextureType::Masked);
+        }
+
+        TEST(TextureCacheTest, writeAndReadTexture) {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            const auto file = NonOwningBufferFile(Path("textures/some/texture.png"), TextureFileContents.data(), TextureFileContents.data() + TextureFileContents.size());
+            const auto key = TextureCacheKey::compute(file, "image");
+            ASSERT_EQ(nullptr, cache.read(key));
+
+            const auto texture = createTexture();
+            cache.write(key, *texture);
+
+            const auto cached = std::unique_ptr<Assets::Texture>(cache.read(key));
+            ASSERT_NE(nullptr, cached);
+            ASSERT_EQ(texture->name(), cached->name());
+            ASSERT_EQ(texture->width(), cached->width());
+            ASSERT_EQ(texture->height(), cached->height());
+            ASSERT_EQ(texture->averageColor(), cached->averageColor());
+            ASSERT_EQ(texture->format(), cached->format());
+            ASSERT_EQ(texture->type(), cached->type());
+            ASSERT_EQ(texture->buffersIfUnprepared(), cached->buffersIfUnprepared());
+        }
+
+        TEST(TextureCacheTest, rejectStaleEntry) {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            const auto path = Path("textures/some/texture.png");
+            const auto file = NonOwningBufferFile(path, TextureFileContents.data(), TextureFileContents.data() + TextureFileContents.size());
+            const auto key = TextureCacheKey::compute(file, "image");
+            cache.write(key, *createTexture());
+
+            ASSERT_EQ(nullptr, cache.read(TextureCacheKey::compute(file, "idmip:gfx/palette.lmp")));
+
+            const auto changedContents = std::string(TextureFileContents).replace(0, 3, "now");
+            const auto changedFile = NonOwningBufferFile(path, changedContents.data(), changedContents.data() + changedContents.size());
+            ASSERT_NE(key, TextureCacheKey::compute(changedFile, "image"));
+            ASSERT_EQ(nullptr, cache.read(TextureCacheKey::compute(changedFile, "image")));
+        }
+
+        TEST(TextureCacheTest, rejectCorruptEntry) {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            const auto file = NonOwningBufferFile(Path("textures/some/texture.png"), TextureFileContents.data(), TextureFileContents.data() + TextureFileContents.size());
+            const auto key = TextureCacheKey::compute(file, "image");
+            cache.write(key, *createTexture());
+
+            env.createFile(Path("cache") + key.entryName(), "TBTX garbage");
+            ASSERT_EQ(nullptr, cache.read(key));
+        }
+
+        TEST(TextureCacheTest, pruneEntries) {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            // pruning a cache that was never written does nothing
+            cache.prune(0u);
+
+            const auto texture = createTexture();
+            auto entryPaths = std::vector<Path>();
+            for (const auto* name : { "textures/first.png", "textures/other.png", "textures/third.png" }) {
+                const auto file = NonOwningBufferFile(Path(name), TextureFileContents.data(), TextureFileContents.data() + TextureFileContents.size());
+                const auto key = TextureCacheKey::compute(file, "image");
+                cache.write(key, *texture);
+                entryPaths.push_back(cache.directory() + key.entryName());
+            }
+
+            const auto entrySize = Disk::fileSize(entryPaths.front());
+            const auto countEntries = [&]() {
+                size_t count = 0u;
+                for (const auto& path : entryPaths) {
+                    if (Disk::fileExists(path)) {
+                        ++count;
+                    }
+                }
+                return count;
+            };
+
+            cache.prune(3u * entrySize);
+            ASSERT_EQ(3u, countEntries());
+
+            cache.prune(2u * entrySize + entrySize / 2u);
+            ASSERT_EQ(2u, countEntries());
+
+            cache.prune(0u);
+            ASSERT_EQ(0u, countEntries());
+        }
+    }
+}
@@ -240,5 +240,48 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST(TokenizerTest, simpleLanguageBlockWithSignedAndExponentAttributes) {
+            const std::string testString("{"
+                                    "    a = +17;"
+                                    "    b = +1.5e2;"
+                                    "    c = -2e-3;"
+                                    "}");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            ASSERT_EQ(SimpleToken::OBrace, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ("a", token.view());
+            ASSERT_EQ(SimpleToken::Equals, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(17, token.toInteger<int>());
+            ASSERT_DOUBLE_EQ(17.0, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Semicolon, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Equals, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Decimal, (token = tokenizer.nextToken()).type());
+            ASSERT_DOUBLE_EQ(150.0, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Semicolon, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Equals, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Decimal, (token = tokenizer.nextToken()).type());
+            ASSERT_DOUBLE_EQ(-0.002, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Semicolon, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
+        }
+
+        TEST(TokenizerTest, unparsableNumbersAreZero) {
+            const std::string testString("abc 99999999999999999999");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(0, token.toInteger<int>());
+            ASSERT_DOUBLE_EQ(0.0, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(0, token.toInteger<int>());
+        }
     }
 }
@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            class Countdown {
+            private:
+                std::mutex m_mutex;
+                std::condition_variable m_done;
+                size_t m_count;
+            public:
+                explicit Countdown(const size_t count) :
+                m_count(count) {}
+
+                void countDown() {
+                    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                    --m_count;
+                    m_done.notify_all();
+                }
+
+                void wait() {
+                    auto lock = std::unique_lock<std::mutex>(m_mutex);
+                    m_done.wait(lock, [&]() { return m_count == 0u; });
+                }
+            };
+        }
+
+        TEST(WorkerPoolTest, runPostedTasks) {
+            WorkerPool pool(4u);
+            ASSERT_EQ(4u, pool.threadCount());
+
+            static constexpr size_t NumTasks = 1000u;
+            std::atomic<size_t> sum(0u);
+            Countdown countdown(NumTasks);
+            for (size_t i = 0u; i < NumTasks; ++i) {
+                pool.post(&pool, [&, i]() {
+                    sum += i;
+                    countdown.countDown();
+                });
+            }
+
+            countdown.wait();
+            ASSERT_EQ(NumTasks * (NumTasks - 1u) / 2u, sum);
+        }
+
+        TEST(WorkerPoolTest, cancelDiscardsPendingTasksAndWaitsForRunningTasks) {
+            WorkerPool pool(1u);
+
+            const int owner = 0;
+            const int otherOwner = 1;
+
+            std::atomic<bool> started(false);
+            std::atomic<bool> finished(false);
+            std::atomic<size_t> count(0u);
+
+            pool.post(&owner, [&]() {
+                started = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                finished = true;
+            });
+            for (size_t i = 0u; i < 10u; ++i) {
+                pool.post(&owner, [&]() { ++count; });
+            }
+
+            Countdown countdown(1u);
+            pool.post(&otherOwner, [&]() { countdown.countDown(); });
+
+            while (!started) {
+                std::this_thread::yield();
+            }
+
+            pool.cancel(&owner);
+            ASSERT_TRUE(finished);
+
+            // the tasks of other owners still run
+            countdown.wait();
+            ASSERT_EQ(0u, count);
+        }
+    }
+}
@@ -22,11 +22,16 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
 #include "IO/ZipFileSystem.h"
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -140,5 +145,45 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        static std::string readContents(const File& file) {
+            auto reader = file.reader();
+            return reader.readString(reader.size());
+        }
+
+        TEST(ZipFileSystemTest, openFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            const auto paths = fs.findItemsRecursively(Path(""), FileExtensionMatcher({ "cfg", "pcx", "wal" }));
+            ASSERT_EQ(11u, paths.size());
+
+            auto pathsWithMissingFile = paths;
+            pathsWithMissingFile.insert(std::next(std::begin(pathsWithMissingFile)), Path("textures/missing.wal"));
+
+            auto errors = std::vector<std::string>();
+            const auto files = fs.openFiles(pathsWithMissingFile, errors);
+            ASSERT_EQ(pathsWithMissingFile.size(), files.size());
+            ASSERT_EQ(1u, errors.size());
+            ASSERT_EQ(nullptr, files[1]);
+
+            for (size_t i = 0; i < pathsWithMissingFile.size(); ++i) {
+                if (i != 1) {
+                    ASSERT_NE(nullptr, files[i]);
+                    ASSERT_EQ(pathsWithMissingFile[i], files[i]->path());
+
+                    const ZipFileSystem otherFS(zipPath);
+                    ASSERT_EQ(readContents(*otherFS.openFile(pathsWithMissingFile[i])), readContents(*files[i]));
+                }
+            }
+        }
+
+        TEST(ZipFileSystemTest, openCachedFile) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            const auto file = fs.openFile(Path("amnet.cfg"));
+            ASSERT_EQ(file, fs.openFile(Path("AMNET.cfg")));
+        }
     }
 }
@@ -33,6 +33,7 @@
 #include "Model/BrushSnapshot.h"
 #include "Model/Hit.h"
 #include "Model/MapFormat.h"
+#include "Model/NodeSnapshot.h"
 #include "Model/PickResult.h"
 #include "Model/World.h"
 
@@ -40,6 +41,8 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/vec.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
@@ -48,7 +51,9 @@
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -3429,6 +3434,128 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        TEST(BrushTest, compactSnapshotOfAttributeChange) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            BrushFace* topFace = cube->findFace(vm::vec3::pos_z());
+            ASSERT_NE(nullptr, topFace);
+
+            const auto snapshot = std::unique_ptr<NodeSnapshot>(cube->takeSnapshot());
+            const auto fullSize = snapshot->sizeInBytes();
+
+            auto attribs = topFace->attribs();
+            attribs.setXOffset(attribs.xOffset() + 1.0f);
+            topFace->setAttribs(attribs);
+
+            // only the changed face is kept, and it is restored in place
+            snapshot->compact();
+            ASSERT_TRUE(snapshot->relative());
+            ASSERT_LT(snapshot->sizeInBytes(), fullSize);
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(topFace, cube->findFace(vm::vec3::pos_z()));
+            for (const BrushFace* face : cube->faces()) {
+                EXPECT_EQ("texture", face->textureName());
+                EXPECT_FLOAT_EQ(0.0f, face->attribs().xOffset());
+            }
+
+            delete cube;
+        }
+
+        TEST(BrushTest, compactSnapshotAfterTransform) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            const auto bounds = cube->logicalBounds();
+
+            std::vector<std::pair<vm::vec3, vm::vec3>> xAxes;
+            for (const BrushFace* face : cube->faces()) {
+                xAxes.emplace_back(face->boundary().normal, face->textureXAxis());
+            }
+
+            const auto snapshot = std::unique_ptr<NodeSnapshot>(cube->takeSnapshot());
+            cube->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)) * vm::rotation_matrix(0.0, 0.0, vm::to_radians(15.0)), true, worldBounds);
+
+            // the planes have changed, so the snapshot must keep all faces
+            snapshot->compact();
+            ASSERT_FALSE(snapshot->relative());
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(bounds, cube->logicalBounds());
+
+            ASSERT_EQ(xAxes.size(), cube->faces().size());
+            for (const BrushFace* face : cube->faces()) {
+                const auto it = std::find_if(std::begin(xAxes), std::end(xAxes), [&](const auto& pair) { return pair.first == face->boundary().normal; });
+                ASSERT_NE(std::end(xAxes), it);
+                EXPECT_EQ(it->second, face->textureXAxis());
+            }
+
+            delete cube;
+        }
+
+        TEST(BrushTest, spillAndUnspillSnapshot) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            const auto bounds = cube->logicalBounds();
+
+            BrushFace* topFace = cube->findFace(vm::vec3::pos_z());
+            ASSERT_NE(nullptr, topFace);
+            auto topAttribs = topFace->attribs();
+            topAttribs.setOffset(vm::vec2f(3.0f, 5.0f));
+            topAttribs.setScale(vm::vec2f(0.5f, 2.0f));
+            topAttribs.setRotation(30.0f);
+            topAttribs.setSurfaceContents(4);
+            topAttribs.setSurfaceFlags(8);
+            topAttribs.setSurfaceValue(1.5f);
+            topFace->setAttribs(topAttribs);
+
+            std::vector<std::pair<vm::vec3, vm::vec3>> xAxes;
+            for (const BrushFace* face : cube->faces()) {
+                xAxes.emplace_back(face->boundary().normal, face->textureXAxis());
+            }
+
+            const auto snapshot = std::unique_ptr<NodeSnapshot>(cube->takeSnapshot());
+            const auto size = snapshot->sizeInBytes();
+
+            std::stringstream stream;
+            snapshot->spill(stream);
+            ASSERT_LT(snapshot->sizeInBytes(), size);
+
+            cube->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)) * vm::rotation_matrix(0.0, 0.0, vm::to_radians(15.0)), true, worldBounds);
+
+            snapshot->unspill(stream);
+            ASSERT_EQ(size, snapshot->sizeInBytes());
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(bounds, cube->logicalBounds());
+
+            topFace = cube->findFace(vm::vec3::pos_z());
+            ASSERT_NE(nullptr, topFace);
+            EXPECT_EQ("texture", topFace->attribs().textureName());
+            EXPECT_EQ(vm::vec2f(3.0f, 5.0f), topFace->attribs().offset());
+            EXPECT_EQ(vm::vec2f(0.5f, 2.0f), topFace->attribs().scale());
+            EXPECT_EQ(30.0f, topFace->attribs().rotation());
+            EXPECT_EQ(4, topFace->attribs().surfaceContents());
+            EXPECT_EQ(8, topFace->attribs().surfaceFlags());
+            EXPECT_EQ(1.5f, topFace->attribs().surfaceValue());
+
+            for (const BrushFace* face : cube->faces()) {
+                const auto it = std::find_if(std::begin(xAxes), std::end(xAxes), [&](const auto& pair) { return pair.first == face->boundary().normal; });
+                ASSERT_NE(std::end(xAxes), it);
+                EXPECT_EQ(it->second, face->textureXAxis());
+            }
+
+            delete cube;
+        }
+
         TEST(BrushTest, resizePastWorldBounds) {
             const vm::bbox3 worldBounds(8192.0);
             World world(MapFormat::Standard);
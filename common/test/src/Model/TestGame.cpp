@@ -75,7 +75,7 @@ namespace TrenchBroom {
             return std::make_unique<World>(format);
         }
 
-        std::unique_ptr<World> TestGame::doLoadMap(const MapFormat format, const vm::bbox3& /* worldBounds */, const IO::Path& /* path */, Logger& /* logger */) const {
+        std::unique_ptr<World> TestGame::doLoadMap(const MapFormat format, const vm::bbox3& /* worldBounds */, const IO::Path& /* path */, const bool /* useCache */, IO::ParserStatus& /* status */) const {
             return std::make_unique<World>(format);
         }
 
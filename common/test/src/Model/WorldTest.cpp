@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectMatchingIssuesVisitor.h"
+#include "Model/Issue.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        struct AllIssues {
+            bool operator()(const Issue*) const {
+                return true;
+            }
+        };
+
+        static std::vector<Issue*> collectIssues(World& world) {
+            CollectMatchingIssuesVisitor<AllIssues> visitor(world.registeredIssueGenerators());
+            world.acceptAndRecurse(visitor);
+            return visitor.issues();
+        }
+
+        TEST(WorldTest, validateInvalidIssuesInSteps) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            World world(MapFormat::Standard);
+            world.registerIssueGenerator(new WorldBoundsIssueGenerator(vm::bbox3(16.0)));
+
+            BrushBuilder builder(&world, worldBounds);
+            for (size_t i = 0; i < 3u; ++i) {
+                world.defaultLayer()->addChild(builder.createCube(8.0, "texture"));
+                world.defaultLayer()->addChild(builder.createCube(64.0, "texture"));
+            }
+
+            // the world, the default layer and six brushes need to be validated
+            ASSERT_TRUE(world.hasInvalidIssues());
+            ASSERT_TRUE(collectIssues(world).empty());
+            ASSERT_EQ(3u, world.validateInvalidIssues(3u).size());
+            ASSERT_EQ(3u, world.validateInvalidIssues(3u).size());
+            ASSERT_TRUE(world.hasInvalidIssues());
+            ASSERT_EQ(2u, world.validateInvalidIssues(3u).size());
+            ASSERT_FALSE(world.hasInvalidIssues());
+            ASSERT_EQ(3u, collectIssues(world).size());
+
+            ASSERT_TRUE(world.validateInvalidIssues(3u).empty());
+            ASSERT_EQ(3u, collectIssues(world).size());
+
+            // registering a generator invalidates the issues of all nodes
+            world.unregisterAllIssueGenerators();
+            world.registerIssueGenerator(new WorldBoundsIssueGenerator(vm::bbox3(16.0)));
+            ASSERT_TRUE(world.hasInvalidIssues());
+            ASSERT_TRUE(collectIssues(world).empty());
+            ASSERT_EQ(8u, world.validateInvalidIssues(8u).size());
+            ASSERT_FALSE(world.hasInvalidIssues());
+            ASSERT_EQ(3u, collectIssues(world).size());
+        }
+
+        TEST(WorldTest, validateOnlyNodesWithInvalidIssues) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            World world(MapFormat::Standard);
+            world.registerIssueGenerator(new WorldBoundsIssueGenerator(vm::bbox3(16.0)));
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCube(8.0, "texture");
+            Brush* brush2 = builder.createCube(64.0, "texture");
+            world.defaultLayer()->addChild(brush1);
+            world.defaultLayer()->addChild(brush2);
+
+            ASSERT_EQ(4u, world.validateInvalidIssues(8u).size());
+            ASSERT_FALSE(world.hasInvalidIssues());
+
+            // removing a brush invalidates the issues of its former ancestors, but the brush is not validated anymore
+            world.defaultLayer()->removeChild(brush2);
+            auto expected = std::vector<Node*>{ world.defaultLayer(), &world };
+            auto validated = world.validateInvalidIssues(8u);
+            kdl::vec_sort(expected);
+            kdl::vec_sort(validated);
+            ASSERT_EQ(expected, validated);
+            ASSERT_EQ(0u, collectIssues(world).size());
+
+            // adding it again validates it along with its new ancestors
+            world.defaultLayer()->addChild(brush2);
+            validated = world.validateInvalidIssues(8u);
+            ASSERT_EQ(3u, validated.size());
+            ASSERT_TRUE(kdl::vec_contains(validated, brush2));
+            ASSERT_EQ(1u, collectIssues(world).size());
+        }
+    }
+}
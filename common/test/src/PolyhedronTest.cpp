@@ -23,6 +23,7 @@
 #include "TrenchBroom.h"
 #include "Polyhedron.h"
 #include "Polyhedron_BrushGeometryPayload.h"
+#include "Polyhedron_ClipKernel.h"
 #include "Polyhedron_DefaultPayload.h"
 #include "Polyhedron_Instantiation.h"
 #include "TestUtils.h"
@@ -2156,6 +2157,43 @@ TEST(PolyhedronTest, intersection_edge_polygon_different_plane) {
                         Polyhedron3d { vm::vec3d(0.0, 0.0, 0.0), vm::vec3d(2.0, 0.0, 0.0), vm::vec3d(2.0, 2.0, 0.0), vm::vec3d(0.0, 2.0, 0.0) } );
 }
 
+TEST(PolyhedronTest, countPlaneStatus) {
+    const auto plane = vm::plane3d(8.0, vm::normalize(vm::vec3d(1.0, 2.0, 3.0)));
+
+    // make sure that some points are exactly inside the plane and that the scalar tail is exercised, too
+    std::vector<double> x, y, z;
+    for (int i = 0; i < 67; ++i) {
+        const auto d = static_cast<double>(i);
+        auto point = vm::vec3d(d - 33.0, static_cast<double>((i * 7) % 13 - 6), static_cast<double>((i * 5) % 11 - 5));
+        if (i % 3 == 0) {
+            point = point - plane.point_distance(point) * plane.normal;
+        }
+        x.push_back(point.x());
+        y.push_back(point.y());
+        z.push_back(point.z());
+    }
+
+    for (size_t count = 0u; count <= x.size(); ++count) {
+        Polyhedron_PlaneStatusCount expected;
+        for (size_t i = 0u; i < count; ++i) {
+            const auto status = plane.point_status(vm::vec3d(x[i], y[i], z[i]));
+            if (status == vm::plane_status::above) {
+                ++expected.above;
+            } else if (status == vm::plane_status::below) {
+                ++expected.below;
+            } else {
+                ++expected.inside;
+            }
+        }
+
+        Polyhedron_PlaneStatusCount actual;
+        polyhedron_countPlaneStatus(plane, x.data(), y.data(), z.data(), count, actual);
+        ASSERT_EQ(expected.above, actual.above);
+        ASSERT_EQ(expected.below, actual.below);
+        ASSERT_EQ(expected.inside, actual.inside);
+    }
+}
+
 TEST(PolyhedronTest, intersection_edge_polyhedron) {
     const Polyhedron3d tetrahedron {
         vm::vec3d(-1.0, -1.0, 0.0),
@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/ViewFrustum.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static vm::bbox3f boxAt(const vm::vec3f& center) {
+            return vm::bbox3f(center - vm::vec3f::fill(8.0f), center + vm::vec3f::fill(8.0f));
+        }
+
+        TEST(ViewFrustumTest, perspectiveCamera) {
+            PerspectiveCamera c;
+            c.setDirection(vm::vec3f::pos_x(), vm::vec3f::pos_z());
+
+            const auto frustum = ViewFrustum(c);
+
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 0.0f))));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, 0.0f))));
+            ASSERT_TRUE(frustum.contains(vm::vec3f(100.0f, 10.0f, -10.0f)));
+
+            // behind the camera
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(-100.0f, 0.0f, 0.0f))));
+            ASSERT_FALSE(frustum.contains(vm::vec3f(-100.0f, 0.0f, 0.0f)));
+
+            // outside of the side planes
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 1000.0f, 0.0f))));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, -1000.0f, 0.0f))));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 1000.0f))));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, -1000.0f))));
+
+            // beyond the far plane
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(c.farPlane() + 100.0f, 0.0f, 0.0f))));
+
+            // a large box which contains the entire frustum
+            ASSERT_TRUE(frustum.intersects(vm::bbox3f(16384.0f)));
+        }
+
+        TEST(ViewFrustumTest, orthographicCamera) {
+            OrthographicCamera c;
+            c.setDirection(vm::vec3f::neg_z(), vm::vec3f::pos_y());
+
+            const auto frustum = ViewFrustum(c);
+            const auto w2 = static_cast<float>(c.viewport().width) / 2.0f;
+            const auto h2 = static_cast<float>(c.viewport().height) / 2.0f;
+
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, -100.0f))));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(w2, h2, -100.0f))));
+
+            // orthographic views see everything along the view direction
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, 100000.0f))));
+
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(w2 + 16.0f, 0.0f, 0.0f))));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(0.0f, -h2 - 16.0f, 0.0f))));
+        }
+    }
+}
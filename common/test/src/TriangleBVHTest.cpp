@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "TriangleBVH.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/ray.h>
+#include <vecmath/intersection.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using BVH = TriangleBVH<float>;
+using VEC = BVH::Vec;
+using RAY = BVH::Ray;
+
+static float findNearestIntersectionBruteForce(const RAY& ray, const std::vector<VEC>& vertices) {
+    auto closestDistance = vm::nan<float>();
+    for (size_t i = 0; i < vertices.size(); i += 3u) {
+        closestDistance = vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, vertices[i], vertices[i + 1u], vertices[i + 2u]));
+    }
+    return closestDistance;
+}
+
+static std::vector<std::array<VEC, 3>> sortedTriangles(const std::vector<VEC>& vertices) {
+    std::vector<std::array<VEC, 3>> result;
+    for (size_t i = 0; i < vertices.size(); i += 3u) {
+        result.push_back({ vertices[i], vertices[i + 1u], vertices[i + 2u] });
+    }
+    std::sort(std::begin(result), std::end(result), [](const auto& lhs, const auto& rhs) {
+        for (size_t i = 0; i < 3u; ++i) {
+            for (size_t j = 0; j < 3u; ++j) {
+                if (lhs[i][j] != rhs[i][j]) {
+                    return lhs[i][j] < rhs[i][j];
+                }
+            }
+        }
+        return false;
+    });
+    return result;
+}
+
+TEST(TriangleBVHTest, buildEmptyTree) {
+    std::vector<VEC> vertices;
+
+    BVH bvh;
+    bvh.clearAndBuild(vertices);
+
+    ASSERT_TRUE(bvh.empty());
+    ASSERT_EQ(0u, bvh.nodeCount());
+    ASSERT_TRUE(vm::is_nan(bvh.findNearestIntersection(RAY(VEC(0, 0, 0), VEC(1, 0, 0)), vertices)));
+}
+
+TEST(TriangleBVHTest, intersectSingleTriangle) {
+    std::vector<VEC> vertices = {
+        VEC(4, -1, -1), VEC(4, 1, -1), VEC(4, 0, 1)
+    };
+
+    BVH bvh;
+    bvh.clearAndBuild(vertices);
+
+    ASSERT_FALSE(bvh.empty());
+    ASSERT_EQ(1u, bvh.nodeCount());
+    ASSERT_FLOAT_EQ(4.0f, bvh.findNearestIntersection(RAY(VEC(0, 0, 0), VEC(1, 0, 0)), vertices));
+    ASSERT_TRUE(vm::is_nan(bvh.findNearestIntersection(RAY(VEC(0, 0, 0), VEC(-1, 0, 0)), vertices)));
+    ASSERT_TRUE(vm::is_nan(bvh.findNearestIntersection(RAY(VEC(0, 4, 0), VEC(1, 0, 0)), vertices)));
+}
+
+TEST(TriangleBVHTest, intersectStackedTriangles) {
+    // all triangles have the same center, so the tree must be split by count
+    std::vector<VEC> vertices;
+    for (size_t i = 0; i < 32u; ++i) {
+        const auto size = static_cast<float>(i + 1u);
+        vertices.push_back(VEC(0, -size, -size));
+        vertices.push_back(VEC(0, size, -size));
+        vertices.push_back(VEC(0, 0, size));
+    }
+
+    BVH bvh;
+    bvh.clearAndBuild(vertices);
+
+    ASSERT_EQ(32u * 3u, vertices.size());
+    ASSERT_FLOAT_EQ(8.0f, bvh.findNearestIntersection(RAY(VEC(-8, 0, 0), VEC(1, 0, 0)), vertices));
+    ASSERT_FLOAT_EQ(8.0f, bvh.findNearestIntersection(RAY(VEC(-8, 20, -20), VEC(1, 0, 0)), vertices));
+    ASSERT_TRUE(vm::is_nan(bvh.findNearestIntersection(RAY(VEC(-8, 40, 0), VEC(1, 0, 0)), vertices)));
+}
+
+TEST(TriangleBVHTest, findNearestIntersectionMatchesBruteForce) {
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> position(-64.0f, 64.0f);
+    std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+
+    std::vector<VEC> vertices;
+    for (size_t i = 0; i < 2000u; ++i) {
+        const auto center = VEC(position(random), position(random), position(random));
+        for (size_t j = 0; j < 3u; ++j) {
+            vertices.push_back(center + VEC(offset(random), offset(random), offset(random)));
+        }
+    }
+
+    const auto originalTriangles = sortedTriangles(vertices);
+
+    BVH bvh;
+    bvh.clearAndBuild(vertices);
+
+    // building the tree only reorders the triangles
+    ASSERT_EQ(originalTriangles, sortedTriangles(vertices));
+    ASSERT_LT(bvh.nodeCount(), 2u * vertices.size() / 3u);
+
+    size_t hits = 0u;
+    for (size_t i = 0; i < 500u; ++i) {
+        const auto origin = VEC(position(random), position(random), position(random)) * 2.0f;
+        const auto target = VEC(position(random), position(random), position(random)) / 2.0f;
+        const auto ray = RAY(origin, vm::normalize(target - origin));
+
+        const auto expected = findNearestIntersectionBruteForce(ray, vertices);
+        const auto actual = bvh.findNearestIntersection(ray, vertices);
+        if (vm::is_nan(expected)) {
+            ASSERT_TRUE(vm::is_nan(actual));
+        } else {
+            ASSERT_FLOAT_EQ(expected, actual);
+            ++hits;
+        }
+    }
+
+    // make sure that the test is meaningful
+    ASSERT_GT(hits, 0u);
+}
@@ -30,6 +30,9 @@
 #include "View/MapDocumentTest.h"
 #include "View/MapDocument.h"
 
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace View {
         class ChangeBrushFaceAttributesTest : public MapDocumentTest {
@@ -70,5 +73,83 @@ namespace TrenchBroom {
             ASSERT_VEC_EQ(initialX, face->textureXAxis());
             ASSERT_VEC_EQ(initialY, face->textureYAxis());
         }
+
+        TEST_F(ChangeBrushFaceAttributesTest, undoMemoryOfOffsetNudges) {
+            Model::Brush* brush = createBrush();
+            document->addNode(brush, document->currentParent());
+
+            const std::vector<Model::BrushFace*> faces = brush->faces();
+            document->select(faces);
+
+            std::vector<std::pair<vm::vec3, vm::vec3>> initialAxes;
+            for (const Model::BrushFace* face : faces) {
+                initialAxes.emplace_back(face->textureXAxis(), face->textureYAxis());
+            }
+
+            const size_t initialUsage = document->undoMemoryUsage();
+
+            static constexpr size_t NumNudges = 2000;
+            Model::ChangeBrushFaceAttributesRequest nudge;
+            nudge.addXOffset(1.0f);
+            for (size_t i = 0; i < NumNudges; ++i) {
+                // commit every nudge separately so that they are not collated
+                document->startTransaction("Nudge");
+                document->setFaceAttributes(nudge);
+                document->commitTransaction();
+            }
+
+            for (const Model::BrushFace* face : faces) {
+                ASSERT_FLOAT_EQ(static_cast<float>(NumNudges), face->xOffset());
+            }
+
+            // every nudge only records the offsets of the faces, which takes less than 96 bytes per face, plus the
+            // fixed overhead of its snapshot; the texture names and the texture axes are not recorded
+            const size_t usage = document->undoMemoryUsage() - initialUsage;
+            ASSERT_LT(usage / NumNudges, 256u + 96u * faces.size());
+
+            for (size_t i = 0; i < NumNudges; ++i) {
+                document->undoCommand();
+            }
+
+            for (size_t i = 0; i < faces.size(); ++i) {
+                const Model::BrushFace* face = faces[i];
+                EXPECT_EQ("texture", face->textureName());
+                EXPECT_FLOAT_EQ(0.0f, face->xOffset());
+                EXPECT_VEC_EQ(initialAxes[i].first, face->textureXAxis());
+                EXPECT_VEC_EQ(initialAxes[i].second, face->textureYAxis());
+            }
+        }
+
+        TEST_F(ChangeBrushFaceAttributesTest, undoCollatedChanges) {
+            Model::Brush* brush = createBrush();
+            document->addNode(brush, document->currentParent());
+
+            Model::BrushFace* face = brush->faces().front();
+            const vm::vec3 initialX = face->textureXAxis();
+            const vm::vec3 initialY = face->textureYAxis();
+
+            document->select(face);
+
+            Model::ChangeBrushFaceAttributesRequest offset;
+            offset.addXOffset(8.0f);
+            Model::ChangeBrushFaceAttributesRequest rotate;
+            rotate.addRotation(15.0f);
+
+            // the rotation is collated into the offset change, whose snapshot did not record the rotation
+            document->startTransaction("Change Attributes");
+            document->setFaceAttributes(offset);
+            document->setFaceAttributes(rotate);
+            document->commitTransaction();
+
+            ASSERT_FLOAT_EQ(8.0f, face->xOffset());
+            ASSERT_FLOAT_EQ(15.0f, face->rotation());
+
+            document->undoCommand();
+
+            ASSERT_FLOAT_EQ(0.0f, face->xOffset());
+            ASSERT_FLOAT_EQ(0.0f, face->rotation());
+            ASSERT_VEC_EQ(initialX, face->textureXAxis());
+            ASSERT_VEC_EQ(initialY, face->textureYAxis());
+        }
     }
 }
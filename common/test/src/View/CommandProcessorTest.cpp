@@ -25,7 +25,10 @@
 #include "View/CommandProcessor.h"
 
 #include <chrono>
+#include <istream>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <thread>
 
 namespace TrenchBroom {
@@ -150,6 +153,58 @@ namespace TrenchBroom {
 
         const Command::CommandType TestCommand::Type = Command::freeType();
 
+        /**
+         * A command that holds on to a payload in order to be undone. Undoing it only succeeds if the payload is
+         * present.
+         */
+        class PayloadCommand : public UndoableCommand {
+        private:
+            std::string m_payload;
+            const std::string m_expectedPayload;
+        public:
+            static const CommandType Type;
+
+            PayloadCommand(const std::string& name, const std::string& payload) :
+            UndoableCommand(Type, name),
+            m_payload(payload),
+            m_expectedPayload(payload) {}
+        private:
+            std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade*) override {
+                return std::make_unique<CommandResult>(true);
+            }
+
+            std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade*) override {
+                return std::make_unique<CommandResult>(m_payload == m_expectedPayload);
+            }
+
+            bool doIsRepeatable(MapDocumentCommandFacade*) const override {
+                return false;
+            }
+
+            bool doCollateWith(UndoableCommand*) override {
+                return false;
+            }
+
+            size_t doGetSizeInBytes() const override {
+                return m_payload.size();
+            }
+
+            void doSpill(std::ostream& stream) override {
+                stream << m_payload.size() << ' ' << m_payload;
+                std::string().swap(m_payload);
+            }
+
+            void doUnspill(std::istream& stream) override {
+                size_t size;
+                stream >> size;
+                stream.ignore(1);
+                m_payload = std::string(size, '\0');
+                stream.read(m_payload.data(), static_cast<std::streamsize>(size));
+            }
+        };
+
+        const Command::CommandType PayloadCommand::Type = Command::freeType();
+
         TEST(CommandProcessorTest, doAndUndoSuccessfulCommand) {
             /*
              * Execute a successful command, then undo it successfully.
@@ -606,5 +661,72 @@ namespace TrenchBroom {
             ASSERT_EQ(commandName1, commandProcessor.undoCommandName());
             ASSERT_EQ(commandName2, commandProcessor.redoCommandName());
         }
+
+        TEST(CommandProcessorTest, discardOldestCommandsWhenOverMemoryBudget) {
+            CommandProcessor commandProcessor(nullptr);
+            commandProcessor.setUndoMemoryBudget(250u, false);
+
+            for (size_t i = 0; i < 5; ++i) {
+                commandProcessor.executeAndStore(std::make_unique<PayloadCommand>("command " + std::to_string(i), std::string(100u, 'a')));
+            }
+
+            ASSERT_EQ(200u, commandProcessor.undoMemoryUsage());
+
+            ASSERT_EQ("command 4", commandProcessor.undoCommandName());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_EQ("command 3", commandProcessor.undoCommandName());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+            ASSERT_EQ(0u, commandProcessor.undoMemoryUsage());
+        }
+
+        TEST(CommandProcessorTest, spillOldestCommandsWhenOverMemoryBudget) {
+            CommandProcessor commandProcessor(nullptr);
+            commandProcessor.setUndoMemoryBudget(250u, true);
+
+            for (size_t i = 0; i < 5; ++i) {
+                commandProcessor.executeAndStore(std::make_unique<PayloadCommand>("command " + std::to_string(i), std::string(100u, static_cast<char>('a' + i))));
+            }
+
+            // only the two most recent commands fit into the budget
+            ASSERT_EQ(200u, commandProcessor.undoMemoryUsage());
+
+            for (size_t i = 0; i < 5; ++i) {
+                ASSERT_EQ("command " + std::to_string(4u - i), commandProcessor.undoCommandName());
+                ASSERT_TRUE(commandProcessor.undo()->success());
+            }
+            ASSERT_FALSE(commandProcessor.canUndo());
+
+            // redoing the commands spills them again
+            for (size_t i = 0; i < 5; ++i) {
+                ASSERT_TRUE(commandProcessor.redo()->success());
+            }
+            ASSERT_EQ(200u, commandProcessor.undoMemoryUsage());
+
+            for (size_t i = 0; i < 5; ++i) {
+                ASSERT_TRUE(commandProcessor.undo()->success());
+            }
+            ASSERT_FALSE(commandProcessor.canUndo());
+        }
+
+        TEST(CommandProcessorTest, spillTransactionsWhenOverMemoryBudget) {
+            CommandProcessor commandProcessor(nullptr);
+            commandProcessor.setUndoMemoryBudget(150u, true);
+
+            for (size_t i = 0; i < 3; ++i) {
+                commandProcessor.startTransaction("transaction " + std::to_string(i));
+                commandProcessor.executeAndStore(std::make_unique<PayloadCommand>("first", std::string(50u, 'a')));
+                commandProcessor.executeAndStore(std::make_unique<PayloadCommand>("second", std::string(50u, 'b')));
+                commandProcessor.commitTransaction();
+            }
+
+            ASSERT_EQ(100u, commandProcessor.undoMemoryUsage());
+
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_EQ("transaction " + std::to_string(2u - i), commandProcessor.undoCommandName());
+                ASSERT_TRUE(commandProcessor.undo()->success());
+            }
+            ASSERT_FALSE(commandProcessor.canUndo());
+        }
     }
 }
@@ -23,6 +23,9 @@
 #include "Polyhedron.h"
 #include "TestUtils.h"
 #include "Assets/EntityDefinition.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
 #include "Model/Group.h"
@@ -44,6 +47,9 @@
 #include <vecmath/scalar.h>
 #include <vecmath/ray.h>
 
+#include <atomic>
+#include <thread>
+
 namespace TrenchBroom {
     namespace View {
         MapDocumentTest::MapDocumentTest() :
@@ -466,6 +472,117 @@ namespace TrenchBroom {
             EXPECT_EQ(expectedBBox2, remainder2->logicalBounds());
         }
 
+        TEST_F(MapDocumentTest, csgSubtractMultipleMinuendsKeepsOrder) {
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* entity = new Model::Entity();
+            document->addNode(entity, document->currentParent());
+
+            std::vector<Model::Node*> minuends;
+            for (size_t i = 0; i < 8; ++i) {
+                const auto x = static_cast<FloatType>(i * 128);
+                minuends.push_back(builder.createCuboid(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 64, 64)), "texture"));
+            }
+            document->addNodes(minuends, entity);
+
+            Model::Brush* subtrahend = builder.createCuboid(vm::bbox3(vm::vec3(0, 32, 0), vm::vec3(1024, 64, 64)), "texture");
+            document->addNode(subtrahend, document->currentParent());
+
+            document->select(subtrahend);
+            ASSERT_TRUE(document->csgSubtract());
+            ASSERT_EQ(8u, entity->children().size());
+
+            for (size_t i = 0; i < 8; ++i) {
+                const auto x = static_cast<FloatType>(i * 128);
+                EXPECT_EQ(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 32, 64)), entity->children()[i]->logicalBounds());
+            }
+        }
+
+        class CsgTextureUsageTest : public MapDocumentTest {
+        protected:
+            Assets::Texture* m_texture;
+            std::thread::id m_mainThread;
+            std::atomic<bool> m_notifiedOnOtherThread;
+
+            void SetUp() override {
+                MapDocumentTest::SetUp();
+
+                m_texture = new Assets::Texture("texture", 64, 64);
+                m_mainThread = std::this_thread::get_id();
+                m_notifiedOnOtherThread = false;
+
+                auto& textureManager = document->textureManager();
+                textureManager.setTextureCollections(std::vector<Assets::TextureCollection*>{ new Assets::TextureCollection(std::vector<Assets::Texture*>{ m_texture }) });
+                textureManager.usageCountDidChange.addObserver(this, &CsgTextureUsageTest::usageCountDidChange);
+            }
+
+            void TearDown() override {
+                document->textureManager().usageCountDidChange.removeObserver(this, &CsgTextureUsageTest::usageCountDidChange);
+                MapDocumentTest::TearDown();
+            }
+
+            void usageCountDidChange() {
+                if (std::this_thread::get_id() != m_mainThread) {
+                    m_notifiedOnOtherThread = true;
+                }
+            }
+
+            void assertAllFacesTextured(const std::vector<Model::Node*>& nodes) {
+                for (const auto* node : nodes) {
+                    const auto* brush = static_cast<const Model::Brush*>(node);
+                    for (const auto* face : brush->faces()) {
+                        ASSERT_EQ(m_texture, face->texture());
+                    }
+                }
+            }
+        };
+
+        TEST_F(CsgTextureUsageTest, csgSubtractUpdatesTextureUsageOnMainThread) {
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* entity = new Model::Entity();
+            document->addNode(entity, document->currentParent());
+
+            std::vector<Model::Node*> minuends;
+            for (size_t i = 0; i < 8; ++i) {
+                const auto x = static_cast<FloatType>(i * 128);
+                minuends.push_back(builder.createCuboid(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 64, 64)), "texture"));
+            }
+            document->addNodes(minuends, entity);
+            assertAllFacesTextured(minuends);
+
+            Model::Brush* subtrahend = builder.createCuboid(vm::bbox3(vm::vec3(0, 32, 0), vm::vec3(1024, 64, 64)), "texture");
+            document->addNode(subtrahend, document->currentParent());
+
+            document->select(subtrahend);
+            ASSERT_TRUE(document->csgSubtract());
+            ASSERT_EQ(8u, entity->children().size());
+            assertAllFacesTextured(entity->children());
+
+            ASSERT_FALSE(m_notifiedOnOtherThread);
+        }
+
+        TEST_F(CsgTextureUsageTest, csgHollowUpdatesTextureUsageOnMainThread) {
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* entity = new Model::Entity();
+            document->addNode(entity, document->currentParent());
+
+            std::vector<Model::Node*> brushes;
+            for (size_t i = 0; i < 8; ++i) {
+                const auto x = static_cast<FloatType>(i * 128);
+                brushes.push_back(builder.createCuboid(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 64, 64)), "texture"));
+            }
+            document->addNodes(brushes, entity);
+
+            document->select(brushes);
+            ASSERT_TRUE(document->csgHollow());
+            ASSERT_LT(8u, entity->children().size());
+            assertAllFacesTextured(entity->children());
+
+            ASSERT_FALSE(m_notifiedOnOtherThread);
+        }
+
         TEST_F(MapDocumentTest, csgSubtractAndUndoRestoresSelection) {
             const Model::BrushBuilder builder(document->world(), document->worldBounds());
 
@@ -28,6 +28,8 @@
 #include "View/MapDocumentTest.h"
 #include "View/MapDocument.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace View {
         class SelectionTest : public MapDocumentTest {};
@@ -91,5 +93,47 @@ namespace TrenchBroom {
 
             ASSERT_EQ(1u, document->selectedNodes().nodeCount());
         }
+
+        TEST_F(SelectionTest, selectTouchingIgnoresDistantBrushes) {
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            Model::Brush* queryBrush = builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture");
+            Model::Brush* touchingBrush = builder.createCuboid(vm::bbox3(vm::vec3(32, 32, 32), vm::vec3(96, 96, 96)), "texture");
+            Model::Brush* distantBrush = builder.createCuboid(vm::bbox3(vm::vec3(512, 512, 512), vm::vec3(576, 576, 576)), "texture");
+
+            document->addNode(queryBrush, document->currentParent());
+            document->addNode(touchingBrush, document->currentParent());
+            document->addNode(distantBrush, document->currentParent());
+
+            document->select(queryBrush);
+            document->selectTouching(false);
+
+            ASSERT_EQ(std::vector<Model::Brush*>{ touchingBrush }, document->selectedNodes().brushes());
+        }
+
+        TEST_F(SelectionTest, selectInsideIgnoresDistantBrushes) {
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            Model::Brush* queryBrush = builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture");
+            Model::Brush* containedBrush = builder.createCuboid(vm::bbox3(vm::vec3(16, 16, 16), vm::vec3(48, 48, 48)), "texture");
+            Model::Brush* touchingBrush = builder.createCuboid(vm::bbox3(vm::vec3(32, 32, 32), vm::vec3(96, 96, 96)), "texture");
+            Model::Brush* distantBrush = builder.createCuboid(vm::bbox3(vm::vec3(512, 512, 512), vm::vec3(576, 576, 576)), "texture");
+
+            document->addNode(queryBrush, document->currentParent());
+            document->addNode(containedBrush, document->currentParent());
+            document->addNode(touchingBrush, document->currentParent());
+            document->addNode(distantBrush, document->currentParent());
+
+            document->select(queryBrush);
+            document->selectInside(false);
+
+            ASSERT_EQ(std::vector<Model::Brush*>{ containedBrush }, document->selectedNodes().brushes());
+        }
     }
 }
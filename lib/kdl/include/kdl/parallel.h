@@ -0,0 +1,127 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_PARALLEL_H
+#define KDL_PARALLEL_H
+
+#include <algorithm> // for std::min, std::max
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kdl {
+    /**
+     * Returns the number of threads used by the parallel algorithms in this file. This is the number of concurrent
+     * threads supported by the hardware, but at least 1.
+     *
+     * @return the number of threads
+     */
+    inline std::size_t parallel_thread_count() {
+        return std::max(std::size_t(1), static_cast<std::size_t>(std::thread::hardware_concurrency()));
+    }
+
+    /**
+     * Calls the given function once for every index in [0, count). The calls are distributed over at most
+     * `parallel_thread_count()` threads, one of which is the calling thread. The function returns once all calls have
+     * completed.
+     *
+     * The order in which the indices are processed is unspecified, so the given function must be safe to call
+     * concurrently for different indices.
+     *
+     * If a call throws an exception, the remaining indices which have not been started yet are skipped, and the first
+     * exception that was thrown is rethrown on the calling thread after all threads have finished.
+     *
+     * @tparam F the type of the function to call, must be callable with a std::size_t argument
+     * @param count the number of indices
+     * @param f the function to call
+     */
+    template <typename F>
+    void parallel_for(const std::size_t count, F&& f) {
+        const auto thread_count = std::min(count, parallel_thread_count());
+        if (thread_count <= 1u) {
+            for (std::size_t i = 0u; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next_index(0u);
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+
+        const auto work = [&]() {
+            try {
+                for (auto i = next_index++; i < count; i = next_index++) {
+                    f(i);
+                }
+            } catch (...) {
+                const auto lock = std::lock_guard<std::mutex>(exception_mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                next_index = count;
+            }
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(thread_count - 1u);
+        for (std::size_t i = 0u; i < thread_count - 1u; ++i) {
+            futures.push_back(std::async(std::launch::async, work));
+        }
+
+        work();
+        for (auto& future : futures) {
+            future.wait();
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**
+     * Applies the given lambda to each element of the given vector and returns a vector containing the results in the
+     * same order as the elements of the given vector. The lambda is applied concurrently by `parallel_for`, so it must
+     * be safe to call concurrently for different elements.
+     *
+     * The result type of the lambda must be default constructible and move assignable.
+     *
+     * @tparam T the type of the vector elements
+     * @tparam A the vector's allocator type
+     * @tparam L the type of the lambda to apply
+     * @param v the vector
+     * @param lambda the lambda to apply
+     * @return a vector containing the transformed values
+     */
+    template <typename T, typename A, typename L>
+    auto vec_parallel_transform(const std::vector<T, A>& v, L&& lambda) {
+        using ResultType = std::decay_t<decltype(lambda(std::declval<const T&>()))>;
+
+        auto result = std::vector<ResultType>(v.size());
+        parallel_for(v.size(), [&](const std::size_t i) {
+            result[i] = lambda(v[i]);
+        });
+        return result;
+    }
+}
+
+#endif //KDL_PARALLEL_H
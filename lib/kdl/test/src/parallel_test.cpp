@@ -0,0 +1,61 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include "kdl/parallel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace kdl {
+    TEST(parallel_test, parallel_for) {
+        parallel_for(0u, [](const std::size_t) { FAIL(); });
+
+        auto visited = std::vector<std::atomic<int>>(1000u);
+        parallel_for(visited.size(), [&](const std::size_t i) {
+            ++visited[i];
+        });
+
+        for (const auto& count : visited) {
+            ASSERT_EQ(1, count.load());
+        }
+    }
+
+    TEST(parallel_test, parallel_for_rethrows_exception) {
+        ASSERT_THROW(parallel_for(1000u, [](const std::size_t i) {
+            if (i == 500u) {
+                throw std::runtime_error("error");
+            }
+        }), std::runtime_error);
+    }
+
+    TEST(parallel_test, vec_parallel_transform) {
+        ASSERT_EQ(std::vector<int>({}), vec_parallel_transform(std::vector<int>({}), [](const int i) { return i + 1; }));
+
+        auto v = std::vector<int>();
+        auto expected = std::vector<int>();
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+            expected.push_back(i * 2);
+        }
+        ASSERT_EQ(expected, vec_parallel_transform(v, [](const int i) { return i * 2; }));
+    }
+}